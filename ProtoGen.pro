@@ -11,6 +11,7 @@ contains(QT_VERSION, ^4.*) {
 
 QT       += core
 QT       += xml
+QT       += concurrent
 
 QT       -= gui
 
@@ -37,7 +38,11 @@ SOURCES += main.cpp \
     protocolstructuremodule.cpp \
     protocolsupport.cpp \
     encodedlength.cpp \
-    shuntingyard.cpp
+    shuntingyard.cpp \
+    protocoldocumentation.cpp \
+    protocolxmlreader.cpp \
+    protocolstatistics.cpp \
+    protocoloperation.cpp
 
 HEADERS += \
     protocolparser.h \
@@ -52,7 +57,11 @@ HEADERS += \
     protocolstructuremodule.h \
     protocolsupport.h \
     encodedlength.h \
-    shuntingyard.h
+    shuntingyard.h \
+    protocoldocumentation.h \
+    protocolxmlreader.h \
+    protocolstatistics.h \
+    protocoloperation.h
 
 RESOURCES += \
     ProtoGen.qrc
@@ -90,6 +99,14 @@ macx{
         # QtXml depends on QtCore, but it will look in the wrong place for it, so fix that too.
         QMAKE_POST_LINK += install_name_tool -change $$[QT_INSTALL_LIBS]/QtCore.framework/Versions/5/QtCore @executable_path/QtCore $$quote($$shell_path($$PWD/ProtoGenInstall/QtXml)) $$escape_expand(\n\t)
 
+        # ProtoGen depends on QtConcurrent, copy it over, and then reset the paths in both the library and ProtoGen
+        QMAKE_POST_LINK += $$QMAKE_COPY_DIR $$quote($$shell_path($$[QT_INSTALL_LIBS]/QtConcurrent.framework/Versions/5/QtConcurrent)) $$quote($$shell_path($$PWD/ProtoGenInstall/QtConcurrent)) $$escape_expand(\n\t)
+        QMAKE_POST_LINK += install_name_tool -id @executable_path/QtConcurrent $$quote($$shell_path($$PWD/ProtoGenInstall/QtConcurrent)) $$escape_expand(\n\t)
+        QMAKE_POST_LINK += install_name_tool -change $$[QT_INSTALL_LIBS]/QtConcurrent.framework/Versions/5/QtConcurrent @executable_path/QtConcurrent $$quote($$shell_path($$PWD/ProtoGenInstall/ProtoGen)) $$escape_expand(\n\t)
+
+        # QtConcurrent depends on QtCore, but it will look in the wrong place for it, so fix that too.
+        QMAKE_POST_LINK += install_name_tool -change $$[QT_INSTALL_LIBS]/QtCore.framework/Versions/5/QtCore @executable_path/QtCore $$quote($$shell_path($$PWD/ProtoGenInstall/QtConcurrent)) $$escape_expand(\n\t)
+
         # ProtoGen depends on QtCore, copy it over, and then reset the paths in both the library and ProtoGen
         QMAKE_POST_LINK += $$QMAKE_COPY_DIR $$quote($$shell_path($$[QT_INSTALL_LIBS]/QtCore.framework/Versions/5/QtCore)) $$quote($$shell_path($$PWD/ProtoGenInstall/QtCore)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += install_name_tool -id @executable_path/QtCore $$quote($$shell_path($$PWD/ProtoGenInstall/QtCore)) $$escape_expand(\n\t)
@@ -119,6 +136,7 @@ unix:!macx{
 
         QMAKE_POST_LINK += $$quote(multimarkdown) $$quote($$shell_path($$PWD\README.md)) > $$quote($$shell_path($$PWD\ProtoGenInstall/ProtoGen.html)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$[QT_INSTALL_LIBS]/libQt5Xml.so.5)) $$quote($$shell_path($$PWD/ProtoGenInstall)) $$escape_expand(\n\t)
+        QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$[QT_INSTALL_LIBS]/libQt5Concurrent.so.5)) $$quote($$shell_path($$PWD/ProtoGenInstall)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$[QT_INSTALL_LIBS]/libQt5Core.so.5)) $$quote($$shell_path($$PWD/ProtoGenInstall)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$[QT_INSTALL_LIBS]/libicudata.so.53)) $$quote($$shell_path($$PWD/ProtoGenInstall)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$[QT_INSTALL_LIBS]/libicui18n.so.53)) $$quote($$shell_path($$PWD/ProtoGenInstall)) $$escape_expand(\n\t)
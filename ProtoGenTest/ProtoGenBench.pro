@@ -0,0 +1,66 @@
+#-------------------------------------------------
+#
+# Encode and decode throughput of the generated code. Generate the code
+# first, from this directory:
+#   ProtoGen ../exampleprotocol.xml
+#   ProtoGen benchbig.xml
+#   ProtoGen benchlittle.xml
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       -= gui
+
+TARGET = ProtoGenBench
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+QMAKE_CXXFLAGS += -Wno-unused-parameter
+
+SOURCES += bench.cpp \
+    packetinterface.c \
+    benchinterface.c \
+    bitfieldspecial.c \
+    Board.c \
+    Date.c \
+    Engine.c \
+    fielddecode.c \
+    fieldencode.c \
+    floatspecial.c \
+    GPS.c \
+    scaleddecode.c \
+    scaledencode.c \
+    TelemetryPacket.c \
+    VersionPacket.c \
+    KeepAlivePacket.c \
+    BenchBigPackets.c \
+    BenchLittlePackets.c
+
+HEADERS += \
+    indices.h \
+    bitfieldspecial.h \
+    Board.h \
+    Date.h \
+    DemolinkProtocol.h \
+    Engine.h \
+    fielddecode.h \
+    fieldencode.h \
+    floatspecial.h \
+    GPS.h \
+    scaleddecode.h \
+    scaledencode.h \
+    TelemetryPacket.h \
+    VersionPacket.h \
+    KeepAlivePacket.h \
+    BenchBigProtocol.h \
+    BenchBigPackets.h \
+    BenchLittleProtocol.h \
+    BenchLittlePackets.h \
+    packetinterface.h
+
+OTHER_FILES += \
+    benchbig.xml \
+    benchlittle.xml
@@ -0,0 +1,51 @@
+#-------------------------------------------------
+#
+# Checks the code generated with the protocol options that change it. The
+# options change the helper modules, so the code is generated into its own
+# directory. Generate the code first, from this directory:
+#   ProtoGen modelink.xml Modelink
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       -= gui
+
+TARGET = ProtoGenModes
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+QMAKE_CXXFLAGS += -Wno-unused-parameter
+
+INCLUDEPATH += Modelink
+
+SOURCES += modes.cpp \
+    modelinkinterface.c \
+    Modelink/bitfieldspecial.c \
+    Modelink/fielddecode.c \
+    Modelink/fieldencode.c \
+    Modelink/floatspecial.c \
+    Modelink/scaleddecode.c \
+    Modelink/scaledencode.c \
+    Modelink/ModelinkBatch.c \
+    Modelink/ModelinkTrace.c \
+    Modelink/ModelinkPackets.c
+
+HEADERS += \
+    Modelink/bitfieldspecial.h \
+    Modelink/fielddecode.h \
+    Modelink/fieldencode.h \
+    Modelink/floatspecial.h \
+    Modelink/scaleddecode.h \
+    Modelink/scaledencode.h \
+    Modelink/ModelinkProtocol.h \
+    Modelink/ModelinkBatch.h \
+    Modelink/ModelinkTrace.h \
+    Modelink/ModelinkPacketsTypes.h \
+    Modelink/ModelinkPackets.h \
+    packetinterface.h
+
+OTHER_FILES += \
+    modelink.xml
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# How the time and memory of a ProtoGen run grow with the size of the
+# protocol. ProtoGen must be built first, and either be in the path or be
+# given with -protogen.
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       -= gui
+
+TARGET = ProtoGenScale
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += scale.cpp
@@ -2,6 +2,11 @@
 #
 # Project created by QtCreator 2014-09-18T14:24:01
 #
+# Generate the code first, from this directory:
+#   ProtoGen ../exampleprotocol.xml
+#   ProtoGen loglink.xml
+#   ProtoGen framelink.xml
+#
 #-------------------------------------------------
 
 QT       += core
@@ -30,7 +35,19 @@ SOURCES += main.cpp \
     scaledencode.c \
     TelemetryPacket.c \
     VersionPacket.c \
-    KeepAlivePacket.c
+    KeepAlivePacket.c \
+    Codec.c \
+    BitfieldsPacket.c \
+    VarintPacket.c \
+    tablecodec.c \
+    checksum.c \
+    FramelinkPackets.c \
+    FramelinkFraming.c \
+    FramelinkDispatch.c \
+    packetlog.c \
+    LoglinkPackets.c \
+    LoglinkFraming.c \
+    LoglinkLog.c
 
 HEADERS += \
     indices.h \
@@ -48,7 +65,23 @@ HEADERS += \
     TelemetryPacket.h \
     VersionPacket.h \
     KeepAlivePacket.h \
+    Codec.h \
+    BitfieldsPacket.h \
+    VarintPacket.h \
+    tablecodec.h \
+    checksum.h \
+    FramelinkProtocol.h \
+    FramelinkPackets.h \
+    FramelinkFraming.h \
+    FramelinkDispatch.h \
+    packetlog.h \
+    LoglinkProtocol.h \
+    LoglinkPackets.h \
+    LoglinkFraming.h \
+    LoglinkLog.h \
     packetinterface.h
 
 OTHER_FILES += \
-    Doxyfile
+    Doxyfile \
+    framelink.xml \
+    loglink.xml
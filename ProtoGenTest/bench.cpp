@@ -0,0 +1,495 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <iostream>
+#include <iomanip>
+#include <string.h>
+#include <math.h>
+#include "VersionPacket.h"
+#include "KeepAlivePacket.h"
+#include "GPS.h"
+#include "Engine.h"
+#include "TelemetryPacket.h"
+#include "BenchBigPackets.h"
+#include "BenchLittlePackets.h"
+#include "packetinterface.h"
+
+#define PI 3.141592653589793
+
+//! The result of timing one packet
+typedef struct
+{
+    QString name;       //!< Name of the packet
+    QString endian;     //!< "big" or "little"
+    int bytes;          //!< Encoded data length of the packet
+    bool decoded;       //!< False if the packet did not decode
+    double encodeNs;    //!< Nanoseconds per encode
+    double decodeNs;    //!< Nanoseconds per decode
+
+}BenchResult;
+
+//! Keeps the optimizer from removing the decodes
+static volatile int sink = 0;
+
+static void fillGPS(GPS_t& gps);
+static void fillTelemetry(Telemetry_t& telemetry);
+static void fillThrottleSettings(ThrottleSettings_t& settings);
+static void fillEngineSettings(EngineSettings_t& settings);
+static void fillVersion(Version_t& version);
+static void encodeEngineCommand(void* pkt, const float* command);
+static void encodeKeepAlive(void* pkt, const KeepAlive_t* keepalive);
+static void printResult(const BenchResult& result);
+static QJsonObject toJson(const BenchResult& result);
+
+
+/*!
+ * Time the encode and decode of one packet
+ * \param name is the name of the packet
+ * \param endian is the byte order of the protocol of the packet
+ * \param encode is the function that encodes the packet
+ * \param decode is the function that decodes the packet
+ * \param input is the data that are encoded
+ * \param iterations is the number of times to encode and decode
+ * \return the timing of the packet
+ */
+template<class T>
+static BenchResult benchPacket(const QString& name, const QString& endian, void (*encode)(void*, const T*), int (*decode)(const void*, T*), const T& input, int iterations)
+{
+    BenchResult result;
+    testPacket_t pkt;
+    T output;
+    QElapsedTimer timer;
+
+    result.name = name;
+    result.endian = endian;
+
+    memset(&pkt, 0, sizeof(pkt));
+    memset(&output, 0, sizeof(output));
+
+    // Once to get the size and make sure the packet works
+    encode(&pkt, &input);
+    result.bytes = pkt.length;
+    result.decoded = (decode(&pkt, &output) != 0);
+
+    timer.start();
+    for(int i = 0; i < iterations; i++)
+        encode(&pkt, &input);
+    result.encodeNs = timer.nsecsElapsed()/(double)iterations;
+
+    int decoded = 0;
+    timer.restart();
+    for(int i = 0; i < iterations; i++)
+        decoded += decode(&pkt, &output);
+    result.decodeNs = timer.nsecsElapsed()/(double)iterations;
+
+    sink += decoded;
+
+    return result;
+
+}// benchPacket
+
+
+/*!
+ * Fill out the stress packet of a long run of bitfields
+ * \param bitfields receives the data
+ */
+template<class T>
+static void fillBitfields(T& bitfields)
+{
+    bitfields.b0 = 1;
+    bitfields.b1 = 2;
+    bitfields.b2 = 5;
+    bitfields.b3 = 9;
+    bitfields.b4 = 17;
+    bitfields.b5 = 33;
+    bitfields.b6 = 65;
+    bitfields.b7 = 6;
+    bitfields.b8 = 0;
+    bitfields.b9 = 1;
+    bitfields.b10 = 3;
+    bitfields.b11 = 12;
+    bitfields.b12 = 30;
+    bitfields.b13 = 60;
+    bitfields.b14 = 120;
+    bitfields.b15 = 15;
+    bitfields.b16 = 300;
+    bitfields.b17 = 1500;
+    bitfields.b18 = 6000;
+    bitfields.b19 = 30000;
+    bitfields.b20 = 60000;
+}
+
+
+/*!
+ * Fill out the stress packet of large scaled arrays
+ * \param scaled receives the data
+ */
+template<class T>
+static void fillScaledArrays(T& scaled)
+{
+    for(int i = 0; i < 64; i++)
+        scaled.samples[i] = (float)(10.0*sin(i*PI/32));
+
+    for(int i = 0; i < 16; i++)
+        scaled.ranges[i] = 62.5*i;
+}
+
+
+/*!
+ * Fill out the stress packet of reduced precision floating point arrays
+ * \param floats receives the data
+ */
+template<class T>
+static void fillFloatArrays(T& floats)
+{
+    for(int i = 0; i < 64; i++)
+        floats.halves[i] = (float)((i - 32)*3.7);
+
+    for(int i = 0; i < 16; i++)
+        floats.reduced[i] = (float)((i - 8)*1234.5);
+}
+
+
+/*!
+ * Fill out the stress packet of deeply nested structures
+ * \param nested receives the data
+ */
+template<class T>
+static void fillNested(T& nested)
+{
+    nested.count = 24;
+
+    for(int i = 0; i < 2; i++)
+    {
+        nested.Outer[i].id = 1000 + i;
+
+        for(int j = 0; j < 3; j++)
+        {
+            nested.Outer[i].Middle[j].flags = (uint8_t)(i*3 + j);
+
+            for(int k = 0; k < 4; k++)
+            {
+                nested.Outer[i].Middle[j].Inner[k].x = (float)(i + j + k);
+                nested.Outer[i].Middle[j].Inner[k].y = (float)(i - j - k);
+                nested.Outer[i].Middle[j].Inner[k].z = (float)(i*j*k);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList arguments = a.arguments();
+    QString jsonFile;
+    QString filter;
+    int iterations = 1000000;
+
+    for(int i = 1; i < arguments.size(); i++)
+    {
+        if((arguments.at(i) == "-iterations") && (i + 1 < arguments.size()))
+            iterations = arguments.at(++i).toInt();
+        else if((arguments.at(i) == "-json") && (i + 1 < arguments.size()))
+            jsonFile = arguments.at(++i);
+        else if((arguments.at(i) == "-filter") && (i + 1 < arguments.size()))
+            filter = arguments.at(++i);
+        else
+        {
+            std::cout << "ProtoGenBench usage:" << std::endl;
+            std::cout << "ProtoGenBench [-iterations N] [-json results.json] [-filter packetname]" << std::endl;
+            return 0;
+        }
+    }
+
+    if(iterations <= 0)
+        iterations = 1;
+
+    // The Demolink packets
+    GPS_t gps;
+    Telemetry_t telemetry;
+    ThrottleSettings_t throttle;
+    EngineSettings_t engine;
+    Version_t version;
+    KeepAlive_t keepalive;
+    Constant_t constant;
+    float command = 0.75f;
+
+    fillGPS(gps);
+    fillTelemetry(telemetry);
+    fillThrottleSettings(throttle);
+    fillEngineSettings(engine);
+    fillVersion(version);
+    memset(&keepalive, 0, sizeof(keepalive));
+    memset(&constant, 0, sizeof(constant));
+    constant.token = 127;
+
+    // The stress packets, in both byte orders
+    BigBitfields_t bigBitfields;
+    BigScaledArrays_t bigScaled;
+    BigFloatArrays_t bigFloats;
+    BigNested_t bigNested;
+    LittleBitfields_t littleBitfields;
+    LittleScaledArrays_t littleScaled;
+    LittleFloatArrays_t littleFloats;
+    LittleNested_t littleNested;
+
+    fillBitfields(bigBitfields);
+    fillScaledArrays(bigScaled);
+    fillFloatArrays(bigFloats);
+    fillNested(bigNested);
+    fillBitfields(littleBitfields);
+    fillScaledArrays(littleScaled);
+    fillFloatArrays(littleFloats);
+    fillNested(littleNested);
+
+    QList<BenchResult> results;
+    QString big("big");
+    QString little("little");
+
+    results.append(benchPacket("KeepAlive", big, encodeKeepAlive, decodeKeepAlivePacketStructure, keepalive, iterations));
+    results.append(benchPacket("GPS", big, encodeGPSPacket, decodeGPSPacket, gps, iterations));
+    results.append(benchPacket("EngineCommand", big, encodeEngineCommand, decodeEngineCommandPacket, command, iterations));
+    results.append(benchPacket("EngineSettings", big, encodeEngineSettingsPacketStructure, decodeEngineSettingsPacketStructure, engine, iterations));
+    results.append(benchPacket("ThrottleSettings", big, encodeThrottleSettingsPacketStructure, decodeThrottleSettingsPacketStructure, throttle, iterations));
+    results.append(benchPacket("Version", big, encodeVersionPacketStructure, decodeVersionPacketStructure, version, iterations));
+    results.append(benchPacket("Telemetry", big, encodeTelemetryPacketStructure, decodeTelemetryPacketStructure, telemetry, iterations));
+    results.append(benchPacket("Constant", big, encodeConstantPacketStructure, decodeConstantPacketStructure, constant, iterations));
+
+    results.append(benchPacket("Bitfields", big, encodeBigBitfieldsPacketStructure, decodeBigBitfieldsPacketStructure, bigBitfields, iterations));
+    results.append(benchPacket("Bitfields", little, encodeLittleBitfieldsPacketStructure, decodeLittleBitfieldsPacketStructure, littleBitfields, iterations));
+    results.append(benchPacket("ScaledArrays", big, encodeBigScaledArraysPacketStructure, decodeBigScaledArraysPacketStructure, bigScaled, iterations));
+    results.append(benchPacket("ScaledArrays", little, encodeLittleScaledArraysPacketStructure, decodeLittleScaledArraysPacketStructure, littleScaled, iterations));
+    results.append(benchPacket("FloatArrays", big, encodeBigFloatArraysPacketStructure, decodeBigFloatArraysPacketStructure, bigFloats, iterations));
+    results.append(benchPacket("FloatArrays", little, encodeLittleFloatArraysPacketStructure, decodeLittleFloatArraysPacketStructure, littleFloats, iterations));
+    results.append(benchPacket("Nested", big, encodeBigNestedPacketStructure, decodeBigNestedPacketStructure, bigNested, iterations));
+    results.append(benchPacket("Nested", little, encodeLittleNestedPacketStructure, decodeLittleNestedPacketStructure, littleNested, iterations));
+
+    int Return = 1;
+    QJsonArray array;
+
+    std::cout << std::left << std::setw(20) << "packet" << std::setw(8) << "endian" << std::right << std::setw(8) << "bytes"
+              << std::setw(14) << "encode ns" << std::setw(14) << "encode MB/s" << std::setw(14) << "decode ns" << std::setw(14) << "decode MB/s" << std::endl;
+
+    for(int i = 0; i < results.size(); i++)
+    {
+        if(!filter.isEmpty() && !results.at(i).name.contains(filter, Qt::CaseInsensitive))
+            continue;
+
+        printResult(results.at(i));
+        array.append(toJson(results.at(i)));
+
+        if(!results.at(i).decoded)
+        {
+            std::cout << results.at(i).name.toStdString() << " (" << results.at(i).endian.toStdString() << ") failed to decode" << std::endl;
+            Return = 0;
+        }
+    }
+
+    if(!jsonFile.isEmpty())
+    {
+        QJsonObject root;
+        root.insert("iterations", iterations);
+        root.insert("results", array);
+
+        QFile file(jsonFile);
+        if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+            file.write(QJsonDocument(root).toJson());
+        else
+        {
+            std::cout << "failed to open results file: " << jsonFile.toStdString() << std::endl;
+            Return = 0;
+        }
+    }
+
+    return Return;
+}
+
+
+/*!
+ * Print one result as a line of the results table
+ * \param result is the result to print
+ */
+void printResult(const BenchResult& result)
+{
+    // bytes per nanosecond is 1000 MB per second
+    std::cout << std::left << std::setw(20) << result.name.toStdString() << std::setw(8) << result.endian.toStdString()
+              << std::right << std::setw(8) << result.bytes << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.encodeNs << std::setw(14) << 1000.0*result.bytes/result.encodeNs
+              << std::setw(14) << result.decodeNs << std::setw(14) << 1000.0*result.bytes/result.decodeNs << std::endl;
+}
+
+
+/*!
+ * Convert one result to JSON for regression tracking
+ * \param result is the result to convert
+ * \return the JSON object of the result
+ */
+QJsonObject toJson(const BenchResult& result)
+{
+    QJsonObject object;
+
+    object.insert("packet", result.name);
+    object.insert("endian", result.endian);
+    object.insert("bytes", result.bytes);
+    object.insert("encodeNs", result.encodeNs);
+    object.insert("decodeNs", result.decodeNs);
+    object.insert("encodeMBps", 1000.0*result.bytes/result.encodeNs);
+    object.insert("decodeMBps", 1000.0*result.bytes/result.decodeNs);
+
+    return object;
+}
+
+
+//! Encode the engine command packet with the same signature as the other packets
+void encodeEngineCommand(void* pkt, const float* command)
+{
+    encodeEngineCommandPacket(pkt, *command);
+}
+
+
+//! Encode the keep alive packet, whose data are all constant
+void encodeKeepAlive(void* pkt, const KeepAlive_t* keepalive)
+{
+    (void)keepalive;
+    encodeKeepAlivePacketStructure(pkt);
+}
+
+
+/*!
+ * Fill out a GPS structure with eight tracked satellites
+ * \param gps receives the data
+ */
+void fillGPS(GPS_t& gps)
+{
+    memset(&gps, 0, sizeof(gps));
+
+    gps.ITOW = 123456789;
+    gps.Week = 1234;
+    gps.PDOP = 2.13f;
+    gps.PositionLLA.altitude = 169.4;
+    gps.PositionLLA.latitude = 45.6980142*PI/180;
+    gps.PositionLLA.longitude = -121.5618339*PI/180;
+    gps.VelocityNED.north = 23.311f;
+    gps.VelocityNED.east = -42.399f;
+    gps.VelocityNED.down = -0.006f;
+    gps.numSvInfo = 8;
+
+    for(int i = 0; i < gps.numSvInfo; i++)
+    {
+        gps.svInfo[i].PRN = (uint8_t)(i + 1);
+        gps.svInfo[i].azimuth = (float)(i*0.5 - 3);
+        gps.svInfo[i].elevation = (float)(i*0.1);
+        gps.svInfo[i].L1CNo = 50;
+        gps.svInfo[i].L2CNo = 33;
+        gps.svInfo[i].visible = 1;
+        gps.svInfo[i].tracked = 1;
+        gps.svInfo[i].healthy = 1;
+        gps.svInfo[i].used = i & 1;
+    }
+}
+
+
+/*!
+ * Fill out a telemetry structure with every optional part included
+ * \param telemetry receives the data
+ */
+void fillTelemetry(Telemetry_t& telemetry)
+{
+    memset(&telemetry, 0, sizeof(telemetry));
+
+    telemetry.insMode = insModeRun;
+    telemetry.numGPSs = 2;
+    fillGPS(telemetry.gpsData[0]);
+    fillGPS(telemetry.gpsData[1]);
+
+    telemetry.numFueltanks = 8;
+    for(int i = 0; i < telemetry.numFueltanks; i++)
+        telemetry.fuel[i] = 10.0f*i;
+
+    telemetry.airDataIncluded = 1;
+    telemetry.OAT = 300;
+    telemetry.staticP = 101325;
+    telemetry.dynamicP = 254;
+
+    telemetry.laserIncluded = 1;
+    telemetry.laserAGL = 131.256f;
+
+    telemetry.magIncluded = 1;
+    telemetry.mag[0] = 12.56f;
+    telemetry.mag[1] = 85.76f;
+    telemetry.mag[2] = -999.9f;
+    telemetry.compassHeading = -1.12f;
+
+    telemetry.numControls = 16;
+    for(int i = 0; i < telemetry.numControls; i++)
+        telemetry.controls[i] = (float)(i*PI/180);
+}
+
+
+/*!
+ * Fill out the throttle settings with a full curve
+ * \param settings receives the data
+ */
+void fillThrottleSettings(ThrottleSettings_t& settings)
+{
+    memset(&settings, 0, sizeof(settings));
+
+    settings.numCurvePoints = 10;
+    settings.enableCurve = 1;
+    settings.highPWM = 2000;
+    settings.lowPWM = 1000;
+    for(int i = 0; i < settings.numCurvePoints; i++)
+    {
+        settings.curvePoint[i].PWM = settings.lowPWM + i*100;
+        settings.curvePoint[i].throttle = i*0.1f;
+    }
+}
+
+
+/*!
+ * Fill out the engine settings
+ * \param settings receives the data
+ */
+void fillEngineSettings(EngineSettings_t& settings)
+{
+    memset(&settings, 0, sizeof(settings));
+
+    settings.gain[0] = 0.1f;
+    settings.gain[1] = (float)(-PI);
+    settings.gain[2] = 200.0f;
+    settings.maxRPM = 8000;
+    settings.mode = directRPM;
+}
+
+
+/*!
+ * Fill out the version information
+ * \param version receives the data
+ */
+void fillVersion(Version_t& version)
+{
+    memset(&version, 0, sizeof(version));
+
+    version.major = 1;
+    version.minor = 2;
+    version.sub = 3;
+    version.patch = 4;
+    strcpy((char*)version.description, "benchmark version with a description of typical length");
+    version.date.day = 14;
+    version.date.month = 10;
+    version.date.year = 2026;
+    version.board.assemblyNumber = 0x12345678;
+    version.board.isCalibrated = 1;
+    version.board.serialNumber = 0x98765432;
+    version.board.manufactureDate.year = 1903;
+    version.board.manufactureDate.month = 12;
+    version.board.manufactureDate.day = 17;
+    version.board.calibratedDate.year = 1969;
+    version.board.calibratedDate.month = 7;
+    version.board.calibratedDate.day = 20;
+}
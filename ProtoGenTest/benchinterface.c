@@ -0,0 +1,70 @@
+#include "BenchBigProtocol.h"
+#include "BenchLittleProtocol.h"
+#include "packetinterface.h"
+
+/*!
+ * The packet functions of the two benchmark protocols, which use the same
+ * simple packet layout as the Demolink protocol in packetinterface.c
+ */
+
+//! \return the packet data pointer from the packet
+uint8_t* getBenchBigPacketData(void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! \return the packet data pointer from the packet
+const uint8_t* getBenchBigPacketDataConst(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! Complete a packet after the data have been encoded
+void finishBenchBigPacket(void* pkt, int size, uint32_t packetID)
+{
+    ((testPacket_t*)pkt)->pkttype = (uint8_t)packetID;
+    ((testPacket_t*)pkt)->length = (uint8_t)size;
+}
+
+//! \return the size of a packet from the packet header
+int getBenchBigPacketSize(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->length;
+}
+
+//! \return the ID of a packet from the packet header
+uint32_t getBenchBigPacketID(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->pkttype;
+}
+
+//! \return the packet data pointer from the packet
+uint8_t* getBenchLittlePacketData(void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! \return the packet data pointer from the packet
+const uint8_t* getBenchLittlePacketDataConst(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! Complete a packet after the data have been encoded
+void finishBenchLittlePacket(void* pkt, int size, uint32_t packetID)
+{
+    ((testPacket_t*)pkt)->pkttype = (uint8_t)packetID;
+    ((testPacket_t*)pkt)->length = (uint8_t)size;
+}
+
+//! \return the size of a packet from the packet header
+int getBenchLittlePacketSize(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->length;
+}
+
+//! \return the ID of a packet from the packet header
+uint32_t getBenchLittlePacketID(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->pkttype;
+}
@@ -1,6 +1,7 @@
 #include <QDateTime>
 #include <iostream>
 #include <math.h>
+#include <stdio.h>
 #include "floatspecial.h"
 #include "bitfieldspecial.h"
 #include "VersionPacket.h"
@@ -8,12 +9,36 @@
 #include "GPS.h"
 #include "Engine.h"
 #include "TelemetryPacket.h"
+#include "LoglinkPackets.h"
+#include "LoglinkLog.h"
+#include "Codec.h"
+#include "BitfieldsPacket.h"
+#include "VarintPacket.h"
+#include "FramelinkPackets.h"
+#include "FramelinkFraming.h"
+#include "FramelinkDispatch.h"
 #include "packetinterface.h"
 
 #define PI 3.141592653589793
 #define deg2rad(x) (PI*(x)/180.0)
 #define rad2deg(x) (180.0*(x)/PI)
 
+// If a field cannot be coded by the table the packet silently falls back to
+// straight line code, and the codec test would compare the code to itself
+#ifndef isTableCodedPacketTableCoded
+#error "The TableCoded packet must be coded by the table codec"
+#endif
+
+//! What the stream parser test handlers received
+typedef struct
+{
+    int positions;
+    int deltas;
+    int statuses;
+    Position_t position;
+    Status_t status;
+}streamTest_t;
+
 static int testConstantPacket(void);
 static int testTelemetryPacket(void);
 static int verifyTelemetryData(Telemetry_t telemetry);
@@ -26,6 +51,15 @@ static int verifyGPSData(GPS_t gps);
 static int testKeepAlivePacket(void);
 static int testVersionPacket(void);
 static int verifyVersionData(Version_t version);
+static int testLogReader(void);
+static int writeLogReaderLog(const char* path, uint64_t start);
+static int testCodecPackets(void);
+template<class T> static void fillOutCodecTest(T& user, int scenario);
+template<class T> static int verifyCodecData(const T& user, int scenario);
+static int testBitfieldsPacket(void);
+static int testVarintPacket(void);
+static int testStreamParser(void);
+static int verifyStreamParser(const FramelinkStreamParser_t& parser, const streamTest_t& test, int discarded);
 
 static int fcompare(double input1, double input2, double epsilon);
 
@@ -69,6 +103,21 @@ int main(int argc, char *argv[])
     if(testKeepAlivePacket() == 0)
         return 0;
 
+    if(testLogReader() == 0)
+        return 0;
+
+    if(testCodecPackets() == 0)
+        return 0;
+
+    if(testBitfieldsPacket() == 0)
+        return 0;
+
+    if(testVarintPacket() == 0)
+        return 0;
+
+    if(testStreamParser() == 0)
+        return 0;
+
     std::cout << "All tests passed" << std::endl;
     return 1;
 }
@@ -835,6 +884,786 @@ int verifyVersionData(Version_t version)
 }
 
 
+/*!
+ * Write the log for the log reader test: ten samples 100 apart in time, with
+ * an event and a few bytes that are not a record in the middle
+ * \param path is the name of the log file
+ * \param start is the time of the first sample
+ * \return the number of bytes that are not a record, or 0 if the log could not be created
+ */
+int writeLogReaderLog(const char* path, uint64_t start)
+{
+    const uint8_t garbage[3] = {0x11, 0x22, 0x33};
+    LoglinkPacket_t pkt;
+    uint8_t record[LOGLINK_LOG_TIME_SIZE + sizeof(pkt.frame)];
+    Sample_t sample;
+    Event_t event;
+    FILE* file;
+    int i;
+
+    file = fopen(path, "wb");
+    if(file == NULL)
+        return 0;
+
+    for(i = 0; i < 10; i++)
+    {
+        sample.channel = (uint8_t)i;
+        sample.value = 0.25f*i;
+        encodeSamplePacketStructure(&pkt, &sample);
+        fwrite(record, 1, encodeLoglinkLogRecord(record, start + 100*i, &pkt), file);
+
+        if(i == 4)
+        {
+            // One event, then bytes that are not a record
+            event.code = 0xBEEF;
+            event.detail = 123456;
+            encodeEventPacketStructure(&pkt, &event);
+            fwrite(record, 1, encodeLoglinkLogRecord(record, start + 450, &pkt), file);
+            fwrite(garbage, 1, sizeof(garbage), file);
+        }
+    }
+
+    fclose(file);
+
+    return sizeof(garbage);
+
+}// writeLogReaderLog
+
+
+/*!
+ * Test the log reader. A log with a few bad bytes in it is indexed, then
+ * opened again with the cached index, and the packets are found by time.
+ * Then the log is rewritten with the same size but later times, at once, so
+ * the cached index must be found to be stale and the log indexed again.
+ */
+int testLogReader(void)
+{
+    const char* path = "loglinktest.log";
+    const void* pkts[4];
+    packetLog_t log;
+    Sample_t sample;
+    Event_t event;
+    uint64_t first;
+    uint64_t start = 0;
+    FILE* file;
+    int i, pass, discarded;
+
+    discarded = writeLogReaderLog(path, start);
+    if(discarded == 0)
+    {
+        std::cout << "Log reader test failed to create the log" << std::endl;
+        return 0;
+    }
+
+    // The first pass builds the index, the second uses the cached index, the
+    // third rewrites the log, whose index is built again
+    for(pass = 0; pass < 3; pass++)
+    {
+        if(pass == 2)
+        {
+            start = 1000;
+            if(writeLogReaderLog(path, start) == 0)
+            {
+                std::cout << "Log reader test failed to rewrite the log" << std::endl;
+                return 0;
+            }
+        }
+
+        if(openLoglinkLog(&log, path) == 0)
+        {
+            std::cout << "Log reader failed to open the log" << std::endl;
+            return 0;
+        }
+
+        if((log.numEntries != 11) || (log.discarded != (uint64_t)discarded))
+        {
+            std::cout << "Log reader indexed the log incorrectly" << std::endl;
+            closePacketLog(&log);
+            return 0;
+        }
+
+        // The samples from 200 to 500 after the start, inclusive
+        if( (findPacketLogEntries(&log, getSamplePacketID(), start + 200, start + 500, &first) != 4) ||
+            (getLoglinkLogPackets(&log, first, 4, pkts) != 4))
+        {
+            std::cout << "Log reader found the wrong number of samples" << std::endl;
+            closePacketLog(&log);
+            return 0;
+        }
+
+        for(i = 0; i < 4; i++)
+        {
+            if( (decodeSamplePacketStructure(pkts[i], &sample) == 0) ||
+                (sample.channel != i + 2) ||
+                fcompare(sample.value, 0.25*(i + 2), 0.01))
+            {
+                std::cout << "Log reader found incorrect samples" << std::endl;
+                closePacketLog(&log);
+                return 0;
+            }
+        }
+
+        if( (findPacketLogEntries(&log, getEventPacketID(), 0, UINT64_MAX, &first) != 1) ||
+            (log.entries[first].time != start + 450) ||
+            (decodeEventPacketStructure(getLoglinkLogPacket(&log, first), &event) == 0) ||
+            (event.code != 0xBEEF) ||
+            (event.detail != 123456))
+        {
+            std::cout << "Log reader found an incorrect event" << std::endl;
+            closePacketLog(&log);
+            return 0;
+        }
+
+        closePacketLog(&log);
+
+        if(pass == 0)
+        {
+            file = fopen("loglinktest.log.idx", "rb");
+            if(file == NULL)
+            {
+                std::cout << "Log reader did not cache the index" << std::endl;
+                return 0;
+            }
+            fclose(file);
+        }
+    }
+
+    remove("loglinktest.log.idx");
+    remove(path);
+
+    return 1;
+
+}// testLogReader
+
+
+/*!
+ * Test the table codec against the straight line code. The TableCoded and
+ * LineCoded packets have the same fields, so each packet is decoded by the
+ * codec of the other packet.
+ */
+int testCodecPackets(void)
+{
+    testPacket_t tablePkt, linePkt;
+    TableCoded_t table;
+    LineCoded_t line;
+
+    if(getTableCodedMinDataLength() != 24)
+    {
+        std::cout << "TableCoded packet minimum data length is wrong" << std::endl;
+        return 0;
+    }
+
+    // Scenario 0 includes the full arrays and the dependent field; scenario 1
+    // leaves them out, and has a negative number of steps
+    for(int scenario = 0; scenario < 2; scenario++)
+    {
+        memset(&table, 0, sizeof(table));
+        memset(&line, 0, sizeof(line));
+        fillOutCodecTest(table, scenario);
+        fillOutCodecTest(line, scenario);
+
+        encodeTableCodedPacketStructure(&tablePkt, &table);
+        encodeLineCodedPacketStructure(&linePkt, &line);
+
+        int length = (scenario == 0) ? (24 + 4*2 + 3 + 2) : (24 + 2*2);
+
+        if((tablePkt.length != length) || (linePkt.length != length))
+        {
+            std::cout << "Codec packet has the wrong length" << std::endl;
+            return 0;
+        }
+
+        if((tablePkt.pkttype != 24) || (linePkt.pkttype != 25))
+        {
+            std::cout << "Codec packet has the wrong type" << std::endl;
+            return 0;
+        }
+
+        if(memcmp(tablePkt.data, linePkt.data, length) != 0)
+        {
+            std::cout << "Table codec and straight line code encoded different data" << std::endl;
+            return 0;
+        }
+
+        if(scenario == 0)
+        {
+            if( (tablePkt.data[0] != 4)     ||
+                (tablePkt.data[1] != 0x00)  || (tablePkt.data[2] != 0x7B) ||    // 123
+                (tablePkt.data[3] != 0xFE)  || (tablePkt.data[4] != 0x38) ||    // -456
+                (tablePkt.data[5] != 0x7F)  || (tablePkt.data[6] != 0xFF) ||    // clamped to 32767
+                (tablePkt.data[7] != 0x80)  || (tablePkt.data[8] != 0x00) ||    // clamped to -32768
+                (tablePkt.data[9] != 1)     ||
+                (tablePkt.data[10] != 0xFE) || (tablePkt.data[11] != 0x1D) || (tablePkt.data[12] != 0xC0) ||
+                (tablePkt.data[13] != 0x65) || (tablePkt.data[14] != 0x9F) ||
+                (tablePkt.data[length-1] != 0xA5))
+            {
+                std::cout << "Table codec encoded incorrect data" << std::endl;
+                return 0;
+            }
+        }
+
+        // Swap the identifiers so each packet is decoded by the other codec
+        tablePkt.pkttype = 25;
+        linePkt.pkttype = 24;
+
+        memset(&table, 0, sizeof(table));
+        memset(&line, 0, sizeof(line));
+
+        if(decodeTableCodedPacketStructure(&linePkt, &table))
+        {
+            if(verifyCodecData(table, scenario) == 0)
+            {
+                std::cout << "decodeTableCodedPacketStructure() yielded incorrect data" << std::endl;
+                return 0;
+            }
+        }
+        else
+        {
+            std::cout << "decodeTableCodedPacketStructure() failed" << std::endl;
+            return 0;
+        }
+
+        if(decodeLineCodedPacketStructure(&tablePkt, &line))
+        {
+            if(verifyCodecData(line, scenario) == 0)
+            {
+                std::cout << "decodeLineCodedPacketStructure() yielded incorrect data" << std::endl;
+                return 0;
+            }
+        }
+        else
+        {
+            std::cout << "decodeLineCodedPacketStructure() failed" << std::endl;
+            return 0;
+        }
+
+        // Both codecs must reject the packet when it is truncated anywhere
+        for(int i = 0; i < length; i++)
+        {
+            tablePkt.length = linePkt.length = i;
+
+            if(decodeTableCodedPacketStructure(&linePkt, &table) || decodeLineCodedPacketStructure(&tablePkt, &line))
+            {
+                std::cout << "Codec packet truncated to " << i << " bytes was not rejected" << std::endl;
+                return 0;
+            }
+        }
+
+    }// for both scenarios
+
+    return 1;
+
+}// testCodecPackets
+
+
+template<class T> void fillOutCodecTest(T& user, int scenario)
+{
+    if(scenario == 0)
+    {
+        user.numValues = 4;
+        user.values[0] = 1.23f;
+        user.values[1] = -4.56f;
+        user.values[2] = 400;
+        user.values[3] = -400;
+        user.hasExtra = 1;
+        user.extra = -123456;
+        user.temperature = 25.5;
+        user.ratio = NAN;
+        user.precise = PI;
+        user.counter = 0xDEADBEEF;
+        user.level = -100;
+        user.numSteps = 2;
+        user.steps[0] = 7;
+        user.steps[1] = 8;
+    }
+    else
+    {
+        // The values beyond numValues, extra, and the steps are not encoded
+        user.numValues = 2;
+        user.values[0] = -0.01f;
+        user.values[1] = 327.67f;
+        user.values[2] = 9;
+        user.values[3] = 9;
+        user.hasExtra = 0;
+        user.extra = 77;
+        user.temperature = -40;
+        user.ratio = 0.5f;
+        user.precise = -0.001;
+        user.counter = 0;
+        user.level = 127;
+        user.numSteps = -1;
+        user.steps[0] = 9;
+        user.steps[1] = 9;
+    }
+}
+
+
+template<class T> int verifyCodecData(const T& user, int scenario)
+{
+    if(scenario == 0)
+    {
+        if(user.numValues != 4) return 0;
+        if(fcompare(user.values[0], 1.23, 0.01)) return 0;
+        if(fcompare(user.values[1], -4.56, 0.01)) return 0;
+        if(fcompare(user.values[2], 327.67, 0.001)) return 0;
+        if(fcompare(user.values[3], -327.68, 0.001)) return 0;
+        if(user.hasExtra != 1) return 0;
+        if(user.extra != -123456) return 0;
+        if(fcompare(user.temperature, 25.5, 165.0/65535)) return 0;
+        if(user.ratio != 0) return 0;
+        if(user.precise != PI) return 0;
+        if(user.counter != 0xDEADBEEF) return 0;
+        if(user.level != -100) return 0;
+        if(user.numSteps != 2) return 0;
+        if(user.steps[0] != 7) return 0;
+        if(user.steps[1] != 8) return 0;
+    }
+    else
+    {
+        if(user.numValues != 2) return 0;
+        if(fcompare(user.values[0], -0.01, 0.001)) return 0;
+        if(fcompare(user.values[1], 327.67, 0.001)) return 0;
+        if(user.values[2] != 0) return 0;
+        if(user.values[3] != 0) return 0;
+        if(user.hasExtra != 0) return 0;
+        if(user.extra != 0) return 0;
+        if(fcompare(user.temperature, -40, 165.0/65535)) return 0;
+        if(user.ratio != 0.5f) return 0;
+        if(user.precise != -0.001) return 0;
+        if(user.counter != 0) return 0;
+        if(user.level != 127) return 0;
+        if(user.numSteps != -1) return 0;
+        if(user.steps[0] != 0) return 0;
+        if(user.steps[1] != 0) return 0;
+    }
+
+    return 1;
+
+}// verifyCodecData
+
+
+/*!
+ * Test groups of bitfields which cross byte boundaries and do not fill their
+ * last byte. The groups are fused into words, so the encoded bytes are
+ * checked against the bit by bit encoding.
+ */
+int testBitfieldsPacket(void)
+{
+    testPacket_t pkt;
+    Bitfields_t bitfields;
+
+    // expected encoding of each group, most significant bit first
+    const uint8_t expected[12] = {0xB5, 0x75, 0x78,             // 5, 0x55, 1, 0xABC in 23 bits
+                                  0x3C,
+                                  0xD8, 0xA0,                   // 0x1B, 0, 0x0A in 12 bits
+                                  0xC3,
+                                  0xFE, 0xDC, 0xBD, 0x5E, 0x68};// 0xFEDCB, 0x1ABCD in 37 bits
+
+    if(getBitfieldsMinDataLength() != 12)
+    {
+        std::cout << "Bitfields packet minimum data length is wrong" << std::endl;
+        return 0;
+    }
+
+    memset(&bitfields, 0, sizeof(bitfields));
+    bitfields.a = 5;
+    bitfields.b = 0x55;
+    bitfields.c = 1;
+    bitfields.d = 0xABC;
+    bitfields.separator1 = 0x3C;
+    bitfields.e = 0x1B;
+    bitfields.f = 0x0A;
+    bitfields.separator2 = 0xC3;
+    bitfields.g = 0xFEDCB;
+    bitfields.h = 0x1ABCD;
+
+    encodeBitfieldsPacketStructure(&pkt, &bitfields);
+
+    if(pkt.length != 12)
+    {
+        std::cout << "Bitfields packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if(pkt.pkttype != 26)
+    {
+        std::cout << "Bitfields packet has the wrong type" << std::endl;
+        return 0;
+    }
+
+    if(memcmp(pkt.data, expected, sizeof(expected)) != 0)
+    {
+        std::cout << "Bitfields packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&bitfields, 0, sizeof(bitfields));
+    if(decodeBitfieldsPacketStructure(&pkt, &bitfields))
+    {
+        if( (bitfields.a != 5)              ||
+            (bitfields.b != 0x55)           ||
+            (bitfields.c != 1)              ||
+            (bitfields.d != 0xABC)          ||
+            (bitfields.separator1 != 0x3C)  ||
+            (bitfields.e != 0x1B)           ||
+            (bitfields.f != 0x0A)           ||
+            (bitfields.separator2 != 0xC3)  ||
+            (bitfields.g != 0xFEDCB)        ||
+            (bitfields.h != 0x1ABCD))
+        {
+            std::cout << "decodeBitfieldsPacketStructure() yielded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "decodeBitfieldsPacketStructure() failed" << std::endl;
+        return 0;
+    }
+
+    // The reserved bits are ignored by the decode, and the unused bits at
+    // the end of each group do not leak into the fields
+    pkt.data[4] |= 0x06;
+    pkt.data[2] |= 0x01;
+    pkt.data[5] |= 0x0F;
+    pkt.data[11] |= 0x07;
+
+    memset(&bitfields, 0, sizeof(bitfields));
+    if(decodeBitfieldsPacketStructure(&pkt, &bitfields))
+    {
+        if( (bitfields.d != 0xABC)  ||
+            (bitfields.e != 0x1B)   ||
+            (bitfields.f != 0x0A)   ||
+            (bitfields.h != 0x1ABCD))
+        {
+            std::cout << "decodeBitfieldsPacketStructure() did not ignore the unused bits" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "decodeBitfieldsPacketStructure() failed" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testBitfieldsPacket
+
+
+/*!
+ * Test variable length integers, signed and unsigned, scalar and array, with
+ * small values and with the extremes of each type. Every truncation of the
+ * packet must be rejected, since the length of each number is only known by
+ * scanning its bytes.
+ */
+int testVarintPacket(void)
+{
+    testPacket_t pkt;
+    Varint_t varint, decoded;
+
+    // expected encoding of the small values
+    const uint8_t expected[22] = {0x05,                                 // small = 5
+                                  0xAC, 0x02,                           // large = 300
+                                  0x03,                                 // delta = -2
+                                  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,   // wide = -2^40
+                                  0x03,                                 // numSamples
+                                  0x00, 0x7F, 0x80, 0x01,               // samples = 0, -64, 64
+                                  0x00, 0x7F, 0x80, 0x01, 0xFF, 0xFF, 0x03};// counts = 0, 127, 128, 65535
+
+    // Scenario 0 uses small values, scenario 1 uses the largest encodings
+    for(int scenario = 0; scenario < 2; scenario++)
+    {
+        int length;
+
+        memset(&varint, 0, sizeof(varint));
+        if(scenario == 0)
+        {
+            varint.small = 5;
+            varint.large = 300;
+            varint.delta = -2;
+            varint.wide = -(1LL << 40);
+            varint.numSamples = 3;
+            varint.samples[0] = 0;
+            varint.samples[1] = -64;
+            varint.samples[2] = 64;
+            varint.counts[0] = 0;
+            varint.counts[1] = 127;
+            varint.counts[2] = 128;
+            varint.counts[3] = 65535;
+            length = 22;
+        }
+        else
+        {
+            varint.small = 65535;
+            varint.large = 0xFFFFFFFF;
+            varint.delta = -2147483647 - 1;
+            varint.wide = -9223372036854775807LL - 1;
+            varint.numSamples = 8;
+            for(int i = 0; i < 8; i++)
+                varint.samples[i] = (i & 1) ? 2147483647 : (-2147483647 - 1);
+            for(int i = 0; i < 4; i++)
+                varint.counts[i] = 65535;
+            length = 3 + 5 + 5 + 10 + 1 + 8*5 + 4*3;
+        }
+
+        encodeVarintPacketStructure(&pkt, &varint);
+
+        if(pkt.length != length)
+        {
+            std::cout << "Varint packet has the wrong length" << std::endl;
+            return 0;
+        }
+
+        if(pkt.pkttype != 27)
+        {
+            std::cout << "Varint packet has the wrong type" << std::endl;
+            return 0;
+        }
+
+        if((scenario == 0) && (memcmp(pkt.data, expected, sizeof(expected)) != 0))
+        {
+            std::cout << "Varint packet encoded incorrect data" << std::endl;
+            return 0;
+        }
+
+        memset(&decoded, 0, sizeof(decoded));
+        if(decodeVarintPacketStructure(&pkt, &decoded))
+        {
+            if( (decoded.small != varint.small) ||
+                (decoded.large != varint.large) ||
+                (decoded.delta != varint.delta) ||
+                (decoded.wide != varint.wide)   ||
+                (decoded.numSamples != varint.numSamples) ||
+                (memcmp(decoded.samples, varint.samples, sizeof(varint.samples)) != 0) ||
+                (memcmp(decoded.counts, varint.counts, sizeof(varint.counts)) != 0))
+            {
+                std::cout << "decodeVarintPacketStructure() yielded incorrect data" << std::endl;
+                return 0;
+            }
+        }
+        else
+        {
+            std::cout << "decodeVarintPacketStructure() failed" << std::endl;
+            return 0;
+        }
+
+        // Truncating the packet anywhere must cut a number short
+        for(int i = 0; i < length; i++)
+        {
+            pkt.length = i;
+            if(decodeVarintPacketStructure(&pkt, &decoded))
+            {
+                std::cout << "Varint packet truncated to " << i << " bytes was not rejected" << std::endl;
+                return 0;
+            }
+        }
+
+    }// for both scenarios
+
+    return 1;
+
+}// testVarintPacket
+
+
+//! Handler for the Position packet of the stream parser test
+static void handlePosition(const void* pkt, void* context)
+{
+    streamTest_t* test = (streamTest_t*)context;
+
+    if(decodePositionPacketStructure(pkt, &test->position))
+        test->positions++;
+}
+
+
+//! Handler for the delta encoded Position packet of the stream parser test
+static void handlePositionDelta(const void* pkt, void* context)
+{
+    streamTest_t* test = (streamTest_t*)context;
+
+    if(decodePositionPacketDelta(pkt, &test->position))
+        test->deltas++;
+}
+
+
+//! Handler for the Status packet of the stream parser test
+static void handleStatus(const void* pkt, void* context)
+{
+    streamTest_t* test = (streamTest_t*)context;
+
+    if(decodeStatusPacketStructure(pkt, &test->status))
+        test->statuses++;
+}
+
+
+/*!
+ * Test the stream parser of the framing module. A stream of frames, garbage,
+ * and frames with a bad check is fed to the parser split at every byte, and
+ * one byte at a time, and every split must find the same frames.
+ */
+int testStreamParser(void)
+{
+    FramelinkPacket_t pkt;
+    FramelinkStreamParser_t parser;
+    Position_t position, reference;
+    Status_t status;
+    streamTest_t test;
+    uint8_t stream[256];
+    int size = 0;
+    int framebytes = 0;
+    int framesize;
+
+    // Garbage, including a first sync byte which is not followed by the second
+    const uint8_t garbage1[] = {0x00, 0x13, 0xA5, 0x00, 0x5A, 0xFF};
+
+    // A first sync byte immediately before the next frame
+    const uint8_t garbage2[] = {0x5A, 0xA5};
+
+    // Garbage at the end of the stream
+    const uint8_t garbage3[] = {0x01, 0x02, 0x03};
+
+    if((setFramelinkPacketHandler(getPositionPacketID(), handlePosition) == 0) ||
+       (setFramelinkPacketHandler(getPositionPacketDeltaID(), handlePositionDelta) == 0) ||
+       (setFramelinkPacketHandler(getStatusPacketID(), handleStatus) == 0))
+    {
+        std::cout << "setFramelinkPacketHandler() failed" << std::endl;
+        return 0;
+    }
+
+    memcpy(stream + size, garbage1, sizeof(garbage1));
+    size += sizeof(garbage1);
+
+    memset(&reference, 0, sizeof(reference));
+    reference.x = 1000;
+    reference.y = -2000;
+    reference.z = 300000;
+    reference.time = 123456;
+    encodePositionPacketStructure(&pkt, &reference);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    if(framesize != (8 + 16 + 2))
+    {
+        std::cout << "Position frame has the wrong size" << std::endl;
+        return 0;
+    }
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+    framebytes += framesize;
+
+    memcpy(stream + size, garbage2, sizeof(garbage2));
+    size += sizeof(garbage2);
+
+    memset(&status, 0, sizeof(status));
+    status.numErrors = 3;
+    status.errors[0] = 1;
+    status.errors[1] = 0x0203;
+    status.errors[2] = 0xFFFF;
+    encodeStatusPacketStructure(&pkt, &status);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+    framebytes += framesize;
+
+    // A frame whose check is wrong
+    position = reference;
+    position.time++;
+    encodePositionPacketStructure(&pkt, &position);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    pkt.frame[framesize - 1] ^= 0x01;
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+
+    // A frame whose data were corrupted
+    encodeStatusPacketStructure(&pkt, &status);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    pkt.frame[9] ^= 0x80;
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+
+    // Only y changed since the reference, so the delta is the mask and y
+    position = reference;
+    position.y = 4000;
+    encodePositionPacketDelta(&pkt, &position, &reference, 0);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    if(framesize != (8 + 1 + 4 + 2))
+    {
+        std::cout << "Position delta frame has the wrong size" << std::endl;
+        return 0;
+    }
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+    framebytes += framesize;
+
+    // The last frame has fewer errors, so it is shorter than the first
+    status.numErrors = 1;
+    encodeStatusPacketStructure(&pkt, &status);
+    framesize = getFramelinkPacketFrameSize(&pkt);
+    memcpy(stream + size, pkt.frame, framesize);
+    size += framesize;
+    framebytes += framesize;
+
+    memcpy(stream + size, garbage3, sizeof(garbage3));
+    size += sizeof(garbage3);
+
+    // Every byte which is not part of a valid frame is discarded exactly once
+    for(int split = 0; split <= size; split++)
+    {
+        memset(&test, 0, sizeof(test));
+        initFramelinkStreamParser(&parser, &test);
+        feedFramelinkStreamParser(&parser, stream, split);
+        feedFramelinkStreamParser(&parser, stream + split, size - split);
+
+        if(verifyStreamParser(parser, test, size - framebytes) == 0)
+        {
+            std::cout << "Stream parser failed with the stream split at byte " << split << std::endl;
+            return 0;
+        }
+    }
+
+    memset(&test, 0, sizeof(test));
+    initFramelinkStreamParser(&parser, &test);
+    for(int i = 0; i < size; i++)
+        feedFramelinkStreamParser(&parser, stream + i, 1);
+
+    if(verifyStreamParser(parser, test, size - framebytes) == 0)
+    {
+        std::cout << "Stream parser failed with the stream fed one byte at a time" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testStreamParser
+
+
+/*!
+ * Verify the state of the stream parser, and what its handlers received,
+ * after it was fed the stream of testStreamParser().
+ */
+int verifyStreamParser(const FramelinkStreamParser_t& parser, const streamTest_t& test, int discarded)
+{
+    if(parser.frames != 4) return 0;
+    if(parser.discarded != (uint32_t)discarded) return 0;
+
+    // Nothing is left over, because the garbage at the end has no sync byte
+    if(parser.received != 0) return 0;
+
+    if(test.positions != 1) return 0;
+    if(test.deltas != 1) return 0;
+    if(test.statuses != 2) return 0;
+
+    // The delta changed y of the first position, the corrupted position was ignored
+    if(test.position.x != 1000) return 0;
+    if(test.position.y != 4000) return 0;
+    if(test.position.z != 300000) return 0;
+    if(test.position.time != 123456) return 0;
+
+    if(test.status.numErrors != 1) return 0;
+    if(test.status.errors[0] != 1) return 0;
+
+    return 1;
+
+}// verifyStreamParser
+
 int fcompare(double input1, double input2, double epsilon)
 {
     if(fabs(input1 - input2) > epsilon)
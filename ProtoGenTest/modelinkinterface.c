@@ -0,0 +1,38 @@
+#include "ModelinkProtocol.h"
+#include "packetinterface.h"
+
+/*!
+ * The packet functions of the Modelink protocol, which uses the same simple
+ * packet layout as the Demolink protocol in packetinterface.c
+ */
+
+//! \return the packet data pointer from the packet
+uint8_t* getModelinkPacketData(void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! \return the packet data pointer from the packet
+const uint8_t* getModelinkPacketDataConst(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->data;
+}
+
+//! Complete a packet after the data have been encoded
+void finishModelinkPacket(void* pkt, int size, uint32_t packetID)
+{
+    ((testPacket_t*)pkt)->pkttype = (uint8_t)packetID;
+    ((testPacket_t*)pkt)->length = (uint8_t)size;
+}
+
+//! \return the size of a packet from the packet header
+int getModelinkPacketSize(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->length;
+}
+
+//! \return the ID of a packet from the packet header
+uint32_t getModelinkPacketID(const void* pkt)
+{
+    return ((testPacket_t*)pkt)->pkttype;
+}
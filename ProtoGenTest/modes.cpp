@@ -0,0 +1,893 @@
+#include <iostream>
+#include <string.h>
+#include <math.h>
+// The types header comes first, to check that it has everything it needs
+#include "ModelinkPacketsTypes.h"
+#include "ModelinkPackets.h"
+#include "ModelinkBatch.h"
+#include "ModelinkTrace.h"
+#include "packetinterface.h"
+
+static int testInlinePacket(void);
+static int testArraysPacket(void);
+static int testFoldedPacket(void);
+static int testAccessorPacket(void);
+static void fillOutAccessorTest(Accessor_t& accessor);
+static int testBufferedPacket(void);
+static int testNativePacket(void);
+static int testPackedPacket(void);
+static int testAccessorBatch(void);
+static int testTracedPacket(void);
+static int testMinimalPacket(void);
+static int testOffsetsPacket(void);
+
+static int fcompare(double input1, double input2, double epsilon);
+
+
+int main(int argc, char *argv[])
+{
+    if(testInlinePacket() == 0)
+        return 0;
+
+    if(testArraysPacket() == 0)
+        return 0;
+
+    if(testOffsetsPacket() == 0)
+        return 0;
+
+    if(testFoldedPacket() == 0)
+        return 0;
+
+    if(testAccessorPacket() == 0)
+        return 0;
+
+    if(testBufferedPacket() == 0)
+        return 0;
+
+    if(testNativePacket() == 0)
+        return 0;
+
+    if(testPackedPacket() == 0)
+        return 0;
+
+    if(testAccessorBatch() == 0)
+        return 0;
+
+    if(testTracedPacket() == 0)
+        return 0;
+
+    if(testMinimalPacket() == 0)
+        return 0;
+
+    std::cout << "All tests passed" << std::endl;
+    return 1;
+}
+
+
+int testInlinePacket(void)
+{
+    testPacket_t pkt;
+    Inline_t user;
+
+    // expected encoding of each field, apart from the float16 level at the end
+    const uint8_t expected[14] = {0x34, 0x12,                 // count 0x1234
+                                  0x2C, 0xCF, 0xFF, 0xFF,     // position -12500
+                                  0x45, 0x01,                 // speed 325
+                                  0x7D,                       // depth 125
+                                  0xA0, 0x86, 0x01, 0x00,     // time 100000
+                                  0xFB};                      // trim -5
+
+    memset(&user, 0, sizeof(user));
+    user.count = 0x1234;
+    user.position = -12.5;
+    user.speed = 3.25f;
+    user.depth = 2.5f;
+    user.time = 100000;
+    user.trim = -5;
+    user.level = 1.5f;
+
+    encodeInlinePacketStructure(&pkt, &user);
+
+    if(pkt.length != 16)
+    {
+        std::cout << "Inline packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if(pkt.pkttype != 1)
+    {
+        std::cout << "Inline packet has the wrong type" << std::endl;
+        return 0;
+    }
+
+    if(memcmp(pkt.data, expected, sizeof(expected)) != 0)
+    {
+        std::cout << "Inline packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeInlinePacketStructure(&pkt, &user))
+    {
+        if( (user.count != 0x1234)                  ||
+            fcompare(user.position, -12.5, 0.001)   ||
+            fcompare(user.speed, 3.25, 0.01)        ||
+            fcompare(user.depth, 2.5, 0.1)          ||
+            (user.time != 100000)                   ||
+            (user.trim != -5)                       ||
+            (user.level != 1.5f))
+        {
+            std::cout << "Inline packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Inline packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testInlinePacket
+
+
+int testArraysPacket(void)
+{
+    testPacket_t pkt;
+    Arrays_t user;
+    int i;
+
+    // expected encoding of each field, apart from the float16 halves at the end
+    const uint8_t expected[29] = {0x01, 0x00, 0x02, 0x00, 0x00, 0x03, 0xFF, 0xFF,   // values
+                                  0x96, 0x00, 0x1F, 0xFF, 0x00, 0x00, 0x10, 0x27,   // samples 150, -225, 0, 10000
+                                  0x03,                                             // numReadings
+                                  0x07, 0x00, 0x00, 0x00,                           // readings 7, -1, 65536
+                                  0xFF, 0xFF, 0xFF, 0xFF,
+                                  0x00, 0x00, 0x01, 0x00};
+
+    memset(&user, 0, sizeof(user));
+    user.values[0] = 1;
+    user.values[1] = 2;
+    user.values[2] = 0x300;
+    user.values[3] = 0xFFFF;
+    user.samples[0] = 1.5f;
+    user.samples[1] = -2.25f;
+    user.samples[2] = 0.0f;
+    user.samples[3] = 100.0f;
+    user.numReadings = 3;
+    user.readings[0] = 7;
+    user.readings[1] = -1;
+    user.readings[2] = 65536;
+    user.readings[3] = 99;      // not encoded, as numReadings is 3
+    user.halves[0] = 0.5f;
+    user.halves[1] = -4.0f;
+    user.halves[2] = 1024.0f;
+
+    encodeArraysPacketStructure(&pkt, &user);
+
+    if(pkt.length != 29 + 6)
+    {
+        std::cout << "Arrays packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if(memcmp(pkt.data, expected, sizeof(expected)) != 0)
+    {
+        std::cout << "Arrays packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeArraysPacketStructure(&pkt, &user))
+    {
+        if( (user.values[0] != 1)                   ||
+            (user.values[1] != 2)                   ||
+            (user.values[2] != 0x300)               ||
+            (user.values[3] != 0xFFFF)              ||
+            fcompare(user.samples[0], 1.5, 0.01)    ||
+            fcompare(user.samples[1], -2.25, 0.01)  ||
+            fcompare(user.samples[2], 0.0, 0.01)    ||
+            fcompare(user.samples[3], 100.0, 0.01)  ||
+            (user.numReadings != 3)                 ||
+            (user.readings[0] != 7)                 ||
+            (user.readings[1] != -1)                ||
+            (user.readings[2] != 65536)             ||
+            (user.halves[0] != 0.5f)                ||
+            (user.halves[1] != -4.0f)               ||
+            (user.halves[2] != 1024.0f))
+        {
+            std::cout << "Arrays packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+
+        // The elements past numReadings are not decoded
+        for(i = 3; i < 5; i++)
+        {
+            if(user.readings[i] != 0)
+            {
+                std::cout << "Arrays packet decoded readings past the end" << std::endl;
+                return 0;
+            }
+        }
+    }
+    else
+    {
+        std::cout << "Arrays packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testArraysPacket
+
+
+int testOffsetsPacket(void)
+{
+    testPacket_t pkt;
+    Offsets_t user;
+
+    memset(&user, 0, sizeof(user));
+    user.numOffsets = -2;
+    user.offsets[0] = 1;
+    user.offsets[1] = 2;
+    user.offsets[2] = 3;
+    user.marker = 0x5A;
+
+    // A negative length codes no offsets at all
+    encodeOffsetsPacketStructure(&pkt, &user);
+
+    if((pkt.length != 2) || (pkt.data[0] != 0xFE) || (pkt.data[1] != 0x5A))
+    {
+        std::cout << "Offsets packet with a negative length encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeOffsetsPacketStructure(&pkt, &user))
+    {
+        if( (user.numOffsets != -2) ||
+            (user.offsets[0] != 0)  ||
+            (user.marker != 0x5A))
+        {
+            std::cout << "Offsets packet with a negative length decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Offsets packet with a negative length failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testOffsetsPacket
+
+
+int testFoldedPacket(void)
+{
+    testPacket_t pkt;
+    Folded_t user;
+
+    const uint8_t expected[9] = {0xDC, 0x05,                // roll 1500
+                                 0xDA, 0x68, 0x03, 0x00,    // altitude 223450
+                                 0xFF, 0xFF,                // pressure, saturated
+                                 0x80};                     // gain, saturated
+
+    memset(&user, 0, sizeof(user));
+    user.roll = 1.5f;
+    user.altitude = 1234.5;
+    user.pressure = 150.0f;     // more than the maximum of 100
+    user.gain = -20.0f;         // less than the minimum of -12.8
+
+    encodeFoldedPacketStructure(&pkt, &user);
+
+    if(pkt.length != 9)
+    {
+        std::cout << "Folded packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if(memcmp(pkt.data, expected, sizeof(expected)) != 0)
+    {
+        std::cout << "Folded packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeFoldedPacketStructure(&pkt, &user))
+    {
+        if( fcompare(user.roll, 1.5, 0.001)         ||
+            fcompare(user.altitude, 1234.5, 0.01)   ||
+            fcompare(user.pressure, 100.0, 0.01)    ||
+            fcompare(user.gain, -12.8, 0.01))
+        {
+            std::cout << "Folded packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Folded packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testFoldedPacket
+
+
+void fillOutAccessorTest(Accessor_t& accessor)
+{
+    memset(&accessor, 0, sizeof(accessor));
+    accessor.mode = 3;
+    accessor.count = 0x4321;
+    accessor.speed = 12.5f;
+    accessor.position = 6378137.25;
+    accessor.history[0] = 1;
+    accessor.history[1] = 2;
+    accessor.history[2] = 3;
+    accessor.history[3] = 4;
+    accessor.flags = 0x80000001;
+    accessor.trim = 250;
+}
+
+
+int testAccessorPacket(void)
+{
+    testPacket_t pkt;
+    Accessor_t accessor;
+    uint8_t mode = 0;
+    uint16_t count = 0;
+    float speed = 0;
+    double position = 0;
+    uint32_t flags = 0;
+    int16_t trim = 0;
+
+    fillOutAccessorTest(accessor);
+    encodeAccessorPacketStructure(&pkt, &accessor);
+
+    if(pkt.length != 1 + 2 + 2 + 8 + 4 + 4 + 2)
+    {
+        std::cout << "Accessor packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    // Every field is read in place, including the one after the array
+    if( (getAccessorPacket_mode(&pkt, &mode) == 0)          ||
+        (getAccessorPacket_count(&pkt, &count) == 0)        ||
+        (getAccessorPacket_speed(&pkt, &speed) == 0)        ||
+        (getAccessorPacket_position(&pkt, &position) == 0)  ||
+        (getAccessorPacket_flags(&pkt, &flags) == 0)        ||
+        (getAccessorPacket_trim(&pkt, &trim) == 0))
+    {
+        std::cout << "Accessor packet failed to get a field" << std::endl;
+        return 0;
+    }
+
+    if( (mode != 3)                             ||
+        (count != 0x4321)                       ||
+        fcompare(speed, 12.5, 0.01)             ||
+        (position != 6378137.25)                ||
+        (flags != 0x80000001)                   ||
+        (trim != 250))
+    {
+        std::cout << "Accessor packet got incorrect data" << std::endl;
+        return 0;
+    }
+
+    // Fields written in place leave the rest of the packet alone
+    if( (setAccessorPacket_speed(&pkt, -7.25f) == 0)        ||
+        (setAccessorPacket_flags(&pkt, 0x01020304) == 0))
+    {
+        std::cout << "Accessor packet failed to set a field" << std::endl;
+        return 0;
+    }
+
+    memset(&accessor, 0, sizeof(accessor));
+    if(decodeAccessorPacketStructure(&pkt, &accessor))
+    {
+        if( (accessor.mode != 3)                        ||
+            (accessor.count != 0x4321)                  ||
+            fcompare(accessor.speed, -7.25, 0.01)       ||
+            (accessor.position != 6378137.25)           ||
+            (accessor.history[0] != 1)                  ||
+            (accessor.history[3] != 4)                  ||
+            (accessor.flags != 0x01020304)              ||
+            (accessor.trim != 250))
+        {
+            std::cout << "Accessor packet decoded incorrect data after a set" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Accessor packet failed to decode after a set" << std::endl;
+        return 0;
+    }
+
+    // A packet that is too short for the default field at the end
+    pkt.length -= 2;
+    if((getAccessorPacket_trim(&pkt, &trim) != 0) || (setAccessorPacket_trim(&pkt, 1) != 0))
+    {
+        std::cout << "Accessor packet accessed a field beyond the end of the packet" << std::endl;
+        return 0;
+    }
+
+    if(getAccessorPacket_flags(&pkt, &flags) == 0)
+    {
+        std::cout << "Accessor packet failed to get a field of a short packet" << std::endl;
+        return 0;
+    }
+
+    // A packet of a different type
+    pkt.length += 2;
+    pkt.pkttype = 1;
+    if((getAccessorPacket_mode(&pkt, &mode) != 0) || (setAccessorPacket_mode(&pkt, 1) != 0))
+    {
+        std::cout << "Accessor packet accessed a packet of the wrong type" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testAccessorPacket
+
+
+int testBufferedPacket(void)
+{
+    Buffered_t user;
+    Inline_t other;
+    uint8_t buf[64];
+    const uint8_t* data;
+    uint32_t id;
+    int length, offset, size;
+
+    const uint8_t expected[8] = {0x02, 0x01,                // sequence 0x0102
+                                 0xDD, 0xFF,                // value -35
+                                 0x03, 0x09, 0x08, 0x07};   // numItems and items
+
+    // The header of the Buffered packet in a batch: identifier then length
+    const uint8_t batchHeader[6] = {0x05, 0x00, 0x00, 0x00, 0x08, 0x00};
+
+    memset(&user, 0, sizeof(user));
+    user.sequence = 0x0102;
+    user.value = -3.5f;
+    user.numItems = 3;
+    user.items[0] = 9;
+    user.items[1] = 8;
+    user.items[2] = 7;
+
+    memset(buf, 0, sizeof(buf));
+    length = encodeBufferedPacketStructureToBuffer(buf, sizeof(buf), 3, &user);
+
+    if((length != 8) || (memcmp(buf + 3, expected, sizeof(expected)) != 0))
+    {
+        std::cout << "Buffered packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    // The capacity must be enough for the largest packet, not just this one
+    if(encodeBufferedPacketStructureToBuffer(buf, 3 + 8, 3, &user) != -1)
+    {
+        std::cout << "Buffered packet encoded into a buffer that could be too small" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeBufferedPacketStructureFromBuffer(buf + 3, length, &user))
+    {
+        if( (user.sequence != 0x0102)           ||
+            fcompare(user.value, -3.5, 0.01)    ||
+            (user.numItems != 3)                ||
+            (user.items[0] != 9)                ||
+            (user.items[1] != 8)                ||
+            (user.items[2] != 7))
+        {
+            std::cout << "Buffered packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Buffered packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    if(decodeBufferedPacketStructureFromBuffer(buf + 3, 4, &user))
+    {
+        std::cout << "Buffered packet decoded from a buffer that was too short" << std::endl;
+        return 0;
+    }
+
+    // A batch of two different packets
+    memset(&other, 0, sizeof(other));
+    other.count = 77;
+    other.time = 123456;
+
+    memset(buf, 0, sizeof(buf));
+    offset = appendBufferedPacketStructureToBatch(buf, sizeof(buf), 0, &user);
+    if((offset != 6 + 8) || (memcmp(buf, batchHeader, sizeof(batchHeader)) != 0))
+    {
+        std::cout << "Buffered packet appended incorrect data to a batch" << std::endl;
+        return 0;
+    }
+
+    size = appendInlinePacketStructureToBatch(buf, sizeof(buf), offset, &other);
+    if(size != offset + 6 + 16)
+    {
+        std::cout << "Inline packet appended incorrect data to a batch" << std::endl;
+        return 0;
+    }
+
+    offset = 0;
+    memset(&user, 0, sizeof(user));
+    memset(&other, 0, sizeof(other));
+
+    if( (nextModelinkBatchPacket(buf, size, &offset, &id, &data, &length) == 0) ||
+        (id != getBufferedPacketID()) ||
+        (length != 8) ||
+        (decodeBufferedPacketStructureFromBuffer(data, length, &user) == 0) ||
+        (user.sequence != 0x0102))
+    {
+        std::cout << "Buffered packet was not the first packet of the batch" << std::endl;
+        return 0;
+    }
+
+    if( (nextModelinkBatchPacket(buf, size, &offset, &id, &data, &length) == 0) ||
+        (id != getInlinePacketID()) ||
+        (length != 16) ||
+        (decodeInlinePacketStructureFromBuffer(data, length, &other) == 0) ||
+        (other.count != 77) ||
+        (other.time != 123456))
+    {
+        std::cout << "Inline packet was not the second packet of the batch" << std::endl;
+        return 0;
+    }
+
+    if(nextModelinkBatchPacket(buf, size, &offset, &id, &data, &length) != 0)
+    {
+        std::cout << "Batch had more packets than were appended" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testBufferedPacket
+
+
+int testNativePacket(void)
+{
+    testPacket_t pkt;
+    Native_t user;
+
+    const uint8_t expected[29] = {0x04, 0x03, 0x02, 0x01,                           // stamp
+                                  0xEF, 0xBE,                                       // flags
+                                  0x07,                                             // mode
+                                  0x80,                                             // spare
+                                  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F,   // x 1.0
+                                  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0,   // y -2.0
+                                  0x19, 0x00,                                       // scaled 25
+                                  0x09, 0x08, 0x07};                                // bytes
+
+    memset(&user, 0, sizeof(user));
+    user.stamp = 0x01020304;
+    user.flags = 0xBEEF;
+    user.mode = 7;
+    user.spare = 0x80;
+    user.x = 1.0;
+    user.y = -2.0;
+    user.scaled = 2.5f;
+    user.bytes[0] = 9;
+    user.bytes[1] = 8;
+    user.bytes[2] = 7;
+
+    encodeNativePacketStructure(&pkt, &user);
+
+    if(pkt.length != 29)
+    {
+        std::cout << "Native packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if(memcmp(pkt.data, expected, sizeof(expected)) != 0)
+    {
+        std::cout << "Native packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeNativePacketStructure(&pkt, &user))
+    {
+        if( (user.stamp != 0x01020304)          ||
+            (user.flags != 0xBEEF)              ||
+            (user.mode != 7)                    ||
+            (user.spare != 0x80)                ||
+            (user.x != 1.0)                     ||
+            (user.y != -2.0)                    ||
+            fcompare(user.scaled, 2.5, 0.1)     ||
+            (user.bytes[0] != 9)                ||
+            (user.bytes[1] != 8)                ||
+            (user.bytes[2] != 7))
+        {
+            std::cout << "Native packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Native packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    // Doubles that are not valid decode as zero, so they are not copied
+    user.x = NAN;
+    user.y = INFINITY;
+    encodeNativePacketStructure(&pkt, &user);
+
+    if((decodeNativePacketStructure(&pkt, &user) == 0) || (user.x != 0.0) || (user.y != 0.0) || (user.stamp != 0x01020304))
+    {
+        std::cout << "Native packet decoded an invalid double" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testNativePacket
+
+
+int testPackedPacket(void)
+{
+    testPacket_t pkt, unpackedPkt;
+    Packed_t user;
+    Unpacked_t unpacked;
+
+    const uint8_t expected[16] = {0x01,                                             // a
+                                  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0x3F,   // b 0.5
+                                  0x34, 0x12,                                       // c
+                                  0xEF, 0xBE, 0xAD, 0xDE,                           // d
+                                  0xFF};                                            // e
+
+    if(sizeof(Packed_t) >= sizeof(Unpacked_t))
+    {
+        std::cout << "Packed structure is not smaller than the same structure unpacked" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    user.a = 1;
+    user.b = 0.5;
+    user.c = 0x1234;
+    user.d = 0xDEADBEEF;
+    user.e = 0xFF;
+
+    memset(&unpacked, 0, sizeof(unpacked));
+    unpacked.a = 1;
+    unpacked.b = 0.5;
+    unpacked.c = 0x1234;
+    unpacked.d = 0xDEADBEEF;
+    unpacked.e = 0xFF;
+
+    encodePackedPacketStructure(&pkt, &user);
+    encodeUnpackedPacketStructure(&unpackedPkt, &unpacked);
+
+    // The order of the members does not change the encoding
+    if( (pkt.length != 16) ||
+        (unpackedPkt.length != 16) ||
+        (memcmp(pkt.data, expected, sizeof(expected)) != 0) ||
+        (memcmp(unpackedPkt.data, expected, sizeof(expected)) != 0))
+    {
+        std::cout << "Packed packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodePackedPacketStructure(&pkt, &user))
+    {
+        if( (user.a != 1)                   ||
+            (user.b != 0.5)                 ||
+            (user.c != 0x1234)              ||
+            (user.d != 0xDEADBEEF)          ||
+            (user.e != 0xFF))
+        {
+            std::cout << "Packed packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Packed packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testPackedPacket
+
+
+int testAccessorBatch(void)
+{
+    testPacket_t pkts[4];
+    const void* pointers[4];
+    Accessor_t accessor;
+    uint8_t mode[4];
+    uint16_t count[4];
+    float speed[4];
+    double position[4];
+    uint32_t flags[4];
+    int16_t trim[4];
+    Accessor_soa_t out;
+    int i;
+
+    for(i = 0; i < 4; i++)
+    {
+        fillOutAccessorTest(accessor);
+        accessor.mode = (uint8_t)i;
+        accessor.count = (uint16_t)(1000*i);
+        accessor.speed = 0.5f*i;
+        accessor.position = -100.25*i;
+        accessor.flags = 0x10000000u*i;
+        accessor.trim = (int16_t)(-i);
+        encodeAccessorPacketStructure(&pkts[i], &accessor);
+        pointers[i] = &pkts[i];
+    }
+
+    memset(&out, 0, sizeof(out));
+    out.mode = mode;
+    out.count = count;
+    out.speed = speed;
+    out.position = position;
+    out.flags = NULL;   // this field is not decoded
+    out.trim = trim;
+
+    memset(flags, 0, sizeof(flags));
+    if(decodeAccessorPacketBatch(pointers, 4, &out) != 4)
+    {
+        std::cout << "Accessor batch failed to decode" << std::endl;
+        return 0;
+    }
+
+    for(i = 0; i < 4; i++)
+    {
+        if( (mode[i] != i)                          ||
+            (count[i] != 1000*i)                    ||
+            fcompare(speed[i], 0.5*i, 0.01)         ||
+            (position[i] != -100.25*i)              ||
+            (trim[i] != -i))
+        {
+            std::cout << "Accessor batch decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+
+    // Packets from a bad one on are not decoded
+    out.flags = flags;
+    pkts[2].pkttype = 1;
+    if(decodeAccessorPacketBatch(pointers, 4, &out) != 2)
+    {
+        std::cout << "Accessor batch decoded a packet of the wrong type" << std::endl;
+        return 0;
+    }
+
+    if((flags[1] != 0x10000000u) || (flags[2] != 0))
+    {
+        std::cout << "Accessor batch decoded incorrect flags" << std::endl;
+        return 0;
+    }
+
+    // A packet that is too short for the default field gets the default
+    pkts[2].pkttype = (uint8_t)getAccessorPacketID();
+    pkts[1].length -= 2;
+    if((decodeAccessorPacketBatch(pointers, 4, &out) != 4) || (trim[0] != 0) || (trim[1] != -7) || (trim[2] != -2))
+    {
+        std::cout << "Accessor batch did not apply the default to a short packet" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testAccessorBatch
+
+
+int testTracedPacket(void)
+{
+    testPacket_t pkt;
+    Traced_t user;
+    const ModelinkTraceCounters_t* counters = getModelinkTraceCounters(getTracedPacketID());
+
+    clearModelinkTraceCounters();
+
+    memset(&user, 0, sizeof(user));
+    user.numValues = 2;
+    user.values[0] = 0x1111;
+    user.values[1] = 0x2222;
+
+    encodeTracedPacketStructure(&pkt, &user);
+
+    if((pkt.length != 5) || (counters->encodes != 1) || (counters->encodedBytes != 5))
+    {
+        std::cout << "Traced packet encode was not counted" << std::endl;
+        return 0;
+    }
+
+    if((decodeTracedPacketStructure(&pkt, &user) == 0) || (counters->decodes != 1) || (counters->decodedBytes != 5))
+    {
+        std::cout << "Traced packet decode was not counted" << std::endl;
+        return 0;
+    }
+
+    pkt.pkttype = 1;
+    if((decodeTracedPacketStructure(&pkt, &user) != 0) || (counters->rejectedId != 1) || (counters->decodes != 1))
+    {
+        std::cout << "Traced packet with the wrong type was not counted" << std::endl;
+        return 0;
+    }
+
+    pkt.pkttype = (uint8_t)getTracedPacketID();
+    pkt.length = 0;
+    if((decodeTracedPacketStructure(&pkt, &user) != 0) || (counters->rejectedLength != 1) || (counters->decodes != 1))
+    {
+        std::cout << "Traced packet that was too short was not counted" << std::endl;
+        return 0;
+    }
+
+    // Other packets have their own counters
+    if(getModelinkTraceCounters(getInlinePacketID())->encodes != 0)
+    {
+        std::cout << "Trace counters were not cleared" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testTracedPacket
+
+
+int testMinimalPacket(void)
+{
+    testPacket_t pkt;
+    Minimal_t user;
+
+    const uint8_t expected[8] = {0x56, 0x34, 0x12,                  // counter in 24 bits
+                                 0xFE, 0xFF, 0xFF, 0xFF, 0xFF};     // offset -2 in 40 bits
+
+    memset(&user, 0, sizeof(user));
+    user.counter = 0x123456;
+    user.offset = -2;
+
+    encodeMinimalPacketStructure(&pkt, &user);
+
+    if((pkt.length != 8) || (memcmp(pkt.data, expected, sizeof(expected)) != 0))
+    {
+        std::cout << "Minimal packet encoded incorrect data" << std::endl;
+        return 0;
+    }
+
+    memset(&user, 0, sizeof(user));
+    if(decodeMinimalPacketStructure(&pkt, &user))
+    {
+        if((user.counter != 0x123456) || (user.offset != -2))
+        {
+            std::cout << "Minimal packet decoded incorrect data" << std::endl;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "Minimal packet failed to decode" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testMinimalPacket
+
+
+int fcompare(double input1, double input2, double epsilon)
+{
+    if(fabs(input1 - input2) > epsilon)
+        return 1;
+    else
+        return 0;
+}
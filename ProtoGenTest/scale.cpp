@@ -0,0 +1,431 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QXmlStreamWriter>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTemporaryDir>
+#include <QProcess>
+#include <QFile>
+#include <QDir>
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+
+#ifdef Q_OS_UNIX
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+//! The shape of a synthetic protocol
+typedef struct
+{
+    int packets;        //!< Number of packets
+    int fields;         //!< Number of fields in each packet
+    int enums;          //!< Number of global enumerations
+    int fanIn;          //!< Number of packets that share each output file
+    int depth;          //!< Depth of the nested structure that each packet includes
+
+}SyntheticShape;
+
+//! The result of one run of ProtoGen
+typedef struct
+{
+    int packets;        //!< Number of packets in the protocol
+    bool ok;            //!< False if ProtoGen could not be run or failed
+    double wallMs;      //!< Wall time of the run in milliseconds
+    double peakRssMB;   //!< Peak resident set size of ProtoGen in megabytes, -1 if not known
+    QJsonObject stats;  //!< The statistics that ProtoGen reported
+
+}ScaleResult;
+
+static bool writeProtocol(const QString& fileName, const SyntheticShape& shape);
+static void writeField(QXmlStreamWriter& xml, int packet, int field, const SyntheticShape& shape);
+static ScaleResult runProtoGen(const QString& protogen, const QString& fileName, const QString& outputPath, int packets);
+static QList<int> toList(const QString& text);
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList arguments = a.arguments();
+    QString protogen("ProtoGen");
+    QString jsonFile;
+    QList<int> sizes;
+    SyntheticShape shape;
+
+    sizes << 1000 << 10000 << 50000;
+    shape.fields = 8;
+    shape.enums = 20;
+    shape.fanIn = 10;
+    shape.depth = 4;
+
+    for(int i = 1; i < arguments.size(); i++)
+    {
+        QString arg = arguments.at(i);
+        bool more = (i + 1 < arguments.size());
+
+        if((arg == "-protogen") && more)
+            protogen = arguments.at(++i);
+        else if((arg == "-packets") && more)
+            sizes = toList(arguments.at(++i));
+        else if((arg == "-fields") && more)
+            shape.fields = arguments.at(++i).toInt();
+        else if((arg == "-enums") && more)
+            shape.enums = arguments.at(++i).toInt();
+        else if((arg == "-fanin") && more)
+            shape.fanIn = arguments.at(++i).toInt();
+        else if((arg == "-depth") && more)
+            shape.depth = arguments.at(++i).toInt();
+        else if((arg == "-json") && more)
+            jsonFile = arguments.at(++i);
+        else
+        {
+            std::cout << "ProtoGenScale usage:" << std::endl;
+            std::cout << "ProtoGenScale [-protogen path] [-packets 1000,10000,50000] [-fields M] [-enums K] [-fanin F] [-depth D] [-json results.json]" << std::endl;
+            return 0;
+        }
+    }
+
+    // At least one of everything keeps the protocol meaningful
+    shape.fields = qMax(shape.fields, 1);
+    shape.enums = qMax(shape.enums, 1);
+    shape.fanIn = qMax(shape.fanIn, 1);
+    shape.depth = qMax(shape.depth, 1);
+
+    int Return = 1;
+    QJsonArray array;
+
+    std::cout << std::right << std::setw(10) << "packets" << std::setw(14) << "wall ms" << std::setw(14) << "parse ms"
+              << std::setw(14) << "generate ms" << std::setw(14) << "peak RSS MB" << std::endl;
+
+    for(int i = 0; i < sizes.size(); i++)
+    {
+        QTemporaryDir dir;
+        if(!dir.isValid())
+        {
+            std::cout << "failed to create a temporary directory" << std::endl;
+            return 0;
+        }
+
+        shape.packets = sizes.at(i);
+
+        QString fileName = dir.path() + "/Synthetic.xml";
+        QString outputPath = dir.path() + "/output/";
+        QDir().mkpath(outputPath);
+
+        if(!writeProtocol(fileName, shape))
+        {
+            std::cout << "failed to write the synthetic protocol: " << fileName.toStdString() << std::endl;
+            return 0;
+        }
+
+        ScaleResult result = runProtoGen(protogen, fileName, outputPath, shape.packets);
+
+        if(!result.ok)
+        {
+            std::cout << "ProtoGen failed for " << shape.packets << " packets" << std::endl;
+            Return = 0;
+            continue;
+        }
+
+        QJsonObject phases = result.stats.value("phases").toObject();
+
+        std::cout << std::setw(10) << result.packets << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.wallMs << std::setw(14) << phases.value("parse").toDouble()
+                  << std::setw(14) << phases.value("generate").toDouble() << std::setw(14) << result.peakRssMB << std::endl;
+
+        QJsonObject object;
+        object.insert("packets", result.packets);
+        object.insert("fields", shape.fields);
+        object.insert("enums", shape.enums);
+        object.insert("fanIn", shape.fanIn);
+        object.insert("depth", shape.depth);
+        object.insert("wallMs", result.wallMs);
+        object.insert("peakRssMB", result.peakRssMB);
+        object.insert("stats", result.stats);
+        array.append(object);
+    }
+
+    if(!jsonFile.isEmpty())
+    {
+        QFile file(jsonFile);
+        if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+            file.write(QJsonDocument(array).toJson());
+        else
+        {
+            std::cout << "failed to open results file: " << jsonFile.toStdString() << std::endl;
+            Return = 0;
+        }
+    }
+
+    return Return;
+}
+
+
+/*!
+ * Write a synthetic protocol. It has a large enumeration of packet
+ * identifiers, global enumerations that the fields use for their types and
+ * array lengths, a chain of nested structures that every packet includes,
+ * and packets that are grouped into shared output files.
+ * \param fileName is the protocol xml file to write
+ * \param shape gives the size of the protocol
+ * \return true if the file was written
+ */
+bool writeProtocol(const QString& fileName, const SyntheticShape& shape)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QXmlStreamWriter xml(&file);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+
+    xml.writeStartElement("Protocol");
+    xml.writeAttribute("name", "Synthetic");
+    xml.writeAttribute("api", "1");
+    xml.writeAttribute("version", "1.0");
+    xml.writeAttribute("comment", "A synthetic protocol for measuring how ProtoGen scales");
+
+    xml.writeStartElement("Enum");
+    xml.writeAttribute("name", "packetIds");
+    xml.writeAttribute("comment", "The identifiers of the packets");
+    for(int i = 0; i < shape.packets; i++)
+    {
+        xml.writeStartElement("Value");
+        xml.writeAttribute("name", "PKT_" + QString::number(i));
+        xml.writeEndElement();
+    }
+    xml.writeEndElement();
+
+    for(int k = 0; k < shape.enums; k++)
+    {
+        xml.writeStartElement("Enum");
+        xml.writeAttribute("name", "enum" + QString::number(k));
+        xml.writeAttribute("comment", "A global enumeration");
+        for(int v = 0; v < 8; v++)
+        {
+            xml.writeStartElement("Value");
+            xml.writeAttribute("name", "E" + QString::number(k) + "_V" + QString::number(v));
+            if(v == 0)
+                xml.writeAttribute("value", "1");
+            xml.writeEndElement();
+        }
+        xml.writeEndElement();
+    }
+
+    // Each level of the chain includes the level below it
+    for(int d = 0; d < shape.depth; d++)
+    {
+        xml.writeStartElement("Structure");
+        xml.writeAttribute("name", "Nest" + QString::number(d));
+        xml.writeAttribute("file", "SyntheticNest");
+        xml.writeAttribute("comment", "Level " + QString::number(d) + " of the nested structures");
+
+        xml.writeStartElement("Data");
+        xml.writeAttribute("name", "level");
+        xml.writeAttribute("inMemoryType", "unsigned16");
+        xml.writeEndElement();
+
+        if(d > 0)
+        {
+            xml.writeStartElement("Data");
+            xml.writeAttribute("name", "inner");
+            xml.writeAttribute("struct", "Nest" + QString::number(d - 1));
+            xml.writeAttribute("array", "2");
+            xml.writeEndElement();
+        }
+
+        xml.writeEndElement();
+    }
+
+    for(int i = 0; i < shape.packets; i++)
+    {
+        xml.writeStartElement("Packet");
+        xml.writeAttribute("name", "Packet" + QString::number(i));
+        xml.writeAttribute("ID", "PKT_" + QString::number(i));
+        xml.writeAttribute("file", "Shared" + QString::number(i / shape.fanIn));
+        xml.writeAttribute("structureInterface", "true");
+        xml.writeAttribute("comment", "Synthetic packet " + QString::number(i));
+
+        for(int j = 0; j < shape.fields; j++)
+            writeField(xml, i, j, shape);
+
+        xml.writeStartElement("Data");
+        xml.writeAttribute("name", "nest");
+        xml.writeAttribute("struct", "Nest" + QString::number(shape.depth - 1));
+        xml.writeEndElement();
+
+        xml.writeEndElement();
+    }
+
+    xml.writeEndElement();
+    xml.writeEndDocument();
+
+    return !xml.hasError();
+
+}// writeProtocol
+
+
+/*!
+ * Write one field of a synthetic packet. The fields cycle through plain,
+ * scaled, bitfield, enumeration, and array encodings, so the generator does
+ * all of its usual work.
+ * \param xml is the writer of the protocol
+ * \param packet is the index of the packet
+ * \param field is the index of the field in the packet
+ * \param shape gives the size of the protocol
+ */
+void writeField(QXmlStreamWriter& xml, int packet, int field, const SyntheticShape& shape)
+{
+    QString enumName = QString::number((packet + field) % shape.enums);
+
+    xml.writeStartElement("Data");
+    xml.writeAttribute("name", "field" + QString::number(field));
+
+    switch(field % 6)
+    {
+    default:
+    case 0:
+        xml.writeAttribute("inMemoryType", "unsigned16");
+        break;
+
+    case 1:
+        xml.writeAttribute("inMemoryType", "float32");
+        xml.writeAttribute("encodedType", "signed16");
+        xml.writeAttribute("max", "100");
+        break;
+
+    case 2:
+    case 3:
+        xml.writeAttribute("inMemoryType", "bitfield4");
+        break;
+
+    case 4:
+        xml.writeAttribute("enum", "enum" + enumName);
+        xml.writeAttribute("encodedType", "unsigned8");
+        break;
+
+    case 5:
+        // The array length is an enumeration, which ProtoGen resolves
+        xml.writeAttribute("inMemoryType", "unsigned8");
+        xml.writeAttribute("array", "E" + enumName + "_V3");
+        break;
+    }
+
+    xml.writeAttribute("comment", "Synthetic field " + QString::number(field));
+    xml.writeEndElement();
+
+}// writeField
+
+
+/*!
+ * Run ProtoGen on a protocol, timing the run and measuring its peak memory
+ * \param protogen is the path of the ProtoGen executable
+ * \param fileName is the protocol xml file
+ * \param outputPath is the directory for the generated files
+ * \param packets is the number of packets in the protocol
+ * \return the result of the run
+ */
+ScaleResult runProtoGen(const QString& protogen, const QString& fileName, const QString& outputPath, int packets)
+{
+    ScaleResult result;
+    QString statsFile = outputPath + "stats.json";
+    QStringList arguments;
+    QElapsedTimer timer;
+
+    result.packets = packets;
+    result.ok = false;
+    result.wallMs = 0;
+    result.peakRssMB = -1;
+
+    arguments << fileName << outputPath << "-no-doxygen" << "-no-markdown" << "-stats=" + statsFile;
+
+    timer.start();
+
+#ifdef Q_OS_UNIX
+    // fork and wait4 give the peak memory of this child alone
+    std::vector<QByteArray> storage;
+    std::vector<char*> argv;
+
+    storage.push_back(QFile::encodeName(protogen));
+    for(int i = 0; i < arguments.size(); i++)
+        storage.push_back(QFile::encodeName(arguments.at(i)));
+
+    for(size_t i = 0; i < storage.size(); i++)
+        argv.push_back(storage[i].data());
+    argv.push_back(NULL);
+
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        // Keep the output of ProtoGen out of the results table
+        freopen("/dev/null", "w", stdout);
+        execvp(argv[0], &argv[0]);
+        _exit(127);
+    }
+    else if(pid < 0)
+        return result;
+
+    int status = 0;
+    struct rusage usage;
+    if(wait4(pid, &status, 0, &usage) != pid)
+        return result;
+
+    result.wallMs = timer.nsecsElapsed()/1000000.0;
+
+    // ru_maxrss is in kilobytes on Linux, and bytes on macOS
+#ifdef Q_OS_MAC
+    result.peakRssMB = usage.ru_maxrss/(1024.0*1024.0);
+#else
+    result.peakRssMB = usage.ru_maxrss/1024.0;
+#endif
+
+    // ProtoGen returns 1 on success
+    result.ok = WIFEXITED(status) && (WEXITSTATUS(status) == 1);
+#else
+    QProcess process;
+    process.setStandardOutputFile(QProcess::nullDevice());
+    process.start(protogen, arguments);
+
+    if(!process.waitForFinished(-1))
+        return result;
+
+    result.wallMs = timer.nsecsElapsed()/1000000.0;
+    result.ok = (process.exitStatus() == QProcess::NormalExit) && (process.exitCode() == 1);
+#endif
+
+    QFile file(statsFile);
+    if(file.open(QIODevice::ReadOnly))
+        result.stats = QJsonDocument::fromJson(file.readAll()).object();
+
+    return result;
+
+}// runProtoGen
+
+
+/*!
+ * Convert a comma separated list of numbers
+ * \param text is the list, like "1000,10000,50000"
+ * \return the numbers that are greater than zero
+ */
+QList<int> toList(const QString& text)
+{
+    QList<int> list;
+    QStringList items = text.split(",", QString::SkipEmptyParts);
+
+    for(int i = 0; i < items.size(); i++)
+    {
+        int value = items.at(i).trimmed().toInt();
+        if(value > 0)
+            list.append(value);
+    }
+
+    return list;
+}
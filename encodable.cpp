@@ -1,6 +1,7 @@
 #include "encodable.h"
 #include "protocolfield.h"
 #include "protocolstructure.h"
+#include "protocolfile.h"
 
 /*!
  * Constructor for encodable
@@ -9,6 +10,7 @@ Encodable::Encodable(const QString& protocolName, const QString& protocolPrefix,
     support(supported),
     protoName(protocolName),
     prefix(protocolPrefix),
+    variableArraySigned(false),
     notEncoded(false),
     notInMemory(false),
     constant(false)
@@ -24,6 +26,7 @@ void Encodable::clear(void)
     name.clear();
     comment.clear();
     array.clear();
+    variableArraySigned = false;
     encodedLength.clear();
     notEncoded = false;
     notInMemory = false;
@@ -31,6 +34,26 @@ void Encodable::clear(void)
 }
 
 
+/*!
+ * Describe the coding of this encodable as an operation. This fills in the
+ * parts that every encodable has, and describes a structure. Primitive
+ * fields refine the operation with their encoding.
+ * \param operation receives the description
+ */
+void Encodable::getOperation(ProtocolOperation& operation) const
+{
+    operation.kind = ProtocolOperation::StructureOperation;
+    operation.encodable = this;
+    operation.array = array;
+    operation.variableArray = variableArray;
+    operation.condition = dependsOn;
+    operation.isDefault = isDefault();
+    operation.minLength = encodedLength.getMinimum();
+    operation.maxLength = encodedLength.getMaximum();
+
+}// Encodable::getOperation
+
+
 /*!
  * Return the signature of this field in a encode function signature. The
  * string will start with ", " assuming this field is not the first part of
@@ -95,6 +118,229 @@ QString Encodable::getDecodeParameterComment(void) const
 }
 
 
+/*!
+ * Return the string that is placed before the decode of this encodable in a
+ * decode function that verifies the data length as it goes. The check
+ * returns 0 if there is not enough data for this encodable and the fixed
+ * length encodables that follow it. This version only knows the maximum
+ * length of the encodable, so the check is conservative.
+ * \param isStructureMember is true if this encodable is accessed by structure pointer
+ * \param restLength is the minimum length of the encodables after this one
+ * \param rejectHook is the line of source to invoke before returning 0, may be empty
+ * \return the check, which is empty if this encodable has a fixed length
+ */
+QString Encodable::getDecodeLengthCheck(bool isStructureMember, const QString& restLength, const QString& rejectHook) const
+{
+    if(encodedLength.minEncodedLength == encodedLength.maxEncodedLength)
+        return QString();
+
+    EncodedLength length;
+    length.addToLength(encodedLength.maxEncodedLength);
+    length.addToLength(restLength);
+
+    QString output = "    // Verify there is enough data for " + name + "\n";
+    output += "    if(byteindex + " + EncodedLength::collapseLengthString(length.maxEncodedLength) + " > numBytes)\n";
+    output += getDecodeReturnString("    ", "0", rejectHook);
+
+    return output;
+}
+
+
+/*!
+ * Return the lines of source that return from a decode function under an
+ * if statement. If there is a hook, such as a trace hook of the protocol,
+ * it is invoked before the return, and the two lines become a block.
+ * \param spacing is the indent of the if statement
+ * \param value is the value to return
+ * \param hook is the line of source to invoke, without indent or line feed, may be empty
+ * \return the lines of source, including line feed
+ */
+QString Encodable::getDecodeReturnString(const QString& spacing, const QString& value, const QString& hook)
+{
+    if(hook.isEmpty())
+        return spacing + "    return " + value + ";\n";
+
+    QString output;
+
+    output += spacing + "{\n";
+    output += spacing + "    " + hook + "\n";
+    output += spacing + "    return " + value + ";\n";
+    output += spacing + "}\n";
+
+    return output;
+}
+
+
+/*!
+ * Return the C++ code that verifies the data length before something is
+ * decoded, in the header-only C++ output. A default field that is missing
+ * ends the decode successfully, anything else that is missing is a failure.
+ * \param length is the number of bytes that will be decoded, which may be
+ *        empty if they have already been decoded
+ * \param operation is the operation that decodes them, which gives the
+ *        minimum length of everything after them
+ * \return the check, including line feeds
+ */
+QString Encodable::getCppLengthCheck(const QString& length, const ProtocolOperation& operation)
+{
+    QString output;
+    QString total = length;
+
+    if(operation.isDefault)
+    {
+        output += "    if(index + " + total + " > size)\n";
+        output += "        return true;\n";
+    }
+    else
+    {
+        if(!operation.restLength.isZero())
+        {
+            if(total.isEmpty())
+                total = operation.restLength.toString();
+            else
+                total += " + " + operation.restLength.toString();
+        }
+
+        output += "    if(index + " + total + " > size)\n";
+        output += "        return false;\n";
+    }
+
+    return output;
+
+}// Encodable::getCppLengthCheck
+
+
+/*!
+ * Get the number of elements of this encodable that are coded in the C++
+ * output. For a variable length array this is a local variable, which
+ * getCppRepeatString() declares, that is limited to the array size.
+ * \return the number of elements, or an empty string if this is not an array
+ */
+QString Encodable::getCppCount(void) const
+{
+    bool ok = false;
+
+    if(!isArray())
+        return QString();
+
+    if(!variableArray.isEmpty())
+        return name + "Count";
+
+    // The array size may be an enumeration or a macro, which is not a size_t
+    array.toInt(&ok);
+    if(ok)
+        return array;
+    else
+        return "static_cast<std::size_t>(" + array + ")";
+
+}// Encodable::getCppCount
+
+
+/*!
+ * Get the C++ expression for the element of this encodable inside the
+ * loop that getCppRepeatString() creates
+ * \return the name, with the loop index if this is an array
+ */
+QString Encodable::getCppAccess(void) const
+{
+    if(isArray())
+        return name + "[i]";
+    else
+        return name;
+}
+
+
+/*!
+ * Wrap the C++ code that codes one element of this encodable in the loop
+ * over the array, and the condition on dependsOn. All the code given is at
+ * the indentation of a function body.
+ * \param element is the code that codes one element
+ * \param before is code that goes before the loop, after the number of
+ *        elements is known, such as a length check
+ * \param after is code that goes after the loop
+ * \return the code, including the comment of this encodable
+ */
+QString Encodable::getCppRepeatString(const QString& element, const QString& before, const QString& after) const
+{
+    QString output;
+
+    if(!variableArray.isEmpty())
+        output += "    const std::size_t " + getCppCount() + " = protogen::arrayCount(" + variableArray + ", " + array + ");\n";
+
+    output += before;
+
+    if(isArray())
+    {
+        output += "    for(std::size_t i = 0; i < " + getCppCount() + "; i++)\n";
+        output += "    {\n";
+        output += ProtocolFile::indentCode(element);
+        output += "    }\n";
+    }
+    else
+        output += element;
+
+    output += after;
+
+    return getCppConditionString(output);
+
+}// Encodable::getCppRepeatString
+
+
+/*!
+ * Wrap C++ code in the condition on dependsOn, if there is one. The code is
+ * at the indentation of a function body.
+ * \param code is the code that codes this encodable
+ * \return the code, including the comment of this encodable
+ */
+QString Encodable::getCppConditionString(const QString& code) const
+{
+    QString output = code;
+
+    if(!dependsOn.isEmpty())
+        output = "    if(" + dependsOn + ")\n    {\n" + ProtocolFile::indentCode(output) + "    }\n";
+
+    if(!comment.isEmpty())
+        output = "    // " + comment + "\n" + output;
+
+    return output;
+
+}// Encodable::getCppConditionString
+
+
+/*!
+ * Get the C++ code that encodes this encodable by calling the encode
+ * function of its structure, for a child structure or an external one.
+ * \return the code to add to the encode function
+ */
+QString Encodable::getCppEncodeStringForStructure(void) const
+{
+    return getCppRepeatString("    " + getCppAccess() + ".encode(data, index);\n");
+}
+
+
+/*!
+ * Get the C++ code that decodes this encodable by calling the decode
+ * function of its structure. The structure checks its own minimum length,
+ * and it is up to us to check for the minimum length of what follows.
+ * \param operation is the operation that decodes this encodable
+ * \return the code to add to the decode function
+ */
+QString Encodable::getCppDecodeStringForStructure(const ProtocolOperation& operation) const
+{
+    QString element;
+    QString check;
+
+    element += "    if(!" + getCppAccess() + ".decode(data, size, index))\n";
+    element += "        return false;\n";
+
+    if(operation.checkLength && !operation.restLength.isZero())
+        check = getCppLengthCheck(QString(), operation);
+
+    return getCppRepeatString(element, QString(), check);
+
+}// Encodable::getCppDecodeStringForStructure
+
+
 /*!
  * Construct a protocol field by parsing a DOM element. The type of Encodable
  * created will be either a ProtocolStructure or a ProtocolField
@@ -3,8 +3,10 @@
 
 #include "protocolsupport.h"
 #include "encodedlength.h"
+#include "protocoloperation.h"
 #include <QDomElement>
 #include <QString>
+#include <QStringList>
 
 class Encodable
 {
@@ -34,7 +36,10 @@ public:
     virtual QString getEncodeString(bool isBigEndian, int* bitcount, bool isStructureMember) const = 0;
 
     //! Return the string that is used to decode this encoable
-    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false) const = 0;
+    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false, const QString& endHook = QString()) const = 0;
+
+    //! Return the string that checks the data length before this encodable is decoded
+    virtual QString getDecodeLengthCheck(bool isStructureMember, const QString& restLength, const QString& rejectHook = QString()) const;
 
     //! Return the string that is used to declare this encodable
     virtual QString getDeclaration(void) const = 0;
@@ -60,6 +65,27 @@ public:
     //! Return the string that sets this encodable to its default value in code
     virtual QString getSetToDefaultsString(bool isStructureMember) const {return QString();}
 
+    //! Return the string that declares this encodable as a member of a C++ structure
+    virtual QString getCppDeclaration(void) const {return getDeclaration();}
+
+    //! Return the C++ include directive needed for this encodable
+    virtual QString getCppIncludeDirective(void) {return QString();}
+
+    //! Return the string that declares the whole structure in C++
+    virtual QString getCppStructureDeclaration(bool isBigEndian) const {return QString();}
+
+    //! Return the C++ code that encodes this encodable as a structure member
+    virtual QString getCppEncodeString(bool isBigEndian) const = 0;
+
+    //! Return the C++ code that decodes this encodable as a structure member
+    virtual QString getCppDecodeString(bool isBigEndian, const ProtocolOperation& operation) const = 0;
+
+    //! Return the C++ code that sets this encodable to its default value
+    virtual QString getCppSetToDefaultsString(void) const {return QString();}
+
+    //! Describe the coding of this encodable as an operation
+    virtual void getOperation(ProtocolOperation& operation) const;
+
     //! Get details needed to produce documentation for this encodable.
     virtual void getDocumentationDetails(QList<int>& outline, QString& startByte, QStringList& bytes, QStringList& names, QStringList& encodings, QStringList& repeats, QStringList& comments) const = 0;
 
@@ -93,9 +119,33 @@ public:
     //! Get the ending bitcount for this fields bitfield
     virtual int getEndingBitCount(void){return 0;}
 
+    //! Set the total number of bits in the group this bitfield belongs to
+    virtual void setBitfieldGroupBits(int bits) {;}
+
+    //! True if this bitfield is packed into a single word with its group
+    virtual bool isFusedBitfield(void) const {return false;}
+
     //! True if this encodable has a default value
     virtual bool isDefault(void) const {return false;}
 
+    //! True if this encodable can be read and written in place in an encoded packet
+    virtual bool supportsDirectAccess(void) const {return false;}
+
+    //! Get the size in bytes of one element of this encodable in memory, 0 if its layout is not known
+    virtual int getInMemoryBytes(void) const {return 0;}
+
+    //! True if this encodable is a signed number in memory
+    virtual bool isInMemorySigned(void) const {return false;}
+
+    //! Get the size in bytes of one element of this encodable if its encoding is a copy of its memory, else 0
+    virtual int getNativeBytes(void) const {return 0;}
+
+    //! True if this encodable can be described by a field of the table codec
+    virtual bool supportsTableCodec(void) const {return false;}
+
+    //! Get the initializer of the table codec field of this encodable, empty if it is not encoded
+    virtual QString getTableFieldString(const QString& structureType, QStringList& constants) const {return QString();}
+
     //! True if this encodable has a direct child that uses bitfields
     virtual bool usesBitfields(void ) const = 0;
 
@@ -105,12 +155,44 @@ public:
     //! True if this encodable has a direct child that uses defaults
     virtual bool usesDefaults(void) const = 0;
 
+    //! Get the number of primitive fields in this encodable, including those of any children
+    virtual int getNumberOfFields(void) const {return 1;}
+
+    //! Get the notices from generating this encodable and its children, which are printed once all modules are generated
+    virtual QStringList getNotices(void) const {return QStringList();}
+
+    //! Return the C++ code that verifies the data length before decoding
+    static QString getCppLengthCheck(const QString& length, const ProtocolOperation& operation);
+
+    //! Return the lines of source that return from a decode function, invoking a hook first
+    static QString getDecodeReturnString(const QString& spacing, const QString& value, const QString& hook);
+
     //! Add successive length strings
     static void addToLengthString(QString & totalLength, const QString & length);
 
     //! Add successive length strings
     static void addToLengthString(QString* totalLength, const QString & length);
 
+protected:
+
+    //! Get the number of elements coded in the C++ output
+    QString getCppCount(void) const;
+
+    //! Get the C++ expression for one element of this encodable
+    QString getCppAccess(void) const;
+
+    //! Wrap the C++ code for one element in the array loop and dependsOn condition
+    QString getCppRepeatString(const QString& element, const QString& before = QString(), const QString& after = QString()) const;
+
+    //! Wrap C++ code in the dependsOn condition
+    QString getCppConditionString(const QString& code) const;
+
+    //! Get the C++ code that encodes this encodable with the functions of its structure
+    QString getCppEncodeStringForStructure(void) const;
+
+    //! Get the C++ code that decodes this encodable with the functions of its structure
+    QString getCppDecodeStringForStructure(const ProtocolOperation& operation) const;
+
 public:
     ProtocolSupport support;//!< Information about what is supported
     QString protoName;      //!< Name of the protocol
@@ -120,6 +202,7 @@ public:
     QString comment;        //!< The comment that goes with this encodable
     QString array;          //!< The array length of this encodable, empty if no array
     QString variableArray;  //!< variable that gives the length of the array in a packet
+    bool variableArraySigned;   //!< True if the variable that gives the length of the array is signed
     QString dependsOn;      //!< variable that determines if this field is present
     EncodedLength encodedLength;    //!< The lengths of the encodables
     bool notEncoded;        //!< True if this encodable is NOT encoded
@@ -1,375 +1,597 @@
 #include "encodedlength.h"
 #include "shuntingyard.h"
-#include <QStringList>
 
-EncodedLength::EncodedLength() :
-    minEncodedLength(),
-    maxEncodedLength(),
-    nonDefaultEncodedLength()
+LengthExpression::LengthExpression(void) :
+    constant(0)
 {
 }
 
 
 /*!
- * Clear the encoded length
+ * Parse a length expression from text, like "4+2*N3D" or "N3D*(6+1)". Sums
+ * and products of numbers and symbols are folded, parentheses are multiplied
+ * out. Anything else, such as a division, is kept as a single symbol.
+ * \param text is the text to parse, which can be empty for a zero length
+ * \return the parsed expression
  */
-void EncodedLength::clear(void)
+LengthExpression LengthExpression::fromString(const QString& text)
 {
-    minEncodedLength.clear();
-    maxEncodedLength.clear();
-    nonDefaultEncodedLength.clear();
-}
+    LengthExpression output;
+    QString trimmed = text;
+    trimmed.remove(' ');
+
+    if(trimmed.isEmpty())
+        return output;
+
+    if(!parseSum(trimmed, output))
+    {
+        output.clear();
+        if(!parseFactor(trimmed, output))
+            output.addTerm(QStringList(getOpaqueFactor(trimmed)), 1);
+    }
+
+    return output;
+
+}// LengthExpression::fromString
 
 
 /*!
- * Determine if there is any data here
- * \return true if an length is recorded, else false
+ * Clear the expression to zero
  */
-bool EncodedLength::isEmpty(void)
+void LengthExpression::clear(void)
 {
-    return maxEncodedLength.isEmpty();
-
+    constant = 0;
+    terms.clear();
+    coefficients.clear();
 }
 
 
 /*!
- * Add successive length strings
- * \param length is the new length string to add
- * \param isString is true if this length is for a string
- * \param isVariable is true if this length is for a variable length array
- * \param isDependent is true if this length is for a field whose presence depends on another field
- * \parma isDefault is true if this lenght is for a default field.
+ * Add another expression to this one
+ * \param right is the expression to add
  */
-void EncodedLength::addToLength(const QString & length, bool isString, bool isVariable, bool isDependent, bool isDefault)
+void LengthExpression::add(const LengthExpression& right)
 {
-    if(length.isEmpty())
-        return;
+    constant += right.constant;
 
-    addToLengthString(maxEncodedLength, length);
+    for(int i = 0; i < right.terms.size(); i++)
+        addTerm(right.terms.at(i), right.coefficients.at(i));
+}
 
-    // Default fields do not add to the length of anything else
-    if(isDefault)
-        return;
 
-    // Length of everthing except default, strings are 1 byte
-    if(isString)
-        addToLengthString(nonDefaultEncodedLength, "1");
-    else
-        addToLengthString(nonDefaultEncodedLength, length);
+/*!
+ * Multiply this expression by another one, as for an array of structures
+ * \param right is the expression to multiply by
+ */
+void LengthExpression::multiply(const LengthExpression& right)
+{
+    LengthExpression product;
 
-    // If not variable or dependent, then add to minimum length
-    if(!isVariable && !isDependent)
+    product.constant = constant*right.constant;
+
+    for(int i = 0; i < terms.size(); i++)
     {
-        // Strings add a minimum length of 1 byte
-        if(isString)
-            addToLengthString(minEncodedLength, "1");
-        else
-            addToLengthString(minEncodedLength, length);
+        product.addTerm(terms.at(i), coefficients.at(i)*right.constant);
+
+        for(int j = 0; j < right.terms.size(); j++)
+        {
+            QStringList factors = terms.at(i) + right.terms.at(j);
+            factors.sort();
+            product.addTerm(factors, coefficients.at(i)*right.coefficients.at(j));
+        }
     }
 
-}// EncodedLength::addToLength
+    for(int j = 0; j < right.terms.size(); j++)
+        product.addTerm(right.terms.at(j), constant*right.coefficients.at(j));
+
+    *this = product;
+
+}// LengthExpression::multiply
 
 
 /*!
- * Add a grouping of length strings to this length
- * \param rightLength is the length strings to add.
- * \param array is the array length, which can be empty.
- * \param isVariable is true if this length is for a variable length array.
- * \param isDependent is true if this length is for a field whose presence depends on another field.
+ * Output the expression as C, with the products of symbols first, followed by
+ * the constant. The products are in a fixed order, so two equal expressions
+ * always give the same text.
+ * \param keepZero should be true to output "0" for a zero expression, else it is empty
+ * \return the expression as C
  */
-void EncodedLength::addToLength(const EncodedLength& rightLength, const QString& array, bool isVariable, bool isDependent)
+QString LengthExpression::toString(bool keepZero) const
 {
-    if(array.isEmpty())
+    QString output;
+
+    for(int i = 0; i < terms.size(); i++)
     {
-        addToLengthString(maxEncodedLength, rightLength.maxEncodedLength);
-        addToLengthString(nonDefaultEncodedLength, rightLength.nonDefaultEncodedLength);
+        QString term = terms.at(i).join("*");
 
-        // If not variable or dependent, then add to minimum length
-        if(!isVariable && !isDependent)
-            addToLengthString(minEncodedLength, rightLength.minEncodedLength);
+        if(coefficients.at(i) == -1)
+            term = "-" + term;
+        else if(coefficients.at(i) != 1)
+            term = QString().setNum(coefficients.at(i)) + "*" + term;
+
+        if(!output.isEmpty() && !term.startsWith("-"))
+            output += "+";
+
+        output += term;
     }
-    else
-    {
-        addToLengthString(maxEncodedLength, array + "*(" + rightLength.maxEncodedLength + ")");
-        addToLengthString(nonDefaultEncodedLength, array + "*(" + rightLength.nonDefaultEncodedLength + ")");
 
-        // If not variable or dependent, then add to minimum length
-        if(!isVariable && !isDependent)
-            addToLengthString(minEncodedLength, array + "*(" + rightLength.minEncodedLength + ")");
+    if(constant != 0)
+    {
+        if(!output.isEmpty() && (constant > 0))
+            output += "+";
 
+        output += QString().setNum(constant);
     }
-}
+
+    if(keepZero && output.isEmpty())
+        output = "0";
+
+    return output;
+
+}// LengthExpression::toString
 
 
 /*!
- * Add a grouping of length strings
- * \param leftLength is the group that is incremented, can be NULL in which case this function does nothing.
- * \param rightLength is the length strings to add.
- * \param array is the array length, which can be empty.
- * \param isVariable is true if this length is for a variable length array.
- * \param isDependent is true if this length is for a field whose presence depends on another field.
+ * Compare two expressions
+ * \param right is the expression to compare with
+ * \return true if the expressions have the same constant and products
  */
-void EncodedLength::add(EncodedLength* leftLength, const EncodedLength& rightLength, const QString& array, bool isVariable, bool isDependent)
+bool LengthExpression::operator==(const LengthExpression& right) const
 {
-    if(leftLength != NULL)
-        leftLength->addToLength(rightLength, array, isVariable, isDependent);
+    return (constant == right.constant) && (terms == right.terms) && (coefficients == right.coefficients);
 }
 
 
 /*!
- * Create a length string like "4 + 3 + N3D*2" by adding successive length strings
- * \param totalLength is the total length string
- * \param length is the new length to add
+ * Add one product of symbols to this expression. The products are kept sorted
+ * so that equal expressions have equal lists.
+ * \param factors is the sorted list of symbols in the product
+ * \param coefficient is the multiplier of the product
  */
-void EncodedLength::addToLengthString(QString & totalLength, QString length)
+void LengthExpression::addTerm(const QStringList& factors, qint64 coefficient)
 {
-    bool ok;
-    double number;
-    int inumber;
-
-    if(length.isEmpty())
+    if(coefficient == 0)
         return;
 
-    // Its possible that length represents something like 24*(6), which we can resolve easily, so lets try
-    number = ShuntingYard::computeInfix(length, &ok);
-    if(ok)
+    QString key = factors.join("*");
+
+    int i = 0;
+    for(; i < terms.size(); i++)
     {
-        // round to nearest integer
-        if(number >= 0)
-            inumber = (int)(number + 0.5);
-        else
-            inumber = (int)(number - 0.5);
+        int compare = terms.at(i).join("*").compare(key);
+
+        if(compare == 0)
+        {
+            coefficients[i] += coefficient;
 
-        length = QString().setNum(inumber);
+            // Terms that cancel are removed
+            if(coefficients.at(i) == 0)
+            {
+                terms.removeAt(i);
+                coefficients.removeAt(i);
+            }
+
+            return;
+        }
+        else if(compare > 0)
+            break;
     }
 
-    if(length == "0")
-        return;
+    terms.insert(i, factors);
+    coefficients.insert(i, coefficient);
 
-    if(totalLength.isEmpty())
-        totalLength = length;
-    else
+}// LengthExpression::addTerm
+
+
+/*!
+ * Parse a sum of terms, where each term is a product of factors
+ * \param text is the text to parse, without spaces
+ * \param output receives the expression
+ * \return false if the text is not a sum this parser understands
+ */
+bool LengthExpression::parseSum(const QString& text, LengthExpression& output)
+{
+    int depth = 0;
+    int start = 0;
+    qint64 sign = 1;
+
+    output.clear();
+
+    for(int i = 0; i <= text.size(); i++)
     {
-        // Add them up
-        totalLength = collapseLengthString(totalLength + "+" + length);
+        QChar c = (i < text.size()) ? text.at(i) : QChar('+');
 
-        /*
-        if(totalLength.endsWith(")") || !ok)
+        if(c == '(')
+            depth++;
+        else if(c == ')')
         {
-            totalLength += "+" + length;
+            if(--depth < 0)
+                return false;
         }
-        else
+
+        if((depth > 0) || ((c != '+') && (c != '-')))
+            continue;
+
+        if(i == start)
         {
-            QString trailingArgument;
+            // A sign in front of the term
+            if(i == text.size())
+                return false;
 
-            // find the last addition operator
-            int index = totalLength.lastIndexOf("+");
+            if(c == '-')
+                sign = -sign;
 
-            // Get the trailing argument
-            if(index <= 0)
-                trailingArgument = totalLength;
-            else
-                trailingArgument = totalLength.right(totalLength.size() - index - 1);
+            start = i + 1;
+            continue;
+        }
+
+        QChar previous = text.at(i - 1);
+
+        // A sign after a multiply or divide belongs to the factor
+        if((i < text.size()) && ((previous == '*') || (previous == '/') || (previous == '%')))
+            continue;
+
+        QString term = text.mid(start, i - start);
+        LengthExpression product;
+        product.constant = sign;
 
-            if(isNumber(trailingArgument))
+        if(term.contains('/') || term.contains('%'))
+        {
+            // Integer division does not distribute, so keep the whole term
+            LengthExpression factor;
+            if(!parseFactor(term, factor))
+                factor.addTerm(QStringList(getOpaqueFactor(term)), 1);
+
+            product.multiply(factor);
+        }
+        else
+        {
+            int factorDepth = 0;
+            int factorStart = 0;
+            for(int j = 0; j <= term.size(); j++)
             {
-                number = ShuntingYard::computeInfix(trailingArgument + "+" + length, &ok);
-                if(ok)
+                QChar f = (j < term.size()) ? term.at(j) : QChar('*');
+
+                if(f == '(')
+                    factorDepth++;
+                else if(f == ')')
+                    factorDepth--;
+                else if((f == '*') && (factorDepth == 0))
                 {
-                    // round to nearest integer
-                    if(number >= 0)
-                        inumber = (int)(number + 0.5);
-                    else
-                        inumber = (int)(number - 0.5);
-
-                    if(index >= 0)
-                    {
-                        // Remove the previous trailing argument
-                        totalLength.remove(index+1, totalLength.size());
-
-                        // Replace with our new one
-                        totalLength += QString().setNum(inumber);
-                    }
-                    else
-                        totalLength = QString().setNum(inumber);
+                    LengthExpression factor;
+                    if(!parseFactor(term.mid(factorStart, j - factorStart), factor))
+                        return false;
+
+                    product.multiply(factor);
+                    factorStart = j + 1;
                 }
-                else
-                    totalLength += "+" + length;
             }
-            else
-                totalLength += "+" + length;
+        }
 
-        }// if length is something we can compute
-        */
+        output.add(product);
 
-    }// if totalLength previously had data
+        sign = (c == '-') ? -1 : 1;
+        start = i + 1;
 
-}// EncodedLength::addToLengthString
+    }// for all characters
+
+    return (depth == 0);
+
+}// LengthExpression::parseSum
 
 
 /*!
- * Collapse a length string as best we can by summing terms
- * \param totalLength is the existing length string.
- * \param keepZero should be true keep "0" in the output.
- * \param minusOne should be true to subtract 1 from the output.
- * \return an equivalent collapsed string
+ * Parse one factor of a product, which is a number, a symbol, or a sum in
+ * parentheses
+ * \param text is the text to parse, without spaces
+ * \param output receives the expression
+ * \return false if the text is empty or its parentheses do not match
  */
-QString EncodedLength::collapseLengthString(QString totalLength, bool keepZero, bool minusOne)
+bool LengthExpression::parseFactor(const QString& text, LengthExpression& output)
 {
-    if(totalLength.contains("(") || totalLength.contains(")"))
-    {
-        if(minusOne)
-            return totalLength + "-1";
-        else
-            return totalLength;
-    }
+    bool ok;
 
-    // Split according to the pluses
-    QStringList list = totalLength.split("+");
-    QStringList others;
+    output.clear();
 
-    // Some of these groups are simple numbers, some of them are not. We are going to re-order to put the numbers together
-    int number = 0;
-    for(int i = 0; i < list.size(); i++)
+    if(text.isEmpty())
+        return false;
+
+    if((text.at(0) == '-') || (text.at(0) == '+'))
     {
-        if(list.at(i).isEmpty())
-            continue;
+        if(!parseFactor(text.mid(1), output))
+            return false;
 
-        if(isNumber(list.at(i)))
+        if(text.at(0) == '-')
         {
-            number += list.at(i).toInt();
-        }
-        else
-        {
-            others.append(list.at(i));
+            LengthExpression negative;
+            negative.constant = -1;
+            output.multiply(negative);
         }
 
-    }// for all the fragments
+        return true;
+    }
 
-    // Handle the minus one here
-    if(minusOne)
-        number--;
+    qint64 number = text.toLongLong(&ok, 0);
+    if(ok)
+    {
+        output.constant = number;
+        return true;
+    }
 
-    QList<QStringList> pairlist;
-    for(int i = 0; i < others.size(); i++)
+    // Skip over an identifier, which could be the name of a function
+    int i = 0;
+    if(text.at(0).isLetter() || (text.at(0) == '_'))
     {
-        // Separate a string like "1*N3D" into "1" and "N3D"
-        pairlist.append(others.at(i).split("*"));
+        while((i < text.size()) && (text.at(i).isLetterOrNumber() || (text.at(i) == '_')))
+            i++;
     }
 
-    others.clear();
-    QString output;
-    for(int i = 0; i < pairlist.size(); i++)
+    if((i > 0) && ((i == text.size()) || ((text.at(i) == '(') && (findClosing(text, i) == text.size() - 1))))
     {
-        // Each entry should have two elements and the first should be a number,
-        // if not then something weird happened, just put it back the way it was
-        if((pairlist.at(i).size() != 2) || !isNumber(pairlist.at(i).at(0)))
-        {
-            if(pairlist.at(i).size() != 0)
-            {
-                if(!output.isEmpty())
-                    output += "+";
+        // A symbol, or a function call like getMinLengthOfThing()
+        output.addTerm(QStringList(text), 1);
+        return true;
+    }
+    else if((i == 0) && (text.at(0) == '(') && (findClosing(text, 0) == text.size() - 1))
+    {
+        // A sum in parentheses is multiplied out
+        if(parseSum(text.mid(1, text.size() - 2), output))
+            return true;
 
-                output += pairlist.at(i).join("*");
-            }
-            continue;
-        }
+        output.clear();
+    }
 
-        int counter = pairlist.at(i).at(0).toInt();
+    // It might be an expression of numbers that we can compute
+    double dnumber = ShuntingYard::computeInfix(text, &ok);
+    if(ok && (dnumber == (double)((qint64)dnumber)))
+    {
+        output.constant = (qint64)dnumber;
+        return true;
+    }
 
-        // Now go through all entries after this one to find anyone that is common
-        for(int j = i + 1; j < pairlist.size(); j++)
-        {
-            // if its not a number, then we can't do anything with it,
-            // we'll catch it in the outer loop when we get to it
-            if((pairlist.at(j).size() != 2) || !isNumber(pairlist.at(j).at(0)))
-                continue;
+    output.addTerm(QStringList(getOpaqueFactor(text)), 1);
+    return true;
 
-            // If the comparison is exactly the same, then we can add this one up
-            if(pairlist.at(i).at(1).compare(pairlist.at(j).at(1)) == 0)
-            {
-                // These two are multiples of the same thing
-                counter += pairlist.at(j).at(0).toInt();
+}// LengthExpression::parseFactor
 
-                // Clear this element, no contribution in the future.
-                pairlist[j].clear();
-            }
-        }
 
-        // finally include this in the output
-        if(counter != 0)
+/*!
+ * Find the parenthesis that closes an opening parenthesis
+ * \param text is the text to search
+ * \param open is the index of the opening parenthesis
+ * \return the index of the closing parenthesis, or -1 if there is none
+ */
+int LengthExpression::findClosing(const QString& text, int open)
+{
+    int depth = 0;
+    for(int i = open; i < text.size(); i++)
+    {
+        if(text.at(i) == '(')
+            depth++;
+        else if(text.at(i) == ')')
         {
-            if(!output.isEmpty())
-                output += "+";
-
-            output += QString().setNum(counter) + "*" + pairlist.at(i).at(1);
+            if(--depth == 0)
+                return i;
         }
     }
 
-    // A negative number outputs the "-" by default
-    if(number < 0)
-        output += QString().setNum(number);
+    return -1;
+}
+
+
+/*!
+ * Get the factor to use for text that is not parsed any further, which is in
+ * parentheses so that it can be multiplied safely
+ * \param text is the text of the factor
+ * \return the factor
+ */
+QString LengthExpression::getOpaqueFactor(const QString& text)
+{
+    if(text.startsWith("(") && (findClosing(text, 0) == text.size() - 1))
+        return text;
     else
+        return "(" + text + ")";
+}
+
+
+EncodedLength::EncodedLength() :
+    minEncodedLength(),
+    maxEncodedLength(),
+    nonDefaultEncodedLength()
+{
+}
+
+
+/*!
+ * Clear the encoded length
+ */
+void EncodedLength::clear(void)
+{
+    minLength.clear();
+    maxLength.clear();
+    nonDefaultLength.clear();
+    updateLengthStrings();
+}
+
+
+/*!
+ * Determine if there is any data here
+ * \return true if an length is recorded, else false
+ */
+bool EncodedLength::isEmpty(void)
+{
+    return maxLength.isZero();
+
+}
+
+
+/*!
+ * Add successive length strings
+ * \param length is the new length string to add
+ * \param isString is true if this length is for a string
+ * \param isVariable is true if this length is for a variable length array
+ * \param isDependent is true if this length is for a field whose presence depends on another field
+ * \parma isDefault is true if this lenght is for a default field.
+ */
+void EncodedLength::addToLength(const QString & length, bool isString, bool isVariable, bool isDependent, bool isDefault)
+{
+    LengthExpression value = LengthExpression::fromString(length);
+
+    if(value.isZero())
+        return;
+
+    // Strings are at least 1 byte
+    LengthExpression one;
+    one.add(1);
+
+    maxLength.add(value);
+
+    // Default fields do not add to the length of anything else
+    if(!isDefault)
     {
-        if(number != 0)
+        // Length of everthing except default, strings are 1 byte
+        if(isString)
+            nonDefaultLength.add(one);
+        else
+            nonDefaultLength.add(value);
+
+        // If not variable or dependent, then add to minimum length
+        if(!isVariable && !isDependent)
         {
-            if(output.isEmpty())
-                output = QString().setNum(number);
+            if(isString)
+                minLength.add(one);
             else
-                output += "+" + QString().setNum(number);
+                minLength.add(value);
         }
     }
 
-    if((keepZero) && output.isEmpty())
-        output = "0";
+    updateLengthStrings();
 
-    // It might be that we can compute a value now, give it a try
-    bool ok;
-    double dnumber = ShuntingYard::computeInfix(output, &ok);
-    if(ok)
+}// EncodedLength::addToLength
+
+
+/*!
+ * Add a length whose minimum and maximum differ because the number of bytes
+ * depends on the value that is encoded, like a variable length integer.
+ * Such lengths cannot be default.
+ * \param minimum is the smallest number of bytes.
+ * \param maximum is the largest number of bytes.
+ * \param isVariable is true if this length is for a variable length array.
+ * \param isDependent is true if this length is for a field whose presence depends on another field.
+ */
+void EncodedLength::addRangeToLength(const QString& minimum, const QString& maximum, bool isVariable, bool isDependent)
+{
+    LengthExpression value = LengthExpression::fromString(maximum);
+
+    maxLength.add(value);
+    nonDefaultLength.add(value);
+
+    // If not variable or dependent, then add to minimum length
+    if(!isVariable && !isDependent)
+        minLength.add(LengthExpression::fromString(minimum));
+
+    updateLengthStrings();
+
+}// EncodedLength::addRangeToLength
+
+
+/*!
+ * Add a grouping of length strings to this length
+ * \param rightLength is the length strings to add.
+ * \param array is the array length, which can be empty.
+ * \param isVariable is true if this length is for a variable length array.
+ * \param isDependent is true if this length is for a field whose presence depends on another field.
+ */
+void EncodedLength::addToLength(const EncodedLength& rightLength, const QString& array, bool isVariable, bool isDependent)
+{
+    if(array.isEmpty())
     {
-        // round to nearest integer
-        if(dnumber >= 0)
-            number = (int)(dnumber + 0.5);
-        else
-            number = (int)(dnumber - 0.5);
+        maxLength.add(rightLength.maxLength);
+        nonDefaultLength.add(rightLength.nonDefaultLength);
 
-        output = QString().setNum(number);
+        // If not variable or dependent, then add to minimum length
+        if(!isVariable && !isDependent)
+            minLength.add(rightLength.minLength);
     }
+    else
+    {
+        LengthExpression count = LengthExpression::fromString(array);
 
-    return output;
+        LengthExpression length = rightLength.maxLength;
+        length.multiply(count);
+        maxLength.add(length);
 
-}// EncodedLength::collapseLengthString
+        length = rightLength.nonDefaultLength;
+        length.multiply(count);
+        nonDefaultLength.add(length);
+
+        // If not variable or dependent, then add to minimum length
+        if(!isVariable && !isDependent)
+        {
+            length = rightLength.minLength;
+            length.multiply(count);
+            minLength.add(length);
+        }
+
+    }
+
+    updateLengthStrings();
+}
 
 
 /*!
-* Subtract one from a length string
-* \param totalLength is the existing length string.
-* \param keepZero should be true keep "0" in the output.
-* \return the string with one less
-*/
-QString EncodedLength::subtractOneFromLengthString(QString totalLength, bool keepZero)
+ * Add a grouping of length strings
+ * \param leftLength is the group that is incremented, can be NULL in which case this function does nothing.
+ * \param rightLength is the length strings to add.
+ * \param array is the array length, which can be empty.
+ * \param isVariable is true if this length is for a variable length array.
+ * \param isDependent is true if this length is for a field whose presence depends on another field.
+ */
+void EncodedLength::add(EncodedLength* leftLength, const EncodedLength& rightLength, const QString& array, bool isVariable, bool isDependent)
 {
-    return EncodedLength::collapseLengthString(totalLength, keepZero, true);
+    if(leftLength != NULL)
+        leftLength->addToLength(rightLength, array, isVariable, isDependent);
 }
 
 
 /*!
- * Determine if a segment of text contains only decimal digits
- * \param text is the text to check
- * \return true if only decimal digits, else false
+ * Output the lengths to the length strings. The strings of equal lengths are
+ * always the same, so they can be compared directly.
  */
-bool EncodedLength::isNumber(const QString& text)
+void EncodedLength::updateLengthStrings(void)
 {
-    if(text.size() <= 0)
-        return false;
+    minEncodedLength = minLength.toString();
+    maxEncodedLength = maxLength.toString();
+    nonDefaultEncodedLength = nonDefaultLength.toString();
+}
 
-    for(int i = 0; i < text.size(); i++)
-    {
-        // Minus signs are OK
-        if(!text.at(i).isDigit() && (text.at(i) != '-'))
-            return false;
-    }
 
-    return true;
+/*!
+ * Collapse a length string as best we can by summing terms
+ * \param totalLength is the existing length string.
+ * \param keepZero should be true keep "0" in the output.
+ * \param minusOne should be true to subtract 1 from the output.
+ * \return an equivalent collapsed string
+ */
+QString EncodedLength::collapseLengthString(QString totalLength, bool keepZero, bool minusOne)
+{
+    LengthExpression length = LengthExpression::fromString(totalLength);
+
+    if(minusOne)
+        length.add(-1);
+
+    return length.toString(keepZero);
+
+}// EncodedLength::collapseLengthString
+
+
+/*!
+* Subtract one from a length string
+* \param totalLength is the existing length string.
+* \param keepZero should be true keep "0" in the output.
+* \return the string with one less
+*/
+QString EncodedLength::subtractOneFromLengthString(QString totalLength, bool keepZero)
+{
+    return EncodedLength::collapseLengthString(totalLength, keepZero, true);
 }
@@ -2,6 +2,71 @@
 #define ENCODEDLENGTH_H
 
 #include <QString>
+#include <QStringList>
+#include <QList>
+
+/*!
+ * A length in bytes as a sum of products, like 4 + 6*N3D + 2*N3D*count. The
+ * terms are folded as they are added, so the length never has to be parsed
+ * again, and it is only turned back into C when it is output.
+ */
+class LengthExpression
+{
+public:
+    LengthExpression(void);
+
+    //! Parse a length expression from text
+    static LengthExpression fromString(const QString& text);
+
+    //! Clear the expression to zero
+    void clear(void);
+
+    //! Determine if the expression is zero
+    bool isZero(void) const {return (constant == 0) && terms.isEmpty();}
+
+    //! Determine if the expression is a plain number
+    bool isConstant(void) const {return terms.isEmpty();}
+
+    //! Add another expression to this one
+    void add(const LengthExpression& right);
+
+    //! Add a number to this expression
+    void add(qint64 number) {constant += number;}
+
+    //! Multiply this expression by another one
+    void multiply(const LengthExpression& right);
+
+    //! Output the expression as C
+    QString toString(bool keepZero = false) const;
+
+    //! Compare two expressions
+    bool operator==(const LengthExpression& right) const;
+
+    //! Compare two expressions
+    bool operator!=(const LengthExpression& right) const {return !(*this == right);}
+
+private:
+
+    //! Add one product of symbols to this expression
+    void addTerm(const QStringList& factors, qint64 coefficient);
+
+    //! Parse a sum of terms, returning false if the text cannot be parsed
+    static bool parseSum(const QString& text, LengthExpression& output);
+
+    //! Parse one factor of a product, returning false if the text cannot be parsed
+    static bool parseFactor(const QString& text, LengthExpression& output);
+
+    //! Find the parenthesis that closes an opening parenthesis
+    static int findClosing(const QString& text, int open);
+
+    //! Get the factor to use for text that is not parsed any further
+    static QString getOpaqueFactor(const QString& text);
+
+    qint64 constant;                //!< The constant part of the expression
+    QList<QStringList> terms;       //!< The sorted symbols of each product, sorted by their text
+    QList<qint64> coefficients;     //!< The multiplier of each product
+};
+
 
 class EncodedLength
 {
@@ -11,6 +76,9 @@ public:
     //! Add successive length strings
     void addToLength(const QString & length, bool isString = false, bool isVariable = false, bool  isDependent = false, bool isDefault = false);
 
+    //! Add a length whose minimum and maximum differ, like a variable length integer
+    void addRangeToLength(const QString& minimum, const QString& maximum, bool isVariable = false, bool isDependent = false);
+
     //! Add a grouping of length strings
     void addToLength(const EncodedLength& rightLength, const QString& array = QString(), bool isVariable = false, bool isDependent = false);
 
@@ -32,6 +100,12 @@ public:
     //! The maximum encoded length of everything except default fields
     QString nonDefaultEncodedLength;
 
+    //! The minimum encoded length, as an expression
+    const LengthExpression& getMinimum(void) const {return minLength;}
+
+    //! The maximum encoded length, as an expression
+    const LengthExpression& getMaximum(void) const {return maxLength;}
+
     //! Collapse a length string as best we can by summing terms
     static QString collapseLengthString(QString totalLength, bool keepZero = false, bool minusOne = false);
 
@@ -40,11 +114,12 @@ public:
 
 private:
 
-    //! Create a length string like "4 + 3 + N3D*2" by adding successive length strings
-    static void addToLengthString(QString & totalLength, QString length);
+    //! Output the lengths to the length strings
+    void updateLengthStrings(void);
 
-    //! Determine if text is a number for our cases
-    static bool isNumber(const QString& text);
+    LengthExpression minLength;         //!< The minimum encoded length
+    LengthExpression maxLength;         //!< The maximum encoded length
+    LengthExpression nonDefaultLength;  //!< The maximum encoded length of everything except default fields
 
 };
 
@@ -340,32 +340,35 @@ QString EnumCreator::getMarkdown(QString outline, const QStringList& packetids)
 
 
 /*!
- * Replace any text that matches an enumeration name with the value of that enumeration
- * \param text is modified to replace names with numbers
- * \return a reference to text
+ * Add the names and values of the enumerators to a symbol table, which is
+ * used to replace enumerator names with numbers. An enumerator whose value
+ * is an expression that ProtoGen cannot resolve is left out, so its name is
+ * not replaced. Names already in the table keep their first definition.
+ * \param symbols receives the name and value of each enumerator
  */
-QString& EnumCreator::replaceEnumerationNameWithValue(QString& text) const
+void EnumCreator::addEnumeratorValues(QHash<QString, QString>& symbols) const
 {
     for(int i = 0; i < nameList.length(); i++)
     {
+        bool ok;
+
         // If we don't have a name there is no point
-        if(nameList.at(i).isEmpty())
+        if(nameList.at(i).isEmpty() || symbols.contains(nameList.at(i)))
             continue;
 
-        // If we don't have a value there is no point
-        if(valueList.at(i) == numberList.at(i))
+        // If the value is an unresolved expression there is no point
+        numberList.at(i).toLongLong(&ok);
+        if(!ok && (valueList.at(i) == numberList.at(i)))
             continue;
 
-        if(text.contains(nameList.at(i)))
-        {
-            text.replace(nameList.at(i), numberList.at(i));
-        }
+        // The value may refer to enumerators that are already known
+        QString number = numberList.at(i);
+        ProtocolParser::replaceEnumerationNameWithValue(number);
 
+        symbols.insert(nameList.at(i), number);
     }
 
-    return text;
-
-}// EnumCreator::replaceEnumerationNameWithValue
+}// EnumCreator::addEnumeratorValues
 
 
 /*!
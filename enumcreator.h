@@ -4,6 +4,7 @@
 #include <QString>
 #include <QStringList>
 #include <QDomElement>
+#include <QHash>
 
 class EnumCreator
 {
@@ -32,8 +33,8 @@ public:
     //! Return the header file output string
     QString getOutput(void) const {return output;}
 
-    //! Replace any text that matches an enumeration name with the value of that enumeration
-    QString& replaceEnumerationNameWithValue(QString& text) const;
+    //! Add the names and values of the enumerators to a symbol table
+    void addEnumeratorValues(QHash<QString, QString>& symbols) const;
 
     //! Return the minimum number of bits needed to encode the enumeration
     int getMinBitWidth(void) const {return minbitwidth;}
@@ -53,6 +53,8 @@ FieldCoding::FieldCoding(ProtocolSupport sup) :
  */
 bool FieldCoding::generate(void)
 {
+    recordHelperDependencies();
+
     if(generateEncodeHeader() && generateEncodeSource() && generateDecodeHeader() && generateDecodeSource())
         return true;
     else
@@ -60,6 +62,68 @@ bool FieldCoding::generate(void)
 }
 
 
+/*!
+ * Remember the helper functions that are called by the helper functions that
+ * the generated code calls, for example the float functions call the integer
+ * functions. This is repeated until no new function is found, so that every
+ * function a called function depends on is output.
+ */
+void FieldCoding::recordHelperDependencies(void)
+{
+    if(!support.minimalHelpers)
+        return;
+
+    QList<int> widths = getVarintWidths();
+    bool found = true;
+
+    while(found)
+    {
+        QString code;
+
+        for(int i = 0; i < typeNames.size(); i++)
+        {
+            for(int b = 0; b < 2; b++)
+            {
+                bool bigendian = (b == 0);
+
+                // No endian concerns if using only 1 byte
+                if(!bigendian && (typeSizes[i] == 1))
+                    continue;
+
+                if(isCalled(encodeSignature(i, bigendian)))
+                    code += fullEncodeFunction(i, bigendian);
+
+                if(isCalled(decodeSignature(i, bigendian)))
+                    code += fullDecodeFunction(i, bigendian);
+
+                if(hasArrayFunction(i) && isCalled(encodeArraySignature(i, bigendian)))
+                    code += fullEncodeArrayFunction(i, bigendian);
+
+                if(hasArrayFunction(i) && isCalled(decodeArraySignature(i, bigendian)))
+                    code += fullDecodeArrayFunction(i, bigendian);
+            }
+        }
+
+        // The signed variable length integers call the unsigned ones
+        for(int i = 0; i < widths.size(); i++)
+        {
+            for(int s = 0; s < 2; s++)
+            {
+                for(int d = 0; d < 2; d++)
+                {
+                    if(isCalled(varintSignature(widths.at(i), s == 1, false, d == 1)))
+                        code += varintFunction(widths.at(i), s == 1, false, d == 1);
+                }
+            }
+        }
+
+        found = ProtocolFile::recordHelperCalls(code);
+
+    }// while new functions are found
+
+}// FieldCoding::recordHelperDependencies
+
+
 /*!
  * Generate the header file for protocol array scaling
  * \return true if the file is generated.
@@ -110,26 +174,71 @@ bool FieldCoding::generateEncodeHeader(void)
 
     header.write("\n#include <stdint.h>\n");
 
-    header.write("\n\
+    if(support.inlineHelpers)
+    {
+        header.write("#include <string.h>\n");
+
+        if(support.specialFloat)
+            header.write("#include \"floatspecial.h\"\n");
+    }
+
+    // The packet code also uses the host byte order to copy native layouts
+    if(support.inlineHelpers || support.nativeLayout)
+        header.write(getHostEndianDefinitions());
+
+    if(isCalled("stringToBytes"))
+        header.write("\n\
     //! Encode a null terminated string on a byte stream\n\
     void stringToBytes(const char* string, uint8_t* bytes, int* index, int maxLength, int fixedLength);\n");
 
-    for(int i = 0; i < typeNames.size(); i++)
+    if(support.inlineHelpers)
     {
-        // big endian
-        header.write("\n");
-        header.write("//! " + briefEncodeComment(i, true) + "\n");
-        header.write(encodeSignature(i, true) + ";\n");
-
-        // little endian
-        if(typeSizes[i] != 1)
+        // The integer functions come first, because the float functions call them
+        generateInlineEncodeFunctions(false);
+        generateInlineEncodeFunctions(true);
+        header.write(getVarintFunctions(false, false));
+    }
+    else
+    {
+        for(int i = 0; i < typeNames.size(); i++)
         {
-            header.write("\n");
-            header.write("//! " + briefEncodeComment(i, false) + "\n");
-            header.write(encodeSignature(i, false) + ";\n");
-        }
+            // big endian
+            if(isCalled(encodeSignature(i, true)))
+            {
+                header.write("\n");
+                header.write("//! " + briefEncodeComment(i, true) + "\n");
+                header.write(encodeSignature(i, true) + ";\n");
+            }
 
-    }// for all output byte counts
+            // little endian
+            if((typeSizes[i] != 1) && isCalled(encodeSignature(i, false)))
+            {
+                header.write("\n");
+                header.write("//! " + briefEncodeComment(i, false) + "\n");
+                header.write(encodeSignature(i, false) + ";\n");
+            }
+
+            if(hasArrayFunction(i))
+            {
+                if(isCalled(encodeArraySignature(i, true)))
+                {
+                    header.write("\n");
+                    header.write("//! " + briefEncodeArrayComment(i, true) + "\n");
+                    header.write(encodeArraySignature(i, true) + ";\n");
+                }
+
+                if((typeSizes[i] != 1) && isCalled(encodeArraySignature(i, false)))
+                {
+                    header.write("\n");
+                    header.write("//! " + briefEncodeArrayComment(i, false) + "\n");
+                    header.write(encodeArraySignature(i, false) + ";\n");
+                }
+            }
+
+        }// for all output byte counts
+
+        header.write(getVarintFunctions(false, true));
+    }
 
     header.write("\n");
 
@@ -156,7 +265,8 @@ bool FieldCoding::generateEncodeSource(void)
     source.write("\n\n");
 
     // The string function, this was hand-written and pasted in here
-    source.write("\
+    if(isCalled("stringToBytes"))
+        source.write("\
 /*!\n\
 * Encode a null terminated string on a byte stream\n\
 * \\param string is the null termianted string to encode\n\
@@ -201,23 +311,48 @@ void stringToBytes(const char* string, uint8_t* bytes, int* index, int maxLength
 }// stringToBytes\n");
 
 
-    for(int i = 0; i < typeNames.size(); i++)
+    // Inline functions are in the header
+    for(int i = 0; (i < typeNames.size()) && !support.inlineHelpers; i++)
     {
         // big endian
-        source.write("\n");
-        source.write(fullEncodeComment(i, true) + "\n");
-        source.write(fullEncodeFunction(i, true) + "\n");
+        if(isCalled(encodeSignature(i, true)))
+        {
+            source.write("\n");
+            source.write(fullEncodeComment(i, true) + "\n");
+            source.write(fullEncodeFunction(i, true) + "\n");
+        }
 
         // little endian
-        if(typeSizes[i] != 1)
+        if((typeSizes[i] != 1) && isCalled(encodeSignature(i, false)))
         {
             source.write("\n");
             source.write(fullEncodeComment(i, false) + "\n");
             source.write(fullEncodeFunction(i, false) + "\n");
         }
 
+        if(hasArrayFunction(i))
+        {
+            if(isCalled(encodeArraySignature(i, true)))
+            {
+                source.write("\n");
+                source.write(fullEncodeArrayComment(i, true) + "\n");
+                source.write(fullEncodeArrayFunction(i, true) + "\n");
+            }
+
+            if((typeSizes[i] != 1) && isCalled(encodeArraySignature(i, false)))
+            {
+                source.write("\n");
+                source.write(fullEncodeArrayComment(i, false) + "\n");
+                source.write(fullEncodeArrayFunction(i, false) + "\n");
+            }
+        }
+
     }
 
+    // The variable length integers
+    if(!support.inlineHelpers)
+        source.write(getVarintFunctions(false, false));
+
     source.write("\n");
 
     return source.flush();
@@ -259,6 +394,159 @@ QString FieldCoding::getReadableTypeName(int type)
 }// FieldCoding::getReadableTypeName
 
 
+/*!
+ * Get the preprocessor code that detects the byte order of the host at
+ * compile time. If the byte order is known the inline coding functions use
+ * memcpy and a byte swap builtin, otherwise they use the portable shifts.
+ * \return The preprocessor code, including linefeeds
+ */
+QString FieldCoding::getHostEndianDefinitions(void)
+{
+    return QString("\n\
+// The host byte order selects the memcpy fast path. Define one of these\n\
+// before including this file to select it manually, this requires the\n\
+// __builtin_bswap16/32/64 functions provided by gcc and clang.\n\
+#if !defined(FIELDCODING_BIG_ENDIAN_HOST) && !defined(FIELDCODING_LITTLE_ENDIAN_HOST)\n\
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)\n\
+#define FIELDCODING_BIG_ENDIAN_HOST\n\
+#elif defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)\n\
+#define FIELDCODING_LITTLE_ENDIAN_HOST\n\
+#endif\n\
+#endif\n");
+
+}// FieldCoding::getHostEndianDefinitions
+
+
+/*!
+ * Write the static inline encode functions to the header file
+ * \param floats should be true to write the floating point functions, else
+ *        the integer functions are written.
+ */
+void FieldCoding::generateInlineEncodeFunctions(bool floats)
+{
+    for(int i = 0; i < typeNames.size(); i++)
+    {
+        if(typeSigNames[i].contains("float") != floats)
+            continue;
+
+        // big endian
+        if(isCalled(encodeSignature(i, true)))
+        {
+            header.write("\n");
+            header.write(fullEncodeComment(i, true) + "\n");
+            header.write("static inline " + fullEncodeFunction(i, true));
+        }
+
+        // little endian
+        if((typeSizes[i] != 1) && isCalled(encodeSignature(i, false)))
+        {
+            header.write("\n");
+            header.write(fullEncodeComment(i, false) + "\n");
+            header.write("static inline " + fullEncodeFunction(i, false));
+        }
+
+        if(hasArrayFunction(i))
+        {
+            if(isCalled(encodeArraySignature(i, true)))
+            {
+                header.write("\n");
+                header.write(fullEncodeArrayComment(i, true) + "\n");
+                header.write("static inline " + fullEncodeArrayFunction(i, true));
+            }
+
+            if((typeSizes[i] != 1) && isCalled(encodeArraySignature(i, false)))
+            {
+                header.write("\n");
+                header.write(fullEncodeArrayComment(i, false) + "\n");
+                header.write("static inline " + fullEncodeArrayFunction(i, false));
+            }
+        }
+
+    }// for all output byte counts
+
+}// FieldCoding::generateInlineEncodeFunctions
+
+
+/*!
+ * Write the static inline decode functions to the header file
+ * \param floats should be true to write the floating point functions, else
+ *        the integer functions are written.
+ */
+void FieldCoding::generateInlineDecodeFunctions(bool floats)
+{
+    for(int type = 0; type < typeNames.size(); type++)
+    {
+        if(typeSigNames[type].contains("float") != floats)
+            continue;
+
+        // big endian
+        if(isCalled(decodeSignature(type, true)))
+        {
+            header.write("\n");
+            header.write(fullDecodeComment(type, true) + "\n");
+            header.write("static inline " + fullDecodeFunction(type, true));
+        }
+
+        // little endian
+        if((typeSizes[type] != 1) && isCalled(decodeSignature(type, false)))
+        {
+            header.write("\n");
+            header.write(fullDecodeComment(type, false) + "\n");
+            header.write("static inline " + fullDecodeFunction(type, false));
+        }
+
+        if(hasArrayFunction(type))
+        {
+            if(isCalled(decodeArraySignature(type, true)))
+            {
+                header.write("\n");
+                header.write(fullDecodeArrayComment(type, true) + "\n");
+                header.write("static inline " + fullDecodeArrayFunction(type, true));
+            }
+
+            if((typeSizes[type] != 1) && isCalled(decodeArraySignature(type, false)))
+            {
+                header.write("\n");
+                header.write(fullDecodeArrayComment(type, false) + "\n");
+                header.write("static inline " + fullDecodeArrayFunction(type, false));
+            }
+        }
+
+    }// for all input types
+
+}// FieldCoding::generateInlineDecodeFunctions
+
+
+/*!
+ * Determine if the native byte order fast path can be used for a type. This
+ * is only true for inline functions of standard integer sizes.
+ * \param type is the enumerator for the type.
+ * \return true if the fast path should be emitted
+ */
+bool FieldCoding::hasNativeFastPath(int type)
+{
+    if(!support.inlineHelpers)
+        return false;
+
+    return ((typeSizes[type] == 2) || (typeSizes[type] == 4) || (typeSizes[type] == 8));
+}
+
+
+/*!
+ * Get the name of the host byte order macro for which the bytes of a type
+ * must be swapped to match the byte order of the stream.
+ * \param bigendian should be true if the byte stream is big endian.
+ * \return the macro name
+ */
+QString FieldCoding::getSwapHostMacro(bool bigendian)
+{
+    if(bigendian)
+        return QString("FIELDCODING_LITTLE_ENDIAN_HOST");
+    else
+        return QString("FIELDCODING_BIG_ENDIAN_HOST");
+}
+
+
 /*!
  * Create the brief function comment, without doxygen decorations
  * \param type is the enumerator for the type.
@@ -417,6 +705,23 @@ QString FieldCoding::integerEncodeFunction(int type, bool bigendian)
         function += "    bytes[(*index)++] = (uint8_t)(number);\n";
     else
     {
+        if(hasNativeFastPath(type))
+        {
+            QString bits = QString().setNum(8*typeSizes[type]);
+
+            function += "#if defined(FIELDCODING_BIG_ENDIAN_HOST) || defined(FIELDCODING_LITTLE_ENDIAN_HOST)\n";
+            function += "    uint" + bits + "_t raw = (uint" + bits + "_t)number;\n";
+            function += "\n";
+            function += "#ifdef " + getSwapHostMacro(bigendian) + "\n";
+            function += "    raw = __builtin_bswap" + bits + "(raw);\n";
+            function += "#endif\n";
+            function += "\n";
+            function += "    // memcpy handles any alignment, and is typically a single store\n";
+            function += "    memcpy(bytes + (*index), &raw, " + QString().setNum(typeSizes[type]) + ");\n";
+            function += "    (*index) += " + QString().setNum(typeSizes[type]) + ";\n";
+            function += "#else\n";
+        }
+
         function += "    // increment byte pointer for starting point\n";
 
         QString opt;
@@ -449,6 +754,9 @@ QString FieldCoding::integerEncodeFunction(int type, bool bigendian)
         // Update the index value to the user
         function += "    (*index) += " + QString().setNum(typeSizes[type]) + ";\n";
 
+        if(hasNativeFastPath(type))
+            function += "#endif\n";
+
     }// if multi-byte fields
 
     function += "}\n";
@@ -458,6 +766,191 @@ QString FieldCoding::integerEncodeFunction(int type, bool bigendian)
 }// FieldCoding::integerEncodeFunction
 
 
+/*!
+ * Determine if the array functions are output for a type.
+ * \param type is the enumerator for the type.
+ * \return true if the array functions should be emitted
+ */
+bool FieldCoding::hasArrayFunction(int type)
+{
+    return support.arrayHelpers;
+}
+
+
+/*!
+ * Determine if a type is one of the special float types (float16 or float24)
+ * which are converted by floatspecial.
+ * \param type is the enumerator for the type.
+ * \return true for float16 and float24
+ */
+bool FieldCoding::isSpecialFloat(int type)
+{
+    return ((typeSigNames[type] == "float24") || (typeSigNames[type] == "float16"));
+}
+
+
+/*!
+ * Create the brief array encode function comment, without doxygen decorations
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \return The string that represents the one line function comment.
+ */
+QString FieldCoding::briefEncodeArrayComment(int type, bool bigendian)
+{
+    return briefEncodeComment(type, bigendian).replace("Encode a ", "Encode an array of ");
+}
+
+
+/*!
+ * Create the full array encode function comment, with doxygen decorations
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \return The string that represents the full multi-line function comment.
+ */
+QString FieldCoding::fullEncodeArrayComment(int type, bool bigendian)
+{
+    QString comment = "/*!\n";
+
+    comment += ProtocolParser::outputLongComment(" *", briefEncodeArrayComment(type, bigendian)) + "\n";
+    comment += " * \\param value points to the array of numbers to encode.\n";
+    comment += " * \\param count is the number of elements in the array.\n";
+    comment += " * \\param bytes is a pointer to the byte stream which receives the encoded data.\n";
+    comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+    comment += " *        will be incremented by " + QString().setNum(typeSizes[type]) + "*count when this function is complete.\n";
+    comment += " */";
+
+    return comment;
+}
+
+
+/*!
+ * Create the one line array encode function signature, without a trailing semicolon
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \return The string that represents the function signature, without a trailing semicolon
+ */
+QString FieldCoding::encodeArraySignature(int type, bool bigendian)
+{
+    QString endian;
+
+    // No endian concerns if using only 1 byte
+    if(typeSizes[type] > 1)
+    {
+        if(bigendian)
+            endian = "Be";
+        else
+            endian = "Le";
+    }
+
+    return QString("void " + typeSigNames[type] + "ArrayTo" + endian + "Bytes(const " + typeNames[type] + "* value, int count, uint8_t* bytes, int* index)");
+
+}// FieldCoding::encodeArraySignature
+
+
+/*!
+ * Generate the full array encode function output, excluding the comment.
+ * Each element is stored at a constant offset, without function calls, so
+ * that compilers can vectorize the loop.
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \return the function as a string
+ */
+QString FieldCoding::fullEncodeArrayFunction(int type, bool bigendian)
+{
+    QString numberType = getEncodedTypeString(typeSizes[type], true);
+
+    if(isSpecialFloat(type))
+        return specialFloatEncodeArrayFunction(type, bigendian);
+
+    QString function = encodeArraySignature(type, bigendian) + "\n";
+    function += "{\n";
+    function += "    int i;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(i = 0; i < count; i++)\n";
+    function += "    {\n";
+
+    if(typeSigNames[type].contains("float"))
+    {
+        function += "        union\n";
+        function += "        {\n";
+        function += "            " + typeNames[type] + " floatValue;\n";
+        function += "            " + numberType + " integerValue;\n";
+        function += "        }field;\n";
+        function += "        " + numberType + " number;\n";
+        function += "\n";
+        function += "        field.floatValue = value[i];\n";
+        function += "        number = field.integerValue;\n";
+    }
+    else
+        function += "        " + numberType + " number = (" + numberType + ")value[i];\n";
+
+    function += "\n";
+    function += arrayElementStoreString(typeSizes[type], bigendian, "        ");
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + QString().setNum(typeSizes[type]) + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::fullEncodeArrayFunction
+
+
+/*!
+ * Generate the full array encode function output, excluding the comment, for
+ * the special float types. The values are converted in blocks by the
+ * floatspecial array functions, and each block is then stored like an
+ * integer array, so both loops can be vectorized.
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \return the function as a string
+ */
+QString FieldCoding::specialFloatEncodeArrayFunction(int type, bool bigendian)
+{
+    QString numberType = getEncodedTypeString(typeSizes[type], true);
+    QString size = QString().setNum(typeSizes[type]);
+    QString conversion;
+
+    if(typeSizes[type] == 3)
+        conversion = "float32ArrayToFloat24";
+    else
+        conversion = "float32ArrayToFloat16";
+
+    QString function = encodeArraySignature(type, bigendian) + "\n";
+    function += "{\n";
+    function += "    " + numberType + " block[64];\n";
+    function += "    int i, j, n;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(j = 0; j < count; j += n)\n";
+    function += "    {\n";
+    function += "        n = ((count - j) < 64) ? (count - j) : 64;\n";
+    function += "\n";
+    function += "        " + conversion + "(value + j, block, n);\n";
+    function += "\n";
+    function += "        for(i = 0; i < n; i++)\n";
+    function += "        {\n";
+    function += "            " + numberType + " number = block[i];\n";
+    function += "\n";
+    function += arrayElementStoreString(typeSizes[type], bigendian, "            ");
+    function += "        }\n";
+    function += "\n";
+    function += "        bytes += " + size + "*n;\n";
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + size + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::specialFloatEncodeArrayFunction
+
+
 /*!
  * Generate the header file for protocols caling
  * \return true if the file is generated.
@@ -510,24 +1003,69 @@ bool FieldCoding::generateDecodeHeader(void)
 
     header.write("\n#include <stdint.h>\n");
 
-    header.write("\n\
-    //! Decode a null terminated string from a byte stream\n\
-    void stringFromBytes(char* string, const uint8_t* bytes, int* index, int maxLength, int fixedLength);\n");
-
-    for(int type = 0; type < typeNames.size(); type++)
+    if(support.inlineHelpers)
     {
-        header.write("\n");
-        header.write("//! " + briefDecodeComment(type, true) + "\n");
-        header.write(decodeSignature(type, true) + ";\n");
+        header.write("#include <string.h>\n");
 
-        if(typeSizes[type] != 1)
-        {
-            header.write("\n");
-            header.write("//! " + briefDecodeComment(type, false) + "\n");
-            header.write(decodeSignature(type, false) + ";\n");
-        }
+        if(support.specialFloat)
+            header.write("#include \"floatspecial.h\"\n");
+    }
 
-    }// for all input types
+    // The packet code also uses the host byte order to copy native layouts
+    if(support.inlineHelpers || support.nativeLayout)
+        header.write(getHostEndianDefinitions());
+
+    if(isCalled("stringFromBytes"))
+        header.write("\n\
+    //! Decode a null terminated string from a byte stream\n\
+    void stringFromBytes(char* string, const uint8_t* bytes, int* index, int maxLength, int fixedLength);\n");
+
+    if(support.inlineHelpers)
+    {
+        // The integer functions come first, because the float functions call them
+        generateInlineDecodeFunctions(false);
+        generateInlineDecodeFunctions(true);
+        header.write(getVarintFunctions(true, false));
+    }
+    else
+    {
+        for(int type = 0; type < typeNames.size(); type++)
+        {
+            if(isCalled(decodeSignature(type, true)))
+            {
+                header.write("\n");
+                header.write("//! " + briefDecodeComment(type, true) + "\n");
+                header.write(decodeSignature(type, true) + ";\n");
+            }
+
+            if((typeSizes[type] != 1) && isCalled(decodeSignature(type, false)))
+            {
+                header.write("\n");
+                header.write("//! " + briefDecodeComment(type, false) + "\n");
+                header.write(decodeSignature(type, false) + ";\n");
+            }
+
+            if(hasArrayFunction(type))
+            {
+                if(isCalled(decodeArraySignature(type, true)))
+                {
+                    header.write("\n");
+                    header.write("//! " + briefDecodeArrayComment(type, true) + "\n");
+                    header.write(decodeArraySignature(type, true) + ";\n");
+                }
+
+                if((typeSizes[type] != 1) && isCalled(decodeArraySignature(type, false)))
+                {
+                    header.write("\n");
+                    header.write("//! " + briefDecodeArrayComment(type, false) + "\n");
+                    header.write(decodeArraySignature(type, false) + ";\n");
+                }
+            }
+
+        }// for all input types
+
+        header.write(getVarintFunctions(true, true));
+    }
 
     header.write("\n");
 
@@ -553,7 +1091,8 @@ bool FieldCoding::generateDecodeSource(void)
 
     source.write("\n\n");
 
-    source.write("\
+    if(isCalled("stringFromBytes"))
+        source.write("\
 /*!\n\
  * Decode a null terminated string from a byte stream\n\
  * \\param string receives the deocded null-terminated string.\n\
@@ -591,23 +1130,48 @@ void stringFromBytes(char* string, const uint8_t* bytes, int* index, int maxLeng
 \n\
 }// stringFromBytes\n");
 
-    for(int type = 0; type < typeNames.size(); type++)
+    // Inline functions are in the header
+    for(int type = 0; (type < typeNames.size()) && !support.inlineHelpers; type++)
     {
         // big endian unsigned
-        source.write("\n");
-        source.write(fullDecodeComment(type, true) + "\n");
-        source.write(fullDecodeFunction(type, true) + "\n");
+        if(isCalled(decodeSignature(type, true)))
+        {
+            source.write("\n");
+            source.write(fullDecodeComment(type, true) + "\n");
+            source.write(fullDecodeFunction(type, true) + "\n");
+        }
 
         // little endian unsigned
-        if(typeSizes[type] != 1)
+        if((typeSizes[type] != 1) && isCalled(decodeSignature(type, false)))
         {
             source.write("\n");
             source.write(fullDecodeComment(type, false) + "\n");
             source.write(fullDecodeFunction(type, false) + "\n");
         }
 
+        if(hasArrayFunction(type))
+        {
+            if(isCalled(decodeArraySignature(type, true)))
+            {
+                source.write("\n");
+                source.write(fullDecodeArrayComment(type, true) + "\n");
+                source.write(fullDecodeArrayFunction(type, true) + "\n");
+            }
+
+            if((typeSizes[type] != 1) && isCalled(decodeArraySignature(type, false)))
+            {
+                source.write("\n");
+                source.write(fullDecodeArrayComment(type, false) + "\n");
+                source.write(fullDecodeArrayFunction(type, false) + "\n");
+            }
+        }
+
     }// for all input types
 
+    // The variable length integers
+    if(!support.inlineHelpers)
+        source.write(getVarintFunctions(true, false));
+
     source.write("\n");
 
     return source.flush();
@@ -788,6 +1352,25 @@ QString FieldCoding::integerDecodeFunction(int type, bool bigendian)
         bool signextend = false;
         QString variable;
 
+        if(hasNativeFastPath(type))
+        {
+            QString bits = QString().setNum(8*typeSizes[type]);
+
+            function += "#if defined(FIELDCODING_BIG_ENDIAN_HOST) || defined(FIELDCODING_LITTLE_ENDIAN_HOST)\n";
+            function += "    uint" + bits + "_t raw;\n";
+            function += "\n";
+            function += "    // memcpy handles any alignment, and is typically a single load\n";
+            function += "    memcpy(&raw, bytes + (*index), " + QString().setNum(typeSizes[type]) + ");\n";
+            function += "    (*index) += " + QString().setNum(typeSizes[type]) + ";\n";
+            function += "\n";
+            function += "#ifdef " + getSwapHostMacro(bigendian) + "\n";
+            function += "    raw = __builtin_bswap" + bits + "(raw);\n";
+            function += "#endif\n";
+            function += "\n";
+            function += "    return (" + typeNames[type] + ")raw;\n";
+            function += "#else\n";
+        }
+
         // We have to perform sign extension for signed types that are nonstandard lengths
         if(typeUnsigneds[type] == false)
             if((typeSizes[type] == 7) || (typeSizes[type] == 6) || (typeSizes[type] == 5) || (typeSizes[type] == 3))
@@ -859,6 +1442,9 @@ QString FieldCoding::integerDecodeFunction(int type, bool bigendian)
         function += "\n";
         function += "    return " + variable + ";\n";
 
+        if(hasNativeFastPath(type))
+            function += "#endif\n";
+
     }// if multi-byte fields
 
     function += "}\n";
@@ -867,3 +1453,565 @@ QString FieldCoding::integerDecodeFunction(int type, bool bigendian)
 
 }// FieldCoding::integerDecodeFunction
 
+
+/*!
+ * Create the brief array decode function comment, without doxygen decorations
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \return The string that represents the one line function comment.
+ */
+QString FieldCoding::briefDecodeArrayComment(int type, bool bigendian)
+{
+    return briefDecodeComment(type, bigendian).replace("Decode a ", "Decode an array of ");
+}
+
+
+/*!
+ * Create the full array decode function comment, with doxygen decorations
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \return The string that represents the full multi-line function comment.
+ */
+QString FieldCoding::fullDecodeArrayComment(int type, bool bigendian)
+{
+    QString comment= ("/*!\n");
+
+    comment += ProtocolParser::outputLongComment(" *", briefDecodeArrayComment(type, bigendian)) + "\n";
+    comment += " * \\param value receives the array of decoded numbers.\n";
+    comment += " * \\param count is the number of elements in the array.\n";
+    comment += " * \\param bytes is a pointer to the byte stream which contains the encoded data.\n";
+    comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+    comment += " *        will be incremented by " + QString().setNum(typeSizes[type]) + "*count when this function is complete.\n";
+    comment += " */";
+
+    return comment;
+}
+
+
+/*!
+ * Create the one line array decode function signature, without a trailing semicolon
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \return The string that represents the function signature, without a trailing semicolon
+ */
+QString FieldCoding::decodeArraySignature(int type, bool bigendian)
+{
+    QString endian;
+
+    // No endian concerns if using only 1 byte
+    if(typeSizes[type] > 1)
+    {
+        if(bigendian)
+            endian = "Be";
+        else
+            endian = "Le";
+    }
+
+    return QString("void " + typeSigNames[type] + "ArrayFrom" + endian + "Bytes(" + typeNames[type] + "* value, int count, const uint8_t* bytes, int* index)");
+
+}// FieldCoding::decodeArraySignature
+
+
+/*!
+ * Generate the full array decode function output, excluding the comment.
+ * Each element is loaded from a constant offset, without function calls, so
+ * that compilers can vectorize the loop.
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \return the function as a string
+ */
+QString FieldCoding::fullDecodeArrayFunction(int type, bool bigendian)
+{
+    QString numberType = getEncodedTypeString(typeSizes[type], true);
+
+    if(isSpecialFloat(type))
+        return specialFloatDecodeArrayFunction(type, bigendian);
+
+    QString function = decodeArraySignature(type, bigendian) + "\n";
+    function += "{\n";
+    function += "    int i;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(i = 0; i < count; i++)\n";
+    function += "    {\n";
+
+    if(typeSigNames[type].contains("float"))
+    {
+        function += "        union\n";
+        function += "        {\n";
+        function += "            " + typeNames[type] + " floatValue;\n";
+        function += "            " + numberType + " integerValue;\n";
+        function += "        }field;\n";
+        function += "\n";
+        function += "        field.integerValue = " + arrayElementLoadString(typeSizes[type], bigendian) + ";\n";
+
+        if(support.specialFloat)
+        {
+            if(typeSizes[type] == 8)
+                function += "        value[i] = isFloat64Valid(field.integerValue) ? field.floatValue : 0;\n";
+            else
+                function += "        value[i] = isFloat32Valid(field.integerValue) ? field.floatValue : 0;\n";
+        }
+        else
+            function += "        value[i] = field.floatValue;\n";
+    }
+    else
+    {
+        function += "        " + numberType + " raw = " + arrayElementLoadString(typeSizes[type], bigendian) + ";\n";
+
+        if(typeUnsigneds[type])
+            function += "        value[i] = raw;\n";
+        else
+            function += "        value[i] = " + arraySignExtendString(typeSizes[type]) + ";\n";
+    }
+
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + QString().setNum(typeSizes[type]) + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::fullDecodeArrayFunction
+
+
+/*!
+ * Generate the full array decode function output, excluding the comment, for
+ * the special float types. Each block of values is loaded like an integer
+ * array, and then converted by the floatspecial array functions, so both
+ * loops can be vectorized.
+ * \param type is the enumerator for the type.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \return the function as a string
+ */
+QString FieldCoding::specialFloatDecodeArrayFunction(int type, bool bigendian)
+{
+    QString numberType = getEncodedTypeString(typeSizes[type], true);
+    QString size = QString().setNum(typeSizes[type]);
+
+    QString function = decodeArraySignature(type, bigendian) + "\n";
+    function += "{\n";
+    function += "    " + numberType + " block[64];\n";
+    function += "    int i, j, n;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(j = 0; j < count; j += n)\n";
+    function += "    {\n";
+    function += "        n = ((count - j) < 64) ? (count - j) : 64;\n";
+    function += "\n";
+    function += "        for(i = 0; i < n; i++)\n";
+    function += "            block[i] = " + arrayElementLoadString(typeSizes[type], bigendian) + ";\n";
+    function += "\n";
+    function += "        " + typeSigNames[type] + "ArrayToFloat32(block, value + j, n);\n";
+    function += "\n";
+    function += "        bytes += " + size + "*n;\n";
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + size + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::specialFloatDecodeArrayFunction
+
+
+
+/*!
+ * Get the bit widths of the variable length integer functions. Smaller
+ * integers use the 32 bit functions.
+ * \return the list of widths, 32 and (if supported) 64
+ */
+QList<int> FieldCoding::getVarintWidths(void)
+{
+    QList<int> widths;
+
+    widths << 32;
+
+    if(support.int64)
+        widths << 64;
+
+    return widths;
+}
+
+
+/*!
+ * Create the one line brief comment of a variable length integer function,
+ * without doxygen decorations
+ * \param bits is the width of the integer in memory, 32 or 64.
+ * \param isSigned should be true for a zigzag encoded signed integer.
+ * \param isArray should be true for the function that codes an array.
+ * \param decode should be true for the decode function.
+ * \return The string that represents the one line function comment.
+ */
+QString FieldCoding::briefVarintComment(int bits, bool isSigned, bool isArray, bool decode)
+{
+    QString name;
+
+    if(isSigned)
+        name = "signed " + QString().setNum(bits) + " bit integer, zigzag and LEB128 encoded";
+    else
+        name = "unsigned " + QString().setNum(bits) + " bit integer, LEB128 encoded";
+
+    if(decode)
+    {
+        if(isArray)
+            return QString("Decode an array of " + name + ", from a byte stream.");
+        else
+            return QString("Decode a " + name + ", from a byte stream.");
+    }
+    else
+    {
+        if(isArray)
+            return QString("Encode an array of " + name + ", on a byte stream.");
+        else
+            return QString("Encode a " + name + ", on a byte stream.");
+    }
+
+}// FieldCoding::briefVarintComment
+
+
+/*!
+ * Create the full comment of a variable length integer function, with
+ * doxygen decorations
+ * \param bits is the width of the integer in memory, 32 or 64.
+ * \param isSigned should be true for a zigzag encoded signed integer.
+ * \param isArray should be true for the function that codes an array.
+ * \param decode should be true for the decode function.
+ * \return The string that represents the full multi-line function comment.
+ */
+QString FieldCoding::fullVarintComment(int bits, bool isSigned, bool isArray, bool decode)
+{
+    QString comment = "/*!\n";
+
+    comment += ProtocolParser::outputLongComment(" *", briefVarintComment(bits, isSigned, isArray, decode)) + "\n";
+    comment += " *\n";
+    comment += " * Each byte carries seven bits of the number, least significant first, and\n";
+    comment += " * the most significant bit of a byte is set if another byte follows.\n";
+
+    if(isSigned)
+    {
+        comment += " * Signed numbers are first mapped to unsigned numbers by zigzag encoding\n";
+        comment += " * (0, -1, 1, -2, ... become 0, 1, 2, 3, ...) so that small magnitudes of\n";
+        comment += " * either sign use few bytes.\n";
+    }
+
+    if(decode)
+    {
+        if(isArray)
+        {
+            comment += " * \\param value receives the decoded numbers.\n";
+            comment += " * \\param count is the number of numbers to decode.\n";
+        }
+
+        comment += " * \\param bytes is a pointer to the byte stream to decode.\n";
+        comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+        comment += " *        will be incremented by the number of bytes decoded when this\n";
+        comment += " *        function is complete.\n";
+        comment += " * \\param maxBytes is the most bytes decoded for one number, so that a\n";
+        comment += " *        number which is not terminated cannot run past the space it was\n";
+        comment += " *        given in the byte stream.\n";
+
+        if(!isArray)
+            comment += " * \\return the decoded number\n";
+    }
+    else
+    {
+        if(isArray)
+        {
+            comment += " * \\param value is the array of numbers to encode.\n";
+            comment += " * \\param count is the number of numbers to encode.\n";
+        }
+        else
+            comment += " * \\param number is the value to encode.\n";
+
+        comment += " * \\param bytes is a pointer to the byte stream which receives the encoded data.\n";
+        comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+        comment += " *        will be incremented by the number of bytes encoded when this\n";
+        comment += " *        function is complete.\n";
+    }
+
+    comment += " */";
+
+    return comment;
+
+}// FieldCoding::fullVarintComment
+
+
+/*!
+ * Create the one line signature of a variable length integer function,
+ * without a trailing semicolon
+ * \param bits is the width of the integer in memory, 32 or 64.
+ * \param isSigned should be true for a zigzag encoded signed integer.
+ * \param isArray should be true for the function that codes an array.
+ * \param decode should be true for the decode function.
+ * \return The string that represents the function signature
+ */
+QString FieldCoding::varintSignature(int bits, bool isSigned, bool isArray, bool decode)
+{
+    QString width = QString().setNum(bits);
+    QString type = QString(isSigned ? "int" : "uint") + width + "_t";
+    QString name = QString(isSigned ? "varint" : "varuint") + width;
+
+    if(decode)
+    {
+        if(isArray)
+            return QString("void " + name + "ArrayFromBytes(" + type + "* value, int count, const uint8_t* bytes, int* index, int maxBytes)");
+        else
+            return QString(type + " " + name + "FromBytes(const uint8_t* bytes, int* index, int maxBytes)");
+    }
+    else
+    {
+        if(isArray)
+            return QString("void " + name + "ArrayToBytes(const " + type + "* value, int count, uint8_t* bytes, int* index)");
+        else
+            return QString("void " + name + "ToBytes(" + type + " number, uint8_t* bytes, int* index)");
+    }
+
+}// FieldCoding::varintSignature
+
+
+/*!
+ * Generate a variable length integer function, excluding the comment. The
+ * signed functions map the number with zigzag encoding, and the array
+ * functions code every element in one loop, with a shortcut for the single
+ * byte numbers that are the point of the encoding.
+ * \param bits is the width of the integer in memory, 32 or 64.
+ * \param isSigned should be true for a zigzag encoded signed integer.
+ * \param isArray should be true for the function that codes an array.
+ * \param decode should be true for the decode function.
+ * \return the function as a string
+ */
+QString FieldCoding::varintFunction(int bits, bool isSigned, bool isArray, bool decode)
+{
+    QString width = QString().setNum(bits);
+    QString utype = "uint" + width + "_t";
+    QString stype = "int" + width + "_t";
+    QString function = varintSignature(bits, isSigned, isArray, decode) + "\n";
+
+    function += "{\n";
+
+    if(decode)
+    {
+        if(isArray)
+        {
+            function += "    int i, n, j = (*index);\n";
+            function += "\n";
+            function += "    for(i = 0; i < count; i++)\n";
+            function += "    {\n";
+            function += "        " + utype + " number = bytes[j] & 0x7F;\n";
+            function += "\n";
+            function += "        // Most numbers are a single byte\n";
+            function += "        for(n = 1; (bytes[j++] & 0x80) && (n < maxBytes); n++)\n";
+            function += "        {\n";
+            function += "            if(7*n < " + width + ")\n";
+            function += "                number |= (" + utype + ")(bytes[j] & 0x7F) << (7*n);\n";
+            function += "        }\n";
+            function += "\n";
+
+            if(isSigned)
+                function += "        value[i] = (" + stype + ")(number >> 1) ^ -(" + stype + ")(number & 1);\n";
+            else
+                function += "        value[i] = number;\n";
+
+            function += "    }\n";
+            function += "\n";
+            function += "    (*index) = j;\n";
+        }
+        else if(isSigned)
+        {
+            function += "    " + utype + " number = varuint" + width + "FromBytes(bytes, index, maxBytes);\n";
+            function += "\n";
+            function += "    // Undo the zigzag mapping\n";
+            function += "    return (" + stype + ")(number >> 1) ^ -(" + stype + ")(number & 1);\n";
+        }
+        else
+        {
+            function += "    " + utype + " number = 0;\n";
+            function += "    int n = 0;\n";
+            function += "    uint8_t byte;\n";
+            function += "\n";
+            function += "    // increment byte pointer for starting point\n";
+            function += "    bytes += (*index);\n";
+            function += "\n";
+            function += "    do\n";
+            function += "    {\n";
+            function += "        byte = bytes[n];\n";
+            function += "\n";
+            function += "        if(7*n < " + width + ")\n";
+            function += "            number |= (" + utype + ")(byte & 0x7F) << (7*n);\n";
+            function += "\n";
+            function += "        n++;\n";
+            function += "\n";
+            function += "    }while((byte & 0x80) && (n < maxBytes));\n";
+            function += "\n";
+            function += "    (*index) += n;\n";
+            function += "\n";
+            function += "    return number;\n";
+        }
+    }
+    else
+    {
+        if(isArray)
+        {
+            function += "    int i, j = (*index);\n";
+            function += "\n";
+            function += "    for(i = 0; i < count; i++)\n";
+            function += "    {\n";
+
+            if(isSigned)
+                function += "        " + utype + " number = ((" + utype + ")value[i] << 1) ^ (0 - ((" + utype + ")value[i] >> " + QString().setNum(bits - 1) + "));\n";
+            else
+                function += "        " + utype + " number = value[i];\n";
+
+            function += "\n";
+            function += "        while(number >= 0x80)\n";
+            function += "        {\n";
+            function += "            bytes[j++] = (uint8_t)(number | 0x80);\n";
+            function += "            number = number >> 7;\n";
+            function += "        }\n";
+            function += "\n";
+            function += "        bytes[j++] = (uint8_t)number;\n";
+            function += "    }\n";
+            function += "\n";
+            function += "    (*index) = j;\n";
+        }
+        else if(isSigned)
+        {
+            function += "    // Zigzag mapping, computed without shifting a negative number\n";
+            function += "    varuint" + width + "ToBytes(((" + utype + ")number << 1) ^ (0 - ((" + utype + ")number >> " + QString().setNum(bits - 1) + ")), bytes, index);\n";
+        }
+        else
+        {
+            function += "    // increment byte pointer for starting point\n";
+            function += "    bytes += (*index);\n";
+            function += "\n";
+            function += "    while(number >= 0x80)\n";
+            function += "    {\n";
+            function += "        *(bytes++) = (uint8_t)(number | 0x80);\n";
+            function += "        number = number >> 7;\n";
+            function += "        (*index)++;\n";
+            function += "    }\n";
+            function += "\n";
+            function += "    *bytes = (uint8_t)number;\n";
+            function += "    (*index)++;\n";
+        }
+    }
+
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::varintFunction
+
+
+/*!
+ * Generate the function that measures variable length integers in a byte
+ * stream, including its comment. The packet decode functions use it to
+ * check the data length before decoding variable length integers.
+ * \param declaration should be true to output the brief comment and
+ *        the prototype, rather than the function.
+ * \return the function as a string
+ */
+QString FieldCoding::varintLengthFunction(bool declaration)
+{
+    QString signature = "int varintLengthFromBytes(const uint8_t* bytes, int available, int count, int maxBytes)";
+    QString function;
+
+    if(declaration)
+    {
+        function += "//! Determine the number of bytes used by variable length integers in a byte stream.\n";
+        function += signature + ";\n";
+        return function;
+    }
+
+    function += "/*!\n";
+    function += " * Determine the number of bytes used by variable length integers in a byte\n";
+    function += " * stream, without reading past the end of the stream.\n";
+    function += " * \\param bytes is a pointer to the first byte of the first number.\n";
+    function += " * \\param available is the number of bytes in the stream from bytes onwards.\n";
+    function += " * \\param count is the number of numbers to measure.\n";
+    function += " * \\param maxBytes is the most bytes used by one number.\n";
+    function += " * \\return the number of bytes used by the numbers, or available + 1 if they\n";
+    function += " *         do not fit in the available bytes.\n";
+    function += " */\n";
+
+    if(support.inlineHelpers)
+        function += "static inline ";
+
+    function += signature + "\n";
+    function += "{\n";
+    function += "    int i, n, length = 0;\n";
+    function += "\n";
+    function += "    for(i = 0; i < count; i++)\n";
+    function += "    {\n";
+    function += "        for(n = 1; ; n++)\n";
+    function += "        {\n";
+    function += "            if(length >= available)\n";
+    function += "                return available + 1;\n";
+    function += "\n";
+    function += "            if(!(bytes[length++] & 0x80) || (n >= maxBytes))\n";
+    function += "                break;\n";
+    function += "        }\n";
+    function += "    }\n";
+    function += "\n";
+    function += "    return length;\n";
+    function += "}\n";
+
+    return function;
+
+}// FieldCoding::varintLengthFunction
+
+
+/*!
+ * Get all the variable length integer functions of the encode or decode
+ * module. The unsigned functions come first, because the signed functions
+ * call them.
+ * \param decode should be true for the decode functions.
+ * \param declarations should be true to output the brief comments and
+ *        prototypes, rather than the functions.
+ * \return the functions as a string
+ */
+QString FieldCoding::getVarintFunctions(bool decode, bool declarations)
+{
+    QString output;
+    QList<int> widths = getVarintWidths();
+
+    for(int i = 0; i < widths.size(); i++)
+    {
+        for(int s = 0; s < 2; s++)
+        {
+            for(int a = 0; a < 2; a++)
+            {
+                if(!isCalled(varintSignature(widths.at(i), s == 1, a == 1, decode)))
+                    continue;
+
+                output += "\n";
+
+                if(declarations)
+                {
+                    output += "//! " + briefVarintComment(widths.at(i), s == 1, a == 1, decode) + "\n";
+                    output += varintSignature(widths.at(i), s == 1, a == 1, decode) + ";\n";
+                }
+                else
+                {
+                    output += fullVarintComment(widths.at(i), s == 1, a == 1, decode) + "\n";
+
+                    if(support.inlineHelpers)
+                        output += "static inline ";
+
+                    output += varintFunction(widths.at(i), s == 1, a == 1, decode);
+                }
+            }
+        }
+    }
+
+    if(decode && isCalled("varintLengthFromBytes"))
+        output += "\n" + varintLengthFunction(declarations);
+
+    return output;
+
+}// FieldCoding::getVarintFunctions
@@ -14,6 +14,9 @@ public:
 
 protected:
 
+    //! Remember the helper functions that the called helper functions call
+    void recordHelperDependencies(void);
+
     //! Get a human readable type name like "unsigned 3 byte integer".
     QString getReadableTypeName(int type);
 
@@ -68,6 +71,78 @@ protected:
     //! Generate the integer decode function
     QString integerDecodeFunction(int type, bool bigendian);
 
+    //! Get the preprocessor code that detects the host byte order
+    QString getHostEndianDefinitions(void);
+
+    //! Write the static inline encode functions to the header
+    void generateInlineEncodeFunctions(bool floats);
+
+    //! Write the static inline decode functions to the header
+    void generateInlineDecodeFunctions(bool floats);
+
+    //! Determine if the native byte order fast path can be used for a type
+    bool hasNativeFastPath(int type);
+
+    //! Get the host byte order macro which requires a byte swap
+    QString getSwapHostMacro(bool bigendian);
+
+    //! Determine if the array functions are output for a type
+    bool hasArrayFunction(int type);
+
+    //! Determine if a type is float16 or float24
+    bool isSpecialFloat(int type);
+
+    //! Generate the one line brief comment for the array encode function
+    QString briefEncodeArrayComment(int type, bool bigendian);
+
+    //! Generate the full comment for the array encode function
+    QString fullEncodeArrayComment(int type, bool bigendian);
+
+    //! Generate the array encode function signature
+    QString encodeArraySignature(int type, bool bigendian);
+
+    //! Generate the full array encode function
+    QString fullEncodeArrayFunction(int type, bool bigendian);
+
+    //! Generate the full array encode function for float16 and float24
+    QString specialFloatEncodeArrayFunction(int type, bool bigendian);
+
+    //! Generate the one line brief comment for the array decode function
+    QString briefDecodeArrayComment(int type, bool bigendian);
+
+    //! Generate the full comment for the array decode function
+    QString fullDecodeArrayComment(int type, bool bigendian);
+
+    //! Generate the array decode function signature
+    QString decodeArraySignature(int type, bool bigendian);
+
+    //! Generate the full array decode function
+    QString fullDecodeArrayFunction(int type, bool bigendian);
+
+    //! Generate the full array decode function for float16 and float24
+    QString specialFloatDecodeArrayFunction(int type, bool bigendian);
+
+    //! Get the bit widths of the variable length integer functions
+    QList<int> getVarintWidths(void);
+
+    //! Generate the one line brief comment for a variable length integer function
+    QString briefVarintComment(int bits, bool isSigned, bool isArray, bool decode);
+
+    //! Generate the full comment for a variable length integer function
+    QString fullVarintComment(int bits, bool isSigned, bool isArray, bool decode);
+
+    //! Generate the variable length integer function signature
+    QString varintSignature(int bits, bool isSigned, bool isArray, bool decode);
+
+    //! Generate the full variable length integer function
+    QString varintFunction(int bits, bool isSigned, bool isArray, bool decode);
+
+    //! Generate the function that measures variable length integers in a byte stream
+    QString varintLengthFunction(bool declaration);
+
+    //! Get all the variable length integer functions of the encode or decode module
+    QString getVarintFunctions(bool decode, bool declarations);
+
     QList<bool> typeUnsigneds;
 };
 
@@ -3,9 +3,13 @@
 #include <QStringList>
 #include <QFile>
 #include <QDir>
+#include <QElapsedTimer>
 #include <iostream>
 
 #include "protocolparser.h"
+#include "protocoldocumentation.h"
+#include "protocolxmlreader.h"
+#include "protocolstatistics.h"
 
 int main(int argc, char *argv[])
 {
@@ -14,6 +18,11 @@ int main(int argc, char *argv[])
     bool nodoxygen = false;
     bool nomarkdown = false;
     bool nohelperfiles = false;
+    bool detachdocs = false;
+    bool loaddom = false;
+    bool stats = false;
+    bool cpp = false;
+    QString statsfile;
 
     // The list of arguments
     QStringList arguments = a.arguments();
@@ -21,10 +30,14 @@ int main(int argc, char *argv[])
     if(arguments.size() <= 1)
     {
         std::cout << "Protocol generator usage:" << std::endl;
-        std::cout << "ProtoGen input.xml [outputpath] [-no-doxygen] [-no-markdown] [-no-helper-files]" << std::endl;
+        std::cout << "ProtoGen input.xml [outputpath] [-no-doxygen] [-no-markdown] [-no-helper-files] [-detach-documentation] [-dom] [-stats[=file.json]] [-cpp]" << std::endl;
         return 0;
     }
 
+    // ProtoGen runs itself this way to build the documentation after the code generation has exited
+    if(arguments.at(1) == "-run-documentation")
+        return ProtocolDocumentation::runDetached(arguments.mid(2));
+
 
     // We expect the input file here
     QString filename = a.arguments().at(1);
@@ -42,55 +55,89 @@ int main(int argc, char *argv[])
             nomarkdown = true;        
         else if(arg.contains("-no-helper-files", Qt::CaseInsensitive))
             nohelperfiles = true;
+        else if(arg.contains("-detach-documentation", Qt::CaseInsensitive))
+            detachdocs = true;
+        else if(arg.compare("-dom", Qt::CaseInsensitive) == 0)
+            loaddom = true;
+        else if(arg.compare("-cpp", Qt::CaseInsensitive) == 0)
+            cpp = true;
+        else if(arg.startsWith("-stats", Qt::CaseInsensitive) || arg.startsWith("-timing", Qt::CaseInsensitive))
+        {
+            // The statistics go to stdout, or to a file given like "-stats=file.json"
+            stats = true;
+            if(arg.contains("="))
+                statsfile = QDir::current().absoluteFilePath(arg.section("=", 1));
+        }
         else if(arg.endsWith(".xml"))
             filename = arg;
         else if(arg != filename)
             path = arg;
     }
 
+    // Time for the statistics
+    QElapsedTimer total, phase;
+    total.start();
+    ProtocolStatistics::setEnabled(stats);
+
     if(!filename.isEmpty())
     {
-        QDomDocument doc("protogen");
+        ProtocolXmlReader reader;
+        bool loaded = false;
 
-        QFile file(filename);
-        if (file.open(QIODevice::ReadOnly))
+        phase.start();
+
+        if(loaddom)
         {
-            if (doc.setContent(&file))
+            // The entire document in memory at once
+            QDomDocument doc("protogen");
+
+            QFile file(filename);
+            if (file.open(QIODevice::ReadOnly))
             {
-                ProtocolParser parser;
+                if (doc.setContent(&file))
+                    loaded = reader.setDocument(doc);
+                else
+                    std::cout << "failed to validate xml from file: " << filename.toStdString() << std::endl;
 
-                // Set our working directory
-                if(!path.isEmpty())
-                {
-                    QDir dir(QDir::current());
+                file.close();
+            }
+            else
+                std::cout << "failed to open protocol file: " << filename.toStdString() << std::endl;
+        }
+        else
+        {
+            // Stream the file, only building the DOM of one packet at a time
+            loaded = reader.readFile(filename);
+            if(!loaded)
+                std::cout << "failed to validate xml from file: " << filename.toStdString() << ": " << reader.getErrorString().toStdString() << std::endl;
+        }
 
-                    // The path could be absolute or relative to
-                    // our current path, this works either way
+        ProtocolStatistics::addPhaseTime("load", phase.nsecsElapsed());
 
-                    // Make sure the path exists
-                    dir.mkpath(path);
+        if(loaded)
+        {
+            ProtocolParser parser;
 
-                    // Now set it as the path to use
-                    QDir::setCurrent(path);
-                }
+            // Set our working directory
+            if(!path.isEmpty())
+            {
+                QDir dir(QDir::current());
 
-                if(parser.parse(doc, nodoxygen, nomarkdown, nohelperfiles))
-                    Return = 1;
+                // The path could be absolute or relative to
+                // our current path, this works either way
 
-            }
-            else
-            {
-                std::cout << "failed to validate xml from file: " << filename.toStdString() << std::endl;
-                Return = 0;
+                // Make sure the path exists
+                dir.mkpath(path);
+
+                // Now set it as the path to use
+                QDir::setCurrent(path);
             }
 
-            file.close();
+            if(parser.parse(reader, nodoxygen, nomarkdown, nohelperfiles, detachdocs, cpp))
+                Return = 1;
         }
         else
-        {
-            std::cout << "failed to open protocol file: " << filename.toStdString() << std::endl;
             Return = 0;
-        }
 
     }
     else
@@ -99,5 +146,24 @@ int main(int argc, char *argv[])
         Return = 0;
     }
 
+    if(stats)
+    {
+        ProtocolStatistics::addPhaseTime("total", total.nsecsElapsed());
+
+        // The 10 slowest modules are enough to see where the time goes
+        QByteArray json = ProtocolStatistics::toJson(10);
+
+        if(statsfile.isEmpty())
+            std::cout << json.constData();
+        else
+        {
+            QFile output(statsfile);
+            if(output.open(QIODevice::WriteOnly | QIODevice::Text))
+                output.write(json);
+            else
+                std::cout << "failed to open statistics file: " << statsfile.toStdString() << std::endl;
+        }
+    }
+
     return Return;
 }
@@ -0,0 +1,49 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+// C++ compilers: don't mangle us
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \file
+ * Routines for computing checks over packet data: CRC-16/CCITT, CRC-32,
+ * CRC-32C and Fletcher checksums. The CRCs are computed eight bytes at a time
+ * from tables, and CRC-32 and CRC-32C use the processor's CRC instructions
+ * when the compiler targets SSE4.2 or ARMv8 with CRC.
+ */
+
+#include <stdint.h>
+
+//! Compute the CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) of a block of data
+uint16_t computeCrc16(const uint8_t* data, int size);
+
+//! Continue a CRC-16/CCITT with another block of data
+uint16_t updateCrc16(uint16_t crc, const uint8_t* data, int size);
+
+//! Compute the CRC-32 (IEEE 802.3, as used by zlib and ethernet) of a block of data
+uint32_t computeCrc32(const uint8_t* data, int size);
+
+//! Continue a CRC-32 with another block of data
+uint32_t updateCrc32(uint32_t crc, const uint8_t* data, int size);
+
+//! Compute the CRC-32C (Castagnoli) of a block of data
+uint32_t computeCrc32c(const uint8_t* data, int size);
+
+//! Continue a CRC-32C with another block of data
+uint32_t updateCrc32c(uint32_t crc, const uint8_t* data, int size);
+
+//! Compute the Fletcher-16 checksum of a block of data
+uint16_t computeFletcher16(const uint8_t* data, int size);
+
+//! Compute the Fletcher-32 checksum of a block of data
+uint32_t computeFletcher32(const uint8_t* data, int size);
+
+//! Test the checksums
+int testChecksum(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // CHECKSUM_H
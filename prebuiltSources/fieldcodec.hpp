@@ -0,0 +1,589 @@
+/*!
+ * \file
+ * Field coding for the header-only C++ output of ProtoGen.
+ *
+ * The byte count, byte order, and signedness of every field are template
+ * parameters. Each call is resolved by the compiler, so the encode or decode
+ * of a fixed length packet inlines to a sequence of loads and stores. The
+ * rounding, clamping, and special float formats are the same as the C
+ * helpers, so the C and C++ outputs of a protocol interoperate.
+ */
+
+#ifndef _FIELDCODEC_HPP
+#define _FIELDCODEC_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if __cplusplus < 201703L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "fieldcodec.hpp requires C++17"
+#endif
+
+namespace protogen
+{
+
+//! The integer types that hold an encoded integer of some number of bytes
+template<unsigned Bytes, bool Signed>
+struct IntegerType
+{
+    static_assert((Bytes >= 1) && (Bytes <= 8), "encoded integers are 1 to 8 bytes");
+
+    //! The unsigned type wide enough for the encoded integer
+    typedef typename std::conditional<(Bytes > 4), std::uint64_t,
+            typename std::conditional<(Bytes > 2), std::uint32_t,
+            typename std::conditional<(Bytes > 1), std::uint16_t, std::uint8_t>::type>::type>::type Unsigned;
+
+    //! The type of the decoded integer
+    typedef typename std::conditional<Signed, typename std::make_signed<Unsigned>::type, Unsigned>::type type;
+};
+
+
+//! The floating point type that holds a decoded float of some number of bits
+template<unsigned Bits>
+struct FloatType
+{
+    typedef typename std::conditional<(Bits > 32), double, float>::type type;
+};
+
+
+/*!
+ * The largest integer that can be encoded
+ * \return 2^(8*Bytes) - 1 if unsigned, or 2^(8*Bytes - 1) - 1 if signed
+ */
+template<unsigned Bytes, bool Signed>
+constexpr typename IntegerType<Bytes, Signed>::type encodedMaximum(void)
+{
+    typedef typename IntegerType<Bytes, false>::Unsigned Word;
+
+    return static_cast<typename IntegerType<Bytes, Signed>::type>(static_cast<Word>(~Word(0)) >> (sizeof(Word)*8 - Bytes*8 + (Signed ? 1 : 0)));
+}
+
+
+/*!
+ * The smallest integer that can be encoded
+ * \return 0 if unsigned, or -2^(8*Bytes - 1) if signed
+ */
+template<unsigned Bytes, bool Signed>
+constexpr typename IntegerType<Bytes, Signed>::type encodedMinimum(void)
+{
+    if constexpr(Signed)
+        return -encodedMaximum<Bytes, Signed>() - 1;
+    else
+        return 0;
+}
+
+
+/*!
+ * Encode an integer in Bytes bytes. Bits of the value above the encoded
+ * width are discarded.
+ * \param data receives the encoded bytes
+ * \param value is the integer, or enumeration, to encode
+ */
+template<unsigned Bytes, bool BigEndian, typename T>
+inline void encodeInteger(std::uint8_t* data, T value)
+{
+    typedef typename IntegerType<Bytes, false>::Unsigned Word;
+
+    const Word word = static_cast<Word>(value);
+
+    for(unsigned i = 0; i < Bytes; i++)
+        data[BigEndian ? (Bytes - 1 - i) : i] = static_cast<std::uint8_t>(word >> (8*i));
+}
+
+
+/*!
+ * Decode an integer from Bytes bytes, sign extending it if it is signed
+ * \param data is the encoded bytes
+ * \return the decoded integer
+ */
+template<unsigned Bytes, bool BigEndian, bool Signed>
+inline typename IntegerType<Bytes, Signed>::type decodeInteger(const std::uint8_t* data)
+{
+    typedef typename IntegerType<Bytes, false>::Unsigned Word;
+
+    Word word = 0;
+
+    for(unsigned i = 0; i < Bytes; i++)
+        word = static_cast<Word>(word | (static_cast<Word>(data[BigEndian ? (Bytes - 1 - i) : i]) << (8*i)));
+
+    // Widths like 24 bits need the sign bit copied into the upper bits
+    if constexpr(Signed && (Bytes*8 < sizeof(Word)*8))
+    {
+        const Word sign = static_cast<Word>(Word(1) << (Bytes*8 - 1));
+        word = static_cast<Word>((word ^ sign) - sign);
+    }
+
+    return static_cast<typename IntegerType<Bytes, Signed>::type>(word);
+}
+
+
+/*!
+ * Convert a float to the 24 bit format with 1 sign bit, 8 exponent bits, and
+ * 15 significand bits
+ * \param value is the float to convert
+ * \return the 24 bit format in the lower bits
+ */
+inline std::uint32_t float32ToFloat24(float value)
+{
+    std::uint32_t integer;
+    std::memcpy(&integer, &value, sizeof(integer));
+
+    return integer >> 8;
+}
+
+
+/*!
+ * Convert the 24 bit float format to a float
+ * \param value is the 24 bit format in the lower bits
+ * \return the float
+ */
+inline float float24ToFloat32(std::uint32_t value)
+{
+    float output;
+    std::uint32_t integer = (value & 0x00FFFFFF) << 8;
+    std::memcpy(&output, &integer, sizeof(output));
+
+    return output;
+}
+
+
+/*!
+ * Convert a float to the 16 bit format with 1 sign bit, 6 exponent bits, and
+ * 9 significand bits. Values too small become zero, and values too large
+ * become the largest magnitude that is not infinity.
+ * \param value is the float to convert
+ * \return the 16 bit format
+ */
+inline std::uint16_t float32ToFloat16(float value)
+{
+    std::uint32_t integer;
+    std::memcpy(&integer, &value, sizeof(integer));
+
+    const std::uint32_t unsignedExponent = (integer >> 23) & 0xFF;
+    const std::uint32_t underflow = 0U - static_cast<std::uint32_t>(unsignedExponent < 127 - 31);
+    const std::uint32_t overflow  = 0U - static_cast<std::uint32_t>(unsignedExponent > 127 + 31);
+
+    std::uint32_t output = ((unsignedExponent - (127 - 31)) << 9) | ((integer & 0x007FFFFF) >> 14);
+    output = (output & ~(underflow | overflow)) | (0x7DFF & overflow);
+    output |= (integer >> 16) & 0x8000;
+
+    return static_cast<std::uint16_t>(output);
+}
+
+
+/*!
+ * Convert the 16 bit float format to a float
+ * \param value is the 16 bit format
+ * \return the float
+ */
+inline float float16ToFloat32(std::uint16_t value)
+{
+    const std::uint32_t nonzero = 0U - static_cast<std::uint32_t>((value & 0x7FFF) != 0);
+
+    std::uint32_t integer = (((static_cast<std::uint32_t>(value & 0x7FFF)) << 14) + ((127 - 31) << 23)) & nonzero;
+    integer |= (static_cast<std::uint32_t>(value & 0x8000)) << 16;
+
+    float output;
+    std::memcpy(&output, &integer, sizeof(output));
+
+    return output;
+}
+
+
+/*!
+ * Encode a floating point number as a 16, 24, 32, or 64 bit float
+ * \param data receives the encoded bytes
+ * \param value is the number to encode
+ */
+template<unsigned Bits, bool BigEndian>
+inline void encodeFloat(std::uint8_t* data, typename FloatType<Bits>::type value)
+{
+    if constexpr(Bits == 64)
+    {
+        std::uint64_t integer;
+        std::memcpy(&integer, &value, sizeof(integer));
+        encodeInteger<8, BigEndian>(data, integer);
+    }
+    else if constexpr(Bits == 32)
+    {
+        std::uint32_t integer;
+        std::memcpy(&integer, &value, sizeof(integer));
+        encodeInteger<4, BigEndian>(data, integer);
+    }
+    else if constexpr(Bits == 24)
+        encodeInteger<3, BigEndian>(data, float32ToFloat24(value));
+    else
+    {
+        static_assert(Bits == 16, "encoded floats are 16, 24, 32, or 64 bits");
+        encodeInteger<2, BigEndian>(data, float32ToFloat16(value));
+    }
+}
+
+
+/*!
+ * Determine if the bits of a 32 or 64 bit float are a valid IEEE-754 number,
+ * without using any floating point instructions, as isFloat32Valid() and
+ * isFloat64Valid() of the C floatspecial module do.
+ * \param integer is the bits of the float
+ * \return false if the float is infinity, NaN, or de-normalized, else true
+ */
+template<unsigned Bits>
+constexpr bool isFloatValid(typename IntegerType<Bits/8, false>::Unsigned integer)
+{
+    static_assert((Bits == 32) || (Bits == 64), "only 32 and 64 bit floats are checked");
+
+    typedef typename IntegerType<Bits/8, false>::Unsigned Word;
+
+    const Word exponent = (Bits == 64) ? static_cast<Word>(0x7FF0000000000000ULL) : static_cast<Word>(0x7F800000UL);
+    const Word significand = (Bits == 64) ? static_cast<Word>(0x000FFFFFFFFFFFFFULL) : static_cast<Word>(0x007FFFFFUL);
+
+    // Infinity or NaN
+    if((integer & exponent) == exponent)
+        return false;
+
+    // De-normalized
+    if(((integer & exponent) == 0) && ((integer & significand) != 0))
+        return false;
+
+    return true;
+}
+
+
+/*!
+ * Decode a 16, 24, 32, or 64 bit float
+ * \param data is the encoded bytes
+ * \tparam Checked is true to decode a 32 or 64 bit float that is infinity,
+ *         NaN, or de-normalized as zero, as the C code does unless
+ *         supportSpecialFloat is false
+ * \return the decoded number
+ */
+template<unsigned Bits, bool BigEndian, bool Checked>
+inline typename FloatType<Bits>::type decodeFloat(const std::uint8_t* data)
+{
+    if constexpr(Bits == 64)
+    {
+        double output;
+        const std::uint64_t integer = decodeInteger<8, BigEndian, false>(data);
+        if constexpr(Checked)
+        {
+            if(!isFloatValid<64>(integer))
+                return 0;
+        }
+        std::memcpy(&output, &integer, sizeof(output));
+        return output;
+    }
+    else if constexpr(Bits == 32)
+    {
+        float output;
+        const std::uint32_t integer = decodeInteger<4, BigEndian, false>(data);
+        if constexpr(Checked)
+        {
+            if(!isFloatValid<32>(integer))
+                return 0;
+        }
+        std::memcpy(&output, &integer, sizeof(output));
+        return output;
+    }
+    else if constexpr(Bits == 24)
+        return float24ToFloat32(decodeInteger<3, BigEndian, false>(data));
+    else
+    {
+        static_assert(Bits == 16, "encoded floats are 16, 24, 32, or 64 bits");
+        return float16ToFloat32(decodeInteger<2, BigEndian, false>(data));
+    }
+}
+
+
+/*!
+ * Scale a number to an integer, rounding to the nearest integer and clamping
+ * to the range that can be encoded, and encode the integer.
+ * \param data receives the encoded bytes
+ * \param value is the number to encode
+ * \param minimum is the value that encodes as zero, which is ignored if signed
+ * \param scaler is multiplied by the value (less the minimum if unsigned)
+ */
+template<unsigned Bytes, bool BigEndian, bool Signed, typename Real>
+inline void encodeScaled(std::uint8_t* data, Real value, Real minimum, Real scaler)
+{
+    typedef typename IntegerType<Bytes, Signed>::type Number;
+
+    constexpr Number maximum = encodedMaximum<Bytes, Signed>();
+    Number number;
+
+    if constexpr(Signed)
+    {
+        constexpr Number lowest = encodedMinimum<Bytes, Signed>();
+        const Real scaled = value*scaler;
+
+        if(scaled >= 0)
+            number = (scaled >= static_cast<Real>(maximum)) ? maximum : static_cast<Number>(scaled + Real(0.5));
+        else
+            number = (scaled <= static_cast<Real>(lowest)) ? lowest : static_cast<Number>(scaled - Real(0.5));
+    }
+    else
+    {
+        const Real scaled = (value - minimum)*scaler;
+
+        if(scaled >= static_cast<Real>(maximum))
+            number = maximum;
+        else if(scaled <= 0)
+            number = 0;
+        else
+            number = static_cast<Number>(scaled + Real(0.5));
+    }
+
+    encodeInteger<Bytes, BigEndian>(data, number);
+}
+
+
+/*!
+ * Decode an integer and scale it to a number
+ * \param data is the encoded bytes
+ * \param minimum is the value that decodes from zero, which is ignored if signed
+ * \param invscaler is multiplied by the integer, and should be the inverse
+ *        of the scaler given to encodeScaled()
+ * \return the decoded number, minimum + integer*invscaler
+ */
+template<unsigned Bytes, bool BigEndian, bool Signed, typename Real>
+inline Real decodeScaled(const std::uint8_t* data, Real minimum, Real invscaler)
+{
+    if constexpr(Signed)
+        return invscaler*decodeInteger<Bytes, BigEndian, Signed>(data);
+    else
+        return minimum + invscaler*decodeInteger<Bytes, BigEndian, Signed>(data);
+}
+
+
+/*!
+ * Encode a bitfield, most significant bit first. The byte that holds the
+ * first bit of a group of bitfields is cleared, so the bitfields of a group
+ * must be encoded in order.
+ * \param data is the first byte of the group of bitfields
+ * \param value is the bitfield, bits of the value above Bits are discarded
+ */
+template<unsigned Offset, unsigned Bits>
+inline void encodeBitfield(std::uint8_t* data, std::uint32_t value)
+{
+    static_assert((Bits >= 1) && (Bits <= 32), "bitfields are 1 to 32 bits");
+
+    unsigned bitoffset = Offset % 8;
+    unsigned bits = Bits;
+
+    data += Offset / 8;
+
+    while(bits > 0)
+    {
+        // The bits of this byte which are left, and how many of them we use
+        const unsigned room = 8 - bitoffset;
+        const unsigned count = (room < bits) ? room : bits;
+        const std::uint8_t part = static_cast<std::uint8_t>(((value >> (bits - count)) & ((1u << count) - 1u)) << (room - count));
+
+        if(bitoffset == 0)
+            *data = part;
+        else
+            *data = static_cast<std::uint8_t>(*data | part);
+
+        bits -= count;
+        bitoffset += count;
+        if(bitoffset >= 8)
+        {
+            data++;
+            bitoffset = 0;
+        }
+    }
+}
+
+
+/*!
+ * Decode a bitfield, most significant bit first
+ * \param data is the first byte of the group of bitfields
+ * \return the bitfield
+ */
+template<unsigned Offset, unsigned Bits>
+inline std::uint32_t decodeBitfield(const std::uint8_t* data)
+{
+    static_assert((Bits >= 1) && (Bits <= 32), "bitfields are 1 to 32 bits");
+
+    unsigned bitoffset = Offset % 8;
+    unsigned bits = Bits;
+    std::uint64_t value = 0;
+
+    data += Offset / 8;
+
+    while(bits > 0)
+    {
+        const unsigned room = 8 - bitoffset;
+        const unsigned count = (room < bits) ? room : bits;
+
+        value = (value << count) | ((static_cast<unsigned>(*data) >> (room - count)) & ((1u << count) - 1u));
+
+        bits -= count;
+        data++;
+        bitoffset = 0;
+    }
+
+    return static_cast<std::uint32_t>(value);
+}
+
+
+/*!
+ * Encode a string, including its terminator
+ * \param data receives the encoded bytes
+ * \param index is the location in data to encode to, which is advanced past the string
+ * \param string is the null terminated string
+ * \param maxLength is the size of the string in memory, including the terminator
+ * \param fixedLength should be true to always encode maxLength bytes
+ */
+inline void encodeString(std::uint8_t* data, std::size_t& index, const char* string, std::size_t maxLength, bool fixedLength)
+{
+    std::size_t i = 0;
+
+    for(; (i + 1 < maxLength) && (string[i] != 0); i++)
+        data[index + i] = static_cast<std::uint8_t>(string[i]);
+
+    data[index + i++] = 0;
+
+    if(fixedLength)
+    {
+        for(; i < maxLength; i++)
+            data[index + i] = 0;
+    }
+
+    index += i;
+}
+
+
+/*!
+ * Decode a string, which is always terminated in memory
+ * \param string receives the string
+ * \param data is the encoded bytes
+ * \param size is the number of encoded bytes available
+ * \param index is the location in data to decode from, which is advanced past the string
+ * \param maxLength is the size of the string in memory, including the terminator
+ * \param fixedLength should be true if maxLength bytes are always encoded
+ * \return false if the string is not complete in the data
+ */
+inline bool decodeString(char* string, const std::uint8_t* data, std::size_t size, std::size_t& index, std::size_t maxLength, bool fixedLength)
+{
+    std::size_t i = 0;
+
+    if((index > size) || (fixedLength && (size - index < maxLength)))
+        return false;
+
+    data += index;
+    size -= index;
+
+    for(; (i + 1 < maxLength) && (i < size) && (data[i] != 0); i++)
+        string[i] = static_cast<char>(data[i]);
+
+    string[i] = 0;
+
+    // The terminator, or the byte where it would be, must be in the data
+    if(i >= size)
+        return false;
+
+    if(fixedLength)
+        index += maxLength;
+    else
+        index += i + 1;
+
+    return true;
+}
+
+
+/*!
+ * Encode a variable length integer, seven bits in each byte, least
+ * significant first, with the top bit of a byte set if another byte follows.
+ * Signed integers are zigzag mapped first, so small magnitudes of either
+ * sign use few bytes.
+ * \param data receives the encoded bytes
+ * \param index is the location in data to encode to, which is advanced past the integer
+ * \param value is the integer to encode
+ */
+template<typename T>
+inline void encodeVarint(std::uint8_t* data, std::size_t& index, T value)
+{
+    typedef typename std::make_unsigned<T>::type Word;
+    Word number = static_cast<Word>(value);
+
+    if constexpr(std::is_signed<T>::value)
+        number = static_cast<Word>(number << 1) ^ static_cast<Word>(0 - (number >> (sizeof(Word)*8 - 1)));
+
+    while(number >= 0x80)
+    {
+        data[index++] = static_cast<std::uint8_t>(number | 0x80);
+        number >>= 7;
+    }
+
+    data[index++] = static_cast<std::uint8_t>(number);
+}
+
+
+/*!
+ * Decode a variable length integer
+ * \param value receives the integer
+ * \param data is the encoded bytes
+ * \param size is the number of encoded bytes available
+ * \param index is the location in data to decode from, which is advanced past the integer
+ * \param maxBytes is the most bytes the integer can use
+ * \return false if the integer is not complete in the data
+ */
+template<typename T>
+inline bool decodeVarint(T& value, const std::uint8_t* data, std::size_t size, std::size_t& index, std::size_t maxBytes)
+{
+    typedef typename std::make_unsigned<T>::type Word;
+    Word number = 0;
+    std::size_t n = 0;
+    std::uint8_t byte;
+
+    do
+    {
+        if(index + n >= size)
+            return false;
+
+        byte = data[index + n];
+
+        if(7*n < sizeof(Word)*8)
+            number |= static_cast<Word>(static_cast<Word>(byte & 0x7F) << (7*n));
+
+        n++;
+
+    }while((byte & 0x80) && (n < maxBytes));
+
+    index += n;
+
+    if constexpr(std::is_signed<T>::value)
+        value = static_cast<T>(number >> 1) ^ -static_cast<T>(number & 1);
+    else
+        value = number;
+
+    return true;
+}
+
+
+/*!
+ * Limit the count of a variable length array to the size of the array
+ * \param count is the count of elements, which may be any integer type
+ * \param size is the number of elements the array can hold
+ * \return the count, clamped to 0 and size
+ */
+template<typename T>
+constexpr std::size_t arrayCount(T count, std::size_t size)
+{
+    if constexpr(std::is_signed<T>::value)
+    {
+        if(count < 0)
+            return 0;
+    }
+
+    if(static_cast<std::size_t>(count) > size)
+        return size;
+    else
+        return static_cast<std::size_t>(count);
+}
+
+}// namespace protogen
+
+#endif // _FIELDCODEC_HPP
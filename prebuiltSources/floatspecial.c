@@ -81,8 +81,9 @@ int isFloat64Valid(uint64_t value)
 
 /*!
  * Convert a 32-bit floating point value (IEEE-754 binary32) to 24-bit floating
- * point value. This is done by limiting the signficand to 16 bits. Underflow
- * will be returned as zero and overflow as the maximum possible value
+ * point value. This is done by limiting the signficand to 15 bits. Since
+ * float24 has the same exponent as binary32 this is just a matter of
+ * discarding the least significant byte, and no branches are needed.
  * \param value is the 32-bit floating point data to convert.
  * \return The 24-bit floating point as a simple 32-bit integer with the most
  *         significant byte clear.
@@ -95,43 +96,13 @@ uint32_t float32ToFloat24(float value)
         uint32_t Integer;
     }field;
 
-    uint32_t significand;
-    uint32_t unsignedExponent;
-    uint32_t output;
-
     // Write the floating point value to our union so we can access its bits.
     // Note that C99 and C++2011 have built in goodness for this sort of
     // thing, but not all compilers support that (sigh...)
     field.Float = value;
 
-    // The significand is the least significant 23 bits (IEEE754)
-    significand = field.Integer & 0x007FFFFF;
-
-    // Exponent occupies the next 8 bits (IEEE754)
-    unsignedExponent = (field.Integer & 0x7F800000) >> 23;
-
-    // Get rid of some bits, here is where we sacrifice resolution
-    output = (uint32_t)(significand >> 8);
-
-    // If significand and exponent are zero means a number of zero
-    if((output == 0) && (unsignedExponent == 0))
-    {
-        // return correctly signed result
-        if(field.Integer & 0x80000000)
-            return 0x00800000;
-        else
-            return 0;
-    }
-
-    // Put the exponent in the output
-    output |= unsignedExponent << 15;
-
-    // Account for the sign
-    if(field.Integer & 0x80000000)
-        output |= 0x00800000;
-
-    // return the 24-bit representation
-    return output;
+    // The sign, the 8 bits of exponent, and the top 15 bits of the significand
+    return field.Integer >> 8;
 
 }// float32ToFloat24
 
@@ -149,26 +120,8 @@ float float24ToFloat32(uint32_t value)
         uint32_t Integer;
     }field;
 
-    // Zero is a special case
-    if((value & 0x007FFFFF) == 0)
-    {
-        field.Integer = 0;
-    }
-    else
-    {
-        // 8 bits of exponent, biased with 127
-        uint32_t unsignedExponent = (value >> 15) & 0xFF;
-
-        // 15 bits of signficand, shift it up to 23 bits
-        field.Integer = (value & 0x00007FFF) << 8;
-
-        // Put the exponent in
-        field.Integer |= (unsignedExponent << 23);
-    }
-
-    // And the sign bit
-    if(value & 0x00800000)
-        field.Integer |= 0x80000000;
+    // The exponent is unchanged, the significand gains 8 zero bits
+    field.Integer = (value & 0x00FFFFFF) << 8;
 
     return field.Float;
 
@@ -177,11 +130,12 @@ float float24ToFloat32(uint32_t value)
 
 /*!
  * Convert a 32-bit floating point value (IEEE-754 binary32) to 16-bit floating
- * point value (IEEE-754 binary16). This is done by limiting the exponent to 6
- * bits and the signficand to 9 bits. Underflow will be returned as zero and
- * overflow as the maximum possible value.
+ * point value. This is done by limiting the exponent to 6 bits and the
+ * signficand to 9 bits. Underflow will be returned as zero and overflow as
+ * the maximum possible value. The range checks are done with masks rather
+ * than branches, so that loops of conversions can be vectorized.
  * \param value is the 32-bit floating point data to convert.
- * \return The binary16 as a simple 16-bit integer.
+ * \return The float16 as a simple 16-bit integer.
  */
 uint16_t float32ToFloat16(float value)
 {
@@ -191,37 +145,18 @@ uint16_t float32ToFloat16(float value)
         uint32_t Integer;
     }field;
 
-    uint32_t significand;
     uint32_t unsignedExponent;
-    int32_t  signedExponent;
-    uint16_t output;
+    uint32_t underflow;
+    uint32_t overflow;
+    uint32_t output;
 
     // Write the floating point value to our union so we can access its bits.
     // Note that C99 and C++2011 have built in goodness for this sort of
     // thing, but not all compilers support that (sigh...)
     field.Float = value;
 
-    // The significand is the least significant 23 bits (IEEE754)
-    significand = field.Integer & 0x007FFFFF;
-
     // Exponent occupies the next 8 bits (IEEE754)
-    unsignedExponent = (field.Integer & 0x7F800000) >> 23;
-
-    // Get rid of some bits, here is where we sacrifice resolution
-    output = (uint16_t)(significand >> 14);
-
-    // If significand and exponent are zero means a number of zero
-    if((output == 0) && (unsignedExponent == 0))
-    {
-        // return correctly signed result
-        if(field.Integer & 0x80000000)
-            return 0x8000;
-        else
-            return 0;
-    }
-
-    // Get the un-biased exponent. Binary32 is biased by 127
-    signedExponent = unsignedExponent - 127;
+    unsignedExponent = (field.Integer >> 23) & 0xFF;
 
     // With a 6-bit exponent we can support exponents of
     // exponent : biased value
@@ -233,36 +168,31 @@ uint16_t float32ToFloat16(float value)
     //  31      : 62
     //  32      : NaN (all exponent bits are 1)
 
-    // We can support (un-biased) exponents of -62 through 63 inclusive
-    if(signedExponent < -31)
-        output = 0;   // underflow to zero
-    else if(signedExponent > 31)
-    {
-        // Largest possible exponent and significand without making a NaN or Inf
-        output = (uint16_t)(0x7DFF);
-    }
-    else
-    {
-        // re-bias with 31
-        unsignedExponent = (uint32_t)(signedExponent + 31);
+    // All ones if the (un-biased) exponent is less than -31 or more than 31,
+    // which includes zero, denormalized, infinity, and NaN
+    underflow = 0U - (uint32_t)(unsignedExponent < 127 - 31);
+    overflow  = 0U - (uint32_t)(unsignedExponent > 127 + 31);
 
-        // Put the exponent in the output
-        output |= (uint16_t)(unsignedExponent << 9);
-    }
+    // Re-bias the exponent with 31, and get rid of some bits of significand,
+    // here is where we sacrifice resolution
+    output = ((unsignedExponent - (127 - 31)) << 9) | ((field.Integer & 0x007FFFFF) >> 14);
+
+    // Underflow to zero, overflow to the largest possible exponent and
+    // significand without making a NaN or Inf
+    output = (output & ~(underflow | overflow)) | (0x7DFF & overflow);
 
     // Account for the sign
-    if(field.Integer & 0x80000000)
-        output |= 0x8000;
+    output |= (field.Integer >> 16) & 0x8000;
 
-    // return the binary16 representation
-    return output;
+    // return the float16 representation
+    return (uint16_t)output;
 
 }// float32ToFloat16
 
 
 /*!
- * Convert a IEEE-754 binary16 floating point representation to binary32
- * \param value is the binary16 representation to convert.
+ * Convert a 16-bit floating point representation to binary32 (IEEE-754)
+ * \param value is the float16 representation to convert.
  * \return the binary32 version as a float.
  */
 float float16ToFloat32(uint16_t value)
@@ -273,33 +203,146 @@ float float16ToFloat32(uint16_t value)
         uint32_t Integer;
     }field;
 
-    // Zero is a special case
-    if((value & 0x7FFF) == 0)
+    // All ones unless the magnitude is zero, which is a special case
+    uint32_t nonzero = 0U - (uint32_t)((value & 0x7FFF) != 0);
+
+    // 6 bits of exponent and 9 bits of significand, shifted up to the binary32
+    // positions. Then the exponent bias changes from 31 to 127.
+    field.Integer = ((((uint32_t)(value & 0x7FFF)) << 14) + ((127 - 31) << 23)) & nonzero;
+
+    // And the sign bit
+    field.Integer |= ((uint32_t)(value & 0x8000)) << 16;
+
+    return field.Float;
+
+}// float16ToFloat32
+
+
+/*!
+ * Convert an array of 32-bit floating point values (IEEE-754 binary32) to
+ * 24-bit floating point values. The conversion is the same as
+ * float32ToFloat24(), written so that compilers can vectorize the loop.
+ * \param value is the array of floating point data to convert.
+ * \param output receives count 24-bit floating point values.
+ * \param count is the number of values to convert.
+ */
+void float32ArrayToFloat24(const float* value, uint32_t* output, int count)
+{
+    int i;
+
+    for(i = 0; i < count; i++)
     {
-        field.Integer = 0;
+        union
+        {
+            float Float;
+            uint32_t Integer;
+        }field;
+
+        field.Float = value[i];
+        output[i] = field.Integer >> 8;
     }
-    else
+
+}// float32ArrayToFloat24
+
+
+/*!
+ * Convert an array of 24-bit floating point representations to binary32
+ * (IEEE-754). The conversion is the same as float24ToFloat32(), written so
+ * that compilers can vectorize the loop.
+ * \param value is the array of 24-bit representations to convert.
+ * \param output receives count binary32 values.
+ * \param count is the number of values to convert.
+ */
+void float24ArrayToFloat32(const uint32_t* value, float* output, int count)
+{
+    int i;
+
+    for(i = 0; i < count; i++)
     {
-        // 6 bits of exponent, biased with 31
-        uint32_t unsignedExponent = (value >> 9) & 0x3F;
+        union
+        {
+            float Float;
+            uint32_t Integer;
+        }field;
+
+        field.Integer = (value[i] & 0x00FFFFFF) << 8;
+        output[i] = field.Float;
+    }
 
-        // We want to subtract 31 to get un-biased, and then add 127 for the new bias
-        unsignedExponent += (127 - 31);
+}// float24ArrayToFloat32
 
-        // 9 bits of signficand, shift it up to 23 bits
-        field.Integer = (value & 0x01FF) << 14;
 
-        // Put the exponent in
-        field.Integer |= (unsignedExponent << 23);
+/*!
+ * Convert an array of 32-bit floating point values (IEEE-754 binary32) to
+ * 16-bit floating point values. The conversion is the same as
+ * float32ToFloat16(), using only integer operations that map onto SIMD
+ * instructions, so that compilers can vectorize the loop.
+ * \param value is the array of floating point data to convert.
+ * \param output receives count 16-bit floating point values.
+ * \param count is the number of values to convert.
+ */
+void float32ArrayToFloat16(const float* value, uint16_t* output, int count)
+{
+    int i;
+
+    for(i = 0; i < count; i++)
+    {
+        union
+        {
+            float Float;
+            uint32_t Integer;
+        }field;
+
+        uint32_t unsignedExponent;
+        uint32_t underflow;
+        uint32_t overflow;
+        uint32_t result;
+
+        field.Float = value[i];
+
+        unsignedExponent = (field.Integer >> 23) & 0xFF;
+        underflow = 0U - (uint32_t)(unsignedExponent < 127 - 31);
+        overflow  = 0U - (uint32_t)(unsignedExponent > 127 + 31);
+
+        result = ((unsignedExponent - (127 - 31)) << 9) | ((field.Integer & 0x007FFFFF) >> 14);
+        result = (result & ~(underflow | overflow)) | (0x7DFF & overflow);
+        result |= (field.Integer >> 16) & 0x8000;
+
+        output[i] = (uint16_t)result;
     }
 
-    // And the sign bit
-    if(value & 0x8000)
-        field.Integer |= 0x80000000;
+}// float32ArrayToFloat16
 
-    return field.Float;
 
-}// float16ToFloat32
+/*!
+ * Convert an array of 16-bit floating point representations to binary32
+ * (IEEE-754). The conversion is the same as float16ToFloat32(), written so
+ * that compilers can vectorize the loop.
+ * \param value is the array of float16 representations to convert.
+ * \param output receives count binary32 values.
+ * \param count is the number of values to convert.
+ */
+void float16ArrayToFloat32(const uint16_t* value, float* output, int count)
+{
+    int i;
+
+    for(i = 0; i < count; i++)
+    {
+        union
+        {
+            float Float;
+            uint32_t Integer;
+        }field;
+
+        uint32_t nonzero = 0U - (uint32_t)((value[i] & 0x7FFF) != 0);
+
+        field.Integer = ((((uint32_t)(value[i] & 0x7FFF)) << 14) + ((127 - 31) << 23)) & nonzero;
+        field.Integer |= ((uint32_t)(value[i] & 0x8000)) << 16;
+
+        output[i] = field.Float;
+    }
+
+}// float16ArrayToFloat32
 
 
 /*!
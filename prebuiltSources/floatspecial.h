@@ -51,9 +51,21 @@ float float24ToFloat32(uint32_t value);
 //! Convert a 32-bit floating point value to 16-bit floating point
 uint16_t float32ToFloat16(float value);
 
-//! Convert a IEEE-754 binary16 floating point representation to binary32
+//! Convert a 16-bit floating point representation to binary32
 float float16ToFloat32(uint16_t value);
 
+//! Convert an array of 32-bit floating point values to 24-bit floating point
+void float32ArrayToFloat24(const float* value, uint32_t* output, int count);
+
+//! Convert an array of 24-bit floating point representations to binary32
+void float24ArrayToFloat32(const uint32_t* value, float* output, int count);
+
+//! Convert an array of 32-bit floating point values to 16-bit floating point
+void float32ArrayToFloat16(const float* value, uint16_t* output, int count);
+
+//! Convert an array of 16-bit floating point representations to binary32
+void float16ArrayToFloat32(const uint16_t* value, float* output, int count);
+
 //! test the special float functionality
 int testSpecialFloat(void);
 
@@ -0,0 +1,482 @@
+// Large file support for 32 bit POSIX systems, before any system header
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "packetlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! The header of a cached index, which is followed by the entries
+typedef struct
+{
+    char magic[8];          //!< "PKTLOGIX"
+    uint32_t format;        //!< The format of the records, from the protocol
+    uint32_t entrySize;     //!< The size of one entry, which changes if the entry changes
+    uint64_t logSize;       //!< The size of the log when it was indexed
+    int64_t logModified;    //!< The modification time of the log when it was indexed
+    uint64_t numEntries;    //!< The number of entries that follow
+    uint64_t discarded;     //!< The number of bytes of the log that were not valid records
+    uint64_t logChecksum;   //!< The checksum of the start and end of the log when it was indexed
+}packetLogIndexHeader_t;
+
+static const char packetLogMagic[8] = {'P', 'K', 'T', 'L', 'O', 'G', 'I', 'X'};
+
+//! The number of bytes at each end of the log that are checksummed
+#define PACKET_LOG_CHECK_SIZE 4096
+
+
+/*!
+ * Map a file into memory for reading
+ * \param path is the name of the file
+ * \param size receives the number of bytes of the file
+ * \param modified receives the modification time of the file, to the
+ *        nanosecond where the system has it
+ * \return the mapping, or NULL if the file cannot be mapped. An empty file
+ *         cannot be mapped.
+ */
+static void* mapPacketLogFile(const char* path, uint64_t* size, int64_t* modified)
+{
+    void* base = NULL;
+
+    #ifdef _WIN32
+
+    LARGE_INTEGER length;
+    FILETIME written;
+    HANDLE mapping;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if(GetFileSizeEx(file, &length) && GetFileTime(file, NULL, NULL, &written) && (length.QuadPart > 0) && ((uint64_t)((SIZE_T)length.QuadPart) == (uint64_t)length.QuadPart))
+    {
+        // The view keeps the mapping open once the handles are closed
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping != NULL)
+        {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+
+        *size = (uint64_t)length.QuadPart;
+        *modified = (int64_t)((((uint64_t)written.dwHighDateTime) << 32) | written.dwLowDateTime);
+    }
+
+    CloseHandle(file);
+
+    #else
+
+    struct stat info;
+    int file = open(path, O_RDONLY);
+
+    if(file < 0)
+        return NULL;
+
+    // The whole file must fit in the address space
+    if((fstat(file, &info) == 0) && (info.st_size > 0) && ((uint64_t)((size_t)info.st_size) == (uint64_t)info.st_size))
+    {
+        base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+        if(base == MAP_FAILED)
+            base = NULL;
+
+        *size = (uint64_t)info.st_size;
+
+        // A log rewritten within a second of being indexed has the same st_mtime
+        #if defined(__APPLE__)
+        *modified = (int64_t)info.st_mtimespec.tv_sec*1000000000 + info.st_mtimespec.tv_nsec;
+        #elif defined(st_mtime)
+        // Systems that have st_mtim define st_mtime in terms of it
+        *modified = (int64_t)info.st_mtim.tv_sec*1000000000 + info.st_mtim.tv_nsec;
+        #else
+        *modified = (int64_t)info.st_mtime;
+        #endif
+    }
+
+    // The mapping stays valid once the file is closed
+    close(file);
+
+    #endif
+
+    return base;
+
+}// mapPacketLogFile
+
+
+/*!
+ * Unmap a file that was mapped by mapPacketLogFile()
+ * \param base is the mapping, which can be NULL
+ * \param size is the number of bytes of the mapping
+ */
+static void unmapPacketLogFile(const void* base, uint64_t size)
+{
+    if(base == NULL)
+        return;
+
+    #ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+    #else
+    munmap((void*)base, (size_t)size);
+    #endif
+
+}// unmapPacketLogFile
+
+
+/*!
+ * Get the checksum (FNV-1a) of the start and end of a packet log. This
+ * catches a log that is rewritten with the same size and modification time
+ * as when it was indexed, without reading all of a log whose index is cached.
+ * \param data is the contents of the log
+ * \param size is the number of bytes of the log
+ * \return the checksum
+ */
+static uint64_t checksumPacketLog(const uint8_t* data, uint64_t size)
+{
+    uint64_t checksum = 14695981039346656037ULL;
+    uint64_t head = size;
+    uint64_t tail;
+    uint64_t i;
+
+    if(head > PACKET_LOG_CHECK_SIZE)
+        head = PACKET_LOG_CHECK_SIZE;
+
+    // The end starts after the start, so a short log is only summed once
+    tail = size - head;
+    if(tail > PACKET_LOG_CHECK_SIZE)
+        tail = PACKET_LOG_CHECK_SIZE;
+
+    for(i = 0; i < head; i++)
+        checksum = (checksum ^ data[i])*1099511628211ULL;
+
+    for(i = size - tail; i < size; i++)
+        checksum = (checksum ^ data[i])*1099511628211ULL;
+
+    return checksum;
+
+}// checksumPacketLog
+
+
+/*!
+ * Compare two entries of the index, by packet identifier, then time, then offset
+ * \param left points to the first entry
+ * \param right points to the second entry
+ * \return less than, equal to, or greater than zero
+ */
+static int comparePacketLogEntries(const void* left, const void* right)
+{
+    const packetLogEntry_t* a = (const packetLogEntry_t*)left;
+    const packetLogEntry_t* b = (const packetLogEntry_t*)right;
+
+    if(a->id != b->id)
+        return (a->id < b->id) ? -1 : 1;
+
+    if(a->time != b->time)
+        return (a->time < b->time) ? -1 : 1;
+
+    if(a->offset != b->offset)
+        return (a->offset < b->offset) ? -1 : 1;
+
+    return 0;
+
+}// comparePacketLogEntries
+
+
+/*!
+ * Build the index of a packet log with one scan of the whole log
+ * \param log is the log, whose data and size have been set
+ * \param scan is the function that scans one record
+ * \return 0 if memory for the index could not be allocated, else 1
+ */
+static int buildPacketLogIndex(packetLog_t* log, packetLogScan_t scan)
+{
+    uint64_t capacity = 1024;
+    uint64_t offset = 0;
+    packetLogEntry_t entry;
+    packetLogEntry_t* entries = (packetLogEntry_t*)malloc(capacity*sizeof(packetLogEntry_t));
+
+    if(entries == NULL)
+        return 0;
+
+    log->numEntries = 0;
+    log->discarded = 0;
+
+    while(offset < log->size)
+    {
+        uint64_t remaining = log->size - offset;
+        int64_t result = scan(log->data + offset, remaining, &entry);
+
+        // The end of the log, which can be a record that was not finished
+        if((result == 0) || ((result > 0) && ((uint64_t)result > remaining)))
+        {
+            log->discarded += remaining;
+            break;
+        }
+
+        if(result < 0)
+        {
+            uint64_t skip = (uint64_t)(-result);
+
+            if(skip > remaining)
+                skip = remaining;
+
+            log->discarded += skip;
+            offset += skip;
+            continue;
+        }
+
+        if(log->numEntries >= capacity)
+        {
+            packetLogEntry_t* larger = (packetLogEntry_t*)realloc(entries, 2*capacity*sizeof(packetLogEntry_t));
+
+            if(larger == NULL)
+            {
+                free(entries);
+                return 0;
+            }
+
+            entries = larger;
+            capacity *= 2;
+        }
+
+        entry.offset = offset;
+        entry.size = (uint32_t)result;
+        entries[log->numEntries++] = entry;
+        offset += (uint64_t)result;
+    }
+
+    qsort(entries, (size_t)log->numEntries, sizeof(packetLogEntry_t), comparePacketLogEntries);
+
+    log->builtEntries = entries;
+    log->entries = entries;
+    return 1;
+
+}// buildPacketLogIndex
+
+
+/*!
+ * Write the index of a packet log to its sidecar file. Nothing is left
+ * behind if the file cannot be written completely, and a file that is cut
+ * short is rejected when it is next opened, since its size is wrong.
+ * \param log is the log, whose index has been built
+ * \param path is the name of the sidecar file
+ * \param format is the format of the records
+ * \param modified is the modification time of the log
+ * \param checksum is the checksum of the log from checksumPacketLog()
+ */
+static void writePacketLogIndex(const packetLog_t* log, const char* path, uint32_t format, int64_t modified, uint64_t checksum)
+{
+    packetLogIndexHeader_t header;
+    int ok;
+    FILE* file = fopen(path, "wb");
+
+    if(file == NULL)
+        return;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, packetLogMagic, sizeof(header.magic));
+    header.format = format;
+    header.entrySize = sizeof(packetLogEntry_t);
+    header.logSize = log->size;
+    header.logModified = modified;
+    header.numEntries = log->numEntries;
+    header.discarded = log->discarded;
+    header.logChecksum = checksum;
+
+    ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+
+    if(ok && (log->numEntries > 0))
+        ok = (fwrite(log->entries, sizeof(packetLogEntry_t), (size_t)log->numEntries, file) == (size_t)log->numEntries);
+
+    if(fclose(file) != 0)
+        ok = 0;
+
+    if(!ok)
+        remove(path);
+
+}// writePacketLogIndex
+
+
+/*!
+ * Map the cached index of a packet log, if it belongs to the log as it is now
+ * \param log is the log, whose data and size have been set
+ * \param path is the name of the sidecar file
+ * \param format is the format of the records
+ * \param modified is the modification time of the log
+ * \param checksum is the checksum of the log from checksumPacketLog()
+ * \return 1 if the cached index is used, else 0
+ */
+static int mapPacketLogIndex(packetLog_t* log, const char* path, uint32_t format, int64_t modified, uint64_t checksum)
+{
+    packetLogIndexHeader_t header;
+    int64_t indexModified;
+    uint64_t size = 0;
+    const uint8_t* base = (const uint8_t*)mapPacketLogFile(path, &size, &indexModified);
+
+    if(base == NULL)
+        return 0;
+
+    if(size >= sizeof(header))
+    {
+        memcpy(&header, base, sizeof(header));
+
+        if((memcmp(header.magic, packetLogMagic, sizeof(header.magic)) == 0) &&
+           (header.format == format) &&
+           (header.entrySize == sizeof(packetLogEntry_t)) &&
+           (header.logSize == log->size) &&
+           (header.logModified == modified) &&
+           (header.logChecksum == checksum) &&
+           (header.numEntries == (size - sizeof(header))/sizeof(packetLogEntry_t)) &&
+           ((size - sizeof(header)) % sizeof(packetLogEntry_t) == 0))
+        {
+            // The header is a multiple of 8 bytes, so the entries are aligned
+            log->indexMapping = (void*)base;
+            log->indexSize = size;
+            log->entries = (const packetLogEntry_t*)(base + sizeof(header));
+            log->numEntries = header.numEntries;
+            log->discarded = header.discarded;
+            return 1;
+        }
+    }
+
+    unmapPacketLogFile(base, size);
+    return 0;
+
+}// mapPacketLogIndex
+
+
+/*!
+ * Open a packet log for reading. The log is mapped into memory and its index
+ * is mapped from the sidecar file, if that was made from the same log: one
+ * with the same size, modification time, and checksum of its start and end.
+ * If it was not, the index is built by scanning the log, and the sidecar file
+ * is written for next time. The sidecar is only a cache: if it cannot be
+ * written the log is still opened.
+ * \param log receives the open log
+ * \param path is the name of the log file. The sidecar file has the same
+ *        name, with ".idx" appended
+ * \param scan is the function that scans one record of the log
+ * \param format identifies the layout of the records, so that an index made
+ *        by a different protocol is not used
+ * \return 0 if the log could not be opened, else 1. An empty log cannot be
+ *         opened.
+ */
+int openPacketLog(packetLog_t* log, const char* path, packetLogScan_t scan, uint32_t format)
+{
+    int64_t modified = 0;
+    uint64_t checksum;
+    char* indexPath;
+
+    memset(log, 0, sizeof(packetLog_t));
+
+    log->data = (const uint8_t*)mapPacketLogFile(path, &log->size, &modified);
+    if(log->data == NULL)
+        return 0;
+
+    checksum = checksumPacketLog(log->data, log->size);
+
+    indexPath = (char*)malloc(strlen(path) + 5);
+    if(indexPath == NULL)
+    {
+        closePacketLog(log);
+        return 0;
+    }
+
+    strcpy(indexPath, path);
+    strcat(indexPath, ".idx");
+
+    if(!mapPacketLogIndex(log, indexPath, format, modified, checksum))
+    {
+        if(!buildPacketLogIndex(log, scan))
+        {
+            free(indexPath);
+            closePacketLog(log);
+            return 0;
+        }
+
+        writePacketLogIndex(log, indexPath, format, modified, checksum);
+    }
+
+    free(indexPath);
+    return 1;
+
+}// openPacketLog
+
+
+/*!
+ * Close a packet log, after which none of its records can be used
+ * \param log is the log to close
+ */
+void closePacketLog(packetLog_t* log)
+{
+    unmapPacketLogFile(log->data, log->size);
+    unmapPacketLogFile(log->indexMapping, log->indexSize);
+    free(log->builtEntries);
+    memset(log, 0, sizeof(packetLog_t));
+
+}// closePacketLog
+
+
+/*!
+ * Find the first entry of the index that comes after a packet identifier and time
+ * \param log is the open log
+ * \param id is the packet identifier
+ * \param time is the time
+ * \param inclusive should be non-zero to skip the entries at time, else they are not skipped
+ * \return the index of the entry, which is numEntries if there is none
+ */
+static uint64_t boundPacketLogEntries(const packetLog_t* log, uint32_t id, uint64_t time, int inclusive)
+{
+    uint64_t low = 0;
+    uint64_t high = log->numEntries;
+
+    while(low < high)
+    {
+        uint64_t middle = low + (high - low)/2;
+        const packetLogEntry_t* entry = &log->entries[middle];
+
+        if((entry->id < id) || ((entry->id == id) && ((entry->time < time) || (inclusive && (entry->time == time)))))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+
+}// boundPacketLogEntries
+
+
+/*!
+ * Find the records of one packet identifier within a range of time. The
+ * records are consecutive entries of the index, in order of time.
+ * \param log is the open log
+ * \param id is the packet identifier to find
+ * \param start is the earliest time to find
+ * \param end is the latest time to find, use UINT64_MAX for all of them
+ * \param first receives the index of the first entry that was found
+ * \return the number of entries that were found
+ */
+uint64_t findPacketLogEntries(const packetLog_t* log, uint32_t id, uint64_t start, uint64_t end, uint64_t* first)
+{
+    uint64_t last;
+
+    *first = boundPacketLogEntries(log, id, start, 0);
+
+    if(end < start)
+        return 0;
+
+    last = boundPacketLogEntries(log, id, end, 1);
+
+    return last - *first;
+
+}// findPacketLogEntries
@@ -0,0 +1,66 @@
+#ifndef PACKETLOG_H
+#define PACKETLOG_H
+
+// C++ compilers: don't mangle us
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \file
+ * Routines that read a log of recorded packets in place. The log file is
+ * memory mapped, and an index of the records by packet identifier and time
+ * is built with one scan of the log. The index is cached in a sidecar file
+ * next to the log (the log's name with ".idx" appended), so the next time the
+ * log is opened only the index is mapped, and the log is only read to check
+ * that it has not changed since it was indexed.
+ * The layout of a record is up to the protocol, which supplies the function
+ * that scans one record.
+ */
+
+#include <stdint.h>
+
+//! One record of a packet log in the index
+typedef struct
+{
+    uint64_t offset;    //!< The location of the record in the log
+    uint64_t time;      //!< The time of the record, in the units of the log
+    uint32_t id;        //!< The identifier of the packet in the record
+    uint32_t size;      //!< The number of bytes of the record
+}packetLogEntry_t;
+
+/*!
+ * Function which scans the record at the start of a buffer. It returns the
+ * number of bytes of the record, having filled out the time, id, and size of
+ * the entry; or 0 if there is no complete record (the end of the log); or a
+ * negative number of bytes to skip to get to the next possible record, if the
+ * data are not a valid record.
+ */
+typedef int64_t (*packetLogScan_t)(const uint8_t* buf, uint64_t size, packetLogEntry_t* entry);
+
+//! A packet log that is open for reading
+typedef struct
+{
+    const uint8_t* data;                //!< The contents of the log
+    uint64_t size;                      //!< The number of bytes of the log
+    const packetLogEntry_t* entries;    //!< The index, sorted by packet identifier, then time, then offset
+    uint64_t numEntries;                //!< The number of records in the index
+    uint64_t discarded;                 //!< The number of bytes that were not valid records, when the index was built
+    void* indexMapping;                 //!< The mapping of the cached index, private
+    uint64_t indexSize;                 //!< The number of bytes of the cached index mapping, private
+    packetLogEntry_t* builtEntries;     //!< The index if it was built and not mapped, private
+}packetLog_t;
+
+//! Open a packet log, using its cached index or building and caching a new one
+int openPacketLog(packetLog_t* log, const char* path, packetLogScan_t scan, uint32_t format);
+
+//! Close a packet log
+void closePacketLog(packetLog_t* log);
+
+//! Find the records of one packet identifier within a range of time
+uint64_t findPacketLogEntries(const packetLog_t* log, uint32_t id, uint64_t start, uint64_t end, uint64_t* first);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // PACKETLOG_H
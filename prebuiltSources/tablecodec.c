@@ -0,0 +1,467 @@
+#include "tablecodec.h"
+#include <string.h>
+
+/*!
+ * Load an unsigned integer from bytes
+ * \param data points to the bytes
+ * \param size is the number of bytes, from 1 to 8
+ * \param bigendian should be non-zero if the most significant byte is first
+ * \return the integer
+ */
+static uint64_t loadTableBytes(const uint8_t* data, int size, int bigendian)
+{
+    uint64_t value = 0;
+    int i;
+
+    if(bigendian)
+    {
+        for(i = 0; i < size; i++)
+            value = (value << 8) | data[i];
+    }
+    else
+    {
+        for(i = size - 1; i >= 0; i--)
+            value = (value << 8) | data[i];
+    }
+
+    return value;
+
+}// loadTableBytes
+
+
+/*!
+ * Store the least significant bytes of an integer
+ * \param value is the integer to store
+ * \param data receives the bytes
+ * \param size is the number of bytes, from 1 to 8
+ * \param bigendian should be non-zero to store the most significant byte first
+ */
+static void storeTableBytes(uint64_t value, uint8_t* data, int size, int bigendian)
+{
+    int i;
+
+    if(bigendian)
+    {
+        for(i = size - 1; i >= 0; i--)
+        {
+            data[i] = (uint8_t)value;
+            value >>= 8;
+        }
+    }
+    else
+    {
+        for(i = 0; i < size; i++)
+        {
+            data[i] = (uint8_t)value;
+            value >>= 8;
+        }
+    }
+
+}// storeTableBytes
+
+
+/*!
+ * Read an integer member of the user structure
+ * \param member points to the member
+ * \param size is the size of the member in bytes
+ * \param isSigned should be non-zero to sign extend the member
+ * \return the member, sign extended if it is signed
+ */
+static uint64_t readTableMember(const uint8_t* member, int size, int isSigned)
+{
+    switch(size)
+    {
+    case 1:
+    {
+        uint8_t value;
+        memcpy(&value, member, 1);
+        return isSigned ? (uint64_t)(int64_t)(int8_t)value : value;
+    }
+    case 2:
+    {
+        uint16_t value;
+        memcpy(&value, member, 2);
+        return isSigned ? (uint64_t)(int64_t)(int16_t)value : value;
+    }
+    case 4:
+    {
+        uint32_t value;
+        memcpy(&value, member, 4);
+        return isSigned ? (uint64_t)(int64_t)(int32_t)value : value;
+    }
+    default:
+    {
+        uint64_t value;
+        memcpy(&value, member, 8);
+        return value;
+    }
+    }
+
+}// readTableMember
+
+
+/*!
+ * Write an integer member of the user structure, discarding the bits that
+ * do not fit
+ * \param member points to the member
+ * \param size is the size of the member in bytes
+ * \param value is the integer to write
+ */
+static void writeTableMember(uint8_t* member, int size, uint64_t value)
+{
+    switch(size)
+    {
+    case 1:
+    {
+        uint8_t number = (uint8_t)value;
+        memcpy(member, &number, 1);
+        break;
+    }
+    case 2:
+    {
+        uint16_t number = (uint16_t)value;
+        memcpy(member, &number, 2);
+        break;
+    }
+    case 4:
+    {
+        uint32_t number = (uint32_t)value;
+        memcpy(member, &number, 4);
+        break;
+    }
+    default:
+        memcpy(member, &value, 8);
+        break;
+    }
+
+}// writeTableMember
+
+
+/*!
+ * Convert a floating point value to an integer, the way a cast does
+ * \param number is the value to convert
+ * \return the integer, as two's complement if it is negative
+ */
+static uint64_t tableDoubleToInteger(double number)
+{
+    if(number < 0)
+        return (uint64_t)(int64_t)number;
+    else
+        return (uint64_t)number;
+}
+
+
+/*!
+ * Get the number of elements of a field that are coded
+ * \param field is the field
+ * \param user is the user structure
+ * \return the number of elements, which is 0 if the field is not present
+ */
+static int getTableCount(const tableField_t* field, const uint8_t* user)
+{
+    int count = field->count;
+
+    if(field->flags & TABLE_CONDITION)
+    {
+        if(readTableMember(user + field->condition, 1 << ((field->flags >> 6) & 3), 0) == 0)
+            return 0;
+    }
+
+    if(field->flags & TABLE_VARIABLE)
+    {
+        uint64_t reference = readTableMember(user + field->reference, 1 << ((field->flags >> 4) & 3), (field->flags & TABLE_REFERENCE_SIGNED) != 0);
+
+        // A negative number of elements codes none
+        if((field->flags & TABLE_REFERENCE_SIGNED) && ((int64_t)reference < 0))
+            count = 0;
+        else if(reference < (uint64_t)count)
+            count = (int)reference;
+    }
+
+    return count;
+
+}// getTableCount
+
+
+/*!
+ * Get the encoded integer of one element of a field
+ * \param table is the packet table
+ * \param field is the field
+ * \param user is the user structure
+ * \param i is the element of the field
+ * \return the encoded integer, or the bits of the encoded float
+ */
+static uint64_t encodeTableValue(const tablePacket_t* table, const tableField_t* field, const uint8_t* user, int i)
+{
+    int memoryKind = field->memory >> 4;
+    int memorySize = field->memory & 0x0F;
+    int encodedKind = field->encoded >> 4;
+    int encodedSize = field->encoded & 0x0F;
+    int isFloat = 0;
+    uint64_t integer = 0;
+    double number = 0;
+
+    // The value from memory, or the constant
+    if(field->flags & TABLE_CONSTANT)
+    {
+        number = table->constants[field->constant + ((field->flags & TABLE_SCALED) ? 2 : 0)];
+        isFloat = 1;
+    }
+    else if(memoryKind == TABLE_FLOAT)
+    {
+        const uint8_t* member = user + field->offset + i*memorySize;
+
+        if(memorySize == 8)
+        {
+            double value;
+            memcpy(&value, member, 8);
+            number = value;
+        }
+        else
+        {
+            float value;
+            memcpy(&value, member, 4);
+            number = value;
+        }
+
+        isFloat = 1;
+    }
+    else if(memoryKind != TABLE_NONE)
+        integer = readTableMember(user + field->offset + i*memorySize, memorySize, memoryKind == TABLE_SIGNED);
+
+    if((field->flags & TABLE_SCALED) || (encodedKind == TABLE_FLOAT))
+    {
+        if(!isFloat)
+        {
+            if(memoryKind == TABLE_SIGNED)
+                number = (double)(int64_t)integer;
+            else
+                number = (double)integer;
+        }
+    }
+
+    if(field->flags & TABLE_SCALED)
+    {
+        double scaler = table->constants[field->constant + 1];
+
+        if(encodedKind == TABLE_SIGNED)
+        {
+            int64_t max = (int64_t)(((uint64_t)1 << (8*encodedSize - 1)) - 1);
+            double scaled = number*scaler;
+
+            // Make sure number fits in the range
+            if(scaled >= 0)
+            {
+                if(scaled >= (double)max)
+                    return (uint64_t)max;
+                else
+                    return (uint64_t)(int64_t)(scaled + 0.5);
+            }
+            else
+            {
+                if(scaled <= (double)(-max - 1))
+                    return (uint64_t)(-max - 1);
+                else
+                    return (uint64_t)(int64_t)(scaled - 0.5);
+            }
+        }
+        else
+        {
+            uint64_t max = (encodedSize >= 8) ? ~(uint64_t)0 : (((uint64_t)1 << (8*encodedSize)) - 1);
+            double scaled = (number - table->constants[field->constant])*scaler;
+
+            // Make sure number fits in the range
+            if(scaled >= (double)max)
+                return max;
+            else if(scaled <= 0)
+                return 0;
+            else
+                return (uint64_t)(scaled + 0.5);
+        }
+    }
+    else if(encodedKind == TABLE_FLOAT)
+    {
+        if(encodedSize == 8)
+        {
+            uint64_t bits;
+            memcpy(&bits, &number, 8);
+            return bits;
+        }
+        else
+        {
+            float value = (float)number;
+            uint32_t bits;
+            memcpy(&bits, &value, 4);
+            return bits;
+        }
+    }
+    else if(isFloat)
+        return tableDoubleToInteger(number);
+    else
+        return integer;
+
+}// encodeTableValue
+
+
+/*!
+ * Decode one element of a field into the user structure
+ * \param table is the packet table
+ * \param field is the field
+ * \param user is the user structure
+ * \param i is the element of the field
+ * \param raw is the encoded integer, or the bits of the encoded float
+ */
+static void decodeTableValue(const tablePacket_t* table, const tableField_t* field, uint8_t* user, int i, uint64_t raw)
+{
+    int memoryKind = field->memory >> 4;
+    int memorySize = field->memory & 0x0F;
+    int encodedKind = field->encoded >> 4;
+    int encodedSize = field->encoded & 0x0F;
+    uint8_t* member = user + field->offset + i*memorySize;
+    int isFloat = 0;
+    double number = 0;
+
+    // Sign extend the encoding
+    if((encodedKind == TABLE_SIGNED) && (encodedSize < 8) && (raw >> (8*encodedSize - 1)))
+        raw |= ~(uint64_t)0 << (8*encodedSize);
+
+    if(encodedKind == TABLE_FLOAT)
+    {
+        if(encodedSize == 8)
+        {
+            // Infinity, NaN, and denormalized numbers are replaced with zero
+            if((table->options & TABLE_CHECK_FLOATS) && ((((raw >> 52) & 0x7FF) == 0x7FF) || ((((raw >> 52) & 0x7FF) == 0) && (raw & 0x000FFFFFFFFFFFFFULL))))
+                number = 0;
+            else
+                memcpy(&number, &raw, 8);
+        }
+        else
+        {
+            uint32_t bits = (uint32_t)raw;
+            float value;
+
+            if((table->options & TABLE_CHECK_FLOATS) && ((((bits >> 23) & 0xFF) == 0xFF) || ((((bits >> 23) & 0xFF) == 0) && (bits & 0x007FFFFF))))
+                value = 0;
+            else
+                memcpy(&value, &bits, 4);
+
+            number = value;
+        }
+
+        isFloat = 1;
+    }
+    else if(field->flags & TABLE_SCALED)
+    {
+        double invscaler = 1.0/table->constants[field->constant + 1];
+
+        if(encodedKind == TABLE_SIGNED)
+            number = invscaler*(double)(int64_t)raw;
+        else
+            number = table->constants[field->constant] + invscaler*(double)raw;
+
+        isFloat = 1;
+    }
+
+    if(memoryKind == TABLE_FLOAT)
+    {
+        if(!isFloat)
+        {
+            if(encodedKind == TABLE_SIGNED)
+                number = (double)(int64_t)raw;
+            else
+                number = (double)raw;
+        }
+
+        if(memorySize == 8)
+            memcpy(member, &number, 8);
+        else
+        {
+            float value = (float)number;
+            memcpy(member, &value, 4);
+        }
+    }
+    else if(isFloat)
+        writeTableMember(member, memorySize, tableDoubleToInteger(number));
+    else
+        writeTableMember(member, memorySize, raw);
+
+}// decodeTableValue
+
+
+/*!
+ * Encode a structure as described by a packet table. Each element of each
+ * field is converted from its in-memory type to its encoding, with the same
+ * rounding and clamping as the scaledencode routines.
+ * \param table is the packet table
+ * \param user is the structure to encode, which may be NULL if every field of
+ *        the table is constant or reserved
+ * \param data receives the encoded bytes
+ * \return the number of bytes encoded
+ */
+int encodeTableFields(const tablePacket_t* table, const void* user, uint8_t* data)
+{
+    const uint8_t* base = (const uint8_t*)user;
+    int bigendian = table->options & TABLE_BIG_ENDIAN;
+    int byteindex = 0;
+    int f, i;
+
+    for(f = 0; f < table->numFields; f++)
+    {
+        const tableField_t* field = &table->fields[f];
+        int encodedSize = field->encoded & 0x0F;
+        int count = getTableCount(field, base);
+
+        for(i = 0; i < count; i++)
+        {
+            storeTableBytes(encodeTableValue(table, field, base, i), data + byteindex, encodedSize, bigendian);
+            byteindex += encodedSize;
+        }
+    }
+
+    return byteindex;
+
+}// encodeTableFields
+
+
+/*!
+ * Decode a structure as described by a packet table. The data length is
+ * checked before each field, so short data are never read past their end.
+ * \param table is the packet table
+ * \param user receives the decoded fields
+ * \param data is the encoded bytes
+ * \param numBytes is the number of encoded bytes
+ * \return 0 if the data are too short for the fields, else 1
+ */
+int decodeTableFields(const tablePacket_t* table, void* user, const uint8_t* data, int numBytes)
+{
+    uint8_t* base = (uint8_t*)user;
+    int bigendian = table->options & TABLE_BIG_ENDIAN;
+    int byteindex = 0;
+    int f, i;
+
+    for(f = 0; f < table->numFields; f++)
+    {
+        const tableField_t* field = &table->fields[f];
+        int encodedSize = field->encoded & 0x0F;
+        int count = getTableCount(field, base);
+
+        if(byteindex + count*encodedSize > numBytes)
+            return 0;
+
+        // Reserved space is skipped
+        if((field->memory >> 4) == TABLE_NONE)
+        {
+            byteindex += count*encodedSize;
+            continue;
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            decodeTableValue(table, field, base, i, loadTableBytes(data + byteindex, encodedSize, bigendian));
+            byteindex += encodedSize;
+        }
+    }
+
+    return 1;
+
+}// decodeTableFields
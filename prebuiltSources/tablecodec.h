@@ -0,0 +1,91 @@
+#ifndef TABLECODEC_H
+#define TABLECODEC_H
+
+// C++ compilers: don't mangle us
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \file
+ * Routines that encode and decode packets which are described by a table of
+ * their fields, rather than by straight line code for each field. One small
+ * interpreter serves every packet, so each packet only costs its table.
+ */
+
+#include <stdint.h>
+
+//! The value is an unsigned integer
+#define TABLE_UNSIGNED 0
+
+//! The value is a signed integer
+#define TABLE_SIGNED 1
+
+//! The value is a float or double
+#define TABLE_FLOAT 2
+
+//! There is no value in memory, the field is reserved space or a constant
+#define TABLE_NONE 3
+
+//! Combine the kind and size in bytes of a value for a table field
+#define TABLE_TYPE(kind, size) ((uint8_t)(((kind) << 4) | (size)))
+
+//! The field is scaled from its in-memory value to an integer encoding
+#define TABLE_SCALED 0x01
+
+//! The field always encodes a constant value
+#define TABLE_CONSTANT 0x02
+
+//! The number of elements of the array is given by another member
+#define TABLE_VARIABLE 0x04
+
+//! The field is only present if another member is non-zero
+#define TABLE_CONDITION 0x08
+
+//! Code the size of the member that gives the number of elements
+#define TABLE_REFERENCE_SIZE(size) ((uint8_t)((((size) >= 8) ? 3 : ((size) >= 4) ? 2 : ((size) >= 2) ? 1 : 0) << 4))
+
+//! Code the size of the member that says if the field is present
+#define TABLE_CONDITION_SIZE(size) ((uint8_t)((((size) >= 8) ? 3 : ((size) >= 4) ? 2 : ((size) >= 2) ? 1 : 0) << 6))
+
+//! The member that gives the number of elements is signed, a negative number codes no elements
+#define TABLE_REFERENCE_SIGNED 0x100
+
+//! Options of a packet table: multi-byte fields are big endian
+#define TABLE_BIG_ENDIAN 0x01
+
+//! Options of a packet table: decoded floating point values are zeroed if they are infinity, NaN, or denormalized
+#define TABLE_CHECK_FLOATS 0x02
+
+//! One field of a packet table, which is 14 bytes
+typedef struct
+{
+    uint16_t offset;    //!< The offset of the member in the user structure
+    uint16_t count;     //!< The number of elements, 1 if not an array
+    uint16_t reference; //!< The offset of the member that gives the number of elements, if TABLE_VARIABLE
+    uint16_t condition; //!< The offset of the member that says if this field is present, if TABLE_CONDITION
+    uint8_t memory;     //!< The TABLE_TYPE() of one element in memory
+    uint8_t encoded;    //!< The TABLE_TYPE() of one element on the wire
+    uint16_t flags;     //!< The TABLE_ flags, and the sizes of the reference and condition members
+    uint8_t constant;   //!< The index of the minimum and scaler (if TABLE_SCALED), followed by the constant (if TABLE_CONSTANT)
+}tableField_t;
+
+//! The table that describes a packet
+typedef struct
+{
+    const tableField_t* fields; //!< The fields in encoded order
+    const double* constants;    //!< The scaling and constant values referenced by the fields
+    uint16_t numFields;         //!< The number of fields
+    uint8_t options;            //!< The TABLE_BIG_ENDIAN and TABLE_CHECK_FLOATS options
+}tablePacket_t;
+
+//! Encode a structure as described by a packet table
+int encodeTableFields(const tablePacket_t* table, const void* user, uint8_t* data);
+
+//! Decode a structure as described by a packet table
+int decodeTableFields(const tablePacket_t* table, void* user, const uint8_t* data, int numBytes);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TABLECODEC_H
@@ -0,0 +1,255 @@
+#include "protocoldocumentation.h"
+#include "protocolfile.h"
+#include "protocolstatistics.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <iostream>
+
+
+/*!
+ * Construct the documentation object for a protocol. No tools are started
+ * until startMarkdown() or startDoxygen() is called.
+ * \param protocolName is the name of the protocol
+ */
+ProtocolDocumentation::ProtocolDocumentation(const QString& protocolName) :
+    name(protocolName),
+    markdown(NULL),
+    doxygen(NULL),
+    markdownStatus(-1),
+    doxygenStatus(-1)
+{
+}
+
+
+/*!
+ * Destroying a QProcess kills it, so wait for the tools first
+ */
+ProtocolDocumentation::~ProtocolDocumentation(void)
+{
+    waitForFinished();
+
+    delete markdown;
+    delete doxygen;
+}
+
+
+/*!
+ * Start multimarkdown on the markdown file of the protocol. The markdown file
+ * must already be complete. The html output goes to a file with the same base
+ * name.
+ */
+void ProtocolDocumentation::startMarkdown(void)
+{
+    if(markdown != NULL)
+        return;
+
+    markdown = new QProcess();
+    markdownTimer.start();
+
+    // Tell the QProcess to send stdout to a file, since that's how the script outputs its data
+    markdown->setStandardOutputFile(QString(name + ".html"));
+
+    QStringList arguments;
+    arguments << name + ".markdown";      // The name of the source file
+    #if defined(__APPLE__) && defined(__MACH__)
+    markdown->start(QString("/usr/local/bin/MultiMarkdown"), arguments);
+    #else
+    markdown->start(QString("multimarkdown"), arguments);
+    #endif
+
+}// ProtocolDocumentation::startMarkdown
+
+
+/*!
+ * Start doxygen on the Doxyfile in the working directory. All of the
+ * generated source files, and the Doxyfile, must already be complete.
+ */
+void ProtocolDocumentation::startDoxygen(void)
+{
+    if(doxygen != NULL)
+        return;
+
+    doxygen = new QProcess();
+    doxygenTimer.start();
+
+    // Nobody reads the output while we are busy, and doxygen would stall if
+    // it filled the pipe, so throw it away
+    doxygen->setStandardOutputFile(QProcess::nullDevice());
+    doxygen->setStandardErrorFile(QProcess::nullDevice());
+
+    // On the mac doxygen is a utility inside the Doxygen.app bundle.
+    #if defined(__APPLE__) && defined(__MACH__)
+    doxygen->start(QString("/Applications/Doxygen.app/Contents/Resources/doxygen"), QStringList("Doxyfile"));
+    #else
+    doxygen->start(QString("doxygen"), QStringList("Doxyfile"));
+    #endif
+
+}// ProtocolDocumentation::startDoxygen
+
+
+/*!
+ * Wait for the tools that were started to finish. The tools run concurrently
+ * so the total wait is only as long as the slowest one. This also removes the
+ * temporary files used to configure doxygen.
+ * \return true if all the tools that were started exited with status 0
+ */
+bool ProtocolDocumentation::waitForFinished(void)
+{
+    bool success = true;
+
+    if(markdown != NULL)
+    {
+        if(markdown->state() != QProcess::NotRunning)
+            markdown->waitForFinished(-1);
+
+        // This includes any time the tool was finished before we looked
+        if(markdownTimer.isValid())
+        {
+            ProtocolStatistics::addPhaseTime("multimarkdown", markdownTimer.nsecsElapsed());
+            markdownTimer.invalidate();
+        }
+
+        markdownStatus = getExitStatus(markdown);
+        if(markdownStatus != 0)
+            success = false;
+    }
+
+    if(doxygen != NULL)
+    {
+        if(doxygen->state() != QProcess::NotRunning)
+            doxygen->waitForFinished(-1);
+
+        if(doxygenTimer.isValid())
+        {
+            ProtocolStatistics::addPhaseTime("doxygen", doxygenTimer.nsecsElapsed());
+            doxygenTimer.invalidate();
+        }
+
+        // Delete our temporary files
+        ProtocolFile::deleteFile("Doxyfile");
+        ProtocolFile::deleteFile("ProtocolDoxyfile");
+
+        doxygenStatus = getExitStatus(doxygen);
+        if(doxygenStatus != 0)
+            success = false;
+    }
+
+    return success;
+
+}// ProtocolDocumentation::waitForFinished
+
+
+/*!
+ * Write the exit status of the tools to the status file. There is one line for
+ * each tool that was started, giving the tool name and its exit status. An
+ * exit status of -1 means the tool could not be started, or crashed.
+ * \return true if the file was written
+ */
+bool ProtocolDocumentation::writeStatusFile(void) const
+{
+    QString status;
+
+    if(markdown != NULL)
+        status += "multimarkdown " + QString().setNum(markdownStatus) + "\n";
+
+    if(doxygen != NULL)
+        status += "doxygen " + QString().setNum(doxygenStatus) + "\n";
+
+    return ProtocolFile::writeFileIfChanged(getStatusFileName(name), status);
+
+}// ProtocolDocumentation::writeStatusFile
+
+
+/*!
+ * Run the tools in a separate process, which is another instance of ProtoGen,
+ * so the generated code is available before the documentation is complete.
+ * The status file is removed now, and written by the separate process when
+ * the tools finish.
+ * \param protocolName is the name of the protocol
+ * \param markdown should be true to run multimarkdown
+ * \param doxygen should be true to run doxygen
+ * \return true if the separate process was started
+ */
+bool ProtocolDocumentation::startDetached(const QString& protocolName, bool markdown, bool doxygen)
+{
+    if(!markdown && !doxygen)
+        return true;
+
+    ProtocolFile::deleteFile(getStatusFileName(protocolName));
+
+    QStringList arguments;
+    arguments << "-run-documentation" << protocolName;
+
+    if(!markdown)
+        arguments << "-no-markdown";
+
+    if(!doxygen)
+        arguments << "-no-doxygen";
+
+    if(!QProcess::startDetached(QCoreApplication::applicationFilePath(), arguments, QDir::currentPath()))
+    {
+        std::cout << "Failed to start documentation process for " << protocolName.toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+
+}// ProtocolDocumentation::startDetached
+
+
+/*!
+ * Run the tools and report their status in the status file. This is the
+ * entry point of the process started by startDetached().
+ * \param arguments are the arguments that follow "-run-documentation", the
+ *        first of which is the protocol name
+ * \return 0 if all the tools exited with status 0, else 1
+ */
+int ProtocolDocumentation::runDetached(const QStringList& arguments)
+{
+    if(arguments.isEmpty())
+        return 1;
+
+    ProtocolDocumentation documentation(arguments.at(0));
+
+    // Both tools are started before waiting for either
+    if(!arguments.contains("-no-markdown", Qt::CaseInsensitive))
+        documentation.startMarkdown();
+
+    if(!arguments.contains("-no-doxygen", Qt::CaseInsensitive))
+        documentation.startDoxygen();
+
+    bool success = documentation.waitForFinished();
+
+    documentation.writeStatusFile();
+
+    if(success)
+        return 0;
+    else
+        return 1;
+
+}// ProtocolDocumentation::runDetached
+
+
+/*!
+ * Get the name of the file that the detached tools report their status in
+ * \param protocolName is the name of the protocol
+ * \return the status file name, relative to the working directory
+ */
+QString ProtocolDocumentation::getStatusFileName(const QString& protocolName)
+{
+    return protocolName + "Documentation.status";
+}
+
+
+/*!
+ * Get the exit status of a finished tool
+ * \param process is the tool process, which must not be running
+ * \return the exit code of the tool, or -1 if it did not start or did not exit normally
+ */
+int ProtocolDocumentation::getExitStatus(const QProcess* process)
+{
+    if((process->error() != QProcess::UnknownError) || (process->exitStatus() != QProcess::NormalExit))
+        return -1;
+
+    return process->exitCode();
+}
@@ -0,0 +1,61 @@
+#ifndef PROTOCOLDOCUMENTATION_H
+#define PROTOCOLDOCUMENTATION_H
+
+/*!
+ * \file
+ * Run the external tools that turn the generated documentation into HTML
+ *
+ * multimarkdown converts the markdown output and doxygen processes the
+ * generated source code. Both can take longer than the code generation, so
+ * they run while ProtoGen is working, or after ProtoGen has exited.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QProcess>
+#include <QElapsedTimer>
+
+class ProtocolDocumentation
+{
+public:
+    //! Construct the documentation object for a protocol
+    ProtocolDocumentation(const QString& protocolName);
+
+    //! Wait for any running tools before destroying the object
+    ~ProtocolDocumentation(void);
+
+    //! Start multimarkdown on the markdown file of the protocol
+    void startMarkdown(void);
+
+    //! Start doxygen on the Doxyfile in the working directory
+    void startDoxygen(void);
+
+    //! Wait for the tools to finish and remove the temporary files
+    bool waitForFinished(void);
+
+    //! Write the exit status of the tools to the status file
+    bool writeStatusFile(void) const;
+
+    //! Run the tools in a separate process that outlives ProtoGen
+    static bool startDetached(const QString& protocolName, bool markdown, bool doxygen);
+
+    //! Run the tools from the separate process started by startDetached()
+    static int runDetached(const QStringList& arguments);
+
+    //! Get the name of the file that the detached tools report their status in
+    static QString getStatusFileName(const QString& protocolName);
+
+protected:
+    //! Get the exit status of a finished tool
+    static int getExitStatus(const QProcess* process);
+
+    QString name;           //!< Base name of the protocol
+    QProcess* markdown;     //!< The multimarkdown process, or NULL
+    QProcess* doxygen;      //!< The doxygen process, or NULL
+    int markdownStatus;     //!< Exit status of multimarkdown, -1 if it did not run correctly
+    int doxygenStatus;      //!< Exit status of doxygen, -1 if it did not run correctly
+    QElapsedTimer markdownTimer;    //!< Time since multimarkdown started, until its time is reported
+    QElapsedTimer doxygenTimer;     //!< Time since doxygen started, until its time is reported
+};
+
+#endif // PROTOCOLDOCUMENTATION_H
@@ -1,6 +1,7 @@
 #include "protocolfield.h"
 #include "protocolparser.h"
 #include "shuntingyard.h"
+#include "protocolscaling.h"
 #include <QString>
 #include <QDomElement>
 #include <iostream>
@@ -14,6 +15,7 @@ TypeData::TypeData() :
     isEnum(false),
     isString(false),
     isFixedString(false),
+    isVarint(false),
     isNull(false),
     bits(8)
 {
@@ -28,6 +30,7 @@ TypeData::TypeData(const TypeData& that) :
     isEnum(that.isEnum),
     isString(that.isString),
     isFixedString(that.isFixedString),
+    isVarint(that.isVarint),
     isNull(that.isNull),
     bits(that.bits)
 {
@@ -153,6 +156,39 @@ void TypeData::extractType(const QString& typeString, const ProtocolSupport& sup
             }
         }
     }
+    else if(type.startsWith("var", Qt::CaseInsensitive))
+    {
+        // Zero bits means the width follows the in memory type
+        bits = extractPositiveInt(type);
+        isSigned = !type.startsWith("varu", Qt::CaseInsensitive);
+
+        if(inMemory)
+        {
+            std::cout << name.toStdString() << ": " << "variable length integers are only an encoding, fixed width in memory type used" << std::endl;
+
+            if(bits == 0)
+                bits = 32;
+
+            extractType(QString(isSigned ? "int" : "uint") + QString().setNum(bits), support, name, inMemory);
+            return;
+        }
+
+        isVarint = true;
+
+        if(((bits % 8) != 0) || (bits > 64))
+        {
+            std::cout << name.toStdString() << ": " << "variable length integer types must be 8, 16, 24, 32, 40, 48, 56, or 64 bits" << std::endl;
+            bits = 8*((bits + 7)/8);
+            if(bits > 64)
+                bits = 64;
+        }
+
+        if((bits > 32) && (support.int64 == false))
+        {
+            std::cout << name.toStdString() << ": " << "Integers greater than 32 bits are disabled in this protocol" << std::endl;
+            bits = 32;
+        }
+    }
     else if(type.startsWith("e", Qt::CaseInsensitive))
     {
         // enumeration types are only for in-memory, never encoded
@@ -363,7 +399,8 @@ ProtocolField::ProtocolField(const QString& protocolName, const QString& protoco
     encodedMax(0),
     scaler(1),
     lastBitfield(false),
-    startingBitCount(0)
+    startingBitCount(0),
+    bitfieldGroupBits(0)
 {
 
 }
@@ -382,7 +419,8 @@ ProtocolField::ProtocolField(const QString& protocolName, const QString& protoco
     encodedMax(0),
     scaler(1),
     lastBitfield(false),
-    startingBitCount(0)
+    startingBitCount(0),
+    bitfieldGroupBits(0)
 {
     parse(field);
 }
@@ -406,6 +444,7 @@ void ProtocolField::clear(void)
     maxString.clear();
     lastBitfield = false;
     startingBitCount = 0;
+    bitfieldGroupBits = 0;
 
 }// ProtocolField::clear
 
@@ -470,6 +509,21 @@ void ProtocolField::parse(const QDomElement& field)
     else
         encodedType.extractType(encodedTypeString, support, name, false);
 
+    // Variable length integers encode the integers and enumerations in memory
+    if(encodedType.isVarint)
+    {
+        if(inMemoryType.isNull || inMemoryType.isFloat || inMemoryType.isStruct || inMemoryType.isString || inMemoryType.isBitfield)
+        {
+            std::cout << name.toStdString() << ": variable length integers only encode integers and enumerations that are in memory, fixed width encoding used" << std::endl;
+            encodedType.isVarint = false;
+
+            if(encodedType.bits == 0)
+                encodedType.bits = inMemoryType.bits;
+        }
+        else if((encodedType.bits == 0) && !inMemoryType.isEnum)
+            encodedType.bits = inMemoryType.bits;
+    }
+
     if(inMemoryType.isNull)
     {
         // Null types are not in memory, and cannot have defaults or variable arrays
@@ -508,6 +562,10 @@ void ProtocolField::parse(const QDomElement& field)
             if(creator != 0)
                 minbits = creator->getMinBitWidth();
 
+            // A variable length integer without a width is as wide as the enumeration
+            if(encodedType.isVarint && (encodedType.bits == 0))
+                encodedType.bits = 8*((minbits + 7)/8);
+
             if(encodedTypeString.isEmpty())
             {
                 // Make it a multiple of 8 bits. The only way to have something
@@ -649,6 +707,21 @@ void ProtocolField::parse(const QDomElement& field)
             minString.clear();
             scalerString.clear();
         }
+        else if(encodedType.isVarint)
+        {
+            std::cout << name.toStdString() << ": min, max, and scaler are ignored because encoded type is a variable length integer, which are never scaled" << std::endl;
+            maxString.clear();
+            minString.clear();
+            scalerString.clear();
+        }
+    }
+
+    // The length of a variable length integer is not known until it is
+    // decoded, so it cannot be used to detect a missing default field
+    if(encodedType.isVarint && !defaultValue.isEmpty())
+    {
+        std::cout << name.toStdString() << ": variable length integers cannot have a default value" << std::endl;
+        defaultValue.clear();
     }
 
     if(inMemoryType.isString)
@@ -892,6 +965,20 @@ void ProtocolField::computeEncodedLength(void)
 
         encodedLength.addToLength(QString().setNum(length));
     }
+    else if(encodedType.isVarint)
+    {
+        // Every element is at least one byte, and one more for every seven bits
+        QString minimum = "1";
+        QString maximum = QString().setNum(getVarintMaxBytes());
+
+        if(!array.isEmpty())
+        {
+            minimum += "*" + array;
+            maximum += "*" + array;
+        }
+
+        encodedLength.addRangeToLength(minimum, maximum, !variableArray.isEmpty(), !dependsOn.isEmpty());
+    }
     else if(inMemoryType.isString)
         encodedLength.addToLength(array, !inMemoryType.isFixedString, false, !dependsOn.isEmpty(), !defaultValue.isEmpty());
     else if(inMemoryType.isStruct)
@@ -933,13 +1020,26 @@ void ProtocolField::computeEncodedLength(void)
  * \return the declaration string
  */
 QString ProtocolField::getDeclaration(void) const
+{
+    return getDeclarationForType(typeName);
+}
+
+
+/*!
+ * Return the string used to declare this field, which is shared by the C and
+ * C++ outputs. This includes the spacing, type, name, semicolon, comment, and
+ * linefeed.
+ * \param type is the type name of the field in the output language
+ * \return the declaration string for this field
+ */
+QString ProtocolField::getDeclarationForType(const QString& type) const
 {
     QString output;
 
     if(notInMemory)
         return output;
 
-    output = "    " + typeName + " " + name;
+    output = "    " + type + " " + name;
 
     if(inMemoryType.isBitfield)
         output += " : " + QString().setNum(inMemoryType.bits);
@@ -964,7 +1064,7 @@ QString ProtocolField::getDeclaration(void) const
 
     return output;
 
-}// ProtocolField::getDeclaration
+}// ProtocolField::getDeclarationForType
 
 
 /*!
@@ -1021,6 +1121,41 @@ QString ProtocolField::getEncodeSignature(void) const
 }
 
 
+/*!
+ * Describe the coding of this field as an operation
+ * \param operation receives the description
+ */
+void ProtocolField::getOperation(ProtocolOperation& operation) const
+{
+    Encodable::getOperation(operation);
+
+    if(inMemoryType.isStruct)
+        return;
+
+    if(encodedType.isBitfield)
+        operation.kind = ProtocolOperation::BitfieldOperation;
+    else if(inMemoryType.isString)
+        operation.kind = ProtocolOperation::StringOperation;
+    else if(inMemoryType.isNull)
+        operation.kind = ProtocolOperation::NullOperation;
+    else
+        operation.kind = ProtocolOperation::FieldOperation;
+
+    operation.bits = encodedType.bits;
+    operation.isSigned = encodedType.isSigned;
+    operation.isFloat = encodedType.isFloat;
+    operation.constantValue = constantValue;
+
+    if(encodedMax > encodedMin)
+    {
+        operation.scaled = true;
+        operation.scaleMinimum = encodedMin;
+        operation.scaler = scaler;
+    }
+
+}// ProtocolField::getOperation
+
+
 /*!
  * Get details needed to produce documentation for this encodable.
  * \param parentName is the name of the parent which will be pre-pended to the name of this encodable
@@ -1040,7 +1175,7 @@ void ProtocolField::getDocumentationDetails(QList<int>& outline, QString& startB
         return;
 
     // See if we can replace any enumeration names with values
-    ProtocolParser::replaceEnumerationNameWithValue(maxEncodedLength);
+    ProtocolParser::replaceEnumerationNameWithValue(maxEncodedLength, true);
 
     // The byte after this one
     QString nextStartByte = EncodedLength::collapseLengthString(startByte + "+" + maxEncodedLength);
@@ -1151,6 +1286,10 @@ void ProtocolField::getDocumentationDetails(QList<int>& outline, QString& startB
         {
             if(encodedType.isBitfield)
                 encodings.append("B" + QString().setNum(encodedType.bits));
+            else if(encodedType.isVarint && encodedType.isSigned)
+                encodings.append("VI" + QString().setNum(encodedType.bits));
+            else if(encodedType.isVarint)
+                encodings.append("VU" + QString().setNum(encodedType.bits));
             else if(encodedType.isFloat)
                 encodings.append("F" + QString().setNum(encodedType.bits));
             else if(encodedType.isSigned)
@@ -1194,6 +1333,16 @@ void ProtocolField::getDocumentationDetails(QList<int>& outline, QString& startB
         if(encodedMax != 0.0)
             description += " Scaled by " + scalerString + " from " + minString + " to " + maxString + ".";
 
+        if(encodedType.isVarint)
+        {
+            description += " Variable length, from 1 to " + QString().setNum(getVarintMaxBytes()) + " bytes for each value";
+
+            if(encodedType.isSigned)
+                description += ", range -" + QString().setNum(pow2(encodedType.bits-1)) + " to " + QString().setNum(pow2(encodedType.bits-1)-1) + ".";
+            else
+                description += ", range 0 to " + QString().setNum(pow2(encodedType.bits)-1) + ".";
+        }
+
         if(!constantValue.isEmpty())
             description += " data are given constant value " + constantValue + ".";
 
@@ -1224,7 +1373,9 @@ QString ProtocolField::getEncodeString(bool isBigEndian, int* bitcount, bool isS
 {
     QString output;
 
-    if(encodedType.isBitfield)
+    if(isFusedBitfield())
+        output = getEncodeStringForFusedBitfield(isStructureMember);
+    else if(encodedType.isBitfield)
     {
         output = getEncodeStringForBitfield(bitcount, isStructureMember);
 
@@ -1255,13 +1406,17 @@ QString ProtocolField::getEncodeString(bool isBigEndian, int* bitcount, bool isS
  *        member of a user structure, else the left hand side is a pointer
  *        to the inMemoryType
  * \param defaultEnabled should be true to handle defaults
+ * \param endHook is the line of source to invoke before returning 1 when a
+ *        default field is missing, may be empty
  * \return The string to add to the source file that encodes this field.
  */
-QString ProtocolField::getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled) const
+QString ProtocolField::getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled, const QString& endHook) const
 {
     QString output;
 
-    if(encodedType.isBitfield)
+    if(isFusedBitfield())
+        output += getDecodeStringForFusedBitfield(isStructureMember);
+    else if(encodedType.isBitfield)
     {
         output += getDecodeStringForBitfield(bitcount, isStructureMember);
 
@@ -1276,7 +1431,7 @@ QString ProtocolField::getDecodeString(bool isBigEndian, int* bitcount, bool isS
         else if(inMemoryType.isStruct)
             output += getDecodeStringForStructure(isStructureMember);
         else
-            output += getDecodeStringForField(isBigEndian, isStructureMember, defaultEnabled);
+            output += getDecodeStringForField(isBigEndian, isStructureMember, defaultEnabled, endHook);
     }
 
     return output;
@@ -1320,6 +1475,119 @@ QString ProtocolField::getSetToDefaultsString(bool isStructureMember) const
 
 }// ProtocolField::getSetToDefaultsString
 
+/*!
+ * Return the string that is placed before the decode of this field in a
+ * decode function that verifies the data length as it goes. The check uses
+ * the actual length of a variable length array, the presence of a dependent
+ * field, or the terminator of a string.
+ * \param isStructureMember is true if this field is accessed by structure pointer
+ * \param restLength is the minimum length of the encodables after this one
+ * \param rejectHook is the line of source to invoke before returning 0, may be empty
+ * \return the check, which is empty if this field has a fixed length
+ */
+QString ProtocolField::getDecodeLengthCheck(bool isStructureMember, const QString& restLength, const QString& rejectHook) const
+{
+    QString output;
+    QString rest;
+
+    if(encodedLength.minEncodedLength == encodedLength.maxEncodedLength)
+        return output;
+
+    QString lhs;
+    if(isStructureMember)
+        lhs = "user->";
+
+    rest = EncodedLength::collapseLengthString(restLength);
+    if(!rest.isEmpty())
+        rest = " + " + rest;
+
+    if(inMemoryType.isString)
+    {
+        if(inMemoryType.isFixedString)
+        {
+            output += "    // Verify there is enough data for " + name + "\n";
+            output += "    if(byteindex + " + array + rest + " > numBytes)\n";
+            output += getDecodeReturnString("    ", "0", rejectHook);
+        }
+        else
+        {
+            // The string is decoded up to its terminator, which must be in the data
+            output += "    // Verify that " + name + " is terminated within the data\n";
+            output += "    {\n";
+            output += "        int length = 0;\n";
+            output += "        while((length < " + array + " - 1) && (byteindex + length" + rest + " < numBytes) && (data[byteindex + length] != 0))\n";
+            output += "            length++;\n";
+            output += "\n";
+            output += "        if(byteindex + length + 1" + rest + " > numBytes)\n";
+            output += getDecodeReturnString("        ", "0", rejectHook);
+            output += "    }\n";
+        }
+
+        return output;
+    }
+
+    if(encodedType.isVarint)
+    {
+        QString count = "1";
+
+        if(!variableArray.isEmpty())
+            count = getArrayHelperCount(isStructureMember, true);
+        else if(!array.isEmpty())
+            count = array;
+
+        // The length is found by scanning the bytes, up to the end of the data
+        QString condition = "byteindex + varintLengthFromBytes(data + byteindex, numBytes - byteindex, " + count + ", " + QString().setNum(getVarintMaxBytes()) + ")" + rest + " > numBytes";
+
+        output += "    // Verify there is enough data for " + name + ", whose length depends on its value\n";
+
+        if(!dependsOn.isEmpty())
+            output += "    if((" + lhs + dependsOn + ") && (" + condition + "))\n";
+        else
+            output += "    if(" + condition + ")\n";
+        output += getDecodeReturnString("    ", "0", rejectHook);
+
+        return output;
+    }
+
+    QString elementLength;
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* struc = ProtocolParser::lookUpStructure(typeName);
+
+        // Only fixed length structures have a known length per element
+        if((struc == NULL) || (struc->encodedLength.minEncodedLength != struc->encodedLength.maxEncodedLength))
+            return Encodable::getDecodeLengthCheck(isStructureMember, restLength, rejectHook);
+
+        elementLength = EncodedLength::collapseLengthString(struc->encodedLength.maxEncodedLength, true);
+    }
+    else if(encodedType.isBitfield || encodedType.isNull)
+        return Encodable::getDecodeLengthCheck(isStructureMember, restLength, rejectHook);
+    else
+        elementLength.setNum(encodedType.bits / 8);
+
+    QString length;
+    if(!variableArray.isEmpty())
+        length = elementLength + "*" + getArrayHelperCount(isStructureMember, true);
+    else if(!array.isEmpty())
+        length = elementLength + "*" + array;
+    else
+        length = elementLength;
+
+    output += "    // Verify there is enough data for " + name + "\n";
+
+    // The same condition as the decode itself
+    if(!dependsOn.isEmpty())
+        output += "    if((" + lhs + dependsOn + ") && (byteindex + " + length + rest + " > numBytes))\n";
+    else
+        output += "    if(byteindex + " + length + rest + " > numBytes)\n";
+    output += getDecodeReturnString("    ", "0", rejectHook);
+
+    return output;
+
+}// ProtocolField::getDecodeLengthCheck
+
+
 
 /*!
  * Get the next lines(s) of source coded needed to encode this bitfield field
@@ -1450,136 +1718,818 @@ QString ProtocolField::getCloseBitfieldString(int* bitcount) const
 
 
 /*!
- * Get the next lines of source needed to encode this string field.
- * \param isStructureMember should be true if the left hand side is a
- *        member of a user structure, else the left hand side is a pointer
- *        to the inMemoryType
- * \return The string to add to the source file to that encodes this field
+ * Determine if this bitfield is packed into a single word with the rest of
+ * its group, instead of being encoded one bit at a time.
+ * \return true if this field is a fused bitfield
  */
-QString ProtocolField::getEncodeStringForString(bool isStructureMember) const
+bool ProtocolField::isFusedBitfield(void) const
 {
-    QString output;
-    QString lhs;
-
-    if(encodedType.isNull)
-        return output;
+    if(!support.fuseBitfields || !isBitfield() || (bitfieldGroupBits <= 0))
+        return false;
 
-    if(isStructureMember)
-        lhs = "user->";
+    // Words larger than 32 bits need 64 bit integer support
+    if(support.int64)
+        return (bitfieldGroupBits <= 64);
     else
-        lhs = "";
+        return (bitfieldGroupBits <= 32);
 
-    if(!comment.isEmpty())
-        output += "    // " + comment + "\n";
+}// ProtocolField::isFusedBitfield
 
-    if(constantValue.isEmpty())
-        output += "    stringToBytes(" + lhs + name + ", data, &byteindex, " + array;
-    else
-    {
-        // constantValue is a string literal, so include the quotes. Except for
-        // a special case. If constantValue ends in "()" then we assume its a
-        // function or macro call
-        if(constantValue.contains("(") && constantValue.contains(")"))
-            output += "    stringToBytes(" + constantValue + ", data, &byteindex, " + array;
-        else
-            output += "    stringToBytes(\"" + constantValue + "\", data, &byteindex, " + array;
-    }
 
-    if(inMemoryType.isFixedString)
-        output += ", 1);\n";
-    else
-        output += ", 0);\n";
+/*!
+ * Determine if this field can be read and written in place in an encoded
+ * packet, without coding the rest of the packet. This requires a single
+ * value that starts on a byte boundary and is always present.
+ * \return true if accessor functions can be created for this field
+ */
+bool ProtocolField::supportsDirectAccess(void) const
+{
+    if(notEncoded || notInMemory || !constantValue.isEmpty() || isArray() || !dependsOn.isEmpty())
+        return false;
 
-    return output;
+    if(isBitfield() || inMemoryType.isString || inMemoryType.isFixedString || inMemoryType.isStruct || encodedType.isVarint)
+        return false;
 
-}// ProtocolField::getEncodeStringForString
+    return !inMemoryType.isNull && !encodedType.isNull;
+
+}// ProtocolField::supportsDirectAccess
 
 
 /*!
- * Get the next lines of source needed to decode this string field
- * \param isStructureMember should be true if the left hand side is a
- *        member of a user structure, else the left hand side is a pointer
- *        to the inMemoryType
- * \return The string to add to the source file to that decodes this field
+ * Get the size in bytes of one element of this field in memory, which is the
+ * size of the native type it is declared with. Bitfields, enumerations, and
+ * external structures are not given a size, as their layout is up to the
+ * compiler, or to another module.
+ * \return the size of one element, or 0 if it is not known
  */
-QString ProtocolField::getDecodeStringForString(bool isStructureMember) const
+int ProtocolField::getInMemoryBytes(void) const
 {
-    QString output;
+    if(notInMemory || inMemoryType.isNull)
+        return 0;
 
-    if(encodedType.isNull)
-        return output;
+    if(inMemoryType.isBitfield || inMemoryType.isEnum || inMemoryType.isStruct)
+        return 0;
 
-    QString lhs;
+    if(inMemoryType.isString || inMemoryType.isFixedString)
+        return 1;
 
-    if(isStructureMember)
-        lhs = "user->";
+    if(inMemoryType.isFloat)
+        return (inMemoryType.bits > 32) ? 8 : 4;
+
+    if(inMemoryType.bits > 32)
+        return 8;
+    else if(inMemoryType.bits > 16)
+        return 4;
+    else if(inMemoryType.bits > 8)
+        return 2;
     else
-        lhs = "";
+        return 1;
 
-    if(!comment.isEmpty())
-        output += "    // " + comment + "\n";
+}// ProtocolField::getInMemoryBytes
 
-    output += "    stringFromBytes(" + lhs + name + ", data, &byteindex, " + array;
 
-    if(inMemoryType.isFixedString)
-        output += ", 1);\n";
-    else
-        output += ", 0);\n";
+/*!
+ * Determine if the encoding of this field is a copy of its bytes in memory,
+ * in the byte order of the protocol. That is the case for an unscaled field
+ * whose encoded type is the same as its in-memory type, and which is always
+ * present with a fixed number of elements. Floats are only copied if the
+ * valid float check on decode is turned off by supportSpecialFloat.
+ * \return the size of one element, or 0 if the encoding is not a copy
+ */
+int ProtocolField::getNativeBytes(void) const
+{
+    if(notEncoded || notInMemory || constant || isDefault() || !variableArray.isEmpty() || !dependsOn.isEmpty())
+        return 0;
 
-    return output;
+    if(inMemoryType.isString || inMemoryType.isFixedString || encodedType.isBitfield || encodedType.isVarint)
+        return 0;
 
-}// ProtocolField::getDecodeStringForString
+    if(encodedMax > encodedMin)
+        return 0;
+
+    if((encodedType.bits != inMemoryType.bits) || (encodedType.isSigned != inMemoryType.isSigned) || (encodedType.isFloat != inMemoryType.isFloat))
+        return 0;
+
+    // Only the widths of the native types, so the encoding is the whole type
+    if((encodedType.bits != 8) && (encodedType.bits != 16) && (encodedType.bits != 32) && (encodedType.bits != 64))
+        return 0;
+
+    if(encodedType.isFloat && (encodedType.bits < 32))
+        return 0;
+
+    // The decode of a float checks that it is valid, which a copy would skip
+    if(encodedType.isFloat && support.specialFloat)
+        return 0;
+
+    return getInMemoryBytes();
+
+}// ProtocolField::getNativeBytes
 
 
 /*!
- * Return the string that is used to encode this structure.
- * \param isStructureMember is true if this encodable is accessed by structure pointer
- * \return the string to add to the source to encode this structure
+ * Determine if this field can be coded by the table codec, which handles
+ * numbers of whole bytes, scaled or not, in arrays that can be variable
+ * length and fields that can depend on another field. Fields that are not
+ * encoded are left out of the table, so they are supported too.
+ * \return true if the field can be described by a table codec field
  */
-QString ProtocolField::getEncodeStringForStructure(bool isStructureMember) const
+bool ProtocolField::supportsTableCodec(void) const
 {
-    QString output;
-    QString access;
-    QString spacing = "    ";
+    if(notEncoded || encodedType.isNull)
+        return true;
 
-    if(encodedType.isNull)
-        return output;
+    if(inMemoryType.isStruct || inMemoryType.isString || inMemoryType.isFixedString || inMemoryType.isBitfield)
+        return false;
 
-    if(!comment.isEmpty())
-        output += spacing + "// " + comment + "\n";
+    if(encodedType.isBitfield || encodedType.isVarint || isDefault())
+        return false;
 
-    if(!dependsOn.isEmpty())
+    // float16 and float24 need the conversions of floatspecial
+    if(encodedType.isFloat && (encodedType.bits < 32))
+        return false;
+
+    return true;
+
+}// ProtocolField::supportsTableCodec
+
+
+/*!
+ * Get the initializer of the tableField_t that describes this field to the
+ * table codec. The layout of the member is given by offsetof() and sizeof(),
+ * so the compiler fills in what ProtoGen does not know, like the size of an
+ * enumeration.
+ * \param structureType is the type of the structure this field is a member of
+ * \param constants is appended with the scaling and constant values of this
+ *        field, which the initializer refers to by their index
+ * \return the initializer, which is empty if this field is not encoded
+ */
+QString ProtocolField::getTableFieldString(const QString& structureType, QStringList& constants) const
+{
+    if(notEncoded || encodedType.isNull)
+        return QString();
+
+    bool inMemory = !(notInMemory || inMemoryType.isNull);
+    QString member = "((" + structureType + "*)0)->";
+    QString offset = "0";
+    QString count = "1";
+    QString reference = "0";
+    QString condition = "0";
+    QString memory = "TABLE_TYPE(TABLE_NONE, 0)";
+    QString encoded;
+    QStringList flags;
+
+    if(inMemory)
     {
-        if(isStructureMember)
-            output += spacing + "if(user->" + dependsOn + ")\n";
+        QString kind;
+
+        if(inMemoryType.isFloat)
+            kind = "TABLE_FLOAT";
+        else if(inMemoryType.isSigned || inMemoryType.isEnum)
+            kind = "TABLE_SIGNED";
         else
-            output += spacing + "if(" + dependsOn + ")\n";
-        output += spacing + "{\n";
-        spacing += "    ";
+            kind = "TABLE_UNSIGNED";
+
+        offset = "offsetof(" + structureType + ", " + name + ")";
+
+        if(isArray())
+            memory = "TABLE_TYPE(" + kind + ", sizeof(" + member + name + "[0]))";
+        else
+            memory = "TABLE_TYPE(" + kind + ", sizeof(" + member + name + "))";
     }
 
+    if(encodedType.isFloat)
+        encoded = "TABLE_TYPE(TABLE_FLOAT, ";
+    else if(encodedType.isSigned)
+        encoded = "TABLE_TYPE(TABLE_SIGNED, ";
+    else
+        encoded = "TABLE_TYPE(TABLE_UNSIGNED, ";
+    encoded += QString().setNum(encodedType.bits/8) + ")";
+
     if(isArray())
-    {
-        if(variableArray.isEmpty())
-        {
-            output += spacing + "for(i = 0; i < " + array + "; i++)\n";
-        }
-        else
-        {
-            if(isStructureMember)
-                output += spacing + "for(i = 0; i < (int)user->" + variableArray + " && i < " + array + "; i++)\n";
-            else
-                output += spacing + "for(i = 0; i < (int)" + variableArray + " && i < " + array + "; i++)\n";
-        }
+        count = array;
 
-        if(isStructureMember)
-            access = "&user->" + name + "[i]";
-        else
-            access = "&" + name + "[i]";
+    int index = constants.size();
 
-        output += spacing + "    byteindex = encode" + typeName + "(data, byteindex, " + access + ");\n";
+    if(encodedMax > encodedMin)
+    {
+        flags.append("TABLE_SCALED");
+        constants.append(getNumberString(encodedMin));
+        constants.append(getNumberString(scaler));
     }
-    else
+
+    if(!constantValue.isEmpty())
+    {
+        flags.append("TABLE_CONSTANT");
+        constants.append("(double)(" + constantValue + ")");
+    }
+
+    if(!variableArray.isEmpty())
+    {
+        flags.append("TABLE_VARIABLE");
+        flags.append("TABLE_REFERENCE_SIZE(sizeof(" + member + variableArray + "))");
+        if(variableArraySigned)
+            flags.append("TABLE_REFERENCE_SIGNED");
+        reference = "offsetof(" + structureType + ", " + variableArray + ")";
+    }
+
+    if(!dependsOn.isEmpty())
+    {
+        flags.append("TABLE_CONDITION");
+        flags.append("TABLE_CONDITION_SIZE(sizeof(" + member + dependsOn + "))");
+        condition = "offsetof(" + structureType + ", " + dependsOn + ")";
+    }
+
+    if(flags.isEmpty())
+        flags.append("0");
+
+    if(constants.size() == index)
+        index = 0;
+
+    return "{" + offset + ", " + count + ", " + reference + ", " + condition + ", " + memory + ", " + encoded + ", " + flags.join(" | ") + ", " + QString().setNum(index) + "}";
+
+}// ProtocolField::getTableFieldString
+
+
+/*!
+ * Determine if this array field is encoded and decoded with a single call to
+ * one of the array helpers, rather than a loop over the single value helpers.
+ * This requires that the in-memory type is exactly the type of the helper's
+ * array argument.
+ * \return true if the array helper is used
+ */
+bool ProtocolField::usesArrayHelper(void) const
+{
+    if(array.isEmpty() || !constantValue.isEmpty())
+        return false;
+
+    if(inMemoryType.isNull || encodedType.isNull || inMemoryType.isEnum || inMemoryType.isStruct || inMemoryType.isString || inMemoryType.isBitfield)
+        return false;
+
+    // The variable length integer array helpers are always available
+    if(encodedType.isVarint)
+        return (typeName == getVarintHelperType());
+
+    if(!support.arrayHelpers)
+        return false;
+
+    if(typeName != inMemoryType.toTypeString())
+        return false;
+
+    if(encodedMax > encodedMin)
+    {
+        // Scaling helpers exist for every native in-memory type, but folded
+        // scaling is preferred since it has no runtime scaling arguments
+        return !support.foldScaling;
+    }
+    else if(encodedType.isFloat)
+    {
+        // The special float types are converted from float only
+        return (typeName == encodedType.toTypeString());
+    }
+    else
+        return (typeName == encodedType.toTypeString());
+
+}// ProtocolField::usesArrayHelper
+
+
+/*!
+ * Get the name of the helper functions that code this variable length
+ * integer field. Integers of 32 bits or fewer use the 32 bit helpers.
+ * \return the helper name, like "varuint32" or "varint64"
+ */
+QString ProtocolField::getVarintHelperName(void) const
+{
+    QString helper = encodedType.isSigned ? "varint" : "varuint";
+
+    if(encodedType.bits > 32)
+        return helper + "64";
+    else
+        return helper + "32";
+}
+
+
+/*!
+ * Get the in-memory type of the helper functions that code this variable
+ * length integer field
+ * \return the type, like "uint32_t" or "int64_t"
+ */
+QString ProtocolField::getVarintHelperType(void) const
+{
+    QString type = encodedType.isSigned ? "int" : "uint";
+
+    if(encodedType.bits > 32)
+        return type + "64_t";
+    else
+        return type + "32_t";
+}
+
+
+/*!
+ * Get the number of array elements that are passed to an array helper,
+ * which accounts for the variable array length. A negative variable array
+ * length gives a count of zero, as the helpers advance the byte index by
+ * the count.
+ * \param isStructureMember should be true if the variable array length is a
+ *        member of a user structure.
+ * \param isDecode should be true for a decode function, in which the
+ *        variable array length is a pointer if not a structure member.
+ * \return the count expression
+ */
+QString ProtocolField::getArrayHelperCount(bool isStructureMember, bool isDecode) const
+{
+    QString length;
+
+    if(variableArray.isEmpty())
+        return array;
+
+    if(isStructureMember)
+        length = "(int)user->" + variableArray;
+    else if(isDecode)
+        length = "(int)(*" + variableArray + ")";
+    else
+        length = "(int)" + variableArray;
+
+    return "((" + length + " <= 0) ? 0 : ((" + length + " < " + array + ") ? " + length + " : " + array + "))";
+
+}// ProtocolField::getArrayHelperCount
+
+
+/*!
+ * Determine if this scaled field is encoded and decoded with inline code in
+ * which the scaling constants are folded, rather than by calling the scaling
+ * helpers with runtime arguments.
+ * \return true if folded scaling is used
+ */
+bool ProtocolField::usesFoldedScaling(void) const
+{
+    return support.foldScaling && (encodedMax > encodedMin) && !encodedType.isNull;
+
+}// ProtocolField::usesFoldedScaling
+
+
+/*!
+ * Get the number of bits of the floating point type used for folded
+ * scaling. Single precision is used if the in-memory type fits in 32 bits
+ * and the encoded integer fits in the 24 bit mantissa of a float, so that
+ * targets without a double precision unit do not need software doubles.
+ * \return 32 for float, or 64 for double
+ */
+int ProtocolField::getFoldedScalingBits(void) const
+{
+    if((inMemoryType.bits > 32) || (encodedType.bits > 24))
+        return 64;
+    else
+        return 32;
+
+}// ProtocolField::getFoldedScalingBits
+
+
+/*!
+ * Get the next lines of source needed to encode this scaled field with the
+ * scaling constants and the integer clamp bounds folded into the code.
+ * \param isBigEndian should be true if the protocol uses big endian ordering.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \param constantValue is the constant value to encode, empty to encode the
+ *        in-memory value.
+ * \param spacing is the indentation of the lines.
+ * \return The string to add to the source file that encodes this field.
+ */
+QString ProtocolField::getEncodeStringForFoldedScaling(bool isBigEndian, bool isStructureMember, const QString& constantValue, const QString& spacing) const
+{
+    QString output;
+    QString value;
+    QString lhs;
+    int length = encodedType.bits / 8;
+    bool Unsigned = !encodedType.isSigned;
+    int floatBits = getFoldedScalingBits();
+    QString floatType;
+    QString halfFraction;
+    QString numberType = ProtocolScaling::getEncodedTypeString(length, Unsigned);
+    QString max = ProtocolScaling::getEncodedMaxString(length, Unsigned);
+
+    if(isStructureMember)
+        lhs = "user->";
+
+    if(floatBits > 32)
+    {
+        floatType = "double";
+        halfFraction = "0.5";
+    }
+    else
+    {
+        floatType = "float";
+        halfFraction = "0.5f";
+    }
+
+    QString endian;
+    if(length > 1)
+    {
+        if(isBigEndian)
+            endian = "Be";
+        else
+            endian = "Le";
+    }
+
+    output += spacing + "// Range of " + name + " is " + getNumberString(encodedMin) + " to " + getNumberString(encodedMax) +  ".\n";
+
+    if(!constantValue.isEmpty())
+        value = "(" + constantValue + ")";
+    else
+    {
+        value = lhs + name;
+
+        if(!array.isEmpty())
+        {
+            value += "[i]";
+
+            if(variableArray.isEmpty())
+                output += spacing + "for(i = 0; i < " + array + "; i++)\n";
+            else
+                output += spacing + "for(i = 0; i < (int)" + lhs + variableArray + " && i < " + array + "; i++)\n";
+        }
+    }
+
+    // The subtraction and the multiply are left out if they do nothing
+    QString scaledvalue = value;
+
+    if(Unsigned && (encodedMin != 0.0))
+        scaledvalue = "(" + scaledvalue + " - " + getNumberString(encodedMin, floatBits) + ")";
+
+    if(scaler != 1.0)
+        scaledvalue += "*" + getNumberString(scaler, floatBits);
+
+    // The clamp bounds are the limits of the encoded integer
+    QString number;
+
+    if(Unsigned)
+        number = "(scaledvalue >= " + getNumberString((double)(pow2(8*length) - 1), floatBits) + ") ? " + max + " : ((scaledvalue <= 0) ? 0 : (" + numberType + ")(scaledvalue + " + halfFraction + "))";
+    else
+    {
+        QString min = ProtocolScaling::getEncodedMinString(length);
+        double limit = (double)pow2(8*length - 1);
+
+        number = "(scaledvalue >= " + getNumberString(limit - 1, floatBits) + ") ? " + max + " : ((scaledvalue <= " + getNumberString(-limit, floatBits) + ") ? " + min + " : (" + numberType + ")(scaledvalue + ((scaledvalue >= 0) ? " + halfFraction + " : -" + halfFraction + ")))";
+    }
+
+    output += spacing + "{\n";
+    output += spacing + "    " + floatType + " scaledvalue = (" + floatType + ")(" + scaledvalue + ");\n";
+    output += spacing + "    " + numberType + " number = " + number + ";\n";
+
+    if(Unsigned)
+        output += spacing + "    uint" + QString().setNum(8*length) + "To" + endian + "Bytes(number, data, &byteindex);\n";
+    else
+        output += spacing + "    int" + QString().setNum(8*length) + "To" + endian + "Bytes(number, data, &byteindex);\n";
+
+    output += spacing + "}\n";
+
+    return output;
+
+}// ProtocolField::getEncodeStringForFoldedScaling
+
+
+/*!
+ * Get the next lines of source needed to decode this scaled field with the
+ * scaling constants folded into the code.
+ * \param isBigEndian should be true if the protocol uses big endian ordering.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \param spacing is the indentation of the lines.
+ * \return The string to add to the source file that decodes this field.
+ */
+QString ProtocolField::getDecodeStringForFoldedScaling(bool isBigEndian, bool isStructureMember, const QString& spacing) const
+{
+    QString output;
+    QString lhs;
+    int length = encodedType.bits / 8;
+    int floatBits = getFoldedScalingBits();
+
+    QString endian;
+    if(length > 1)
+    {
+        if(isBigEndian)
+            endian = "Be";
+        else
+            endian = "Le";
+    }
+
+    output += spacing + "// Range of " + name + " is " + getNumberString(encodedMin) + " to " + getNumberString(encodedMax) +  ".\n";
+
+    if(isStructureMember)
+        lhs = "user->";
+    else if(array.isEmpty())
+        lhs = "*";
+
+    if(array.isEmpty())
+        lhs += name;
+    else
+    {
+        if(variableArray.isEmpty())
+            output += spacing + "for(i = 0; i < " + array + "; i++)\n";
+        else if(isStructureMember)
+            output += spacing + "for(i = 0; i < (int)user->" + variableArray + " && i < " + array + "; i++)\n";
+        else
+            output += spacing + "for(i = 0; i < (int)(*" + variableArray + ") && i < " + array + "; i++)\n";
+
+        lhs += name + "[i]";
+    }
+
+    QString number;
+
+    if(encodedType.isSigned)
+        number = "int";
+    else
+        number = "uint";
+
+    number += QString().setNum(8*length) + "From" + endian + "Bytes(data, &byteindex)";
+
+    // The inverse scaler is computed now, rather than by the target
+    if(scaler != 1.0)
+        number = getNumberString(1.0/scaler, floatBits) + "*" + number;
+    else if(floatBits > 32)
+        number = "(double)" + number;
+    else
+        number = "(float)" + number;
+
+    if(!encodedType.isSigned && (encodedMin != 0.0))
+        number = getNumberString(encodedMin, floatBits) + " + " + number;
+
+    if(array.isEmpty())
+        output += spacing + lhs + " = (" + typeName + ")(" + number + ");\n";
+    else
+        output += spacing + "    " + lhs + " = (" + typeName + ")(" + number + ");\n";
+
+    return output;
+
+}// ProtocolField::getDecodeStringForFoldedScaling
+
+
+/*!
+ * Get the next lines of source needed to encode this bitfield when it is
+ * fused with its group. The group is built in the local "bitword" using
+ * constant shifts and masks, and the last field of the group writes the
+ * whole word to the byte stream, most significant bit first.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \return The string to add to the source file that encodes this field.
+ */
+QString ProtocolField::getEncodeStringForFusedBitfield(bool isStructureMember) const
+{
+    QString output;
+    QString constant = constantValue;
+    int wordBytes = getFusedBitfieldBytes();
+    int shift = 8*wordBytes - (startingBitCount + encodedType.bits);
+    QString mask = "0x" + QString().setNum(pow2(encodedType.bits) - 1, 16).toUpper();
+    QString wordType = "uint32_t";
+
+    if(wordBytes > 4)
+        wordType = "uint64_t";
+
+    if(!comment.isEmpty())
+        output += "    // " + comment + "\n";
+
+    // Null in memory types are treated as zero constant
+    if(inMemoryType.isNull)
+        constant = "0";
+
+    if(constant == "0")
+    {
+        // Zero bits only matter if they start the word
+        if(startingBitCount == 0)
+            output += "    bitword = 0;\n";
+    }
+    else
+    {
+        QString value;
+
+        if(!constant.isEmpty())
+            value = constant;
+        else if(isStructureMember)
+            value = "user->" + name;
+        else
+            value = name;
+
+        if(startingBitCount == 0)
+            output += "    bitword = ";
+        else
+            output += "    bitword |= ";
+
+        output += "((" + wordType + ")(" + value + ") & " + mask + ")";
+
+        if(shift > 0)
+            output += " << " + QString().setNum(shift);
+
+        output += ";\n";
+    }
+
+    // The last bitfield writes the entire group
+    if(lastBitfield)
+    {
+        QString bits = QString().setNum(8*wordBytes);
+        QString castType;
+
+        if(wordBytes > 4)
+            castType = "uint64_t";
+        else if(wordBytes > 2)
+            castType = "uint32_t";
+        else if(wordBytes > 1)
+            castType = "uint16_t";
+        else
+            castType = "uint8_t";
+
+        output += "    uint" + bits + "ToBeBytes((" + castType + ")bitword, data, &byteindex); // close bit field, " + QString().setNum(wordBytes) + " bytes\n";
+        output += "\n";
+    }
+
+    return output;
+
+}// ProtocolField::getEncodeStringForFusedBitfield
+
+
+/*!
+ * Get the next lines of source needed to decode this bitfield when it is
+ * fused with its group. The first field of the group reads the whole word
+ * from the byte stream, and each field is extracted with a constant shift
+ * and mask.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \return The string to add to the source file that decodes this field.
+ */
+QString ProtocolField::getDecodeStringForFusedBitfield(bool isStructureMember) const
+{
+    QString output;
+    int wordBytes = getFusedBitfieldBytes();
+    int shift = 8*wordBytes - (startingBitCount + encodedType.bits);
+    QString mask = "0x" + QString().setNum(pow2(encodedType.bits) - 1, 16).toUpper();
+
+    // The first bitfield reads the entire group
+    if(startingBitCount == 0)
+        output += "    bitword = uint" + QString().setNum(8*wordBytes) + "FromBeBytes(data, &byteindex); // bit field group, " + QString().setNum(wordBytes) + " bytes\n";
+
+    if(!comment.isEmpty())
+        output += "    // " + comment + "\n";
+
+    if(inMemoryType.isNull)
+    {
+        if(comment.isEmpty())
+            output += "    // reserved bits\n";
+    }
+    else
+    {
+        if(isStructureMember)
+            output += "    user->"; // Access via structure pointer
+        else
+            output += "    *";      // Access via direct pointer
+
+        if(shift > 0)
+            output += name + " = (" + typeName + ")((bitword >> " + QString().setNum(shift) + ") & " + mask + ");\n";
+        else
+            output += name + " = (" + typeName + ")(bitword & " + mask + ");\n";
+    }
+
+    if(lastBitfield)
+        output += "\n";
+
+    return output;
+
+}// ProtocolField::getDecodeStringForFusedBitfield
+
+
+/*!
+ * Get the next lines of source needed to encode this string field.
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \return The string to add to the source file to that encodes this field
+ */
+QString ProtocolField::getEncodeStringForString(bool isStructureMember) const
+{
+    QString output;
+    QString lhs;
+
+    if(encodedType.isNull)
+        return output;
+
+    if(isStructureMember)
+        lhs = "user->";
+    else
+        lhs = "";
+
+    if(!comment.isEmpty())
+        output += "    // " + comment + "\n";
+
+    if(constantValue.isEmpty())
+        output += "    stringToBytes(" + lhs + name + ", data, &byteindex, " + array;
+    else
+    {
+        // constantValue is a string literal, so include the quotes. Except for
+        // a special case. If constantValue ends in "()" then we assume its a
+        // function or macro call
+        if(constantValue.contains("(") && constantValue.contains(")"))
+            output += "    stringToBytes(" + constantValue + ", data, &byteindex, " + array;
+        else
+            output += "    stringToBytes(\"" + constantValue + "\", data, &byteindex, " + array;
+    }
+
+    if(inMemoryType.isFixedString)
+        output += ", 1);\n";
+    else
+        output += ", 0);\n";
+
+    return output;
+
+}// ProtocolField::getEncodeStringForString
+
+
+/*!
+ * Get the next lines of source needed to decode this string field
+ * \param isStructureMember should be true if the left hand side is a
+ *        member of a user structure, else the left hand side is a pointer
+ *        to the inMemoryType
+ * \return The string to add to the source file to that decodes this field
+ */
+QString ProtocolField::getDecodeStringForString(bool isStructureMember) const
+{
+    QString output;
+
+    if(encodedType.isNull)
+        return output;
+
+    QString lhs;
+
+    if(isStructureMember)
+        lhs = "user->";
+    else
+        lhs = "";
+
+    if(!comment.isEmpty())
+        output += "    // " + comment + "\n";
+
+    output += "    stringFromBytes(" + lhs + name + ", data, &byteindex, " + array;
+
+    if(inMemoryType.isFixedString)
+        output += ", 1);\n";
+    else
+        output += ", 0);\n";
+
+    return output;
+
+}// ProtocolField::getDecodeStringForString
+
+
+/*!
+ * Return the string that is used to encode this structure.
+ * \param isStructureMember is true if this encodable is accessed by structure pointer
+ * \return the string to add to the source to encode this structure
+ */
+QString ProtocolField::getEncodeStringForStructure(bool isStructureMember) const
+{
+    QString output;
+    QString access;
+    QString spacing = "    ";
+
+    if(encodedType.isNull)
+        return output;
+
+    if(!comment.isEmpty())
+        output += spacing + "// " + comment + "\n";
+
+    if(!dependsOn.isEmpty())
+    {
+        if(isStructureMember)
+            output += spacing + "if(user->" + dependsOn + ")\n";
+        else
+            output += spacing + "if(" + dependsOn + ")\n";
+        output += spacing + "{\n";
+        spacing += "    ";
+    }
+
+    if(isArray())
+    {
+        if(variableArray.isEmpty())
+        {
+            output += spacing + "for(i = 0; i < " + array + "; i++)\n";
+        }
+        else
+        {
+            if(isStructureMember)
+                output += spacing + "for(i = 0; i < (int)user->" + variableArray + " && i < " + array + "; i++)\n";
+            else
+                output += spacing + "for(i = 0; i < (int)" + variableArray + " && i < " + array + "; i++)\n";
+        }
+
+        if(isStructureMember)
+            access = "&user->" + name + "[i]";
+        else
+            access = "&" + name + "[i]";
+
+        output += spacing + "    byteindex = encode" + typeName + "(data, byteindex, " + access + ");\n";
+    }
+    else
     {
         if(isStructureMember)
             access = "&user->" + name;
@@ -1730,7 +2680,9 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
         spacing += "    ";
     }
 
-    if(encodedMax > encodedMin)
+    if(usesFoldedScaling())
+        output += getEncodeStringForFoldedScaling(isBigEndian, isStructureMember, constantValue, spacing);
+    else if(encodedMax > encodedMin)
     {
         // The scaled outputs. Note that scaled outputs never encode
         // in floating point, since floats carry their scaling with them
@@ -1738,8 +2690,8 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
         // Additional commenting to describe the scaling
         output += spacing + "// Range of " + name + " is " + getNumberString(encodedMin) + " to " + getNumberString(encodedMax) +  ".\n";
 
-        // Handle the array
-        if(!array.isEmpty())
+        // Handle the array, which is one call if we have an array helper
+        if(!array.isEmpty() && !usesArrayHelper())
         {
             if(variableArray.isEmpty())
                 output += spacing + "for(i = 0; i < " + array + "; i++)\n";
@@ -1765,7 +2717,10 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
         else
             output += "uint" + QString().setNum(inMemoryType.bits);
 
-        output += "ScaledTo";
+        if(usesArrayHelper())
+            output += "ArrayScaledTo";
+        else
+            output += "ScaledTo";
 
         // Now the encoded part:
 
@@ -1786,7 +2741,9 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
             // The reference to the data
             output += lhs + name;
 
-            if(!array.isEmpty())
+            if(usesArrayHelper())
+                output += ", " + getArrayHelperCount(isStructureMember, false);
+            else if(!array.isEmpty())
                 output += "[i]";
         }
         else
@@ -1819,6 +2776,8 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
             else
                 output += spacing + "float" + QString().setNum(encodedType.bits) + "To" + endian + "Bytes(" + cast + constantValue + ", data, &byteindex);\n";
         }
+        else if(usesArrayHelper())
+            output += spacing + "float" + QString().setNum(encodedType.bits) + "ArrayTo" + endian + "Bytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, false) + ", data, &byteindex);\n";
         else
         {
             if(variableArray.isEmpty())
@@ -1832,6 +2791,34 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
                 output += spacing + "    float" + QString().setNum(encodedType.bits) + "To" + endian + "Bytes(" + cast + constantValue + ", data, &byteindex);\n";
         }
     }
+    else if(encodedType.isVarint)
+    {
+        // The helpers take the 32 or 64 bit integer that holds the value
+        QString helper = getVarintHelperName();
+        QString cast = "(" + getVarintHelperType() + ")";
+
+        if(array.isEmpty())
+        {
+            if(constantValue.isEmpty())
+                output += spacing + helper + "ToBytes(" + cast + lhs + name + ", data, &byteindex);\n";
+            else
+                output += spacing + helper + "ToBytes(" + cast + constantValue + ", data, &byteindex);\n";
+        }
+        else if(usesArrayHelper())
+            output += spacing + helper + "ArrayToBytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, false) + ", data, &byteindex);\n";
+        else
+        {
+            if(variableArray.isEmpty())
+                output += spacing + "for(i = 0; i < " + array + "; i++)\n";
+            else
+                output += spacing + "for(i = 0; i < (int)" + lhs + variableArray + " && i < " + array + "; i++)\n";
+
+            if(constantValue.isEmpty())
+                output += spacing + "    " + helper + "ToBytes(" + cast + lhs + name + "[i], data, &byteindex);\n";
+            else
+                output += spacing + "    " + helper + "ToBytes(" + cast + constantValue + ", data, &byteindex);\n";
+        }
+    }
     else
     {
         // Here we are not scaling, and we are not encoding a float. It may
@@ -1858,6 +2845,8 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
             else
                 output += opener + QString().setNum(encodedType.bits) + "To" + endian + "Bytes(" + cast + constantValue + ", data, &byteindex);\n";
         }
+        else if(usesArrayHelper())
+            output += opener + QString().setNum(encodedType.bits) + "ArrayTo" + endian + "Bytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, false) + ", data, &byteindex);\n";
         else
         {
             if(variableArray.isEmpty())
@@ -1889,9 +2878,11 @@ QString ProtocolField::getEncodeStringForField(bool isBigEndian, bool isStructur
  *        member of a user structure, else the left hand side is a pointer
  *        to the inMemoryType
  * \param defaultEnabled should be true to enable default handling
+ * \param endHook is the line of source to invoke before returning 1 when
+ *        this default field is missing, may be empty
  * \return The string to add to the source file that decodes this field.
  */
-QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructureMember, bool defaultEnabled) const
+QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructureMember, bool defaultEnabled, const QString& endHook) const
 {
     QString output;
     QString endian;
@@ -1946,7 +2937,7 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
     if(defaultEnabled && !defaultValue.isEmpty())
     {
         output += spacing + "if(byteindex + " + lengthString + " > numBytes)\n";
-        output += spacing + "    return 1;\n";
+        output += getDecodeReturnString(spacing, "1", endHook);
         output += spacing + "else\n";
         output += spacing + "{\n";
         spacing += "    ";
@@ -1964,13 +2955,17 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
             output += spacing + "byteindex += " + lengthString + ";\n";
 
     }
+    else if(usesFoldedScaling())
+        output += getDecodeStringForFoldedScaling(isBigEndian, isStructureMember, spacing);
     else if(encodedMax > encodedMin)
     {
         // Additional commenting to describe the scaling
         output += spacing + "// Range of " + name + " is " + getNumberString(encodedMin) + " to " + getNumberString(encodedMax) +  ".\n";
 
-        // Handle the array
-        if(!array.isEmpty())
+        // Handle the array, which is one call if we have an array helper
+        if(usesArrayHelper())
+            output += spacing;
+        else if(!array.isEmpty())
         {
             if(variableArray.isEmpty())
                 output += spacing + "for(i = 0; i < " + array + "; i++)\n";
@@ -1996,7 +2991,10 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
         else
             output += "uint" + QString().setNum(inMemoryType.bits);
 
-        output += "ScaledFrom";
+        if(usesArrayHelper())
+            output += "ArrayScaledFrom";
+        else
+            output += "ScaledFrom";
 
         // Now the encoded part:
 
@@ -2009,7 +3007,12 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
         else
             output += "Unsigned";
 
-        output += endian + "Bytes(data, &byteindex";
+        output += endian + "Bytes(";
+
+        if(usesArrayHelper())
+            output += lhs + name + ", " + getArrayHelperCount(isStructureMember, true) + ", ";
+
+        output += "data, &byteindex";
 
         // Signature changes for signed versus unsigned
         if(!encodedType.isSigned)
@@ -2027,6 +3030,8 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
         // choose different bit widths.
         if(array.isEmpty())
             output += spacing + lhs + name + " = float" + QString().setNum(encodedType.bits) + "From" + endian + "Bytes(data, &byteindex);\n";
+        else if(usesArrayHelper())
+            output += spacing + "float" + QString().setNum(encodedType.bits) + "ArrayFrom" + endian + "Bytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, true) + ", data, &byteindex);\n";
         else
         {
             if(variableArray.isEmpty())
@@ -2042,6 +3047,32 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
             output += spacing + "    " + lhs + name + "[i] = float" + QString().setNum(encodedType.bits) + "From" + endian + "Bytes(data, &byteindex);\n";
         }
     }
+    else if(encodedType.isVarint)
+    {
+        // The most bytes of one element, so that bad data cannot run past the field
+        QString helper = getVarintHelperName();
+        QString cast = "(" + typeName + ")";
+        QString maxBytes = QString().setNum(getVarintMaxBytes());
+
+        if(array.isEmpty())
+            output += spacing + lhs + name + " = " + cast + helper + "FromBytes(data, &byteindex, " + maxBytes + ");\n";
+        else if(usesArrayHelper())
+            output += spacing + helper + "ArrayFromBytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, true) + ", data, &byteindex, " + maxBytes + ");\n";
+        else
+        {
+            if(variableArray.isEmpty())
+                output += spacing + "for(i = 0; i < " + array + "; i++)\n";
+            else
+            {
+                if(isStructureMember)
+                    output += spacing + "for(i = 0; i < (int)user->" + variableArray + " && i < " + array + "; i++)\n";
+                else
+                    output += spacing + "for(i = 0; i < (int)(*" + variableArray + ") && i < " + array + "; i++)\n";
+            }
+
+            output += spacing + "    " + lhs + name + "[i] = " + cast + helper + "FromBytes(data, &byteindex, " + maxBytes + ");\n";
+        }
+    }
     else
     {
         // Here we are not scaling, and we are not encoding a float. It may
@@ -2057,6 +3088,8 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
 
         if(array.isEmpty())
             output += spacing + lhs + name + " = " + cast + opener + QString().setNum(encodedType.bits) + "From" + endian + "Bytes(data, &byteindex);\n";
+        else if(usesArrayHelper())
+            output += spacing + opener + QString().setNum(encodedType.bits) + "ArrayFrom" + endian + "Bytes(" + lhs + name + ", " + getArrayHelperCount(isStructureMember, true) + ", data, &byteindex);\n";
         else
         {
             if(variableArray.isEmpty())
@@ -2094,6 +3127,298 @@ QString ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStructur
 }// ProtocolField::getDecodeStringForField
 
 
+/*!
+ * Get the declaration for this field as a member of a C++ structure, which
+ * differs from the C declaration only in the namespace of the integer types
+ * \return the declaration string
+ */
+QString ProtocolField::getCppDeclaration(void) const
+{
+    return getDeclarationForType(getCppTypeName());
+}
+
+
+/*!
+ * Get the type name of this field in the C++ output
+ * \return the type name, with the fixed width integers in namespace std
+ */
+QString ProtocolField::getCppTypeName(void) const
+{
+    if(inMemoryType.isStruct || inMemoryType.isEnum || inMemoryType.isString || inMemoryType.isFloat)
+        return typeName;
+    else
+        return "std::" + typeName;
+}
+
+
+/*!
+ * Return the C++ include directive needed for this field, which is the C++
+ * header of an external structure
+ * \return the include file name, or an empty string
+ */
+QString ProtocolField::getCppIncludeDirective(void)
+{
+    if(!inMemoryType.isStruct)
+        return QString();
+
+    QString output = ProtocolParser::lookUpIncludeName(typeName);
+
+    // The C++ header sits next to the C header of the same module
+    if(output.endsWith(".h"))
+        output += "pp";
+
+    return output;
+
+}// ProtocolField::getCppIncludeDirective
+
+
+/*!
+ * Get the template arguments that give the number of bytes and the byte
+ * order of this field in the C++ output
+ * \param isBigEndian should be true for big endian encoding
+ * \return the arguments, like "2, true"
+ */
+QString ProtocolField::getCppCodingArguments(bool isBigEndian) const
+{
+    if(isBigEndian)
+        return QString().setNum(encodedType.bits/8) + ", true";
+    else
+        return QString().setNum(encodedType.bits/8) + ", false";
+}
+
+
+/*!
+ * Get the C++ code that encodes this field as a member of a structure. The
+ * code encodes at data + index, and moves index past the encoded bytes.
+ * \param isBigEndian should be true for big endian encoding.
+ * \return The code to add to the encode function
+ */
+QString ProtocolField::getCppEncodeString(bool isBigEndian) const
+{
+    QString element;
+    QString value = constantValue;
+    QString length = QString().setNum(encodedType.bits/8);
+
+    if(encodedType.isNull)
+        return QString();
+
+    // Null in memory types are treated as zero constant
+    if(value.isEmpty())
+    {
+        if(inMemoryType.isNull)
+            value = "0";
+        else
+            value = getCppAccess();
+    }
+
+    if(encodedType.isBitfield)
+    {
+        element += "    protogen::encodeBitfield<" + QString().setNum(startingBitCount) + ", " + QString().setNum(encodedType.bits) + ">(data + index, static_cast<std::uint32_t>(" + value + "));\n";
+
+        if(lastBitfield)
+            element += "    index += " + QString().setNum(getFusedBitfieldBytes()) + ";\n";
+
+        return getCppConditionString(element);
+    }
+    else if(inMemoryType.isString)
+    {
+        // A constant string is a literal, unless it looks like a function or macro call
+        if(constantValue.isEmpty())
+            value = inMemoryType.isNull ? "\"\"" : name;
+        else if(!(constantValue.contains("(") && constantValue.contains(")")))
+            value = "\"" + constantValue + "\"";
+
+        if(inMemoryType.isFixedString)
+            element += "    protogen::encodeString(data, index, " + value + ", " + array + ", true);\n";
+        else
+            element += "    protogen::encodeString(data, index, " + value + ", " + array + ", false);\n";
+
+        return getCppConditionString(element);
+    }
+    else if(inMemoryType.isStruct)
+        return getCppEncodeStringForStructure();
+    else if(encodedType.isVarint)
+    {
+        element += "    protogen::encodeVarint(data, index, static_cast<std::" + getVarintHelperType() + ">(" + value + "));\n";
+        return getCppRepeatString(element);
+    }
+
+    if(encodedMax > encodedMin)
+    {
+        QString real = "float";
+        if(inMemoryType.bits > 32)
+            real = "double";
+
+        if(encodedType.isSigned)
+            element += "    protogen::encodeScaled<" + getCppCodingArguments(isBigEndian) + ", true, " + real + ">(data + index, static_cast<" + real + ">(" + value + "), " + getNumberString(0.0, inMemoryType.bits) + ", " + getNumberString(scaler, inMemoryType.bits) + ");\n";
+        else
+            element += "    protogen::encodeScaled<" + getCppCodingArguments(isBigEndian) + ", false, " + real + ">(data + index, static_cast<" + real + ">(" + value + "), " + getNumberString(encodedMin, inMemoryType.bits) + ", " + getNumberString(scaler, inMemoryType.bits) + ");\n";
+    }
+    else if(encodedType.isFloat)
+    {
+        QString endian = isBigEndian ? "true" : "false";
+        element += "    protogen::encodeFloat<" + QString().setNum(encodedType.bits) + ", " + endian + ">(data + index, static_cast<" + encodedType.toTypeString() + ">(" + value + "));\n";
+    }
+    else
+        element += "    protogen::encodeInteger<" + getCppCodingArguments(isBigEndian) + ">(data + index, static_cast<std::" + encodedType.toTypeString() + ">(" + value + "));\n";
+
+    element += "    index += " + length + ";\n";
+
+    return getCppRepeatString(element);
+
+}// ProtocolField::getCppEncodeString
+
+
+/*!
+ * Get the C++ code that decodes this field as a member of a structure. The
+ * length of the data is checked before anything is decoded whose length is
+ * not known until the data before it are decoded.
+ * \param isBigEndian should be true for big endian encoding.
+ * \param operation is the operation that decodes this field
+ * \return The code to add to the decode function
+ */
+QString ProtocolField::getCppDecodeString(bool isBigEndian, const ProtocolOperation& operation) const
+{
+    QString element;
+    QString check;
+    QString length = QString().setNum(encodedType.bits/8);
+    QString type = getCppTypeName();
+    QString access = getCppAccess();
+
+    if(encodedType.isNull)
+        return QString();
+
+    if(encodedType.isBitfield)
+    {
+        if(!inMemoryType.isNull)
+            element += "    " + access + " = static_cast<" + type + ">(protogen::decodeBitfield<" + QString().setNum(startingBitCount) + ", " + QString().setNum(encodedType.bits) + ">(data + index));\n";
+
+        if(lastBitfield)
+            element += "    index += " + QString().setNum(getFusedBitfieldBytes()) + ";\n";
+
+        return getCppConditionString(element);
+    }
+    else if(inMemoryType.isString)
+    {
+        QString target = name;
+        QString fixed = inMemoryType.isFixedString ? "true" : "false";
+
+        // A string that is not in memory is decoded to a scratch buffer, to find its end
+        if(inMemoryType.isNull)
+        {
+            target = "skipped";
+            element += "    char skipped[" + array + "];\n";
+        }
+
+        element += "    if(!protogen::decodeString(" + target + ", data, size, index, " + array + ", " + fixed + "))\n";
+        element += "        return false;\n";
+
+        if(inMemoryType.isNull)
+            element = "    {\n" + ProtocolFile::indentCode(element) + "    }\n";
+
+        if(operation.checkLength && !operation.restLength.isZero())
+            element += getCppLengthCheck(QString(), operation);
+
+        return getCppConditionString(element);
+    }
+    else if(inMemoryType.isStruct)
+        return getCppDecodeStringForStructure(operation);
+    else if(encodedType.isVarint)
+    {
+        QString after;
+
+        // Each element checks its own bytes as it is decoded
+        element += "    {\n";
+        element += "        std::" + getVarintHelperType() + " value;\n";
+        element += "        if(!protogen::decodeVarint(value, data, size, index, " + QString().setNum(getVarintMaxBytes()) + "))\n";
+        element += "            return false;\n";
+        element += "        " + access + " = static_cast<" + type + ">(value);\n";
+        element += "    }\n";
+
+        // The fields that follow are covered by one check
+        if(operation.checkLength && !operation.restLength.isZero())
+            after = getCppLengthCheck(QString(), operation);
+
+        return getCppRepeatString(element, QString(), after);
+    }
+
+    // The number of bytes of all the elements, which is checked up front
+    if(operation.checkLength || operation.isDefault)
+    {
+        if(isArray())
+            check = getCppLengthCheck(length + "*" + getCppCount(), operation);
+        else
+            check = getCppLengthCheck(length, operation);
+    }
+
+    if(inMemoryType.isNull)
+    {
+        // Skip over reserved space
+        if(isArray())
+            return getCppConditionString(check + "    index += " + length + "*" + array + ";\n");
+        else
+            return getCppConditionString(check + "    index += " + length + ";\n");
+    }
+    else if(encodedMax > encodedMin)
+    {
+        QString real = "float";
+        if(inMemoryType.bits > 32)
+            real = "double";
+
+        if(encodedType.isSigned)
+            element += "    " + access + " = static_cast<" + type + ">(protogen::decodeScaled<" + getCppCodingArguments(isBigEndian) + ", true, " + real + ">(data + index, " + getNumberString(0.0, inMemoryType.bits) + ", " + getNumberString(1.0, inMemoryType.bits) + "/" + getNumberString(scaler, inMemoryType.bits) + "));\n";
+        else
+            element += "    " + access + " = static_cast<" + type + ">(protogen::decodeScaled<" + getCppCodingArguments(isBigEndian) + ", false, " + real + ">(data + index, " + getNumberString(encodedMin, inMemoryType.bits) + ", " + getNumberString(1.0, inMemoryType.bits) + "/" + getNumberString(scaler, inMemoryType.bits) + "));\n";
+    }
+    else if(encodedType.isFloat)
+    {
+        QString endian = isBigEndian ? "true" : "false";
+        QString checked = support.specialFloat ? "true" : "false";
+        element += "    " + access + " = static_cast<" + type + ">(protogen::decodeFloat<" + QString().setNum(encodedType.bits) + ", " + endian + ", " + checked + ">(data + index));\n";
+    }
+    else if(encodedType.isSigned)
+        element += "    " + access + " = static_cast<" + type + ">(protogen::decodeInteger<" + getCppCodingArguments(isBigEndian) + ", true>(data + index));\n";
+    else
+        element += "    " + access + " = static_cast<" + type + ">(protogen::decodeInteger<" + getCppCodingArguments(isBigEndian) + ", false>(data + index));\n";
+
+    element += "    index += " + length + ";\n";
+
+    return getCppRepeatString(element, check);
+
+}// ProtocolField::getCppDecodeString
+
+
+/*!
+ * Return the C++ code that sets this field to its default value
+ * \return the code to add to the decode function, including line feed
+ */
+QString ProtocolField::getCppSetToDefaultsString(void) const
+{
+    QString output;
+
+    if(defaultValue.isEmpty() || notInMemory)
+        return output;
+
+    if(isArray())
+    {
+        // Every element is set, not just the ones that are in use
+        bool ok = false;
+        array.toInt(&ok);
+
+        if(ok)
+            output += "    for(std::size_t i = 0; i < " + array + "; i++)\n";
+        else
+            output += "    for(std::size_t i = 0; i < static_cast<std::size_t>(" + array + "); i++)\n";
+        output += "        " + name + "[i] = " + defaultValue + ";\n";
+    }
+    else
+        output += "    " + name + " = " + defaultValue + ";\n";
+
+    return output;
+
+}// ProtocolField::getCppSetToDefaultsString
+
+
 /*!
  * Get a properly formatted number string for a floating point number
  * \param number is the number to turn into a string
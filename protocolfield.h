@@ -24,6 +24,7 @@ public:
     bool isEnum;        //!< true if type is an enumeration
     bool isString;      //!< true if type is a variable length string
     bool isFixedString; //!< true if type is a fixed length string
+    bool isVarint;      //!< true if type is a variable length integer, which is only an encoding
     bool isNull;        //!< true if type is null, i.e not in memory OR not encoded
     int bits;           //!< number of bits used by type
 
@@ -79,9 +80,33 @@ public:
     //! Get the ending bitcount for this fields bitfield
     virtual int getEndingBitCount(void){return startingBitCount + encodedType.bits;}
 
+    //! Set the total number of bits in the group this bitfield belongs to
+    virtual void setBitfieldGroupBits(int bits) {bitfieldGroupBits = bits;}
+
+    //! True if this bitfield is packed into a single word with its group
+    virtual bool isFusedBitfield(void) const;
+
     //! True if this encodable has a default value
     virtual bool isDefault(void) const {return !defaultValue.isEmpty();}
 
+    //! True if this field can be read and written in place in an encoded packet
+    virtual bool supportsDirectAccess(void) const;
+
+    //! Get the size in bytes of one element of this field in memory
+    virtual int getInMemoryBytes(void) const;
+
+    //! True if this field is a signed number in memory
+    virtual bool isInMemorySigned(void) const {return inMemoryType.isSigned;}
+
+    //! Get the size in bytes of one element of this field if its encoding is a copy of its memory
+    virtual int getNativeBytes(void) const;
+
+    //! True if this field can be described by a field of the table codec
+    virtual bool supportsTableCodec(void) const;
+
+    //! Get the initializer of the table codec field of this field
+    virtual QString getTableFieldString(const QString& structureType, QStringList& constants) const;
+
     //! Get the declaration for this field
     virtual QString getDeclaration(void) const;
 
@@ -91,6 +116,9 @@ public:
     //! Return the signature of this field in an encode function signature
     virtual QString getEncodeSignature(void) const;
 
+    //! Describe the coding of this field as an operation
+    virtual void getOperation(ProtocolOperation& operation) const;
+
     //! Get details needed to produce documentation for this encodable.
     virtual void getDocumentationDetails(QList<int>& outline, QString& startByte, QStringList& bytes, QStringList& names, QStringList& encodings, QStringList& repeats, QStringList& comments) const;
 
@@ -98,11 +126,29 @@ public:
     virtual QString getEncodeString(bool isBigEndian, int* bitcount, bool isStructureMember) const;
 
     //! Return the string that is used to decode this encoable
-    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false) const;
+    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false, const QString& endHook = QString()) const;
 
     //! Return the string that sets this encodable to its default value in code
     virtual QString getSetToDefaultsString(bool isStructureMember) const;
 
+    //! Return the string that checks the data length before this field is decoded
+    virtual QString getDecodeLengthCheck(bool isStructureMember, const QString& restLength, const QString& rejectHook = QString()) const;
+
+    //! Get the declaration for this field as a member of a C++ structure
+    virtual QString getCppDeclaration(void) const;
+
+    //! Return the C++ include directive needed for this field
+    virtual QString getCppIncludeDirective(void);
+
+    //! Return the C++ code that encodes this field
+    virtual QString getCppEncodeString(bool isBigEndian) const;
+
+    //! Return the C++ code that decodes this field
+    virtual QString getCppDecodeString(bool isBigEndian, const ProtocolOperation& operation) const;
+
+    //! Return the C++ code that sets this field to its default value
+    virtual QString getCppSetToDefaultsString(void) const;
+
     //! Make this primitive not a default
     virtual void clearDefaults(void) {defaultValue.clear();}
 
@@ -132,10 +178,20 @@ protected:
 
     bool lastBitfield;      //!< True if this is the last bitfield in the local group
     int startingBitCount;   //!< The starting bit count for this field
+    int bitfieldGroupBits;  //!< The total number of bits in this fields bitfield group
 
     //! Compute the encoded length string
     void computeEncodedLength(void);
 
+    //! Get the declaration for this field, using a specific type name
+    QString getDeclarationForType(const QString& type) const;
+
+    //! Get the type name of this field in the C++ output
+    QString getCppTypeName(void) const;
+
+    //! Get the template arguments that give the byte count and order of this field in the C++ output
+    QString getCppCodingArguments(bool isBigEndian) const;
+
     //! Get the next lines(s) of source coded needed to encode a bitfield field
     QString getEncodeStringForBitfield(int* bitcount, bool isStructureMember) const;
 
@@ -158,11 +214,47 @@ protected:
     QString getDecodeStringForStructure(bool isStructureMember) const;
 
     //! Get the next lines(s, bool isStructureMember) of source coded needed to decode a field, which is not a bitfield or a string
-    QString getDecodeStringForField(bool isBigEndian, bool isStructureMember, bool defaultEnabled = false) const;
+    QString getDecodeStringForField(bool isBigEndian, bool isStructureMember, bool defaultEnabled = false, const QString& endHook = QString()) const;
 
     //! Get the source needed to close out a string of bitfields in the encode function.
     QString getCloseBitfieldString(int* bitcount) const;
 
+    //! Get the next lines of source needed to encode a bitfield that is fused with its group
+    QString getEncodeStringForFusedBitfield(bool isStructureMember) const;
+
+    //! Get the next lines of source needed to decode a bitfield that is fused with its group
+    QString getDecodeStringForFusedBitfield(bool isStructureMember) const;
+
+    //! Get the number of bytes in the word used for this fields fused bitfield group
+    int getFusedBitfieldBytes(void) const {return (bitfieldGroupBits + 7)/8;}
+
+    //! Determine if this array field is coded with a single call to an array helper
+    bool usesArrayHelper(void) const;
+
+    //! Get the number of array elements passed to an array helper
+    QString getArrayHelperCount(bool isStructureMember, bool isDecode) const;
+
+    //! Determine if this scaled field is coded inline with folded constants
+    bool usesFoldedScaling(void) const;
+
+    //! Get the number of bits of the floating point type used for folded scaling
+    int getFoldedScalingBits(void) const;
+
+    //! Get the largest number of bytes used by one element of a variable length integer field
+    int getVarintMaxBytes(void) const {return (encodedType.bits + 6)/7;}
+
+    //! Get the name of the helper functions of a variable length integer field, like "varuint32"
+    QString getVarintHelperName(void) const;
+
+    //! Get the in-memory type of the helper functions of a variable length integer field
+    QString getVarintHelperType(void) const;
+
+    //! Get the next lines of source needed to encode a scaled field with folded constants
+    QString getEncodeStringForFoldedScaling(bool isBigEndian, bool isStructureMember, const QString& constantValue, const QString& spacing) const;
+
+    //! Get the next lines of source needed to decode a scaled field with folded constants
+    QString getDecodeStringForFoldedScaling(bool isBigEndian, bool isStructureMember, const QString& spacing) const;
+
     //! Compute the power of 2 raised to some bits
     uint64_t pow2(uint8_t bits) const;
 
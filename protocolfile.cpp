@@ -1,8 +1,13 @@
 #include "protocolfile.h"
 #include "protocolparser.h"
+#include "protocolstatistics.h"
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDevice>
+#include <QByteArray>
+#include <QStringList>
+#include <QMutexLocker>
 #include <iostream>
 
 #ifdef WIN32
@@ -10,6 +15,14 @@
 extern Q_CORE_EXPORT int qt_ntfs_permission_lookup;
 #endif
 
+// The files that have been output by this run of ProtoGen
+QHash<QString, ProtocolFile*> ProtocolFile::openFiles;
+QMutex ProtocolFile::openFilesMutex;
+
+// The helper functions that the files output by this run of ProtoGen call
+QSet<QString> ProtocolFile::helperCalls;
+QMutex ProtocolFile::helperCallsMutex;
+
 /*!
  * Create the file object
  * \param moduleName is the name of the file, not counting any extension
@@ -18,7 +31,8 @@ ProtocolFile::ProtocolFile(const QString& moduleName, bool onlyversion) :
     module(moduleName),
     dirty(false),
     appending(false),
-    versionOnly(onlyversion)
+    versionOnly(onlyversion),
+    openFile(NULL)
 {
 }
 
@@ -29,7 +43,9 @@ ProtocolFile::ProtocolFile(const QString& moduleName, bool onlyversion) :
  */
 ProtocolFile::ProtocolFile() :
     dirty(false),
-    appending(false)
+    appending(false),
+    versionOnly(false),
+    openFile(NULL)
 {
 }
 
@@ -159,6 +175,26 @@ void ProtocolFile::makeLineSeparator(QString& contents)
 }
 
 
+/*!
+ * Indent each line of code by one more level (4 spaces). Blank lines are
+ * left empty.
+ * \param contents is the code to indent
+ * \return the indented code
+ */
+QString ProtocolFile::indentCode(const QString& contents)
+{
+    QStringList lines = contents.split("\n");
+
+    for(int i = 0; i < lines.size(); i++)
+    {
+        if(!lines.at(i).isEmpty())
+            lines[i] = "    " + lines.at(i);
+    }
+
+    return lines.join("\n");
+}
+
+
 /*!
  * delete a specific file. The file will be deleted even if it is read-only.
  * \param fileName identifies the file relative to the current working directory
@@ -211,6 +247,309 @@ void ProtocolFile::deleteModule(const QString& moduleName)
 }
 
 
+/*!
+ * Write a file that modules have been appending to, and remove it from the
+ * files that are kept open. Nothing else may append to the file at the same
+ * time.
+ * \param fileName identifies the file relative to the current working directory
+ * \return true if the file was written, false if it was not open or could not be written
+ */
+bool ProtocolFile::flushOpenFile(const QString& fileName)
+{
+    openFilesMutex.lock();
+    ProtocolFile* file = openFiles.take(fileName);
+    openFilesMutex.unlock();
+
+    if(file == NULL)
+        return false;
+
+    bool written = file->flush();
+    delete file;
+
+    return written;
+
+}// ProtocolFile::flushOpenFile
+
+
+/*!
+ * Forget any files that are kept open for appending, without writing them.
+ * This is done at the start of a run of ProtoGen.
+ */
+void ProtocolFile::clearOpenFiles(void)
+{
+    QMutexLocker lock(&openFilesMutex);
+
+    QHash<QString, ProtocolFile*>::iterator i;
+    for(i = openFiles.begin(); i != openFiles.end(); ++i)
+    {
+        // Clear first, the destructor would otherwise write the file
+        i.value()->clear();
+        delete i.value();
+    }
+
+    openFiles.clear();
+
+}// ProtocolFile::clearOpenFiles
+
+
+/*!
+ * Take over the contents of a file that is kept open for appending. Whatever
+ * the previous modules wrote becomes our contents, without any copying, so we
+ * append to it as if we had written it ourselves.
+ * \param file is the open file, which must have the same name as us
+ */
+void ProtocolFile::takeOpenFile(ProtocolFile* file)
+{
+    openFile = file;
+
+    contents.swap(file->contents);
+    prototypeContents.swap(file->prototypeContents);
+
+    // If someone wrote to the open file we are appending
+    appending = file->dirty;
+    dirty = file->dirty;
+
+}// ProtocolFile::takeOpenFile
+
+
+/*!
+ * Give our contents back to the file that is kept open for appending, instead
+ * of writing them to disk. The open file is written once all modules are done.
+ * \return true if we have an open file, false if our contents need to be written
+ */
+bool ProtocolFile::returnOpenFile(void)
+{
+    if(openFile == NULL)
+        return false;
+
+    openFile->contents.swap(contents);
+    openFile->prototypeContents.swap(prototypeContents);
+    openFile->dirty = openFile->dirty || dirty;
+    openFile = NULL;
+
+    // Empty our data
+    clear();
+
+    return true;
+
+}// ProtocolFile::returnOpenFile
+
+
+/*!
+ * Get the comment that goes at the top of the file to say that ProtoGen
+ * generated it.
+ * \return the generation stamp, including the blank line that follows it
+ */
+QString ProtocolFile::getGenerationStamp(void) const
+{
+    if(versionOnly)
+        return "// " + fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + "\n\n";
+    else
+        return "// " + fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + " on " + QDateTime::currentDateTime().toString() + "\n\n";
+}
+
+
+/*!
+ * Remove the date and time from the generation stamp in the first line of
+ * file data, so that file data can be compared without it.
+ * \param data is the file data
+ * \return the file data without the date and time of generation
+ */
+QByteArray ProtocolFile::removeGenerationDate(const QByteArray& data)
+{
+    int end = data.indexOf('\n');
+    int stamp = data.indexOf(" was generated by ProtoGen version ");
+
+    if((end < 0) || (stamp < 0) || (stamp > end))
+        return data;
+
+    int date = data.indexOf(" on ", stamp);
+
+    if((date < 0) || (date > end))
+        return data;
+
+    return data.left(date) + data.mid(end);
+}
+
+
+/*!
+ * Write the complete contents of a file, unless the file already has those
+ * contents. The date and time of generation are ignored in the comparison.
+ * Leaving an unchanged file untouched keeps its modification time, so build
+ * tools do not rebuild anything that depends on it.
+ * \param fileName identifies the file relative to the current working directory
+ * \param text is the complete contents of the file
+ * \return true if the file has the contents, false if it could not be written
+ */
+bool ProtocolFile::writeFileIfChanged(const QString& fileName, const QString& text)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // The helper modules are output last, with only the functions that are called
+    recordHelperCalls(text);
+
+    QByteArray data = text.toLocal8Bit();
+    QFile file(fileName);
+
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QByteArray existing = file.readAll();
+        file.close();
+
+        if(removeGenerationDate(existing) == removeGenerationDate(data))
+        {
+            ProtocolStatistics::addFile(data.size(), false, timer.nsecsElapsed());
+            return true;
+        }
+    }
+
+    // The file may have been left read-only by a version control system
+    makeFileWritable(fileName);
+
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        std::cout << "Failed to open " << fileName.toStdString() << std::endl;
+        return false;
+    }
+
+    file.write(data);
+    file.close();
+
+    ProtocolStatistics::addFile(data.size(), true, timer.nsecsElapsed());
+
+    return true;
+
+}// ProtocolFile::writeFileIfChanged
+
+
+/*!
+ * Find the helper functions that some code calls. The names of the helper
+ * functions all end in "Bytes", like uint16ToBeBytes() or
+ * float32ScaledTo2SignedLeBytes(), so only those names are searched for.
+ * \param code is the code to search
+ * \return the names of the functions, which may repeat
+ */
+QStringList ProtocolFile::getHelperCalls(const QString& code)
+{
+    QStringList names;
+
+    for(int index = code.indexOf("Bytes("); index >= 0; index = code.indexOf("Bytes(", index + 6))
+    {
+        int start = index;
+
+        while((start > 0) && (code.at(start - 1).isLetterOrNumber() || (code.at(start - 1) == '_')))
+            start--;
+
+        names.append(code.mid(start, index + 5 - start));
+    }
+
+    return names;
+
+}// ProtocolFile::getHelperCalls
+
+
+/*!
+ * Remember the helper functions that some code calls
+ * \param code is the code to search
+ * \return true if a function was found that was not already remembered
+ */
+bool ProtocolFile::recordHelperCalls(const QString& code)
+{
+    QStringList names = getHelperCalls(code);
+
+    QMutexLocker lock(&helperCallsMutex);
+
+    int previous = helperCalls.size();
+
+    for(int i = 0; i < names.size(); i++)
+        helperCalls.insert(names.at(i));
+
+    return (helperCalls.size() > previous);
+
+}// ProtocolFile::recordHelperCalls
+
+
+/*!
+ * Determine if any of the files output by this run of ProtoGen call a helper
+ * function. Helper modules are output after every other file, so they can
+ * leave out the functions which are not called.
+ * \param function is the name of the function
+ * \return true if the function is called
+ */
+bool ProtocolFile::isHelperCalled(const QString& function)
+{
+    QMutexLocker lock(&helperCallsMutex);
+
+    return helperCalls.contains(function);
+}
+
+
+/*!
+ * Forget the helper functions that were called. This is done at the start of
+ * a run of ProtoGen.
+ */
+void ProtocolFile::clearHelperCalls(void)
+{
+    QMutexLocker lock(&helperCallsMutex);
+
+    helperCalls.clear();
+}
+
+
+/*!
+ * Copy a file, unless the destination already has the same contents.
+ * \param source identifies the file to copy, which can be a resource
+ * \param destination identifies the copy relative to the current working directory
+ * \return true if the destination has the contents, false if the copy failed
+ */
+bool ProtocolFile::copyFileIfChanged(const QString& source, const QString& destination)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile input(source);
+    QFile output(destination);
+
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        std::cout << "Failed to open " << source.toStdString() << std::endl;
+        return false;
+    }
+
+    QByteArray data = input.readAll();
+    input.close();
+
+    if(output.open(QIODevice::ReadOnly))
+    {
+        QByteArray existing = output.readAll();
+        output.close();
+
+        if(existing == data)
+        {
+            ProtocolStatistics::addFile(data.size(), false, timer.nsecsElapsed());
+            return true;
+        }
+    }
+
+    makeFileWritable(destination);
+
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        std::cout << "Failed to open " << destination.toStdString() << std::endl;
+        return false;
+    }
+
+    output.write(data);
+    output.close();
+
+    ProtocolStatistics::addFile(data.size(), true, timer.nsecsElapsed());
+
+    return true;
+
+}// ProtocolFile::copyFileIfChanged
+
+
 /*!
  * Destroy the protocol file making sure to dump the contents to disk if needed
  */
@@ -226,6 +565,9 @@ ProtocolFile::~ProtocolFile()
  */
 bool ProtocolFile::flush(void)
 {
+    if(returnOpenFile())
+        return true;
+
     if(!dirty)
         return false;
 
@@ -236,24 +578,13 @@ bool ProtocolFile::flush(void)
         return false;
     }
 
-    QFile file(fileName());
-
-    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        std::cout << "Failed to open " << fileName().toStdString() << std::endl;
-        return false;
-    }
-
     // The actual interesting contents
-    file.write(qPrintable(contents));
-
-    // And the file
-    file.close();
+    bool written = writeFileIfChanged(fileName(), contents);
 
     // Empty our data
     clear();
 
-    return true;
+    return written;
 
 }// ProtocolFile::flush
 
@@ -274,6 +605,10 @@ QString ProtocolHeaderFile::fileName(void) const
  */
 bool ProtocolHeaderFile::flush(void)
 {
+    // Other modules may still append to this file
+    if(returnOpenFile())
+        return true;
+
     if(!dirty)
         return false;
 
@@ -284,46 +619,36 @@ bool ProtocolHeaderFile::flush(void)
         return false;
     }
 
-    QFile file(fileName());
-
-    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        std::cout << "Failed to open " << fileName().toStdString() << std::endl;
-        return false;
-    }
+    QString output;
 
     if(!appending)
     {
         // Tag for when the file was generated
-        if(versionOnly)
-            file.write(qPrintable("// " + file.fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + "\n\n"));
-        else
-            file.write(qPrintable("// " + file.fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + " on " + QDateTime::currentDateTime().toString() + "\n\n"));
+        output += getGenerationStamp();
 
         // The opening #ifdef
         QString define = "_" + module.toUpper() + "_H";
-        file.write(qPrintable("#ifndef " + define + "\n"));
-        file.write(qPrintable("#define " + define + "\n"));
+        output += "#ifndef " + define + "\n";
+        output += "#define " + define + "\n";
 
-        file.write("\n// C++ compilers: don't mangle us\n");
-        file.write("#ifdef __cplusplus\n");
-        file.write("extern \"C\" {\n");
-        file.write("#endif\n\n");
+        output += "\n// C++ compilers: don't mangle us\n";
+        output += "#ifdef __cplusplus\n";
+        output += "extern \"C\" {\n";
+        output += "#endif\n\n";
     }
 
     // The actual interesting contents
-    file.write(qPrintable(contents));
+    output += contents;
 
     // close the file out
-    file.write(qPrintable(getClosingStatement()));
+    output += getClosingStatement();
 
-    // And the file
-    file.close();
+    bool written = writeFileIfChanged(fileName(), output);
 
     // Empty our data
     clear();
 
-    return true;
+    return written;
 
 }// ProtocolHeaderFile::flush
 
@@ -348,37 +673,86 @@ QString ProtocolHeaderFile::getClosingStatement(void)
 
 
 /*!
- * Setup a file for a possible append. The append will happen if the file
- * already exists, in which case it is read out, and the closing statement
- * removed so append can be performed
+ * Setup a file for a possible append. All the modules that append to a file
+ * share one open file, which is written once they are done. If another module
+ * has already written to the open file we take over its contents, and are
+ * appending.
  */
 void ProtocolHeaderFile::prepareToAppend(void)
 {
-    QFile file(fileName());
+    openFilesMutex.lock();
 
-    if(file.exists())
+    ProtocolFile* file = openFiles.value(fileName(), NULL);
+    if(file == NULL)
     {
-        if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        {
-            std::cout << "Failed to open " << fileName().toStdString() << " for append" << std::endl;
-            return ;
-        }
+        file = new ProtocolHeaderFile();
+        file->setModuleName(module);
+        openFiles.insert(fileName(), file);
+    }
 
-        // Read the entire file, and store as existing text string data
-        contents = file.readAll();
+    openFilesMutex.unlock();
+
+    takeOpenFile(file);
+
+}// ProtocolHeaderFile::prepareToAppend
 
-        // Close the file, we don't need it anymore
-        file.close();
 
-        // Remove the trailing closing statement from the file so we can append further stuff
-        contents.remove(getClosingStatement());
+/*!
+ * Append to the prototype section of the file, which comes after the include
+ * of our own header and before everything else
+ * \param text is the information to append
+ */
+void ProtocolSourceFile::writePrototype(const QString& text)
+{
+    prototypeContents += text;
+    dirty = true;
+}
 
-        // we are appending
-        appending = true;
 
-    }// If the file already exists
+/*!
+ * Output an include directive in the prototype section of the file, unless
+ * the file already contains it. This lets an include directive be output
+ * once the rest of the file is known.
+ * \param include is the name of the file to include, including the extension
+ */
+void ProtocolSourceFile::writePrototypeIncludeDirective(const QString& include)
+{
+    QString directive = "#include \"" + include + "\"";
 
-}// ProtocolHeaderFile::prepareToAppend
+    if(prototypeContents.contains(directive) || contents.contains(directive))
+        return;
+
+    writePrototype(directive + "\n");
+
+}// ProtocolSourceFile::writePrototypeIncludeDirective
+
+
+/*!
+ * Include the helper modules whose functions the file calls, in the prototype
+ * section of the file. This is done once the file is complete, instead of
+ * including every helper module before the file is written.
+ */
+void ProtocolSourceFile::writeHelperIncludeDirectives(void)
+{
+    QStringList names = getHelperCalls(contents);
+
+    for(int i = 0; i < names.size(); i++)
+    {
+        if(names.at(i).contains("ScaledTo"))
+            writePrototypeIncludeDirective("scaledencode.h");
+        else if(names.at(i).contains("ScaledFrom"))
+            writePrototypeIncludeDirective("scaleddecode.h");
+        else if(names.at(i).contains("From"))
+            writePrototypeIncludeDirective("fielddecode.h");
+        else if(names.at(i).contains("To"))
+            writePrototypeIncludeDirective("fieldencode.h");
+    }
+
+    // The host byte order of the native layout copies
+    if(contents.contains("FIELDCODING_"))
+        writePrototypeIncludeDirective("fieldencode.h");
+
+}// ProtocolSourceFile::writeHelperIncludeDirectives
 
 
 /*!
@@ -397,6 +771,10 @@ QString ProtocolSourceFile::fileName(void) const
  */
 bool ProtocolSourceFile::flush(void)
 {
+    // Other modules may still append to this file
+    if(returnOpenFile())
+        return true;
+
     if(!dirty)
         return false;
 
@@ -407,42 +785,32 @@ bool ProtocolSourceFile::flush(void)
         return false;
     }
 
-    QFile file(fileName());
-
-    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        std::cout << "Failed to open " << fileName().toStdString() << std::endl;
-        return false;
-    }
+    QString output;
 
     if(!appending)
     {
         // Tag for when the file was generated
-        if(versionOnly)
-            file.write(qPrintable("// " + file.fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + "\n\n"));
-        else
-            file.write(qPrintable("// " + file.fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + " on " + QDateTime::currentDateTime().toString() + "\n\n"));
+        output += getGenerationStamp();
 
         // The source file includes the header
-        file.write(qPrintable("#include \"" + module + ".h\"\n"));
+        output += "#include \"" + module + ".h\"\n";
     }
 
     // The part of the file that goes before the main body
-    file.write(qPrintable(prototypeContents));
+    output += prototypeContents;
 
     // The actual interesting contents
-    file.write(qPrintable(contents));
+    output += contents;
 
     // Close it out
-    file.write(qPrintable(getClosingStatement()));
+    output += getClosingStatement();
 
-    // And the file
-    file.close();
+    bool written = writeFileIfChanged(fileName(), output);
 
     // Empty our data
     clear();
 
-    return true;
+    return written;
 
 }// ProtocolSourceFile::flush
 
@@ -462,34 +830,107 @@ QString ProtocolSourceFile::getClosingStatement(void)
 
 
 /*!
- * Setup a file for a possible append. The append will happen if the file
- * already exists, in which case it is read out, and the closing statement
- * removed so append can be performed
+ * Setup a file for a possible append. All the modules that append to a file
+ * share one open file, which is written once they are done. If another module
+ * has already written to the open file we take over its contents, and are
+ * appending.
  */
 void ProtocolSourceFile::prepareToAppend(void)
 {
-    QFile file(fileName());
+    openFilesMutex.lock();
 
-    if(file.exists())
+    ProtocolFile* file = openFiles.value(fileName(), NULL);
+    if(file == NULL)
     {
-        if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        {
-            std::cout << "Failed to open " << fileName().toStdString() << " for append" << std::endl;
-            return ;
-        }
+        file = new ProtocolSourceFile();
+        file->setModuleName(module);
+        openFiles.insert(fileName(), file);
+    }
 
-        // Read the entire file, and store as existing text string data
-        contents = file.readAll();
+    openFilesMutex.unlock();
 
-        // Close the file, we don't need it anymore
-        file.close();
+    takeOpenFile(file);
 
-        // Remove the trailing closing statement from the file so we can append further stuff
-        contents.remove(getClosingStatement());
+}// ProtocolSourceFile::prepareToAppend
 
-        // we are appending
-        appending = true;
 
-    }// If the file already exists
+/*!
+ * Return the filename, which is the module name plus ".hpp"
+ * \return the filename
+ */
+QString ProtocolCppHeaderFile::fileName(void) const
+{
+    return module + ".hpp";
+}
 
-}// ProtocolSourceFile::prepareToAppend
+
+/*!
+ * Write the file to disc, including any prologue/epilogue. Unlike the C
+ * header there is no extern "C" block, the whole point of this file is C++.
+ * \return true if the file is written, else there is a problem opening\overwriting the file
+ */
+bool ProtocolCppHeaderFile::flush(void)
+{
+    // Other modules may still append to this file
+    if(returnOpenFile())
+        return true;
+
+    if(!dirty)
+        return false;
+
+    // Got to have a name
+    if(module.isEmpty())
+    {
+        std::cout << "Empty module name when writing protocol C++ header file" << std::endl;
+        return false;
+    }
+
+    QString output;
+
+    if(!appending)
+    {
+        // Tag for when the file was generated
+        output += getGenerationStamp();
+
+        // The opening #ifdef, which must not collide with the C header
+        QString define = "_" + module.toUpper() + "_HPP";
+        output += "#ifndef " + define + "\n";
+        output += "#define " + define + "\n\n";
+    }
+
+    // The actual interesting contents
+    output += contents;
+
+    // close the opening #ifdef
+    output += "#endif\n";
+
+    bool written = writeFileIfChanged(fileName(), output);
+
+    // Empty our data
+    clear();
+
+    return written;
+
+}// ProtocolCppHeaderFile::flush
+
+
+/*!
+ * Setup a file for a possible append, in the same way as the C header
+ */
+void ProtocolCppHeaderFile::prepareToAppend(void)
+{
+    openFilesMutex.lock();
+
+    ProtocolFile* file = openFiles.value(fileName(), NULL);
+    if(file == NULL)
+    {
+        file = new ProtocolCppHeaderFile();
+        file->setModuleName(module);
+        openFiles.insert(fileName(), file);
+    }
+
+    openFilesMutex.unlock();
+
+    takeOpenFile(file);
+
+}// ProtocolCppHeaderFile::prepareToAppend
@@ -2,6 +2,11 @@
 #define PROTOCOLFILE_H
 
 #include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
 
 class ProtocolFile
 {
@@ -49,10 +54,61 @@ public:
     //! delete both the .c and .h file
     static void deleteModule(const QString& moduleName);
 
+    //! Write a file that was kept open for appending, and forget about it
+    static bool flushOpenFile(const QString& fileName);
+
+    //! Forget any files that are kept open for appending, without writing them
+    static void clearOpenFiles(void);
+
+    //! Write a file, unless it already has the same contents
+    static bool writeFileIfChanged(const QString& fileName, const QString& text);
+
+    //! Copy a file, unless the destination already has the same contents
+    static bool copyFileIfChanged(const QString& source, const QString& destination);
+
     //! Make sure one blank line at end
     static void makeLineSeparator(QString& contents);
 
+    //! Indent each line of code by one more level
+    static QString indentCode(const QString& contents);
+
+    //! Remember the helper functions that some code calls
+    static bool recordHelperCalls(const QString& code);
+
+    //! Determine if any generated code calls a helper function
+    static bool isHelperCalled(const QString& function);
+
+    //! Forget the helper functions that were called
+    static void clearHelperCalls(void);
+
 protected:
+    //! Get the comment that says when and by what the file was generated
+    QString getGenerationStamp(void) const;
+
+    //! Remove the date and time of generation from file data
+    static QByteArray removeGenerationDate(const QByteArray& data);
+
+    //! Find the helper functions that some code calls
+    static QStringList getHelperCalls(const QString& code);
+
+    //! Take over the contents of a file that is kept open for appending
+    void takeOpenFile(ProtocolFile* file);
+
+    //! Give our contents back to the file that is kept open for appending
+    bool returnOpenFile(void);
+
+    //! Files that modules append to, by file name, which are written once all modules are done
+    static QHash<QString, ProtocolFile*> openFiles;
+
+    //! Protects openFiles, as modules are output from different threads
+    static QMutex openFilesMutex;
+
+    //! The names of the helper functions called by the files that have been written
+    static QSet<QString> helperCalls;
+
+    //! Protects helperCalls, as modules are output from different threads
+    static QMutex helperCallsMutex;
+
     QString module;     //!< The module name, not including the file extension
     QString contents;   //!< The contents, not including the prologue or epilogue
     QString prototypeContents;  //!< Contents that go before the main body of the file
@@ -60,6 +116,8 @@ protected:
     bool dirty;         //!< Flag set to indicate that the file contents are dirty and need to be flushed
     bool appending;     //!< Flag set if an append operation is in progress
     bool versionOnly;   //!< Flag to limit protogen notice to use only the version, not the date and time
+
+    ProtocolFile* openFile; //!< The open file which our contents belong to, or NULL
 };
 
 
@@ -89,6 +147,12 @@ public:
     //! Append to the prototype section of the file
     void writePrototype(const QString& text);
 
+    //! Output an include directive in the prototype section of the file
+    void writePrototypeIncludeDirective(const QString& include);
+
+    //! Include the helper modules whose functions the file calls
+    void writeHelperIncludeDirectives(void);
+
     //! Write the file to disc, including any prologue/epilogue
     bool flush(void);
 
@@ -105,4 +169,19 @@ protected:
 };
 
 
+class ProtocolCppHeaderFile : public ProtocolFile
+{
+public:
+
+    //! Write the file to disc, including any prologue/epilogue
+    virtual bool flush(void);
+
+    //! Return the filename
+    virtual QString fileName(void) const;
+
+    //! Prepare to do an append operation
+    void prepareToAppend(void);
+};
+
+
 #endif // PROTOCOLFILE_H
@@ -0,0 +1,146 @@
+#include "protocoloperation.h"
+#include "encodable.h"
+
+/*!
+ * Construct an empty operation
+ */
+ProtocolOperation::ProtocolOperation(void) :
+    kind(StructureOperation),
+    encodable(NULL),
+    index(0),
+    count(1),
+    bits(0),
+    isSigned(false),
+    isFloat(false),
+    scaled(false),
+    scaleMinimum(0.0),
+    scaler(1.0),
+    isDefault(false),
+    constantOffset(false),
+    checkLength(false)
+{
+}
+
+
+/*!
+ * Lower a list of encodables to operations, one for each encodable that is
+ * encoded. Encodables that are only in memory have no operation.
+ * \param encodables is the list of encodables of a packet or structure
+ */
+void ProtocolOperationList::lower(const QList<Encodable*>& encodables)
+{
+    operations.clear();
+
+    for(int i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->isNotEncoded())
+            continue;
+
+        ProtocolOperation operation;
+        encodables.at(i)->getOperation(operation);
+        operation.index = i;
+        operations.append(operation);
+    }
+
+}// ProtocolOperationList::lower
+
+
+/*!
+ * Merge operations that are coded together. The fields of a bitfield group
+ * share bytes, so the group becomes one operation that starts and ends on a
+ * byte boundary.
+ */
+void ProtocolOperationList::mergeAdjacent(void)
+{
+    for(int i = 1; i < operations.size(); i++)
+    {
+        ProtocolOperation& previous = operations[i-1];
+        const ProtocolOperation& next = operations.at(i);
+
+        if((previous.kind != ProtocolOperation::BitfieldOperation) || (next.kind != ProtocolOperation::BitfieldOperation))
+            continue;
+
+        previous.bits += next.bits;
+        previous.count = next.index + next.count - previous.index;
+        previous.minLength.add(next.minLength);
+        previous.maxLength.add(next.maxLength);
+
+        operations.removeAt(i);
+        i--;
+    }
+
+}// ProtocolOperationList::mergeAdjacent
+
+
+/*!
+ * Work out the wire offset of each operation, which is constant as long as
+ * every operation before it has a fixed length, and where the data length
+ * must be checked when decoding. Only operations whose length is not fixed
+ * need a check, and that check also covers the minimum length of everything
+ * after it, so the fixed length operations that follow need no check.
+ */
+void ProtocolOperationList::hoistBoundsChecks(void)
+{
+    LengthExpression offset;
+    bool constant = true;
+
+    for(int i = 0; i < operations.size(); i++)
+    {
+        ProtocolOperation& operation = operations[i];
+
+        operation.constantOffset = constant;
+        if(constant)
+            operation.offset = offset;
+        else
+            operation.offset.clear();
+
+        if(operation.minLength != operation.maxLength)
+            constant = false;
+        else
+            offset.add(operation.maxLength);
+    }
+
+    LengthExpression rest;
+
+    for(int i = operations.size() - 1; i >= 0; i--)
+    {
+        ProtocolOperation& operation = operations[i];
+
+        operation.restLength = rest;
+        operation.checkLength = (operation.minLength != operation.maxLength);
+        rest.add(operation.minLength);
+    }
+
+}// ProtocolOperationList::hoistBoundsChecks
+
+
+/*!
+ * Lower a list of encodables and run all the passes over the operations
+ * \param encodables is the list of encodables of a packet or structure
+ */
+void ProtocolOperationList::build(const QList<Encodable*>& encodables)
+{
+    lower(encodables);
+    mergeAdjacent();
+    hoistBoundsChecks();
+}
+
+
+/*!
+ * Find the operation that codes an encodable
+ * \param index is the index of the encodable in the list that was lowered
+ * \return the operation, or NULL if the encodable is not encoded
+ */
+const ProtocolOperation* ProtocolOperationList::find(int index) const
+{
+    for(int i = 0; i < operations.size(); i++)
+    {
+        const ProtocolOperation& operation = operations.at(i);
+
+        if((index >= operation.index) && (index < operation.index + operation.count))
+            return &operation;
+    }
+
+    return NULL;
+
+}// ProtocolOperationList::find
@@ -0,0 +1,92 @@
+#ifndef PROTOCOLOPERATION_H
+#define PROTOCOLOPERATION_H
+
+/*!
+ * \file
+ * The encode and decode operations of a packet or structure
+ *
+ * The encodables of a packet are lowered to a flat list of operations, each
+ * of which knows where it is on the wire, how wide it is, how it is scaled,
+ * and when it is present. Passes over the list, such as merging the fields
+ * of a bitfield group or working out where length checks are needed, are
+ * done once, and every emitter of code or documentation reads the result.
+ */
+
+#include "encodedlength.h"
+#include <QString>
+#include <QList>
+
+class Encodable;
+
+class ProtocolOperation
+{
+public:
+    //! The kind of coding done by an operation
+    enum Kind
+    {
+        FieldOperation,     //!< A number, or an array of numbers
+        BitfieldOperation,  //!< Bits that do not start or end on a byte boundary
+        StringOperation,    //!< A fixed or variable length string
+        StructureOperation, //!< A structure, coded by its own functions
+        NullOperation       //!< Bytes that are skipped, or a constant that is not in memory
+    };
+
+    //! Construct an empty operation
+    ProtocolOperation(void);
+
+    Kind kind;                      //!< The kind of coding done
+    const Encodable* encodable;     //!< The first encodable coded by this operation
+    int index;                      //!< The index of the first encodable in its parent
+    int count;                      //!< The number of encodables coded by this operation
+    int bits;                       //!< The encoded width in bits of one element, 0 if not known
+    bool isSigned;                  //!< True if the encoding is signed
+    bool isFloat;                   //!< True if the encoding is floating point
+    bool scaled;                    //!< True if the in-memory value is scaled to an integer encoding
+    double scaleMinimum;            //!< The in-memory value that encodes as zero, if scaled
+    double scaler;                  //!< The multiplier from in-memory to encoded units, if scaled
+    QString constantValue;          //!< The value that is always encoded, empty if not constant
+    QString array;                  //!< The number of elements, empty if not an array
+    QString variableArray;          //!< The name of the field that gives the number of elements in use
+    QString condition;              //!< The name of the field that says if this operation is present
+    bool isDefault;                 //!< True if this operation can be left out at the end of a packet
+    LengthExpression minLength;     //!< The minimum encoded length in bytes
+    LengthExpression maxLength;     //!< The maximum encoded length in bytes
+    bool constantOffset;            //!< True if every operation before this one has a fixed length
+    LengthExpression offset;        //!< The byte offset from the start of the data, if it is constant
+    bool checkLength;               //!< True if the data length must be checked before this operation is decoded
+    LengthExpression restLength;    //!< The minimum length of the operations after this one
+};
+
+
+class ProtocolOperationList
+{
+public:
+    //! Lower a list of encodables to operations
+    void lower(const QList<Encodable*>& encodables);
+
+    //! Merge operations that are coded together
+    void mergeAdjacent(void);
+
+    //! Work out the wire offsets and where the data length must be checked
+    void hoistBoundsChecks(void);
+
+    //! Lower a list of encodables and run all the passes
+    void build(const QList<Encodable*>& encodables);
+
+    //! Remove all operations
+    void clear(void) {operations.clear();}
+
+    //! Get the number of operations
+    int size(void) const {return operations.size();}
+
+    //! Get one of the operations
+    const ProtocolOperation& at(int i) const {return operations.at(i);}
+
+    //! Find the operation that codes an encodable
+    const ProtocolOperation* find(int index) const;
+
+private:
+    QList<ProtocolOperation> operations;    //!< The operations in wire order
+};
+
+#endif // PROTOCOLOPERATION_H
@@ -20,7 +20,13 @@
  *        significant byte first.
  */
 ProtocolPacket::ProtocolPacket(const QString& protocolName, const QString& protocolPrefix, ProtocolSupport supported, const QString& protocolApi, const QString& protocolVersion, bool bigendian) :
-    ProtocolStructureModule(protocolName, protocolPrefix, supported, protocolApi, protocolVersion, bigendian)
+    ProtocolStructureModule(protocolName, protocolPrefix, supported, protocolApi, protocolVersion, bigendian),
+    structureFunctions(false),
+    parameterFunctions(false),
+    accessorFunctions(false),
+    deltaFunctions(false),
+    tableCodec(false),
+    batchFunctions(false)
 {
 }
 
@@ -38,6 +44,14 @@ void ProtocolPacket::clear(void)
 {
     ProtocolStructureModule::clear();
     id.clear();
+    deltaId.clear();
+    structureFunctions = false;
+    parameterFunctions = false;
+    accessorFunctions = false;
+    deltaFunctions = false;
+    tableCodec = false;
+    batchFunctions = false;
+    operations.clear();
 
     // Note that data set during constructor are not changed
 
@@ -45,8 +59,9 @@ void ProtocolPacket::clear(void)
 
 
 /*!
- * Create the source and header files that represent a packet
- * \param packet is DOM element that defines the packet
+ * Parse the DOM description of a packet. This only builds the packet,
+ * generate() must then be called to write the files.
+ * \param e is DOM element that defines the packet
  */
 void ProtocolPacket::parse(const QDomElement& e)
 {
@@ -70,21 +85,136 @@ void ProtocolPacket::parse(const QDomElement& e)
     }
 
     // The file directive allows us to override the file name
-    QString moduleName = e.attribute("file");
+    moduleName = e.attribute("file");
 
     if(moduleName.isEmpty())
     {
         // The file names
         header.setModuleName(prefix + name + "Packet");
         source.setModuleName(prefix + name + "Packet");
+        cppHeader.setModuleName(prefix + name + "Packet");
     }
     else
     {
         // The file names
         header.setModuleName(moduleName);
         source.setModuleName(moduleName);
+        cppHeader.setModuleName(moduleName);
     }
 
+    // Other includes specific to this packet
+    parseIncludes(e);
+
+    id = e.attribute("ID");
+
+    // If no ID is supplied then use the packet name in upper case,
+    // assuming that the user will define it elsewhere
+    if(id.isEmpty())
+        id = name.toUpper();
+
+    structureFunctions = e.attribute("structureInterface").contains("true", Qt::CaseInsensitive);
+    parameterFunctions = e.attribute("parameterInterface").contains("true", Qt::CaseInsensitive);
+    accessorFunctions = e.attribute("accessorInterface").contains("true", Qt::CaseInsensitive);
+    deltaFunctions = e.attribute("delta").contains("true", Qt::CaseInsensitive);
+    batchFunctions = e.attribute("batchInterface").contains("true", Qt::CaseInsensitive);
+
+    // The packet can override the protocol choice of codec
+    QString table = e.attribute("tableCodec");
+    if(table.isEmpty())
+        tableCodec = support.tableCodec;
+    else
+        tableCodec = table.contains("true", Qt::CaseInsensitive);
+
+    // If there is no encodable list we better have parameter functions
+    if(encodables.length() <= 0)
+    {
+        structureFunctions = false;
+        parameterFunctions = true;
+    }
+    else if((structureFunctions == false) && (parameterFunctions == false))
+    {
+        // If the user gave us no guidance (or turned both off, which is the
+        // same as no guidance), make a choice based on the size of the
+        // encodable list. If we only have 1 parameter, there is no sense in
+        // wrapping it in a structure
+        if(encodables.length() <= 1)
+            parameterFunctions = true;
+        else
+            structureFunctions = true;
+    }
+
+    // The offsets and length checks used when the code is generated
+    operations.build(encodables);
+
+    // The changes are relative to a reference structure
+    if(deltaFunctions && !structureFunctions)
+    {
+        std::cout << name.toStdString() << ": delta encoding requires the structure interface" << std::endl;
+        deltaFunctions = false;
+    }
+
+    if(deltaFunctions && getDeltaOperations().isEmpty())
+    {
+        std::cout << name.toStdString() << ": delta encoding requires fields that the user sets" << std::endl;
+        deltaFunctions = false;
+    }
+
+    // Delta packets have their own identifier, so a receiver can tell them
+    // apart from full packets. As for the ID the default is a name the user
+    // will define elsewhere
+    deltaId = e.attribute("deltaID");
+    if(deltaId.isEmpty())
+        deltaId = name.toUpper() + "_DELTA";
+
+    // The table describes the members of the structure
+    if(tableCodec && !structureFunctions)
+    {
+        std::cout << name.toStdString() << ": the table codec requires the structure interface" << std::endl;
+        tableCodec = false;
+    }
+
+    // A packet of only constants has no structure to describe
+    if(tableCodec && (getNumberOfNonConstEncodes() <= 0))
+        tableCodec = false;
+
+    if(tableCodec)
+    {
+        QStringList constants;
+
+        for(int i = 0; i < encodables.size(); i++)
+        {
+            if(!encodables.at(i)->supportsTableCodec())
+            {
+                std::cout << name.toStdString() << ": " << encodables.at(i)->name.toStdString() << " cannot be coded by the table codec, the packet is coded by straight line code" << std::endl;
+                tableCodec = false;
+                break;
+            }
+
+            encodables.at(i)->getTableFieldString(typeName, constants);
+        }
+
+        // The fields refer to the constants with one byte
+        if(tableCodec && (constants.size() > 255))
+        {
+            std::cout << name.toStdString() << ": too many scaled or constant fields for the table codec, the packet is coded by straight line code" << std::endl;
+            tableCodec = false;
+        }
+    }
+
+}// ProtocolPacket::parse
+
+
+/*!
+ * Create the source and header files that represent a packet. Like
+ * ProtocolStructureModule::generate() this only touches the files of this
+ * packet.
+ */
+void ProtocolPacket::generate(void)
+{
+    // Make sure these are empty
+    header.clear();
+    source.clear();
+
     // We may be appending data to an already existing file
     header.prepareToAppend();
     source.prepareToAppend();
@@ -115,52 +245,35 @@ void ProtocolPacket::parse(const QDomElement& e)
     else
         header.makeLineSeparator();
 
+    // The types go in the header, unless they have their own
+    openTypesHeader();
+    ProtocolHeaderFile& types = support.typesHeaders ? typesHeader : header;
+
     // Add other includes specific to this packet
-    ProtocolParser::outputIncludes(header, e);
+    outputIncludes(types);
 
     // Include directives that may be needed for our children
-    for(int i = 0; i < encodables.length(); i++)
-        header.writeIncludeDirective(encodables[i]->getIncludeDirective());
+    outputChildIncludes(types);
 
     // White space is good
-    header.makeLineSeparator();
+    types.makeLineSeparator();
 
     // Output enumerations specific to this packet
     for(int i = 0; i < enumList.length(); i++)
     {
-        header.makeLineSeparator();
-        header.write(enumList.at(i)->getOutput());
+        types.makeLineSeparator();
+        types.write(enumList.at(i)->getOutput());
     }
 
     // White space is good
-    header.makeLineSeparator();
-
-    bool structureFunctions = e.attribute("structureInterface").contains("true", Qt::CaseInsensitive);
-    bool parameterFunctions = e.attribute("parameterInterface").contains("true", Qt::CaseInsensitive);
-
-    // If there is no encodable list we better have parameter functions
-    if(encodables.length() <= 0)
-    {
-        structureFunctions = false;
-        parameterFunctions = true;
-    }
-    else if((structureFunctions == false) && (parameterFunctions == false))
-    {
-        // If the user gave us no guidance (or turned both off, which is the
-        // same as no guidance), make a choice based on the size of the
-        // encodable list. If we only have 1 parameter, there is no sense in
-        // wrapping it in a structure
-        if(encodables.length() <= 1)
-            parameterFunctions = true;
-        else
-            structureFunctions = true;
-    }
+    types.makeLineSeparator();
 
     // Create the structure definition in the header.
     // This includes any sub-structures as well
-    header.write(getStructureDeclaration(structureFunctions));
+    types.write(getStructureDeclaration(structureFunctions));
 
     // White space is good
+    types.makeLineSeparator();
     header.makeLineSeparator();
 
     // Include the helper files in the source, but only do this once
@@ -175,10 +288,28 @@ void ProtocolPacket::parse(const QDomElement& e)
         if(support.bitfield)
             source.writeIncludeDirective("bitfieldspecial.h");
 
-        source.writeIncludeDirective("fielddecode.h");
-        source.writeIncludeDirective("fieldencode.h");
-        source.writeIncludeDirective("scaleddecode.h");
-        source.writeIncludeDirective("scaledencode.h");
+        // With minimal helpers only the modules that are called are included, once the source is done
+        if(!support.minimalHelpers)
+        {
+            source.writeIncludeDirective("fielddecode.h");
+            source.writeIncludeDirective("fieldencode.h");
+            source.writeIncludeDirective("scaleddecode.h");
+            source.writeIncludeDirective("scaledencode.h");
+        }
+
+        // offsetof and memcpy, for the fields that are copied
+        if(support.nativeLayout)
+        {
+            source.writeIncludeDirective("stddef.h", QString(), true);
+            source.writeIncludeDirective("string.h", QString(), true);
+        }
+    }
+
+    // The interpreter of the packet table, and offsetof for the table
+    if(tableCodec)
+    {
+        source.writeIncludeDirective("tablecodec.h");
+        source.writeIncludeDirective("stddef.h", QString(), true);
     }
 
     // The functions that include structures which are children of this
@@ -192,6 +323,13 @@ void ProtocolPacket::parse(const QDomElement& e)
         {
             // The functions that encode and decode the packet from a structure.
             createStructurePacketFunctions();
+
+            if(support.bufferInterface)
+                createBufferFunctions(true);
+
+            // The functions that encode and decode only the fields that changed
+            if(deltaFunctions)
+                createDeltaFunctions();
         }
 
     }
@@ -200,23 +338,39 @@ void ProtocolPacket::parse(const QDomElement& e)
     {
         // The functions that encode and decode the packet from parameters
         createPacketFunctions();
+
+        if(support.bufferInterface)
+            createBufferFunctions(false);
     }
 
+    // The functions that read and write single fields in place
+    if(accessorFunctions)
+        createFieldAccessorFunctions();
+
+    // The function that decodes many packets for analysis
+    if(batchFunctions)
+        createBatchDecodeFunction();
+
     // Utility functions for ID, length, etc.
-    createUtilityFunctions(e);
+    createUtilityFunctions();
 
     // White space is good
     header.makeLineSeparator();
 
+    if(support.minimalHelpers)
+        source.writeHelperIncludeDirectives();
+
     // Write to disk
     header.flush();
     source.flush();
+    typesHeader.flush();
 
     // Make sure these are empty for next time around
     header.clear();
     source.clear();
+    typesHeader.clear();
 
-}// ProtocolPacket::parse
+}// ProtocolPacket::generate
 
 
 /*!
@@ -244,17 +398,9 @@ void ProtocolPacket::createSubStructureFunctions(void)
 /*!
  * Create utility functions for packet ID and lengths. The structure must
  * already have been parsed to give the lengths
- * \param e is the top level DOM element that represents the packet.
  */
-void ProtocolPacket::createUtilityFunctions(const QDomElement& e)
+void ProtocolPacket::createUtilityFunctions(void)
 {
-    id = e.attribute("ID");
-
-    // If no ID is supplied then use the packet name in upper case,
-    // assuming that the user will define it elsewhere
-    if(id.isEmpty())
-        id = name.toUpper();
-
     // The prototype for the packet ID
     header.makeLineSeparator();
     header.write("//! return the packet ID for the " + prefix + name + " packet\n");
@@ -282,10 +428,22 @@ void ProtocolPacket::createUtilityFunctions(const QDomElement& e)
     source.write(" */\n");
     source.write("int get" + prefix + name + "MinDataLength(void)\n");
     source.write("{\n");
-    if(encodedLength.minEncodedLength.isEmpty())
-        source.write("    return 0;\n");
-    else
-        source.write("    return " + encodedLength.minEncodedLength + ";\n");
+    source.write("    return " + ProtocolParser::getResolvedLength(encodedLength.minEncodedLength) + ";\n");
+    source.write("}\n");
+
+    // The prototype for the maximum packet length
+    header.makeLineSeparator();
+    header.write("//! return the maximum data length for the " + prefix + name + " packet\n");
+    header.write("int get" + prefix + name + "MaxDataLength(void);\n");
+
+    // And the source code
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\return the maximum data length in bytes for the " + prefix + name + " packet\n");
+    source.write(" */\n");
+    source.write("int get" + prefix + name + "MaxDataLength(void)\n");
+    source.write("{\n");
+    source.write("    return " + ProtocolParser::getResolvedLength(encodedLength.maxEncodedLength) + ";\n");
     source.write("}\n");
 
 }// ProtocolPacket::createUtilityFunctions
@@ -302,6 +460,14 @@ void ProtocolPacket::createStructurePacketFunctions(void)
 
         // For structures the prefix is already in the typeName
 
+        // Make the choice of codec visible to the user
+        if(tableCodec)
+        {
+            header.makeLineSeparator();
+            header.write("//! The structure functions of the " + prefix + name + " packet are interpreted from a table by tablecodec\n");
+            header.write("#define is" + prefix + name + "PacketTableCoded() 1\n");
+        }
+
         // The prototype for the packet encode function
         header.makeLineSeparator();
         header.write("//! " + getPacketEncodeBriefComment() + "\n");
@@ -310,6 +476,18 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         else
             header.write("void encode" + prefix + name + "PacketStructure(void* pkt);\n");
 
+        if(tableCodec)
+        {
+            source.makeLineSeparator();
+            source.write(getTableDeclaration());
+        }
+        else
+        {
+            // The layout checks of the fields that are copied
+            source.makeLineSeparator();
+            source.write(getNativeLayoutChecks(getNativeRuns(), isBigEndian));
+        }
+
         // The source function for the encode function
         source.makeLineSeparator();
         source.write("/*!\n");
@@ -332,27 +510,36 @@ void ProtocolPacket::createStructurePacketFunctions(void)
             source.write("{\n");
         }
 
-        source.write("    uint8_t* data = get" + protoName + "PacketData(pkt);\n");
-        source.write("    int byteindex = 0;\n");
-
-        if(bitfields)
-            source.write("    int bitcount = 0;\n");
-
-        if(needsIterator)
-            source.write("    int i = 0;\n");
+        if(tableCodec)
+        {
+            QString user = (numNonConstEncodes > 0) ? "user" : "0";
 
-        int bitcount = 0;
-        for(int i = 0; i < encodables.length(); i++)
+            source.write("    int size;\n");
+            source.write(getTraceString("ENCODE_BEGIN", "get" + prefix + name + "PacketID()"));
+            source.write("\n");
+            source.write("    size = encodeTableFields(&" + prefix + name + "PacketTable, " + user + ", get" + protoName + "PacketData(pkt));\n");
+            source.write("\n");
+            source.write("    // complete the process of creating the packet\n");
+            source.write("    finish" + protoName + "Packet(pkt, size, get" + prefix + name + "PacketID());\n");
+            source.write(getTraceString("ENCODE_END", "get" + prefix + name + "PacketID(), size"));
+            source.write("}\n");
+        }
+        else
         {
+            source.write("    uint8_t* data = get" + protoName + "PacketData(pkt);\n");
+            source.write("    int byteindex = 0;\n");
+            source.write(getBitfieldDeclarations());
+            if(needsIterator)
+                source.write("    int i = 0;\n");
+            source.write(getTraceString("ENCODE_BEGIN", "get" + prefix + name + "PacketID()"));
+            source.write(getEncodeBody(true));
             source.makeLineSeparator();
-            source.write(encodables[i]->getEncodeString(isBigEndian, &bitcount, true));
+            source.write("    // complete the process of creating the packet\n");
+            source.write("    finish" + protoName + "Packet(pkt, " + getEncodedSizeString() + ", get" + prefix + name + "PacketID());\n");
+            source.write(getTraceString("ENCODE_END", "get" + prefix + name + "PacketID(), get" + protoName + "PacketSize(pkt)"));
+            source.write("}\n");
         }
 
-        source.makeLineSeparator();
-        source.write("    // complete the process of creating the packet\n");
-        source.write("    finish" + protoName + "Packet(pkt, byteindex, get" + prefix + name + "PacketID());\n");
-        source.write("}\n");
-
         // The prototype for the packet decode function
         header.makeLineSeparator();
         header.write("//! " + getPacketDecodeBriefComment() + "\n");
@@ -372,70 +559,38 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         source.write("int decode" + prefix + name + "PacketStructure(const void* pkt, " + typeName + "* user)\n");
         source.write("{\n");
         source.write("    int numBytes;\n");
-        source.write("    int byteindex = 0;\n");
-        source.write("    const uint8_t* data;\n");
-        if(bitfields)
-            source.write("    int bitcount = 0;\n");
+        if(!tableCodec)
+        {
+            source.write("    int byteindex = 0;\n");
+            source.write("    const uint8_t* data;\n");
+            source.write(getBitfieldDeclarations());
 
-        if(needsIterator)
-            source.write("    int i = 0;\n");
+            if(needsIterator)
+                source.write("    int i = 0;\n");
+        }
+        source.write(getTraceString("DECODE_BEGIN", "get" + prefix + name + "PacketID()"));
         source.write("\n");
         source.write("    // Verify the packet identifier\n");
-        source.write("    if(get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
-        source.write("        return 0;\n");
+        source.write(getRejectString("get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID()", "get" + protoName + "PacketSize(pkt)", "ID"));
         source.write("\n");
         source.write("    // Verify the packet size\n");
         source.write("    numBytes = get" + protoName + "PacketSize(pkt);\n");
-        source.write("    if(numBytes < get" + prefix + name + "MinDataLength())\n");
-        source.write("        return 0;\n");
+        source.write(getRejectString("numBytes < get" + prefix + name + "MinDataLength()", "numBytes", "LENGTH"));
         source.write("\n");
-        source.write("    // The raw data from the packet\n");
-        source.write("    data = get" + protoName + "PacketDataConst(pkt);\n");
-        source.makeLineSeparator();
-        if(defaults)
-        {
-            source.write("    // this packet has default fields, make sure they are set\n");
-
-            for(int i = 0; i < encodables.size(); i++)
-                source.write(encodables[i]->getSetToDefaultsString(true));
-
-        }// if defaults are used in this packet
-
-        source.makeLineSeparator();
-
-        // Keep our own track of the bitcount so we know what to do when we close the bitfield
-        bitcount = 0;
-        int i;
-        for(i = 0; i < encodables.length(); i++)
-        {
-            source.makeLineSeparator();
-
-            // Encode just the nondefaults here
-            if(encodables[i]->isDefault())
-                break;
-
-            source.write(encodables[i]->getDecodeString(isBigEndian, &bitcount, true, true));
-        }
-
-        // Before we write out the decodes for default fields we need to check
-        // packet size in the event that we were using variable length arrays
-        // or dependent fields
-        if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
+        if(tableCodec)
         {
-            source.makeLineSeparator();
-            source.write("    // Used variable length arrays or dependent fields, check actual length\n");
-            source.write("    if(numBytes < byteindex)\n");
-            source.write("        return 0;\n");
+            source.write("    // The codec checks the length of each field as it decodes\n");
+            source.write(getRejectString("decodeTableFields(&" + prefix + name + "PacketTable, user, get" + protoName + "PacketDataConst(pkt), numBytes) == 0", "numBytes", "LENGTH"));
         }
-
-        // Now finish the fields (if any defaults)
-        for(; i < encodables.length(); i++)
+        else
         {
+            source.write("    // The raw data from the packet\n");
+            source.write("    data = get" + protoName + "PacketDataConst(pkt);\n");
             source.makeLineSeparator();
-            source.write(encodables[i]->getDecodeString(isBigEndian, &bitcount, true, true));
+            source.write(getDecodePaths(true, true));
         }
-
         source.makeLineSeparator();
+        source.write(getTraceString("DECODE_END", "get" + prefix + name + "PacketID(), numBytes"));
         source.write("    return 1;\n");
         source.write("}\n");
     }
@@ -450,8 +605,11 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         source.write(" */\n");
         source.write("void encode" + prefix + name + "PacketStructure(void* pkt)\n");
         source.write("{\n");
+        source.write(getTraceString("ENCODE_BEGIN", "get" + prefix + name + "PacketID()"));
+        source.write("\n");
         source.write("    // create a zero length packet\n");
         source.write("    finish" + protoName + "Packet(pkt, 0, get" + prefix + name + "PacketID());\n");
+        source.write(getTraceString("ENCODE_END", "get" + prefix + name + "PacketID(), 0"));
         source.write("}\n");
 
         source.write("\n");
@@ -464,10 +622,12 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         source.write(" */\n");
         source.write("int decode" + prefix + name + "PacketStructure(const void* pkt)\n");
         source.write("{\n");
-        source.write("    if(get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
-        source.write("        return 0;\n");
-        source.write("    else\n");
-        source.write("        return 1;\n");
+        source.write(getTraceString("DECODE_BEGIN", "get" + prefix + name + "PacketID()"));
+        source.write("\n");
+        source.write(getRejectString("get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID()", "get" + protoName + "PacketSize(pkt)", "ID"));
+        source.write("\n");
+        source.write(getTraceString("DECODE_END", "get" + prefix + name + "PacketID(), 0"));
+        source.write("    return 1;\n");
         source.write("}\n");
     }
 
@@ -505,24 +665,15 @@ void ProtocolPacket::createPacketFunctions(void)
         source.write("{\n");
         source.write("    uint8_t* data = get"+ protoName + "PacketData(pkt);\n");
         source.write("    int byteindex = 0;\n");
-
-        if(bitfields)
-            source.write("    int bitcount = 0;\n");
-
+        source.write(getBitfieldDeclarations());
         if(needsIterator)
             source.write("    int i = 0;\n");
-
-        // Keep our own track of the bitcount so we know what to do when we close the bitfield
-        int bitcount = 0;
-        for(i = 0; i < encodables.length(); i++)
-        {
-            source.makeLineSeparator();
-            source.write(encodables[i]->getEncodeString(isBigEndian, &bitcount, false));
-        }
-
+        source.write(getTraceString("ENCODE_BEGIN", "get" + prefix + name + "PacketID()"));
+        source.write(getEncodeBody(false));
         source.makeLineSeparator();
         source.write("    // complete the process of creating the packet\n");
-        source.write("    finish" + protoName + "Packet(pkt, byteindex, get" + prefix + name + "PacketID());\n");
+        source.write("    finish" + protoName + "Packet(pkt, " + getEncodedSizeString() + ", get" + prefix + name + "PacketID());\n");
+        source.write(getTraceString("ENCODE_END", "get" + prefix + name + "PacketID(), get" + protoName + "PacketSize(pkt)"));
         source.write("}\n");
 
         // Now the decode function
@@ -538,61 +689,21 @@ void ProtocolPacket::createPacketFunctions(void)
         source.write(" */\n");
         source.write(getPacketDecodeSignature() + "\n");
         source.write("{\n");
-        if(bitfields)
-            source.write("    int bitcount = 0;\n");
+        source.write(getBitfieldDeclarations());
         if(needsIterator)
             source.write("    int i = 0;\n");
         source.write("    int byteindex = 0;\n");
         source.write("    const uint8_t* data = get" + protoName + "PacketDataConst(pkt);\n");
         source.write("    int numBytes = get" + protoName + "PacketSize(pkt);\n");
+        source.write(getTraceString("DECODE_BEGIN", "get" + prefix + name + "PacketID()"));
         source.write("\n");
-        source.write("    if(get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
-        source.write("        return 0;\n");
+        source.write(getRejectString("get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID()", "numBytes", "ID"));
         source.write("\n");
-        source.write("    if(numBytes < get" + prefix + name + "MinDataLength())\n");
-        source.write("        return 0;\n");
-        if(defaults)
-        {
-            source.write("\n");
-            source.write("    // this packet has default fields, make sure they are set\n");
-
-            for(int i = 0; i < encodables.size(); i++)
-                source.write(encodables[i]->getSetToDefaultsString(false));
-
-        }// if defaults are used in this packet
-
-        // Keep our own track of the bitcount so we know what to do when we close the bitfield
-        bitcount = 0;
-        for(i = 0; i < encodables.length(); i++)
-        {
-            source.makeLineSeparator();
-
-            // Encode just the nondefaults here
-            if(encodables[i]->isDefault())
-                break;
-
-            source.write(encodables[i]->getDecodeString(isBigEndian, &bitcount, false, true));
-        }
-
-        // Before we write out the decodes for default fields we need to check
-        // packet size in the event that we were using variable length arrays
-        // or dependent fields
-        if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
-        {
-            source.makeLineSeparator();
-            source.write("    // Used variable length arrays or dependent fields, check actual length\n");
-            source.write("    if(numBytes < byteindex)\n");
-            source.write("        return 0;\n");
-        }
-
-        // Now finish the fields (if any defaults)
-        for(; i < encodables.length(); i++)
-        {
-            source.makeLineSeparator();
-            source.write(encodables[i]->getDecodeString(isBigEndian, &bitcount, false, true));
-        }
-
+        source.write(getRejectString("numBytes < get" + prefix + name + "MinDataLength()", "numBytes", "LENGTH"));
+        source.makeLineSeparator();
+        source.write(getDecodePaths(false, true));
         source.makeLineSeparator();
+        source.write(getTraceString("DECODE_END", "get" + prefix + name + "PacketID(), numBytes"));
         source.write("    return 1;\n");
         source.write("}\n");
     }
@@ -607,8 +718,11 @@ void ProtocolPacket::createPacketFunctions(void)
         source.write(" */\n");
         source.write(getPacketEncodeSignature() + "\n");
         source.write("{\n");
+        source.write(getTraceString("ENCODE_BEGIN", "get" + prefix + name + "PacketID()"));
+        source.write("\n");
         source.write("    // create a zero length packet\n");
         source.write("    finish" + protoName + "Packet(pkt, 0, get" + prefix + name + "PacketID());\n");
+        source.write(getTraceString("ENCODE_END", "get" + prefix + name + "PacketID(), 0"));
         source.write("}\n");
 
         source.write("\n");
@@ -621,10 +735,12 @@ void ProtocolPacket::createPacketFunctions(void)
         source.write(" */\n");
         source.write(getPacketDecodeSignature() + "\n");
         source.write("{\n");
-        source.write("    if(get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
-        source.write("        return 0;\n");
-        source.write("    else\n");
-        source.write("        return 1;\n");
+        source.write(getTraceString("DECODE_BEGIN", "get" + prefix + name + "PacketID()"));
+        source.write("\n");
+        source.write(getRejectString("get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketID()", "get" + protoName + "PacketSize(pkt)", "ID"));
+        source.write("\n");
+        source.write(getTraceString("DECODE_END", "get" + prefix + name + "PacketID(), 0"));
+        source.write("    return 1;\n");
         source.write("}\n");
     }
 
@@ -632,48 +748,226 @@ void ProtocolPacket::createPacketFunctions(void)
 
 
 /*!
- * \return The signature of the packet encode function, without semicolon or comments or line feed
+ * Create the functions that encode and decode the packet data directly in a
+ * caller supplied buffer, rather than in a packet object, and the function
+ * that appends the packet to a batch of packets in a buffer.
+ * \param isStructure should be true to create the structure interface,
+ *        else the parameter interface is created.
  */
-QString ProtocolPacket::getPacketEncodeSignature(void) const
+void ProtocolPacket::createBufferFunctions(bool isStructure)
 {
-    if(encodables.length() > 0)
+    if(getNumberOfEncodes() <= 0)
+        return;
+
+    QString functionName = prefix + name + "Packet";
+    QString encodeParameters;
+    QString decodeParameters;
+    QString arguments;
+
+    if(isStructure)
     {
-        QString output = "void encode" + prefix + name + "Packet(void* pkt";
+        functionName += "Structure";
 
-        output += getDataEncodeParameterList() + ")";
+        if(getNumberOfNonConstEncodes() > 0)
+        {
+            encodeParameters = ", const " + typeName + "* user";
+            arguments = ", user";
+        }
 
-        return output;
+        decodeParameters = ", " + typeName + "* user";
     }
     else
-        return QString("void encode" + prefix + name + "Packet(void* pkt)");
-}
-
-
-/*!
- * \return The signature of the packet decode function, without semicolon or comments or line feed
- */
-QString ProtocolPacket::getPacketDecodeSignature(void) const
-{
-    if(encodables.length() > 0)
     {
-        QString output = "int decode" + prefix + name + "Packet(const void* pkt";
-
-        output += getDataDecodeParameterList() + ")";
+        encodeParameters = getDataEncodeParameterList();
+        decodeParameters = getDataDecodeParameterList();
 
-        return output;
+        for(int i = 0; i < encodables.length(); i++)
+        {
+            if(!encodables.at(i)->getEncodeSignature().isEmpty())
+                arguments += ", " + encodables.at(i)->name;
+        }
     }
-    else
-        return QString("int decode" + prefix + name + "Packet(const void* pkt)");
-}
 
+    QString maxLength = EncodedLength::collapseLengthString(encodedLength.maxEncodedLength, true);
+    QString encodeName = "encode" + functionName + "ToBuffer";
+    QString decodeName = "decode" + functionName + "FromBuffer";
+    QString appendName = "append" + functionName + "ToBatch";
 
-/*!
- * \return The brief comment of the packet encode function, without doxygen decorations or line feed
- */
-QString ProtocolPacket::getPacketEncodeBriefComment(void) const
-{
-    return QString("Create the " + prefix + name + " packet");
-}
+    QString endian;
+    if(isBigEndian)
+        endian = "Be";
+    else
+        endian = "Le";
+
+    header.makeLineSeparator();
+    header.write("//! Encode the " + prefix + name + " packet data into a buffer\n");
+    header.write("int " + encodeName + "(uint8_t* buf, int capacity, int offset" + encodeParameters + ");\n");
+
+    header.makeLineSeparator();
+    header.write("//! Decode the " + prefix + name + " packet data from a buffer\n");
+    header.write("int " + decodeName + "(const uint8_t* buf, int numBytes" + decodeParameters + ");\n");
+
+    header.makeLineSeparator();
+    header.write("//! Append the " + prefix + name + " packet to a batch of packets in a buffer\n");
+    header.write("int " + appendName + "(uint8_t* buf, int capacity, int offset" + encodeParameters + ");\n");
+
+    // The encode function
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Encode the " + prefix + name + " packet data into a buffer\n");
+    source.write(" *\n");
+    source.write(" * Only the packet data are encoded, the caller is responsible for any header\n");
+    source.write(" * that identifies the packet. The buffer must have room for the largest\n");
+    source.write(" * possible encoding of the data, which is " + maxLength + " bytes.\n");
+    source.write(" * \\param buf receives the encoded data\n");
+    source.write(" * \\param capacity is the number of bytes in buf\n");
+    source.write(" * \\param offset is the location in buf of the first byte of the data\n");
+    if(isStructure)
+    {
+        if(getNumberOfNonConstEncodes() > 0)
+            source.write(" * \\param user points to the user data that will be encoded in buf\n");
+    }
+    else
+    {
+        for(int i = 0; i < encodables.length(); i++)
+            source.write(encodables.at(i)->getEncodeParameterComment());
+    }
+    source.write(" * \\return the number of bytes encoded, or -1 if the data do not fit in buf\n");
+    source.write(" */\n");
+    source.write("int " + encodeName + "(uint8_t* buf, int capacity, int offset" + encodeParameters + ")\n");
+    source.write("{\n");
+    source.write("    uint8_t* data = buf + offset;\n");
+    source.write("    int byteindex = 0;\n");
+    source.write(getBitfieldDeclarations());
+    if(needsIterator)
+        source.write("    int i = 0;\n");
+    source.write("\n");
+    source.write("    if((offset < 0) || (capacity - offset < " + maxLength + "))\n");
+    source.write("        return -1;\n");
+    source.write(getEncodeBody(isStructure));
+    source.makeLineSeparator();
+    source.write("    return " + getEncodedSizeString() + ";\n");
+    source.write("}\n");
+
+    // The decode function
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Decode the " + prefix + name + " packet data from a buffer\n");
+    source.write(" *\n");
+    source.write(" * The packet identifier is not checked, since it is not part of the data.\n");
+    source.write(" * \\param buf is the encoded packet data\n");
+    source.write(" * \\param numBytes is the number of bytes of data in buf\n");
+    if(isStructure)
+        source.write(" * \\param user receives the data decoded from buf\n");
+    else
+    {
+        for(int i = 0; i < encodables.length(); i++)
+            source.write(encodables.at(i)->getDecodeParameterComment());
+    }
+    source.write(" * \\return 0 is returned if the data are too short, else 1\n");
+    source.write(" */\n");
+    source.write("int " + decodeName + "(const uint8_t* buf, int numBytes" + decodeParameters + ")\n");
+    source.write("{\n");
+    source.write("    int byteindex = 0;\n");
+    source.write("    const uint8_t* data = buf;\n");
+    source.write(getBitfieldDeclarations());
+    if(needsIterator)
+        source.write("    int i = 0;\n");
+    source.write("\n");
+    source.write("    if(numBytes < get" + prefix + name + "MinDataLength())\n");
+    source.write("        return 0;\n");
+    source.makeLineSeparator();
+    source.write(getDecodePaths(isStructure));
+    source.makeLineSeparator();
+    source.write("    return 1;\n");
+    source.write("}\n");
+
+    // The batch function
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Append the " + prefix + name + " packet to a batch of packets in a buffer\n");
+    source.write(" *\n");
+    source.write(" * The packet is framed by its 4 byte identifier and 2 byte data length, which\n");
+    source.write(" * are followed by the packet data. Packets are appended back to back, and can\n");
+    source.write(" * be separated by the receiver using next" + protoName + "BatchPacket().\n");
+    source.write(" * \\param buf receives the framed packet\n");
+    source.write(" * \\param capacity is the number of bytes in buf\n");
+    source.write(" * \\param offset is the location in buf of the end of the batch so far\n");
+    if(isStructure)
+    {
+        if(getNumberOfNonConstEncodes() > 0)
+            source.write(" * \\param user points to the user data that will be encoded in buf\n");
+    }
+    else
+    {
+        for(int i = 0; i < encodables.length(); i++)
+            source.write(encodables.at(i)->getEncodeParameterComment());
+    }
+    source.write(" * \\return the location in buf of the end of the batch including this\n");
+    source.write(" *         packet, or -1 if the packet does not fit in buf\n");
+    source.write(" */\n");
+    source.write("int " + appendName + "(uint8_t* buf, int capacity, int offset" + encodeParameters + ")\n");
+    source.write("{\n");
+    source.write("    int byteindex = offset;\n");
+    source.write("    int length;\n");
+    source.write("\n");
+    source.write("    // The data follow the packet identifier and the data length\n");
+    source.write("    length = " + encodeName + "(buf, capacity, offset + 6" + arguments + ");\n");
+    source.write("    if((length < 0) || (length > 65535))\n");
+    source.write("        return -1;\n");
+    source.write("\n");
+    source.write("    uint32To" + endian + "Bytes(get" + prefix + name + "PacketID(), buf, &byteindex);\n");
+    source.write("    uint16To" + endian + "Bytes((uint16_t)length, buf, &byteindex);\n");
+    source.write("\n");
+    source.write("    return byteindex + length;\n");
+    source.write("}\n");
+
+}// ProtocolPacket::createBufferFunctions
+
+
+/*!
+ * \return The signature of the packet encode function, without semicolon or comments or line feed
+ */
+QString ProtocolPacket::getPacketEncodeSignature(void) const
+{
+    if(encodables.length() > 0)
+    {
+        QString output = "void encode" + prefix + name + "Packet(void* pkt";
+
+        output += getDataEncodeParameterList() + ")";
+
+        return output;
+    }
+    else
+        return QString("void encode" + prefix + name + "Packet(void* pkt)");
+}
+
+
+/*!
+ * \return The signature of the packet decode function, without semicolon or comments or line feed
+ */
+QString ProtocolPacket::getPacketDecodeSignature(void) const
+{
+    if(encodables.length() > 0)
+    {
+        QString output = "int decode" + prefix + name + "Packet(const void* pkt";
+
+        output += getDataDecodeParameterList() + ")";
+
+        return output;
+    }
+    else
+        return QString("int decode" + prefix + name + "Packet(const void* pkt)");
+}
+
+
+/*!
+ * \return The brief comment of the packet encode function, without doxygen decorations or line feed
+ */
+QString ProtocolPacket::getPacketEncodeBriefComment(void) const
+{
+    return QString("Create the " + prefix + name + " packet");
+}
 
 
 /*!
@@ -731,6 +1025,852 @@ QString ProtocolPacket::getDataDecodeBriefComment(void) const
 }
 
 
+/*!
+ * Determine if this packet is coded using constant byte offsets. This is
+ * only possible if the minimum and maximum lengths are the same, i.e. the
+ * packet has no variable length arrays, dependent fields, variable length
+ * strings, or default fields.
+ * \return true if every encodable is placed at a constant byte offset
+ */
+bool ProtocolPacket::usesFixedOffsets(void) const
+{
+    if(!support.fixedOffsets || encodedLength.minEncodedLength.isEmpty())
+        return false;
+
+    return (encodedLength.minEncodedLength.compare(encodedLength.maxEncodedLength) == 0);
+}
+
+
+/*!
+ * Get the line of source that sets the byte index to the constant offset of
+ * an encodable. Each encodable starts from its own offset, rather than from
+ * where the previous encodable finished, which breaks the serial dependency
+ * on the byte index.
+ * \param index is the location of the encodable in the list of encodables
+ * \return the line of source, which will be empty if this packet does not
+ *         use fixed offsets, or if the encodable continues a bitfield group
+ */
+QString ProtocolPacket::getFixedOffsetString(int index) const
+{
+    if(!usesFixedOffsets())
+        return QString();
+
+    const ProtocolOperation* operation = operations.find(index);
+
+    // Bitfields in the middle of a group do not start on a byte boundary
+    if((operation == NULL) || (operation->index != index) || !operation->constantOffset)
+        return QString();
+
+    // The byte index is already zero at the start of the function
+    if(operation->offset.isZero())
+        return QString();
+
+    return "    byteindex = " + operation->offset.toString() + ";\n";
+
+}// ProtocolPacket::getFixedOffsetString
+
+
+/*!
+ * Get the constant byte offset of an encodable in the packet data. The
+ * offset is only constant if every previous encodable has a fixed length.
+ * \param index is the location of the encodable in the list of encodables
+ * \return the offset, which will be empty if the offset is not constant
+ */
+QString ProtocolPacket::getConstantOffset(int index) const
+{
+    const ProtocolOperation* operation = operations.find(index);
+
+    if((operation == NULL) || !operation->constantOffset)
+        return QString();
+
+    return operation->offset.toString(true);
+
+}// ProtocolPacket::getConstantOffset
+
+
+/*!
+ * Get the body of a packet encode function, which follows the declarations
+ * of "data", "byteindex", the bitfield scratch variables, and the iterator.
+ * \param isStructureMember should be true if the fields are members of a
+ *        user structure, else they are function parameters
+ * \return the source code of the field encodings
+ */
+QString ProtocolPacket::getEncodeBody(bool isStructureMember) const
+{
+    QString output;
+
+    // Fields can only be copied from a user structure
+    QList<int> runs;
+    if(isStructureMember)
+        runs = getNativeRuns();
+
+    // Keep our own track of the bitcount so we know what to do when we close the bitfield
+    int bitcount = 0;
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        ProtocolFile::makeLineSeparator(output);
+
+        if(isStructureMember && (runs.at(i) > i))
+        {
+            output += getNativeEncodeString(i, runs.at(i), isBigEndian, &bitcount);
+            i = runs.at(i) - 1;
+            continue;
+        }
+
+        output += getFixedOffsetString(i);
+        output += encodables[i]->getEncodeString(isBigEndian, &bitcount, isStructureMember);
+    }
+
+    return output;
+
+}// ProtocolPacket::getEncodeBody
+
+
+/*!
+ * Get the expression for the number of bytes encoded at the end of a packet
+ * encode function.
+ * \return the constant size for fixed offset packets, else "byteindex"
+ */
+QString ProtocolPacket::getEncodedSizeString(void) const
+{
+    if(usesFixedOffsets())
+        return encodedLength.minEncodedLength;
+    else
+        return QString("byteindex");
+}
+
+
+/*!
+ * Get the body of a packet decode function. This follows the declarations
+ * and the minimum length check, and uses "data", "byteindex", and
+ * "numBytes". The body returns 0 if the data are too short.
+ * \param isStructureMember should be true if the fields are members of a
+ *        user structure, else they are function parameters
+ * \param checkLengths should be true to verify the data length before each
+ *        variable length field, rather than relying on the caller to verify
+ *        that there is enough data for the largest packet
+ * \param traced should be true for the body to invoke the trace hooks when
+ *        it rejects data that are too short, or ends before the defaults
+ * \return the source code of the field decodings, without the final return
+ */
+QString ProtocolPacket::getDecodeBody(bool isStructureMember, bool checkLengths, bool traced) const
+{
+    QString output;
+    QString rejectHook;
+    QString endHook;
+
+    // The hooks go under the if statements of the returns, so they lose the indent of a trace line
+    if(traced)
+    {
+        rejectHook = getRejectHook("numBytes", "LENGTH");
+        endHook = getTraceString("DECODE_END", "get" + prefix + name + "PacketID(), numBytes").trimmed();
+    }
+
+    if(defaults)
+    {
+        output += "    // this packet has default fields, make sure they are set\n";
+
+        for(int i = 0; i < encodables.size(); i++)
+            output += encodables[i]->getSetToDefaultsString(isStructureMember);
+
+    }// if defaults are used in this packet
+
+    // Fields can only be copied to a user structure
+    QList<int> runs;
+    if(isStructureMember)
+        runs = getNativeRuns();
+
+    // Keep our own track of the bitcount so we know what to do when we close the bitfield
+    int bitcount = 0;
+    int i;
+    for(i = 0; i < encodables.length(); i++)
+    {
+        ProtocolFile::makeLineSeparator(output);
+
+        // Encode just the nondefaults here
+        if(encodables[i]->isDefault())
+            break;
+
+        // Native runs have a fixed length, and need no length checks
+        if(isStructureMember && (runs.at(i) > i))
+        {
+            output += getNativeDecodeString(i, runs.at(i), isBigEndian, &bitcount, true);
+            i = runs.at(i) - 1;
+            continue;
+        }
+
+        if(checkLengths)
+        {
+            const ProtocolOperation* operation = operations.find(i);
+
+            // The check includes the minimum length of everything after this encodable
+            if((operation != NULL) && (operation->index == i) && operation->checkLength)
+                output += encodables[i]->getDecodeLengthCheck(isStructureMember, operation->restLength.toString(), rejectHook);
+        }
+
+        output += getFixedOffsetString(i);
+        output += encodables[i]->getDecodeString(isBigEndian, &bitcount, isStructureMember, true, endHook);
+    }
+
+    // Before we write out the decodes for default fields we need to check
+    // packet size in the event that we were using variable length arrays
+    // or dependent fields
+    if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
+    {
+        ProtocolFile::makeLineSeparator(output);
+        output += "    // Used variable length arrays or dependent fields, check actual length\n";
+        output += "    if(numBytes < byteindex)\n";
+        output += getDecodeReturnString("    ", "0", rejectHook);
+    }
+
+    // Now finish the fields (if any defaults)
+    for(; i < encodables.length(); i++)
+    {
+        ProtocolFile::makeLineSeparator(output);
+        output += encodables[i]->getDecodeString(isBigEndian, &bitcount, isStructureMember, true, endHook);
+    }
+
+    return output;
+
+}// ProtocolPacket::getDecodeBody
+
+
+/*!
+ * Get the body of a packet decode function with two paths. Data that are
+ * at least as long as the largest packet are decoded without any checks
+ * beyond the minimum length check, otherwise the data length is verified
+ * before each variable length field. Packets whose length is fixed only
+ * need the minimum length check, and have a single path.
+ * \param isStructureMember should be true if the fields are members of a
+ *        user structure, else they are function parameters
+ * \param traced should be true for the early returns to invoke the trace hooks
+ * \return the source code of the field decodings, without the final return
+ */
+QString ProtocolPacket::getDecodePaths(bool isStructureMember, bool traced) const
+{
+    if(encodedLength.minEncodedLength == encodedLength.maxEncodedLength)
+        return getDecodeBody(isStructureMember, false, traced);
+
+    QString output;
+
+    output += "    if(numBytes >= get" + prefix + name + "MaxDataLength())\n";
+    output += "    {\n";
+    output += "        // Enough data for the largest packet, no more length checks are needed\n";
+    output += ProtocolFile::indentCode(getDecodeBody(isStructureMember, false, traced));
+    output += "    }\n";
+    output += "    else\n";
+    output += "    {\n";
+    output += "        // Short data, verify the length before each variable length field\n";
+    output += ProtocolFile::indentCode(getDecodeBody(isStructureMember, true, traced));
+    output += "    }\n";
+
+    return output;
+
+}// ProtocolPacket::getDecodePaths
+
+
+/*!
+ * Get the line of source that invokes one of the trace hooks of the protocol.
+ * The hooks are macros that expand to nothing unless the user defines them,
+ * so their arguments cost nothing when tracing is off.
+ * \param hook is the name of the hook, like "DECODE_END"
+ * \param arguments are the arguments of the hook
+ * \return the line of source, including line feed
+ */
+QString ProtocolPacket::getTraceString(const QString& hook, const QString& arguments) const
+{
+    return "    " + protoName.toUpper() + "_TRACE_" + hook + "(" + arguments + ");\n";
+}
+
+
+/*!
+ * Get the lines of source that reject a packet that fails a check, invoking
+ * the reject hook before returning 0
+ * \param condition is the condition that rejects the packet
+ * \param length is the length to pass to the hook
+ * \param reason is the reason to pass to the hook, "ID" or "LENGTH"
+ * \return the lines of source, including line feed
+ */
+QString ProtocolPacket::getRejectString(const QString& condition, const QString& length, const QString& reason) const
+{
+    QString output;
+
+    output += "    if(" + condition + ")\n";
+    output += getDecodeReturnString("    ", "0", getRejectHook(length, reason));
+
+    return output;
+
+}// ProtocolPacket::getRejectString
+
+
+/*!
+ * Get the invocation of the reject hook, without indent or line feed, so it
+ * can be placed under the if statement of any return that rejects a packet
+ * \param length is the length to pass to the hook
+ * \param reason is the reason to pass to the hook, "ID" or "LENGTH"
+ * \return the invocation of the hook
+ */
+QString ProtocolPacket::getRejectHook(const QString& length, const QString& reason) const
+{
+    return getTraceString("DECODE_REJECT", "get" + prefix + name + "PacketID(), " + length + ", " + protoName.toUpper() + "_TRACE_REJECT_" + reason).trimmed();
+}
+
+
+/*!
+ * Create the functions that read and write single fields in place in an
+ * encoded packet. Only fields at a constant offset are given accessors, so
+ * a field can be reached without coding any other part of the packet.
+ */
+void ProtocolPacket::createFieldAccessorFunctions(void)
+{
+    for(int index = 0; index < encodables.length(); index++)
+    {
+        const Encodable* field = encodables.at(index);
+
+        if(!field->supportsDirectAccess())
+            continue;
+
+        QString offset = getConstantOffset(index);
+        if(offset.isEmpty())
+            continue;
+
+        // The packet must be long enough to hold the whole field
+        EncodedLength end;
+        end.addToLength(offset);
+        end.addToLength(field->encodedLength);
+        QString required = EncodedLength::collapseLengthString(end.maxEncodedLength, true);
+
+        QString getName = "get" + prefix + name + "Packet_" + field->name;
+        QString setName = "set" + prefix + name + "Packet_" + field->name;
+
+        header.makeLineSeparator();
+        header.write("//! Decode the " + field->name + " field of the " + prefix + name + " packet in place\n");
+        header.write("int " + getName + "(const void* pkt" + field->getDecodeSignature() + ");\n");
+
+        header.makeLineSeparator();
+        header.write("//! Encode the " + field->name + " field of an existing " + prefix + name + " packet in place\n");
+        header.write("int " + setName + "(void* pkt" + field->getEncodeSignature() + ");\n");
+
+        int bitcount = 0;
+
+        source.makeLineSeparator();
+        source.write("/*!\n");
+        source.write(" * \\brief Decode the " + field->name + " field of the " + prefix + name + " packet in place\n");
+        source.write(" *\n");
+        source.write(" * Only this field is decoded, directly from its location in the packet data.\n");
+        source.write(" * \\param pkt points to the packet being decoded by this function\n");
+        source.write(field->getDecodeParameterComment());
+        source.write(" * \\return 0 is returned if the packet ID or size is wrong, else 1\n");
+        source.write(" */\n");
+        source.write("int " + getName + "(const void* pkt" + field->getDecodeSignature() + ")\n");
+        source.write("{\n");
+        source.write("    int byteindex = " + offset + ";\n");
+        source.write("    const uint8_t* data = get" + protoName + "PacketDataConst(pkt);\n");
+        source.write("\n");
+        source.write("    if(get" + protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
+        source.write("        return 0;\n");
+        source.write("\n");
+        source.write("    if(get" + protoName + "PacketSize(pkt) < " + required + ")\n");
+        source.write("        return 0;\n");
+        source.write("\n");
+        source.write(field->getDecodeString(isBigEndian, &bitcount, false));
+        source.write("\n");
+        source.write("    return 1;\n");
+        source.write("}\n");
+
+        source.makeLineSeparator();
+        source.write("/*!\n");
+        source.write(" * \\brief Encode the " + field->name + " field of an existing " + prefix + name + " packet in place\n");
+        source.write(" *\n");
+        source.write(" * Only this field is encoded, the rest of the packet is not changed. If the\n");
+        source.write(" * packet carries a check value it must be updated by the caller.\n");
+        source.write(" * \\param pkt points to the packet being changed by this function\n");
+        source.write(field->getEncodeParameterComment());
+        source.write(" * \\return 0 is returned if the packet ID or size is wrong, else 1\n");
+        source.write(" */\n");
+        source.write("int " + setName + "(void* pkt" + field->getEncodeSignature() + ")\n");
+        source.write("{\n");
+        source.write("    int byteindex = " + offset + ";\n");
+        source.write("    uint8_t* data = get" + protoName + "PacketData(pkt);\n");
+        source.write("\n");
+        source.write("    if(get" + protoName + "PacketID(pkt) != get" + prefix + name + "PacketID())\n");
+        source.write("        return 0;\n");
+        source.write("\n");
+        source.write("    if(get" + protoName + "PacketSize(pkt) < " + required + ")\n");
+        source.write("        return 0;\n");
+        source.write("\n");
+        source.write(field->getEncodeString(isBigEndian, &bitcount, false));
+        source.write("\n");
+        source.write("    return 1;\n");
+        source.write("}\n");
+
+    }// for all encodables
+
+}// ProtocolPacket::createFieldAccessorFunctions
+
+
+/*!
+ * Get the operations that are sent in a delta packet. Each operation has one
+ * bit in the presence mask, so the fields of a bitfield group are sent
+ * together. Operations that code nothing the user sets, like constants or
+ * fields that are not in memory, are never sent.
+ * \return the list of operations, in encoded order
+ */
+QList<const ProtocolOperation*> ProtocolPacket::getDeltaOperations(void) const
+{
+    QList<const ProtocolOperation*> list;
+
+    for(int i = 0; i < operations.size(); i++)
+    {
+        const ProtocolOperation& operation = operations.at(i);
+
+        for(int j = operation.index; j < operation.index + operation.count; j++)
+        {
+            if(encodables.at(j)->isNotEncoded() || encodables.at(j)->isNotInMemory() || encodables.at(j)->isConstant())
+                continue;
+
+            list.append(&operation);
+            break;
+        }
+    }
+
+    return list;
+
+}// ProtocolPacket::getDeltaOperations
+
+
+/*!
+ * Get the maximum encoded length of the delta encoded form of this packet,
+ * which is the presence mask followed by every field.
+ * \return the maximum length in bytes, which may be an expression
+ */
+QString ProtocolPacket::getDeltaMaxEncodedLength(void) const
+{
+    EncodedLength length;
+
+    length.addToLength(QString().setNum(getDeltaMaskBytes()));
+    length.addToLength(encodedLength.maxEncodedLength);
+
+    return length.maxEncodedLength;
+
+}// ProtocolPacket::getDeltaMaxEncodedLength
+
+
+/*!
+ * Get the expression that compares the user data of an operation against
+ * the reference. Single values are compared directly, anything else is
+ * compared byte for byte.
+ * \param operation is the operation to compare
+ * \return the C expression, which is true if the data have changed
+ */
+QString ProtocolPacket::getDeltaChangedString(const ProtocolOperation& operation) const
+{
+    QStringList changes;
+
+    for(int j = operation.index; j < operation.index + operation.count; j++)
+    {
+        const Encodable* encodable = encodables.at(j);
+
+        if(encodable->isNotEncoded() || encodable->isNotInMemory() || encodable->isConstant())
+            continue;
+
+        QString member = encodable->name;
+
+        if(encodable->isPrimitive() && !encodable->isArray())
+            changes.append("(user->" + member + " != reference->" + member + ")");
+        else
+            changes.append("(memcmp(&user->" + member + ", &reference->" + member + ", sizeof(user->" + member + ")) != 0)");
+    }
+
+    return changes.join(" || ");
+
+}// ProtocolPacket::getDeltaChangedString
+
+
+/*!
+ * Create the functions that encode and decode only the fields that changed
+ * since a reference structure. The data start with a presence mask, with
+ * one bit for each field, and only the fields whose bit is set follow. A
+ * keyframe sets every bit. The decode function applies the fields it finds
+ * to the structure it is given, which must hold the state of the last
+ * packet that was decoded.
+ */
+void ProtocolPacket::createDeltaFunctions(void)
+{
+    QList<const ProtocolOperation*> list = getDeltaOperations();
+
+    int maskBytes = getDeltaMaskBytes();
+    QString maskLength = QString().setNum(maskBytes);
+
+    // memcmp for the fields that are not single values
+    source.writeIncludeDirective("string.h", QString(), true);
+
+    // The prototype for the delta packet ID
+    header.makeLineSeparator();
+    header.write("//! return the packet ID for the delta encoded " + prefix + name + " packet\n");
+    header.write("uint32_t get" + prefix + name + "PacketDeltaID(void);\n");
+
+    // And the source code
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\return the packet ID for the delta encoded " + prefix + name + " packet\n");
+    source.write(" */\n");
+    source.write("uint32_t get" + prefix + name + "PacketDeltaID(void)\n");
+    source.write("{\n");
+    source.write("    return " + deltaId + ";\n");
+    source.write("}\n");
+
+    // The prototype for the delta encode function
+    header.makeLineSeparator();
+    header.write("//! Create the " + prefix + name + " packet with only the fields that changed since a reference\n");
+    header.write("void encode" + prefix + name + "PacketDelta(void* pkt, const " + typeName + "* user, const " + typeName + "* reference, int keyframe);\n");
+
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Create the " + prefix + name + " packet with only the fields that changed since a reference\n");
+    source.write(" *\n");
+    source.write(" * The packet data start with a " + maskLength + " byte presence mask, one bit for each\n");
+    source.write(" * field in encoded order, least significant bit first. Only the fields\n");
+    source.write(" * whose bit is set follow the mask. The packet has its own identifier,\n");
+    source.write(" * get" + prefix + name + "PacketDeltaID(), so it is not mistaken for a full packet.\n");
+    source.write(" * \\param pkt points to the packet which will be created by this function\n");
+    source.write(" * \\param user points to the user data that will be encoded in pkt\n");
+    source.write(" * \\param reference points to the data the receiver already has, which is\n");
+    source.write(" *        usually the data of the last packet that was sent\n");
+    source.write(" * \\param keyframe should be non-zero to encode every field, which the\n");
+    source.write(" *        receiver needs first and from time to time afterwards\n");
+    source.write(" */\n");
+    source.write("void encode" + prefix + name + "PacketDelta(void* pkt, const " + typeName + "* user, const " + typeName + "* reference, int keyframe)\n");
+    source.write("{\n");
+    source.write("    uint8_t* data = get" + protoName + "PacketData(pkt);\n");
+    source.write("    int byteindex = " + maskLength + ";\n");
+    source.write(getBitfieldDeclarations());
+    if(needsIterator)
+        source.write("    int i = 0;\n");
+    source.write("\n");
+    source.write("    // The presence mask, filled in as the fields are encoded\n");
+    for(int m = 0; m < maskBytes; m++)
+        source.write("    data[" + QString().setNum(m) + "] = 0;\n");
+
+    int bitcount = 0;
+    for(int k = 0; k < list.size(); k++)
+    {
+        const ProtocolOperation& operation = *list.at(k);
+        QString body;
+
+        body += "    data[" + QString().setNum(k/8) + "] |= 0x" + QString("%1").arg(1 << (k % 8), 2, 16, QChar('0')) + ";\n";
+        for(int j = operation.index; j < operation.index + operation.count; j++)
+            body += encodables.at(j)->getEncodeString(isBigEndian, &bitcount, true);
+
+        source.write("\n");
+        source.write("    if(keyframe || " + getDeltaChangedString(operation) + ")\n");
+        source.write("    {\n");
+        source.write(ProtocolFile::indentCode(body));
+        source.write("    }\n");
+    }
+
+    source.makeLineSeparator();
+    source.write("    // complete the process of creating the packet\n");
+    source.write("    finish" + protoName + "Packet(pkt, byteindex, get" + prefix + name + "PacketDeltaID());\n");
+    source.write("}\n");
+
+    // The prototype for the delta decode function
+    header.makeLineSeparator();
+    header.write("//! Apply the fields of a " + prefix + name + " packet created by the delta encode function\n");
+    header.write("int decode" + prefix + name + "PacketDelta(const void* pkt, " + typeName + "* user);\n");
+
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Apply the fields of a " + prefix + name + " packet created by the delta encode function\n");
+    source.write(" *\n");
+    source.write(" * Fields whose bit is clear in the presence mask are not changed. If the\n");
+    source.write(" * data are too short the fields before the problem have already been\n");
+    source.write(" * applied, so the caller should wait for the next keyframe.\n");
+    source.write(" * \\param pkt points to the packet being decoded by this function\n");
+    source.write(" * \\param user holds the data of the last packet that was decoded, and\n");
+    source.write(" *        receives the fields decoded from this packet\n");
+    source.write(" * \\return 0 is returned if the packet ID or size is wrong, else 1\n");
+    source.write(" */\n");
+    source.write("int decode" + prefix + name + "PacketDelta(const void* pkt, " + typeName + "* user)\n");
+    source.write("{\n");
+    source.write("    int numBytes;\n");
+    source.write("    int byteindex = " + maskLength + ";\n");
+    source.write("    const uint8_t* data;\n");
+    source.write(getBitfieldDeclarations());
+    if(needsIterator)
+        source.write("    int i = 0;\n");
+    source.write("\n");
+    source.write("    // Verify the packet identifier\n");
+    source.write("    if(get"+ protoName + "PacketID(pkt) != get" + prefix + name + "PacketDeltaID())\n");
+    source.write("        return 0;\n");
+    source.write("\n");
+    source.write("    // Verify the packet size, which must at least hold the presence mask\n");
+    source.write("    numBytes = get" + protoName + "PacketSize(pkt);\n");
+    source.write("    if(numBytes < " + maskLength + ")\n");
+    source.write("        return 0;\n");
+    source.write("\n");
+    source.write("    // The raw data from the packet\n");
+    source.write("    data = get" + protoName + "PacketDataConst(pkt);\n");
+
+    bitcount = 0;
+    for(int k = 0; k < list.size(); k++)
+    {
+        const ProtocolOperation& operation = *list.at(k);
+        QString body;
+
+        // Any field may be missing, so every field checks its own length
+        if(operation.minLength == operation.maxLength)
+        {
+            body += "    if(byteindex + " + operation.maxLength.toString() + " > numBytes)\n";
+            body += "        return 0;\n";
+        }
+        else
+        {
+            for(int j = operation.index; j < operation.index + operation.count; j++)
+                body += encodables.at(j)->getDecodeLengthCheck(true, QString());
+        }
+
+        for(int j = operation.index; j < operation.index + operation.count; j++)
+            body += encodables.at(j)->getDecodeString(isBigEndian, &bitcount, true);
+
+        source.write("\n");
+        source.write("    if(data[" + QString().setNum(k/8) + "] & 0x" + QString("%1").arg(1 << (k % 8), 2, 16, QChar('0')) + ")\n");
+        source.write("    {\n");
+        source.write(ProtocolFile::indentCode(body));
+        source.write("    }\n");
+    }
+
+    source.makeLineSeparator();
+    source.write("    return 1;\n");
+    source.write("}\n");
+
+}// ProtocolPacket::createDeltaFunctions
+
+
+/*!
+ * Create the function that decodes many packets of this type into arrays,
+ * one for each field, rather than into an array of structures. The packets
+ * are all validated first, and then each field is decoded from every packet
+ * in its own loop, so each loop only touches one output array. Only fields
+ * that could have accessors are decoded, as they are at a constant offset,
+ * and default fields are set to their default in packets too short for them.
+ * The fields that are left out are reported as notices of the packet.
+ */
+void ProtocolPacket::createBatchDecodeFunction(void)
+{
+    QString soaName = prefix + name + "_soa_t";
+    QList<int> columns;
+    QStringList omitted;
+
+    for(int index = 0; index < encodables.length(); index++)
+    {
+        const Encodable* field = encodables.at(index);
+
+        if(field->isNotEncoded() || field->isNotInMemory())
+            continue;
+
+        if(field->supportsDirectAccess() && !getConstantOffset(index).isEmpty())
+            columns.append(index);
+        else if(!field->isConstant())
+        {
+            omitted.append(field->name);
+            notices.append(name + ": " + field->name + " is not at a constant offset, or is not a single value, and is left out of the batch decode");
+        }
+    }
+
+    if(columns.isEmpty())
+    {
+        notices.append(name + ": no fields can be batch decoded");
+        return;
+    }
+
+    header.makeLineSeparator();
+    if(omitted.isEmpty())
+        header.write("//! The fields of many " + prefix + name + " packets, one array for each field\n");
+    else
+    {
+        header.write("/*!\n");
+        header.write(" * The fields of many " + prefix + name + " packets, one array for each field\n");
+        header.write(" * that is at a constant offset in the packet. These fields are not in the\n");
+        header.write(" * batch decode, and must be decoded one packet at a time: " + omitted.join(", ") + "\n");
+        header.write(" */\n");
+    }
+    header.write("typedef struct\n");
+    header.write("{\n");
+    for(int i = 0; i < columns.size(); i++)
+    {
+        const Encodable* field = encodables.at(columns.at(i));
+
+        if(field->comment.isEmpty())
+            header.write("    " + field->typeName + "* " + field->name + ";\n");
+        else
+            header.write("    " + field->typeName + "* " + field->name + "; //!< " + field->comment + "\n");
+    }
+    header.write("}" + soaName + ";\n");
+
+    header.makeLineSeparator();
+    header.write("//! Decode many " + prefix + name + " packets into arrays of each field\n");
+    header.write("int decode" + prefix + name + "PacketBatch(const void* const* pkts, int n, const " + soaName + "* out);\n");
+
+    source.makeLineSeparator();
+    source.write("/*!\n");
+    source.write(" * \\brief Decode many " + prefix + name + " packets into arrays of each field\n");
+    source.write(" *\n");
+    source.write(" * The packets are checked before any are decoded. Each field is then decoded\n");
+    source.write(" * from every packet in turn, into element i of its array for packet i.\n");
+    source.write(" * \\param pkts points to the array of n packets being decoded by this function\n");
+    source.write(" * \\param n is the number of packets\n");
+    source.write(" * \\param out holds the arrays that receive the fields, each of which must\n");
+    source.write(" *        have room for n elements. Fields whose array is null are not decoded.\n");
+    source.write(" * \\return the number of packets decoded. This is less than n if a packet has\n");
+    source.write(" *         the wrong ID or size, in which case the packets from that one on\n");
+    source.write(" *         are not decoded.\n");
+    source.write(" */\n");
+    source.write("int decode" + prefix + name + "PacketBatch(const void* const* pkts, int n, const " + soaName + "* out)\n");
+    source.write("{\n");
+    source.write("    int i;\n");
+    source.write("    int count;\n");
+    source.write("\n");
+    source.write("    // Verify every packet first, so the loops below have no checks\n");
+    source.write("    for(count = 0; count < n; count++)\n");
+    source.write("    {\n");
+    source.write("        if(get" + protoName + "PacketID(pkts[count]) != get" + prefix + name + "PacketID())\n");
+    source.write("            break;\n");
+    source.write("\n");
+    source.write("        if(get" + protoName + "PacketSize(pkts[count]) < get" + prefix + name + "MinDataLength())\n");
+    source.write("            break;\n");
+    source.write("    }\n");
+
+    for(int i = 0; i < columns.size(); i++)
+    {
+        const Encodable* field = encodables.at(columns.at(i));
+        QString offset = getConstantOffset(columns.at(i));
+        int bitcount = 0;
+
+        // The decode of a single field through a pointer, as for the accessors
+        QString decode = field->getDecodeString(isBigEndian, &bitcount, false);
+
+        // Only the minimum length was checked, a default field may not be in the packet
+        if(field->isDefault())
+        {
+            EncodedLength end;
+            end.addToLength(offset);
+            end.addToLength(field->encodedLength);
+
+            QString required = EncodedLength::collapseLengthString(end.maxEncodedLength, true);
+
+            decode = "    if(get" + protoName + "PacketSize(pkts[i]) < " + required + ")\n" +
+                     ProtocolFile::indentCode(field->getSetToDefaultsString(false)) +
+                     "    else\n" +
+                     "    {\n" +
+                     ProtocolFile::indentCode(decode) +
+                     "    }\n";
+        }
+
+        decode = ProtocolFile::indentCode(ProtocolFile::indentCode(decode));
+
+        source.write("\n");
+        source.write("    if(out->" + field->name + ")\n");
+        source.write("    {\n");
+        source.write("        for(i = 0; i < count; i++)\n");
+        source.write("        {\n");
+        source.write("            const uint8_t* data = get" + protoName + "PacketDataConst(pkts[i]);\n");
+        source.write("            int byteindex = " + offset + ";\n");
+        source.write("            " + field->typeName + "* " + field->name + " = &out->" + field->name + "[i];\n");
+        source.write("\n");
+        source.write(decode);
+        source.write("        }\n");
+        source.write("    }\n");
+    }
+
+    source.write("\n");
+    source.write("    return count;\n");
+    source.write("}\n");
+
+}// ProtocolPacket::createBatchDecodeFunction
+
+
+/*!
+ * Get the declaration of the table that describes the structure of this
+ * packet to the table codec: one tableField_t for each encoded field, the
+ * scaling and constant values they refer to, and the tablePacket_t that
+ * ties them together with the byte order.
+ * \return the declaration, for the source file
+ */
+QString ProtocolPacket::getTableDeclaration(void) const
+{
+    QString output;
+    QStringList fields;
+    QStringList constants;
+    QString table = prefix + name + "PacketTable";
+    QString options;
+
+    for(int i = 0; i < encodables.size(); i++)
+    {
+        QString field = encodables.at(i)->getTableFieldString(typeName, constants);
+
+        if(!field.isEmpty())
+            fields.append(field);
+    }
+
+    if(isBigEndian)
+        options = "TABLE_BIG_ENDIAN";
+
+    // The same check as the decode functions of fielddecode
+    if(support.specialFloat)
+    {
+        if(options.isEmpty())
+            options = "TABLE_CHECK_FLOATS";
+        else
+            options += " | TABLE_CHECK_FLOATS";
+    }
+
+    if(options.isEmpty())
+        options = "0";
+
+    // The offsets of the table are 16 bits
+    output += "// The table codec can only reach members in the first 64K of the structure\n";
+    output += "typedef char tableCodecSizeOf" + typeName + "[(sizeof(" + typeName + ") <= 65535) ? 1 : -1];\n";
+    output += "\n";
+    output += "//! The fields of the " + prefix + name + " packet, in encoded order\n";
+    output += "static const tableField_t " + table + "Fields[" + QString().setNum(fields.size()) + "] =\n";
+    output += "{\n";
+    output += "    " + fields.join(",\n    ") + "\n";
+    output += "};\n";
+    output += "\n";
+
+    if(!constants.isEmpty())
+    {
+        output += "//! The scaling and constant values of the fields of the " + prefix + name + " packet\n";
+        output += "static const double " + table + "Constants[" + QString().setNum(constants.size()) + "] = {" + constants.join(", ") + "};\n";
+        output += "\n";
+    }
+
+    output += "//! The description of the " + prefix + name + " packet for the table codec\n";
+    output += "static const tablePacket_t " + table + " = {" + table + "Fields, " + (constants.isEmpty() ? QString("0") : table + "Constants") + ", " + QString().setNum(fields.size()) + ", " + options + "};\n";
+
+    return output;
+
+}// ProtocolPacket::getTableDeclaration
+
+
+/*!
+ * Get the C++ declaration of the packet identifier, which is a member of the
+ * C++ structure of the packet so that templates can dispatch on it.
+ * \return the declaration, at the indentation of a structure member
+ */
+QString ProtocolPacket::getCppStructureConstants(void) const
+{
+    QString output;
+
+    output += "    //! The identifier of the " + name + " packet\n";
+    output += "    static constexpr std::uint32_t id = " + id + ";\n";
+
+    return output;
+
+}// ProtocolPacket::getCppStructureConstants
+
+
 QString ProtocolPacket::getTopLevelMarkdown(QString outline) const
 {
     QString output;
@@ -757,14 +1897,17 @@ QString ProtocolPacket::getTopLevelMarkdown(QString outline) const
 
     if(encodedLength.minEncodedLength.compare(encodedLength.maxEncodedLength) == 0)
     {
-        output += "- data length: " + EncodedLength::collapseLengthString(encodedLength.minEncodedLength).replace("1*", "").replace("*", "&times;") + "\n";
+        output += "- data length: " + EncodedLength::collapseLengthString(encodedLength.minEncodedLength).replace("*", "&times;") + "\n";
     }
     else
     {
-        output += "- minimum data length: " + EncodedLength::collapseLengthString(encodedLength.minEncodedLength).replace("1*", "").replace("*", "&times;") + "\n";
-        output += "- maximum data length: " + EncodedLength::collapseLengthString(encodedLength.maxEncodedLength).replace("1*", "").replace("*", "&times;") + "\n";
+        output += "- minimum data length: " + EncodedLength::collapseLengthString(encodedLength.minEncodedLength).replace("*", "&times;") + "\n";
+        output += "- maximum data length: " + EncodedLength::collapseLengthString(encodedLength.maxEncodedLength).replace("*", "&times;") + "\n";
     }
 
+    if(deltaFunctions)
+        output += "- delta encoded: packets with the ID `" + deltaId + "` start with a " + QString().setNum(getDeltaMaskBytes()) + " byte presence mask, one bit for each field that is not constant, and only the fields whose bit is set follow\n";
+
     if(enumList.size() > 0)
     {
         output += "\n";
@@ -821,11 +1964,10 @@ QString ProtocolPacket::getTopLevelMarkdown(QString outline) const
         // Figure out the column widths, note that we assume all the lists are the same length
         for(int i = 0; i < names.length(); i++)
         {
-            // replace a "1*" with nothing, since that won't change the value but
-            // is clearer. Also replace "*" with the html time symbol. This
-            // looks better and does not cause markdown to emphasize the text
-            // if there are multiple "*".
-            bytes[i].replace("1*", "").replace("*", "&times;");
+            // Replace "*" with the html time symbol. This looks better and
+            // does not cause markdown to emphasize the text if there are
+            // multiple "*".
+            bytes[i].replace("*", "&times;");
 
             if(bytes.at(i).length() > byteColumn)
                 byteColumn = bytes.at(i).length();
@@ -5,6 +5,7 @@
 #include <QDomNodeList>
 #include <QList>
 #include "protocolstructuremodule.h"
+#include "protocoloperation.h"
 
 class ProtocolPacket : public ProtocolStructureModule
 {
@@ -15,6 +16,9 @@ public:
     //! Parse a packet from the DOM
     virtual void parse(const QDomElement& e);
 
+    //! Write the source and header files for this packet
+    virtual void generate(void);
+
     //! Destroy the protocol packet
     ~ProtocolPacket(void);
 
@@ -27,8 +31,26 @@ public:
     //! Get the ID string of this packet
     QString getId(void) const {return id;}
 
+    //! Determine if this packet has a delta encoded form
+    bool hasDelta(void) const {return deltaFunctions;}
+
+    //! Get the ID string of the delta encoded form of this packet
+    QString getDeltaId(void) const {return deltaId;}
+
+    //! Get the number of bytes of the presence mask of the delta encoded form
+    int getDeltaMaskBytes(void) const {return (getDeltaOperations().size() + 7)/8;}
+
+    //! Get the maximum encoded length of the delta encoded form
+    QString getDeltaMaxEncodedLength(void) const;
+
+    //! Determine if the structure functions of this packet are interpreted from a table
+    bool isTableCoded(void) const {return tableCodec;}
+
 protected:
 
+    //! Get the C++ declaration of the packet identifier
+    virtual QString getCppStructureConstants(void) const;
+
     //! Create the structure definition code
     void createStructureDefinition(void);
 
@@ -38,6 +60,9 @@ protected:
     //! Create the functions that encode and decode the parameters
     void createPacketFunctions(void);
 
+    //! Create the functions that encode and decode the packet data in a caller supplied buffer
+    void createBufferFunctions(bool isStructure);
+
     //! Create the function that encodes the structure
     void createStructureEncodeFunction(const QDomElement& e);
 
@@ -45,7 +70,7 @@ protected:
     void createSubStructureFunctions(void);
 
     //! Create the functions that encode and decode the structure
-    void createUtilityFunctions(const QDomElement& e);
+    void createUtilityFunctions(void);
 
     //! Get the packet encode signature
     QString getPacketEncodeSignature(void) const;
@@ -71,8 +96,64 @@ protected:
     //! Get the structure decode comment
     QString getDataDecodeBriefComment(void) const;
 
+    //! Determine if this packet is coded using constant byte offsets
+    bool usesFixedOffsets(void) const;
+
+    //! Get the line of source that sets the byte index to the constant offset of an encodable
+    virtual QString getFixedOffsetString(int index) const;
+
+    //! Get the constant byte offset of an encodable, empty if the offset is not constant
+    QString getConstantOffset(int index) const;
+
+    //! Get the body of a packet encode function
+    QString getEncodeBody(bool isStructureMember) const;
+
+    //! Get the expression for the number of bytes encoded by a packet encode function
+    QString getEncodedSizeString(void) const;
+
+    //! Get the body of a packet decode function
+    QString getDecodeBody(bool isStructureMember, bool checkLengths = false, bool traced = false) const;
+
+    //! Get the body of a packet decode function with a fast path and a length checked path
+    QString getDecodePaths(bool isStructureMember, bool traced = false) const;
+
+    //! Get the line of source that invokes one of the trace hooks of the protocol
+    QString getTraceString(const QString& hook, const QString& arguments) const;
+
+    //! Get the lines of source that reject a packet that fails a check
+    QString getRejectString(const QString& condition, const QString& length, const QString& reason) const;
+
+    //! Get the invocation of the reject hook, which goes under the if statement of a return
+    QString getRejectHook(const QString& length, const QString& reason) const;
+
+    //! Create the functions that read and write single fields in place
+    void createFieldAccessorFunctions(void);
+
+    //! Create the functions that encode and decode only the fields that changed
+    void createDeltaFunctions(void);
+
+    //! Get the operations that are sent in a delta packet, each with one bit in the presence mask
+    QList<const ProtocolOperation*> getDeltaOperations(void) const;
+
+    //! Get the expression that is true if an operation has changed since the reference
+    QString getDeltaChangedString(const ProtocolOperation& operation) const;
+
+    //! Create the function that decodes many packets into arrays of each field
+    void createBatchDecodeFunction(void);
+
+    //! Get the declaration of the table that describes this packet to the table codec
+    QString getTableDeclaration(void) const;
+
 protected:
-    QString id; //!< Packet identifier string
+    QString id;                 //!< Packet identifier string
+    QString deltaId;            //!< Packet identifier string of the delta encoded form
+    bool structureFunctions;    //!< True to output functions that encode and decode a structure
+    bool parameterFunctions;    //!< True to output functions that encode and decode parameters
+    bool accessorFunctions;     //!< True to output functions that access single fields in place
+    bool deltaFunctions;        //!< True to output functions that encode and decode only the fields that changed
+    bool tableCodec;            //!< True if the structure functions are interpreted from a table by the table codec
+    bool batchFunctions;        //!< True to output a function that decodes many packets into arrays of each field
+    ProtocolOperationList operations;   //!< The encodables lowered to operations, built when the packet is parsed
 };
 
 #endif // PROTOCOLPACKET_H
@@ -4,12 +4,17 @@
 #include "protocolscaling.h"
 #include "fieldcoding.h"
 #include "protocolsupport.h"
+#include "shuntingyard.h"
+#include "protocoldocumentation.h"
+#include "protocolxmlreader.h"
+#include "protocolstatistics.h"
 #include <QDomDocument>
 #include <QFile>
 #include <QFileDevice>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QStringList>
-#include <QProcess>
+#include <QtConcurrent>
 #include <iostream>
 
 // The version of the protocol generator is set here
@@ -27,6 +32,15 @@ QList<EnumCreator*> ProtocolParser::enums;
 // A static list of parsed global enumerations
 QList<EnumCreator*> ProtocolParser::globalEnums;
 
+// The parsed structures and packets, by type name
+QHash<QString, ProtocolStructureModule*> ProtocolParser::structureSymbols;
+
+// The parsed enumerations, by name
+QHash<QString, EnumCreator*> ProtocolParser::enumSymbols;
+
+// The values of the parsed enumerators, by name
+QHash<QString, QString> ProtocolParser::enumeratorSymbols;
+
 /*!
  * \brief ProtocolParser::ProtocolParser
  */
@@ -44,6 +58,7 @@ ProtocolParser::~ProtocolParser()
 {
     // Write anything out that might be pending
     header.flush();
+    cppHeader.flush();
 
     clear();
 }
@@ -55,10 +70,15 @@ ProtocolParser::~ProtocolParser()
 void ProtocolParser::clear(void)
 {
     header.clear();
+    cppHeader.clear();
     name.clear();
     prefix.clear();
     version.clear();
     api.clear();
+    framing.clear();
+    frameSync.clear();
+    logReader = false;
+    traceCounters = false;
 
     // Empty the static list
     for(int i = 0; i < structures.size(); i++)
@@ -94,9 +114,20 @@ void ProtocolParser::clear(void)
         }
     }
 
+    // Files left open by a previous parse are not appended
+    ProtocolFile::clearOpenFiles();
+
+    // The helpers called by a previous parse are not output for this one
+    ProtocolFile::clearHelperCalls();
+
     // enums and globalEnums contain the same pointers
     enums.clear();
     globalEnums.clear();
+
+    // The symbol tables point into the lists
+    structureSymbols.clear();
+    enumSymbols.clear();
+    enumeratorSymbols.clear();
 }
 
 
@@ -106,14 +137,46 @@ void ProtocolParser::clear(void)
  * \param nodoxygen should be true to skip the doxygen generation.
  * \param nomarkdown should be true to skip the markdown generation.
  * \param nohelperfiles should be true to skip generating helper source files.
+ * \param detachdocs should be true to leave the documentation tools running
+ *        after this function returns, with their status reported in a file.
+ * \param cpp should be true to output header-only C++ alongside the C.
  * \return true if something was written to a file
  */
-bool ProtocolParser::parse(const QDomDocument& doc, bool nodoxygen, bool nomarkdown, bool nohelperfiles)
+bool ProtocolParser::parse(const QDomDocument& doc, bool nodoxygen, bool nomarkdown, bool nohelperfiles, bool detachdocs, bool cpp)
+{
+    ProtocolXmlReader reader;
+
+    if(!reader.setDocument(doc))
+    {
+        std::cout << reader.getErrorString().toStdString() << std::endl;
+        return false;
+    }
+
+    return parse(reader, nodoxygen, nomarkdown, nohelperfiles, detachdocs, cpp);
+
+}// ProtocolParser::parse
+
+
+/*!
+ * Parse the protocol from the xml reader. This kicks off the auto code generation for the protocol
+ * \param reader gives the elements of the protocol, which may be streamed from a file.
+ * \param nodoxygen should be true to skip the doxygen generation.
+ * \param nomarkdown should be true to skip the markdown generation.
+ * \param nohelperfiles should be true to skip generating helper source files.
+ * \param detachdocs should be true to leave the documentation tools running
+ *        after this function returns, with their status reported in a file.
+ * \param cpp should be true to output header-only C++ alongside the C.
+ * \return true if something was written to a file
+ */
+bool ProtocolParser::parse(ProtocolXmlReader& reader, bool nodoxygen, bool nomarkdown, bool nohelperfiles, bool detachdocs, bool cpp)
 {
     ProtocolSupport support;
 
+    // The C++ output is a command line choice, not part of the protocol
+    support.cpp = cpp;
+
     // The outer most element
-    QDomElement docElem = doc.documentElement();
+    QDomElement docElem = reader.getProtocolElement();
 
     // This element must have the "Protocol" tag
     if(docElem.tagName() != "Protocol")
@@ -145,6 +208,91 @@ bool ProtocolParser::parse(const QDomDocument& doc, bool nodoxygen, bool nomarkd
     if(docElem.attribute("supportBitfield").contains("false", Qt::CaseInsensitive))
         support.bitfield = false;
 
+    // contiguous bitfields can be fused into a single word
+    if(docElem.attribute("fuseBitfields").contains("true", Qt::CaseInsensitive))
+        support.fuseBitfields = true;
+
+    // fixed length packets can be coded with constant offsets
+    if(docElem.attribute("fixedOffsets").contains("true", Qt::CaseInsensitive))
+        support.fixedOffsets = true;
+
+    // helper functions can be placed inline in the headers
+    if(docElem.attribute("inlineHelpers").contains("true", Qt::CaseInsensitive))
+        support.inlineHelpers = true;
+
+    // arrays can be coded in bulk
+    if(docElem.attribute("arrayHelpers").contains("true", Qt::CaseInsensitive))
+        support.arrayHelpers = true;
+
+    // scaling constants can be folded into the packet code
+    if(docElem.attribute("foldScaling").contains("true", Qt::CaseInsensitive))
+        support.foldScaling = true;
+
+    // packets can be encoded into caller supplied buffers and batches
+    if(docElem.attribute("bufferInterface").contains("true", Qt::CaseInsensitive))
+        support.bufferInterface = true;
+
+    // structure members can be declared in order of alignment
+    if(docElem.attribute("packMembers").contains("true", Qt::CaseInsensitive))
+        support.packMembers = true;
+
+    // fields that are encoded as they are in memory can be copied
+    if(docElem.attribute("nativeLayout").contains("true", Qt::CaseInsensitive))
+        support.nativeLayout = true;
+
+    // CRC and checksum routines can be output for the user
+    if(docElem.attribute("checksumHelpers").contains("true", Qt::CaseInsensitive))
+        support.checksum = true;
+
+    // packets can be coded by tables instead of straight line code
+    if(docElem.attribute("tableCodec").contains("true", Qt::CaseInsensitive))
+        support.tableCodec = true;
+
+    // the helper modules can leave out the functions that are not called
+    if(docElem.attribute("minimalHelpers").contains("true", Qt::CaseInsensitive))
+        support.minimalHelpers = true;
+
+    // the types of each module can be included without its functions
+    if(docElem.attribute("typesHeaders").contains("true", Qt::CaseInsensitive))
+        support.typesHeaders = true;
+
+    // packets can be framed with a synchronization word and a check
+    framing = docElem.attribute("framing").trimmed().toLower();
+    if(!framing.isEmpty())
+    {
+        if(!(QStringList() << "crc16" << "crc32" << "crc32c" << "fletcher16" << "fletcher32").contains(framing))
+        {
+            std::cout << "Protocol framing must be crc16, crc32, crc32c, fletcher16, or fletcher32, not " << framing.toStdString() << ", packets will not be framed" << std::endl;
+            framing.clear();
+        }
+        else
+        {
+            bool ok = false;
+            frameSync = docElem.attribute("frameSync").trimmed();
+
+            if(frameSync.isEmpty())
+                frameSync = "0xA55A";
+            else if((frameSync.toUInt(&ok, 0) > 0xFFFF) || !ok)
+            {
+                std::cout << "Protocol frameSync must be a number from 0 to 0xFFFF, not " << frameSync.toStdString() << ", using 0xA55A" << std::endl;
+                frameSync = "0xA55A";
+            }
+
+            support.checksum = true;
+        }
+    }
+
+    // framed packets can be recorded to logs which are read in place
+    logReader = docElem.attribute("logReader").contains("true", Qt::CaseInsensitive);
+    if(logReader && framing.isEmpty())
+    {
+        std::cout << "Protocol logReader requires framing, the log reader will not be output" << std::endl;
+        logReader = false;
+    }
+
+    // the trace hooks of the packet functions can count packets
+    traceCounters = docElem.attribute("traceCounters").contains("true", Qt::CaseInsensitive);
+
     // Prefix is not required
     prefix = docElem.attribute("prefix").trimmed();
 
@@ -152,74 +300,171 @@ bool ProtocolParser::parse(const QDomDocument& doc, bool nodoxygen, bool nomarkd
     if(docElem.attribute("endian").contains("little", Qt::CaseInsensitive))
         bigendian = false;
 
+    // Time for the statistics
+    QElapsedTimer phase, timer;
+    phase.start();
+
     // Build the top level module
     if(!createProtocolFiles(docElem))
         return false;
 
-    // All of the top level Structures, which stand alone in their own modules
-    QList<QDomNode> structlist = childElementsByTagName(docElem, "Structure");
-
-    // All of the top level packets. Packets can only be at the top level
-    QList<QDomNode> packetlist = childElementsByTagName(docElem, "Packet");
-
-    // Delete the files we are going to create so we don't have to worry about appending when we shouldn't
-    for(int i = 0; i < structlist.size(); i++)
-    {
-        QDomElement e = structlist.at(i).toElement();
-
-        QString moduleName = e.attribute("file");
-        if(moduleName.isEmpty())
-            moduleName = e.attribute("name");
+    if(support.cpp)
+        createCppProtocolFile(docElem);
 
-        ProtocolFile::deleteModule(moduleName);
+    // The modules in the order they are defined, which is the order their
+    // contributions appear in files that are shared between them
+    QList<ProtocolStructureModule*> modules;
 
-    }// for all structures
-
-    for(int i = 0; i < packetlist.size(); i++)
+    // Parsing is serial, as each structure can refer to the symbols of the
+    // structures and enumerations that were defined before it. All of the top
+    // level Structures stand alone in their own modules
+    for(int i = 0; i < reader.getNumberOfStructures(); i++)
     {
-        QDomElement e = packetlist.at(i).toElement();
-        QString moduleName = e.attribute("file");
-        if(moduleName.isEmpty())
-            moduleName = e.attribute("name") + "Packet";
-
-        ProtocolFile::deleteModule(moduleName);
+        QDomElement element = reader.getStructure(i);
+        if(element.isNull())
+        {
+            std::cout << reader.getErrorString().toStdString() << std::endl;
+            continue;
+        }
 
-    }// for all packets
+        timer.start();
 
-    for(int i = 0; i < structlist.size(); i++)
-    {
         // Create the module object
         ProtocolStructureModule* module = new ProtocolStructureModule(name, prefix, support, api, version, bigendian);
 
         // Parse its XML
-        module->parse(structlist.at(i).toElement());
+        module->parse(element);
 
-        // Keep it around, but only if we got something for it
-        if(module->encodedLength.isEmpty())
-            delete module;
-        else
+        ProtocolStatistics::addModuleTime(module->name, timer.nsecsElapsed(), 0);
+
+        // Empty structures are still output, but are not kept around
+        modules.push_back(module);
+        if(!module->encodedLength.isEmpty())
+        {
             structures.push_back(module);
+            addStructureSymbol(module, "structure");
+        }
 
     }// for all top level structures
-    structlist.clear();
+    int numStructureModules = modules.size();
 
-    // Create the packet files
-    for(int i = 0; i < packetlist.size(); i++)
+    // Parse the packets. Packets can only be at the top level
+    for(int i = 0; i < reader.getNumberOfPackets(); i++)
     {
+        QDomElement element = reader.getPacket(i);
+        if(element.isNull())
+        {
+            std::cout << reader.getErrorString().toStdString() << std::endl;
+            continue;
+        }
+
+        timer.start();
+
         // Create the module object
         ProtocolPacket* packet = new ProtocolPacket(name, prefix, support, api, version, bigendian);
 
         // Parse its XML
-        packet->parse(packetlist.at(i).toElement());
+        packet->parse(element);
+
+        ProtocolStatistics::addModuleTime(packet->name, timer.nsecsElapsed(), 0);
 
         // Keep it around
+        modules.push_back(packet);
         packets.push_back(packet);
+        addStructureSymbol(packet, "packet");
 
     }// for all packets
-    packetlist.clear();
+
+    ProtocolStatistics::addPhaseTime("parse", phase.nsecsElapsed());
+
+    if(ProtocolStatistics::isEnabled())
+    {
+        int numFields = 0;
+        for(int i = 0; i < modules.size(); i++)
+            numFields += modules.at(i)->getNumberOfFields();
+
+        ProtocolStatistics::addCount("structures", structures.size());
+        ProtocolStatistics::addCount("packets", packets.size());
+        ProtocolStatistics::addCount("fields", numFields);
+        ProtocolStatistics::addCount("enumerations", enums.size());
+    }
+
+    // Group the modules by the file they are output to. Each group is
+    // generated in order, but different groups are generated in parallel
+    QList<QList<ProtocolStructureModule*> > fileGroups;
+    QHash<QString, int> fileGroupIndex;
+    for(int i = 0; i < modules.size(); i++)
+    {
+        QString fileName = modules.at(i)->getHeaderFileName();
+
+        if(!fileGroupIndex.contains(fileName))
+        {
+            fileGroupIndex.insert(fileName, fileGroups.size());
+            fileGroups.append(QList<ProtocolStructureModule*>());
+        }
+
+        fileGroups[fileGroupIndex.value(fileName)].append(modules.at(i));
+    }
+
+    // The markdown only needs the parsed modules, so multimarkdown can run
+    // while the code is generated
+    ProtocolDocumentation documentation(name);
+    if(!nomarkdown)
+    {
+        phase.start();
+        outputMarkdown(bigendian);
+        ProtocolStatistics::addPhaseTime("markdown", phase.nsecsElapsed());
+
+        if(!detachdocs)
+            documentation.startMarkdown();
+    }
+
+    phase.start();
+    QtConcurrent::blockingMap(fileGroups, generateModules);
+
+    // The modules were generated on worker threads, so their notices are printed now, in order
+    for(int i = 0; i < modules.size(); i++)
+    {
+        QStringList notices = modules.at(i)->getNotices();
+        for(int j = 0; j < notices.size(); j++)
+            std::cout << notices.at(j).toStdString() << std::endl;
+    }
+
+    // Now we can get rid of the empty structures
+    for(int i = 0; i < numStructureModules; i++)
+    {
+        if(modules.at(i)->encodedLength.isEmpty())
+            delete modules[i];
+    }
+    modules.clear();
+
+    // The receiver side dispatcher for all the packets
+    bool dispatch = false;
+    if(docElem.attribute("packetDispatch").contains("true", Qt::CaseInsensitive))
+        dispatch = createDispatchFiles();
+
+    // The receiver side of the batch framing
+    if(support.bufferInterface)
+        createBatchFiles(bigendian);
+
+    // The implementation of the packet interface for framed packets
+    if(!framing.isEmpty())
+        createFramingFiles(bigendian, dispatch);
+
+    // The reader of logs of framed packets
+    if(logReader)
+        createLogFiles(bigendian);
+
+    // The counters behind the trace hooks
+    if(traceCounters)
+        createTraceFiles();
+
+    ProtocolStatistics::addPhaseTime("generate", phase.nsecsElapsed());
 
     if(!nohelperfiles)
     {
+        phase.start();
+
         // Auto-generated files for coding
         ProtocolScaling(support).generate();
         FieldCoding(support).generate();
@@ -235,26 +480,89 @@ bool ProtocolParser::parse(const QDomDocument& doc, bool nodoxygen, bool nomarkd
         if(support.bitfield)
             fileNames << "bitfieldspecial.c" << "bitfieldspecial.h";
 
+        if(support.cpp)
+            fileNames << "fieldcodec.hpp";
+
+        if(support.checksum)
+            fileNames << "checksum.c" << "checksum.h";
+
+        // Packets can choose the table codec even if the protocol does not
+        bool tableCodec = false;
+        for(int i = 0; i < packets.size(); i++)
+            tableCodec |= packets.at(i)->isTableCoded();
+
+        if(tableCodec)
+            fileNames << "tablecodec.c" << "tablecodec.h";
+
+        if(logReader)
+            fileNames << "packetlog.c" << "packetlog.h";
+
         for(int i = 0; i < fileNames.length(); i++)
-        {
-            ProtocolFile::deleteFile(fileNames[i]);
-            QFile::copy(sourcePath + fileNames[i], fileNames[i]);
-        }
+            ProtocolFile::copyFileIfChanged(sourcePath + fileNames[i], fileNames[i]);
+
+        ProtocolStatistics::addPhaseTime("helpers", phase.nsecsElapsed());
     }
 
-    if(!nomarkdown)
-        outputMarkdown(bigendian);
+    #ifdef _DEBUG
+    nodoxygen = true;
+    #endif
 
-    #ifndef _DEBUG
+    // Doxygen needs all of the generated code
     if(!nodoxygen)
+    {
         outputDoxygen();
-    #endif
+        if(!detachdocs)
+            documentation.startDoxygen();
+    }
+
+    if(detachdocs)
+        ProtocolDocumentation::startDetached(name, !nomarkdown, !nodoxygen);
+    else
+    {
+        phase.start();
+        documentation.waitForFinished();
+        ProtocolStatistics::addPhaseTime("documentationWait", phase.nsecsElapsed());
+    }
 
     return true;
 
 }// ProtocolParser::parse
 
 
+/*!
+ * Generate the files for a group of modules that share the same files. The
+ * modules append to the files in the order they are in the list, and the
+ * files are written to disk once all the modules are done.
+ * \param group is the list of modules, which must be the only modules that
+ *        output to these files.
+ */
+void ProtocolParser::generateModules(QList<ProtocolStructureModule*>& group)
+{
+    QElapsedTimer timer;
+
+    for(int i = 0; i < group.size(); i++)
+    {
+        timer.start();
+        group[i]->generate();
+
+        if(group.at(i)->support.cpp)
+            group[i]->generateCpp();
+
+        ProtocolStatistics::addModuleTime(group.at(i)->name, 0, timer.nsecsElapsed());
+    }
+
+    // The modules share files, so usually this only writes for the first one
+    for(int i = 0; i < group.size(); i++)
+    {
+        ProtocolFile::flushOpenFile(group.at(i)->getHeaderFileName());
+        ProtocolFile::flushOpenFile(group.at(i)->getSourceFileName());
+        ProtocolFile::flushOpenFile(group.at(i)->getCppHeaderFileName());
+        ProtocolFile::flushOpenFile(group.at(i)->getTypesHeaderFileName());
+    }
+
+}// ProtocolParser::generateModules
+
+
 /*!
  * Create the header file for the top level module of the protocol
  * \param docElem is the "protocol" element from the DOM
@@ -345,7 +653,10 @@ bool ProtocolParser::createProtocolFiles(const QDomElement& docElem)
 
     header.write("\n");
     header.write("// The prototypes below provide an interface to the packets.\n");
-    header.write("// They are not auto-generated functions, but must be hand-written\n");
+    if(framing.isEmpty())
+        header.write("// They are not auto-generated functions, but must be hand-written\n");
+    else
+        header.write("// They are implemented for framed packets by " + name + "Framing\n");
     header.write("\n");
     header.write("//! \\return the packet data pointer from the packet\n");
     header.write("uint8_t* get" + name + "PacketData(void* pkt);\n");
@@ -363,11 +674,1442 @@ bool ProtocolParser::createProtocolFiles(const QDomElement& docElem)
     header.write("uint32_t get" + name + "PacketID(const void* pkt);\n");
     header.write("\n");
 
+    // The hooks cost nothing unless they are defined, either by the trace
+    // module or by the user
+    QString define = name.toUpper();
+    header.write("// Trace hooks of the packet encode and decode functions. Each one does\n");
+    header.write("// nothing unless it is defined before this point, for example in an Include\n");
+    header.write("// of the protocol\n");
+    if(traceCounters)
+        header.writeIncludeDirective(name + "Trace.h");
+    header.write("\n");
+    header.write("//! The reason passed to " + define + "_TRACE_DECODE_REJECT if the packet identifier is wrong\n");
+    header.write("#define " + define + "_TRACE_REJECT_ID 1\n");
+    header.write("\n");
+    header.write("//! The reason passed to " + define + "_TRACE_DECODE_REJECT if the packet is too short\n");
+    header.write("#define " + define + "_TRACE_REJECT_LENGTH 2\n");
+    QStringList hooks;
+    hooks << "ENCODE_BEGIN(id)" << "ENCODE_END(id, len)" << "DECODE_BEGIN(id)" << "DECODE_END(id, len)" << "DECODE_REJECT(id, len, reason)";
+    for(int i = 0; i < hooks.size(); i++)
+    {
+        header.write("\n");
+        header.write("#ifndef " + define + "_TRACE_" + hooks.at(i).left(hooks.at(i).indexOf("(")) + "\n");
+        header.write("#define " + define + "_TRACE_" + hooks.at(i) + "\n");
+        header.write("#endif\n");
+    }
+    header.write("\n");
+
     return true;
 
 }// ProtocolParser::createProtocolFiles
 
 
+/*!
+ * Create the header for the top level module of the header-only C++ output.
+ * Everything in the C++ output lives in a namespace named for the protocol,
+ * starting with the global enumerations, so it can be used alongside the C.
+ * This must be called after createProtocolFiles().
+ * \param docElem is the "protocol" element from the DOM
+ */
+void ProtocolParser::createCppProtocolFile(const QDomElement& docElem)
+{
+    cppHeader.setModuleName(name + "Protocol");
+    cppHeader.setVersionOnly(true);
+
+    cppHeader.write("/*!\n");
+    cppHeader.write(" * \\file\n");
+    cppHeader.write(" * \\brief " + cppHeader.fileName() + " is the top level of the header-only C++ interface to the " + name + " protocol stack\n");
+
+    if(!comment.isEmpty())
+    {
+        cppHeader.write(" *\n");
+        outputLongComment(cppHeader, " *", comment);
+        cppHeader.write("\n");
+    }
+
+    cppHeader.write(" */\n");
+    cppHeader.write("\n");
+
+    cppHeader.write("#include <cstdint>\n");
+    cppHeader.write("#include <cstddef>\n");
+    cppHeader.write("#include <array>\n");
+    cppHeader.writeIncludeDirective("fieldcodec.hpp");
+
+    // Add other includes
+    outputIncludes(cppHeader, docElem);
+
+    cppHeader.makeLineSeparator();
+    cppHeader.write("namespace " + name + "\n");
+    cppHeader.write("{\n");
+
+    for(int i = 0; i < globalEnums.size(); i++)
+    {
+        cppHeader.makeLineSeparator();
+        cppHeader.write(globalEnums.at(i)->getOutput());
+    }
+
+    if(!api.isEmpty())
+    {
+        cppHeader.makeLineSeparator();
+        cppHeader.write("//! The protocol API enumeration\n");
+        cppHeader.write("constexpr int api = " + api + ";\n");
+    }
+
+    if(!version.isEmpty())
+    {
+        cppHeader.makeLineSeparator();
+        cppHeader.write("//! The protocol version string\n");
+        cppHeader.write("constexpr const char* version = \"" + version + "\";\n");
+    }
+
+    cppHeader.makeLineSeparator();
+    cppHeader.write("}// namespace " + name + "\n");
+    cppHeader.write("\n");
+
+}// ProtocolParser::createCppProtocolFile
+
+
+/*!
+ * Get the numeric value of a packet identifier, which may be given in terms
+ * of enumerations.
+ * \param id is the packet identifier string
+ * \param value receives the numeric value
+ * \return true if the identifier could be resolved to a number
+ */
+bool ProtocolParser::getPacketIdValue(QString id, qulonglong* value)
+{
+    bool ok = false;
+
+    replaceEnumerationNameWithValue(id);
+
+    // Try a literal first, which allows hexadecimal
+    *value = id.trimmed().toULongLong(&ok, 0);
+
+    if(!ok)
+    {
+        double number = ShuntingYard::computeInfix(id, &ok);
+
+        if(!ok || (number < 0) || (number != (double)((qulonglong)number)))
+            return false;
+
+        *value = (qulonglong)number;
+    }
+
+    return true;
+
+}// ProtocolParser::getPacketIdValue
+
+
+/*!
+ * Create the module which dispatches received packets to handler functions
+ * based on the packet identifier. The dispatcher also knows the minimum and
+ * maximum data lengths of each packet, which allows a receiver to reject a
+ * packet of the wrong size before decoding it. The lookup is a direct table
+ * if the identifiers are compact, a binary search if they are sparse, or a
+ * switch statement if the identifiers cannot be resolved by ProtoGen. The
+ * delta encoded form of a packet has its own identifier, limits, and handler.
+ * \return true if the module was output, false if there are no packets
+ */
+bool ProtocolParser::createDispatchFiles(void)
+{
+    QList<ProtocolPacket*> sorted;
+    QList<bool> deltas;
+    QStringList ids;
+    QList<qulonglong> values;
+    bool resolved = true;
+
+    for(int i = 0; i < packets.size(); i++)
+    {
+        if(packets.at(i) == NULL)
+            continue;
+
+        for(int form = 0; form < (packets.at(i)->hasDelta() ? 2 : 1); form++)
+        {
+            QString id = (form == 0) ? packets.at(i)->getId() : packets.at(i)->getDeltaId();
+            qulonglong value = 0;
+
+            if(!getPacketIdValue(id, &value))
+                resolved = false;
+
+            // Insertion sort by value, which also finds duplicates
+            int j = 0;
+            while((j < values.size()) && (values.at(j) < value))
+                j++;
+
+            if(resolved && (j < values.size()) && (values.at(j) == value))
+            {
+                std::cout << packets.at(i)->name.toStdString() << ": packet ID " << id.toStdString() << " duplicates the ID of " << sorted.at(j)->name.toStdString() << ", not included in the dispatcher" << std::endl;
+                continue;
+            }
+
+            sorted.insert(j, packets.at(i));
+            deltas.insert(j, form != 0);
+            ids.insert(j, id);
+            values.insert(j, value);
+        }
+    }
+
+    if(sorted.size() <= 0)
+        return false;
+
+    // Without numbers we keep the order of the xml
+    if(!resolved)
+    {
+        sorted.clear();
+        deltas.clear();
+        ids.clear();
+        for(int i = 0; i < packets.size(); i++)
+        {
+            if(packets.at(i) == NULL)
+                continue;
+
+            sorted.append(packets.at(i));
+            deltas.append(false);
+            ids.append(packets.at(i)->getId());
+
+            if(packets.at(i)->hasDelta())
+            {
+                sorted.append(packets.at(i));
+                deltas.append(true);
+                ids.append(packets.at(i)->getDeltaId());
+            }
+        }
+    }
+
+    // A direct table is used if at least half of it is used
+    qulonglong span = 0;
+    bool dense = false;
+    if(resolved)
+    {
+        span = values.last() - values.first() + 1;
+        dense = (span <= (qulonglong)(2*sorted.size()));
+    }
+
+    QString module = name + "Dispatch";
+    QString handlerType = name + "PacketHandler_t";
+    QString limitsType = name + "PacketLimits_t";
+    QString count = QString().setNum(sorted.size());
+
+    ProtocolHeaderFile dispatchHeader;
+    ProtocolSourceFile dispatchSource;
+
+    dispatchHeader.setModuleName(module);
+    dispatchSource.setModuleName(module);
+
+    dispatchHeader.write("/*!\n");
+    dispatchHeader.write(" * \\file\n");
+    dispatchHeader.write(" * \\brief " + dispatchHeader.fileName() + " dispatches received packets of the " + name + " protocol stack\n");
+    dispatchHeader.write(" *\n");
+    dispatchHeader.write(outputLongComment(" *", "Handler functions are installed for each packet ID. When a packet is received the dispatcher looks up the packet ID, verifies that the packet size is within the limits for that packet, and calls the handler. The handler typically calls the decode function for the packet.") + "\n");
+    dispatchHeader.write(" */\n");
+    dispatchHeader.write("\n");
+    dispatchHeader.writeIncludeDirective(name + "Protocol.h");
+    dispatchHeader.write("\n");
+    dispatchHeader.write("//! Function which handles a received packet, with a user supplied context\n");
+    dispatchHeader.write("typedef void (*" + handlerType + ")(const void* pkt, void* context);\n");
+    dispatchHeader.write("\n");
+    dispatchHeader.write("//! Install the handler for a packet ID\n");
+    dispatchHeader.write("int set" + name + "PacketHandler(uint32_t id, " + handlerType + " handler);\n");
+    dispatchHeader.write("\n");
+    dispatchHeader.write("//! Get the minimum and maximum data lengths for a packet ID\n");
+    dispatchHeader.write("int get" + name + "PacketLengthLimits(uint32_t id, int* minLength, int* maxLength);\n");
+    dispatchHeader.write("\n");
+    dispatchHeader.write("//! Call the handler for a received packet\n");
+    dispatchHeader.write("int dispatch" + name + "Packet(const void* pkt, void* context);\n");
+
+    // The packet headers give us the packet IDs
+    dispatchSource.write("\n");
+    for(int i = 0; i < sorted.size(); i++)
+        dispatchSource.writeIncludeDirective(sorted.at(i)->getHeaderFileName());
+
+    dispatchSource.write("\n");
+    dispatchSource.write("//! The identifier and data length limits of a packet\n");
+    dispatchSource.write("typedef struct\n");
+    dispatchSource.write("{\n");
+    dispatchSource.write("    uint32_t id;        //!< packet identifier\n");
+    dispatchSource.write("    int minLength;      //!< minimum data length in bytes\n");
+    dispatchSource.write("    int maxLength;      //!< maximum data length in bytes\n");
+    dispatchSource.write("}" + limitsType + ";\n");
+    dispatchSource.write("\n");
+
+    if(resolved)
+        dispatchSource.write("//! The limits of each packet, in order of increasing packet ID\n");
+    else
+        dispatchSource.write("//! The limits of each packet\n");
+
+    dispatchSource.write("static const " + limitsType + " " + name + "PacketLimits[" + count + "] =\n");
+    dispatchSource.write("{\n");
+    for(int i = 0; i < sorted.size(); i++)
+    {
+        QString minLength;
+        QString maxLength;
+
+        // A delta packet can be as short as its presence mask
+        if(deltas.at(i))
+        {
+            minLength.setNum(sorted.at(i)->getDeltaMaskBytes());
+            maxLength = getResolvedLength(sorted.at(i)->getDeltaMaxEncodedLength());
+        }
+        else
+        {
+            minLength = getResolvedLength(sorted.at(i)->encodedLength.minEncodedLength);
+            maxLength = getResolvedLength(sorted.at(i)->encodedLength.maxEncodedLength);
+        }
+
+        dispatchSource.write("    {" + ids.at(i) + ", " + minLength + ", " + maxLength + "}");
+
+        if(i < sorted.size() - 1)
+            dispatchSource.write(",");
+
+        if(deltas.at(i))
+            dispatchSource.write(" // " + sorted.at(i)->name + " delta\n");
+        else
+            dispatchSource.write(" // " + sorted.at(i)->name + "\n");
+    }
+    dispatchSource.write("};\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("//! The handler of each packet, in the same order as the limits\n");
+    dispatchSource.write("static " + handlerType + " " + name + "PacketHandlers[" + count + "];\n");
+
+    if(dense)
+    {
+        QString first = QString().setNum(values.first()) + "u";
+
+        dispatchSource.write("\n");
+        dispatchSource.write("//! The location in the limits of each packet ID starting from " + QString().setNum(values.first()) + ", -1 if the ID is not used\n");
+        dispatchSource.write("static const int16_t " + name + "PacketIndex[" + QString().setNum(span) + "] =\n");
+        dispatchSource.write("{\n");
+
+        int j = 0;
+        QString line = "   ";
+        for(qulonglong id = values.first(); id <= values.last(); id++)
+        {
+            if(values.at(j) == id)
+                line += " " + QString().setNum(j++);
+            else
+                line += " -1";
+
+            if(id < values.last())
+                line += ",";
+
+            // Keep the lines readable
+            if((line.size() > 72) || (id == values.last()))
+            {
+                dispatchSource.write(line + "\n");
+                line = "   ";
+            }
+        }
+
+        dispatchSource.write("};\n");
+        dispatchSource.write("\n");
+        dispatchSource.write("/*!\n");
+        dispatchSource.write(" * Find the location of a packet in the dispatch tables using a direct lookup\n");
+        dispatchSource.write(" * \\param id is the packet identifier\n");
+        dispatchSource.write(" * \\return the location of the packet, or -1 if the ID is not known\n");
+        dispatchSource.write(" */\n");
+        dispatchSource.write("static int find" + name + "Packet(uint32_t id)\n");
+        dispatchSource.write("{\n");
+        dispatchSource.write("    // Unsigned arithmetic takes care of IDs less than the first one\n");
+        dispatchSource.write("    uint32_t offset = id - " + first + ";\n");
+        dispatchSource.write("\n");
+        dispatchSource.write("    if(offset >= " + QString().setNum(span) + "u)\n");
+        dispatchSource.write("        return -1;\n");
+        dispatchSource.write("    else\n");
+        dispatchSource.write("        return " + name + "PacketIndex[offset];\n");
+        dispatchSource.write("}\n");
+    }
+    else if(resolved)
+    {
+        dispatchSource.write("\n");
+        dispatchSource.write("/*!\n");
+        dispatchSource.write(" * Find the location of a packet in the dispatch tables using a binary search\n");
+        dispatchSource.write(" * \\param id is the packet identifier\n");
+        dispatchSource.write(" * \\return the location of the packet, or -1 if the ID is not known\n");
+        dispatchSource.write(" */\n");
+        dispatchSource.write("static int find" + name + "Packet(uint32_t id)\n");
+        dispatchSource.write("{\n");
+        dispatchSource.write("    int low = 0;\n");
+        dispatchSource.write("    int high = " + QString().setNum(sorted.size() - 1) + ";\n");
+        dispatchSource.write("\n");
+        dispatchSource.write("    while(low <= high)\n");
+        dispatchSource.write("    {\n");
+        dispatchSource.write("        int middle = (low + high)/2;\n");
+        dispatchSource.write("\n");
+        dispatchSource.write("        if(" + name + "PacketLimits[middle].id < id)\n");
+        dispatchSource.write("            low = middle + 1;\n");
+        dispatchSource.write("        else if(" + name + "PacketLimits[middle].id > id)\n");
+        dispatchSource.write("            high = middle - 1;\n");
+        dispatchSource.write("        else\n");
+        dispatchSource.write("            return middle;\n");
+        dispatchSource.write("    }\n");
+        dispatchSource.write("\n");
+        dispatchSource.write("    return -1;\n");
+        dispatchSource.write("}\n");
+    }
+    else
+    {
+        dispatchSource.write("\n");
+        dispatchSource.write("/*!\n");
+        dispatchSource.write(" * Find the location of a packet in the dispatch tables. The packet IDs are\n");
+        dispatchSource.write(" * not known to ProtoGen, so the compiler chooses how to do the search.\n");
+        dispatchSource.write(" * \\param id is the packet identifier\n");
+        dispatchSource.write(" * \\return the location of the packet, or -1 if the ID is not known\n");
+        dispatchSource.write(" */\n");
+        dispatchSource.write("static int find" + name + "Packet(uint32_t id)\n");
+        dispatchSource.write("{\n");
+        dispatchSource.write("    switch(id)\n");
+        dispatchSource.write("    {\n");
+        dispatchSource.write("    default: return -1;\n");
+        for(int i = 0; i < sorted.size(); i++)
+            dispatchSource.write("    case " + ids.at(i) + ": return " + QString().setNum(i) + ";\n");
+        dispatchSource.write("    }\n");
+        dispatchSource.write("}\n");
+    }
+
+    dispatchSource.write("\n");
+    dispatchSource.write("/*!\n");
+    dispatchSource.write(" * Install the handler for a packet ID, replacing any previous handler\n");
+    dispatchSource.write(" * \\param id is the packet identifier\n");
+    dispatchSource.write(" * \\param handler is the function to call when the packet is dispatched, which\n");
+    dispatchSource.write(" *        can be 0 to remove the handler\n");
+    dispatchSource.write(" * \\return 0 if the packet ID is not known, else 1\n");
+    dispatchSource.write(" */\n");
+    dispatchSource.write("int set" + name + "PacketHandler(uint32_t id, " + handlerType + " handler)\n");
+    dispatchSource.write("{\n");
+    dispatchSource.write("    int index = find" + name + "Packet(id);\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    if(index < 0)\n");
+    dispatchSource.write("        return 0;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    " + name + "PacketHandlers[index] = handler;\n");
+    dispatchSource.write("    return 1;\n");
+    dispatchSource.write("}\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("/*!\n");
+    dispatchSource.write(" * Get the minimum and maximum data lengths for a packet ID\n");
+    dispatchSource.write(" * \\param id is the packet identifier\n");
+    dispatchSource.write(" * \\param minLength receives the minimum data length in bytes\n");
+    dispatchSource.write(" * \\param maxLength receives the maximum data length in bytes\n");
+    dispatchSource.write(" * \\return 0 if the packet ID is not known, else 1\n");
+    dispatchSource.write(" */\n");
+    dispatchSource.write("int get" + name + "PacketLengthLimits(uint32_t id, int* minLength, int* maxLength)\n");
+    dispatchSource.write("{\n");
+    dispatchSource.write("    int index = find" + name + "Packet(id);\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    if(index < 0)\n");
+    dispatchSource.write("        return 0;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    *minLength = " + name + "PacketLimits[index].minLength;\n");
+    dispatchSource.write("    *maxLength = " + name + "PacketLimits[index].maxLength;\n");
+    dispatchSource.write("    return 1;\n");
+    dispatchSource.write("}\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("/*!\n");
+    dispatchSource.write(" * Call the handler for a received packet, after verifying its size\n");
+    dispatchSource.write(" * \\param pkt points to the received packet\n");
+    dispatchSource.write(" * \\param context is passed to the handler\n");
+    dispatchSource.write(" * \\return 0 if the packet ID is not known, the packet size is outside the\n");
+    dispatchSource.write(" *         limits, or there is no handler for the packet; else 1\n");
+    dispatchSource.write(" */\n");
+    dispatchSource.write("int dispatch" + name + "Packet(const void* pkt, void* context)\n");
+    dispatchSource.write("{\n");
+    dispatchSource.write("    int index = find" + name + "Packet(get" + name + "PacketID(pkt));\n");
+    dispatchSource.write("    int size;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    if(index < 0)\n");
+    dispatchSource.write("        return 0;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    size = get" + name + "PacketSize(pkt);\n");
+    dispatchSource.write("    if((size < " + name + "PacketLimits[index].minLength) || (size > " + name + "PacketLimits[index].maxLength))\n");
+    dispatchSource.write("        return 0;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    if(" + name + "PacketHandlers[index] == 0)\n");
+    dispatchSource.write("        return 0;\n");
+    dispatchSource.write("\n");
+    dispatchSource.write("    " + name + "PacketHandlers[index](pkt, context);\n");
+    dispatchSource.write("    return 1;\n");
+    dispatchSource.write("}\n");
+
+    dispatchHeader.flush();
+    dispatchSource.flush();
+
+    return true;
+
+}// ProtocolParser::createDispatchFiles
+
+
+/*!
+ * Create the module which separates a batch of packets that were appended to
+ * one buffer by the append<Packet>ToBatch() functions. Each packet in the
+ * batch is framed by its 32-bit identifier and 16-bit data length.
+ * \param bigendian should be true if the frames are big endian
+ */
+void ProtocolParser::createBatchFiles(bool bigendian)
+{
+    QString module = name + "Batch";
+    QString endian;
+
+    if(bigendian)
+        endian = "Be";
+    else
+        endian = "Le";
+
+    ProtocolHeaderFile batchHeader;
+    ProtocolSourceFile batchSource;
+
+    batchHeader.setModuleName(module);
+    batchSource.setModuleName(module);
+
+    batchHeader.write("/*!\n");
+    batchHeader.write(" * \\file\n");
+    batchHeader.write(" * \\brief " + batchHeader.fileName() + " separates batches of packets of the " + name + " protocol stack\n");
+    batchHeader.write(" *\n");
+    batchHeader.write(outputLongComment(" *", "A batch is a buffer of packets appended back to back. Each packet is a frame of the 4 byte packet identifier, the 2 byte data length, and the packet data. The data are decoded by the decode<Packet>FromBuffer() functions.") + "\n");
+    batchHeader.write(" */\n");
+    batchHeader.write("\n");
+    batchHeader.writeIncludeDirective(name + "Protocol.h");
+    batchHeader.write("\n");
+    batchHeader.write("//! Get the next packet from a batch of packets\n");
+    batchHeader.write("int next" + name + "BatchPacket(const uint8_t* buf, int size, int* offset, uint32_t* id, const uint8_t** data, int* length);\n");
+
+    batchSource.write("\n");
+    batchSource.writeIncludeDirective("fielddecode.h");
+    batchSource.write("\n");
+    batchSource.write("/*!\n");
+    batchSource.write(" * Get the next packet from a batch of packets\n");
+    batchSource.write(" * \\param buf is the batch of packets\n");
+    batchSource.write(" * \\param size is the number of bytes in buf\n");
+    batchSource.write(" * \\param offset is the location in buf of the next packet, and is updated\n");
+    batchSource.write(" *        to the location of the packet after that\n");
+    batchSource.write(" * \\param id receives the packet identifier\n");
+    batchSource.write(" * \\param data receives a pointer to the packet data in buf\n");
+    batchSource.write(" * \\param length receives the number of bytes of packet data\n");
+    batchSource.write(" * \\return 0 if there are no more complete packets in buf, else 1\n");
+    batchSource.write(" */\n");
+    batchSource.write("int next" + name + "BatchPacket(const uint8_t* buf, int size, int* offset, uint32_t* id, const uint8_t** data, int* length)\n");
+    batchSource.write("{\n");
+    batchSource.write("    int byteindex = *offset;\n");
+    batchSource.write("\n");
+    batchSource.write("    if((byteindex < 0) || (size - byteindex < 6))\n");
+    batchSource.write("        return 0;\n");
+    batchSource.write("\n");
+    batchSource.write("    *id = uint32From" + endian + "Bytes(buf, &byteindex);\n");
+    batchSource.write("    *length = uint16From" + endian + "Bytes(buf, &byteindex);\n");
+    batchSource.write("\n");
+    batchSource.write("    if(size - byteindex < *length)\n");
+    batchSource.write("        return 0;\n");
+    batchSource.write("\n");
+    batchSource.write("    *data = buf + byteindex;\n");
+    batchSource.write("    *offset = byteindex + *length;\n");
+    batchSource.write("    return 1;\n");
+    batchSource.write("}\n");
+
+    batchHeader.flush();
+    batchSource.flush();
+
+}// ProtocolParser::createBatchFiles
+
+
+/*!
+ * Create the module which frames packets for a byte stream. Each frame is the
+ * synchronization word, the 32-bit packet identifier, the 16-bit data length,
+ * the packet data, and a check of everything before it. The module implements
+ * the packet interface functions that are otherwise hand-written, and a
+ * parser which separates frames from a stream of received bytes.
+ * \param bigendian should be true if the frames are big endian
+ * \param dispatch should be true if the dispatch module was output, in which
+ *        case frames are checked against the length limits of their packet
+ *        and the stream parser calls the dispatcher
+ */
+void ProtocolParser::createFramingFiles(bool bigendian, bool dispatch)
+{
+    QString module = name + "Framing";
+    QString define = name.toUpper();
+    QString packetType = name + "Packet_t";
+    QString endian;
+    QString checkType;
+    QString checkName;
+    QString checkFunction;
+
+    if(bigendian)
+        endian = "Be";
+    else
+        endian = "Le";
+
+    if(framing == "crc16")
+    {
+        checkType = "uint16";
+        checkName = "CRC-16/CCITT";
+        checkFunction = "computeCrc16";
+    }
+    else if(framing == "crc32")
+    {
+        checkType = "uint32";
+        checkName = "CRC-32";
+        checkFunction = "computeCrc32";
+    }
+    else if(framing == "crc32c")
+    {
+        checkType = "uint32";
+        checkName = "CRC-32C";
+        checkFunction = "computeCrc32c";
+    }
+    else if(framing == "fletcher16")
+    {
+        checkType = "uint16";
+        checkName = "Fletcher-16 checksum";
+        checkFunction = "computeFletcher16";
+    }
+    else
+    {
+        checkType = "uint32";
+        checkName = "Fletcher-32 checksum";
+        checkFunction = "computeFletcher32";
+    }
+
+    QString checkSize = (checkType == "uint16") ? "2" : "4";
+    QString parserType = name + "StreamParser_t";
+    QString handlerType = name + "FrameHandler_t";
+
+    // The first byte of the synchronization word on the wire, which is what the stream parser scans for
+    uint sync = frameSync.toUInt(NULL, 0);
+    QString syncFirst = "0x" + QString().setNum(bigendian ? (sync >> 8) : (sync & 0xFF), 16).rightJustified(2, '0').toUpper();
+
+    // The frame buffer is sized for the largest packet, if we know it
+    qulonglong maxData = 0;
+    bool knownMax = !packets.isEmpty();
+    for(int i = 0; i < packets.size(); i++)
+    {
+        bool ok = false;
+        qulonglong length = getResolvedLength(packets.at(i)->encodedLength.maxEncodedLength).toULongLong(&ok);
+
+        if(ok)
+            maxData = qMax(maxData, length);
+        else
+            knownMax = false;
+
+        // A delta packet can be longer than the full packet, by its presence mask
+        if(packets.at(i)->hasDelta())
+        {
+            length = getResolvedLength(packets.at(i)->getDeltaMaxEncodedLength()).toULongLong(&ok);
+
+            if(ok)
+                maxData = qMax(maxData, length);
+            else
+                knownMax = false;
+        }
+    }
+
+    ProtocolHeaderFile framingHeader;
+    ProtocolSourceFile framingSource;
+
+    framingHeader.setModuleName(module);
+    framingSource.setModuleName(module);
+
+    framingHeader.write("/*!\n");
+    framingHeader.write(" * \\file\n");
+    framingHeader.write(" * \\brief " + framingHeader.fileName() + " frames the packets of the " + name + " protocol stack\n");
+    framingHeader.write(" *\n");
+    framingHeader.write(outputLongComment(" *", "Each packet is a frame of the 2 byte synchronization word " + frameSync + ", the 4 byte packet identifier, the 2 byte data length, the packet data, and the " + checkSize + " byte " + checkName + " of everything before it, in " + (bigendian ? "big" : "little") + " endian byte order. The frame is built in " + packetType + ", which implements the packet interface functions of " + name + "Protocol.h, so those functions must not also be hand-written.") + "\n");
+    framingHeader.write(" *\n");
+    if(dispatch)
+        framingHeader.write(outputLongComment(" *", "Received bytes are fed to a " + parserType + " in chunks of any size. The parser finds the frames, checks them, and passes each valid frame to dispatch" + name + "Packet(). A frame that is complete in a chunk is dispatched from the chunk itself; only a frame that is split across chunks is copied, once, into the parser.") + "\n");
+    else
+        framingHeader.write(outputLongComment(" *", "Received bytes are fed to a " + parserType + " in chunks of any size. The parser finds the frames, checks them, and passes each valid frame to the handler of the parser. A frame that is complete in a chunk is handled from the chunk itself; only a frame that is split across chunks is copied, once, into the parser.") + "\n");
+    framingHeader.write(" */\n");
+    framingHeader.write("\n");
+    framingHeader.writeIncludeDirective("stddef.h", QString(), true);
+    framingHeader.writeIncludeDirective(name + "Protocol.h");
+    framingHeader.write("\n");
+    framingHeader.write("//! The synchronization word at the start of each frame\n");
+    framingHeader.write("#define " + define + "_FRAME_SYNC " + frameSync + "u\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! The number of bytes of a frame before the packet data\n");
+    framingHeader.write("#define " + define + "_FRAME_HEADER_SIZE 8\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! The number of bytes of a frame after the packet data\n");
+    framingHeader.write("#define " + define + "_FRAME_CHECK_SIZE " + checkSize + "\n");
+    framingHeader.write("\n");
+    if(knownMax)
+        framingHeader.write("// The largest packet data of the protocol. Define this before including this file to change it\n");
+    else
+        framingHeader.write("// The packet data lengths of the protocol could not be resolved, define this before including this file to change it\n");
+    framingHeader.write("#ifndef " + define + "_MAX_PACKET_DATA\n");
+    framingHeader.write("#define " + define + "_MAX_PACKET_DATA " + (knownMax ? QString().setNum(qMax(maxData, (qulonglong)1)) : QString("1024")) + "\n");
+    framingHeader.write("#endif\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! A packet of the " + name + " protocol, which holds one frame\n");
+    framingHeader.write("typedef struct\n");
+    framingHeader.write("{\n");
+    framingHeader.write("    uint8_t frame[" + define + "_FRAME_HEADER_SIZE + " + define + "_MAX_PACKET_DATA + " + define + "_FRAME_CHECK_SIZE];\n");
+    framingHeader.write("}" + packetType + ";\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! \\return the number of bytes of the frame of a finished packet\n");
+    framingHeader.write("int get" + name + "PacketFrameSize(const void* pkt);\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! Check the frame of a received packet\n");
+    framingHeader.write("int check" + name + "Packet(const void* pkt);\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! Check a frame at the start of a buffer of received bytes\n");
+    framingHeader.write("int check" + name + "Frame(const uint8_t* buf, int size);\n");
+    framingHeader.write("\n");
+    if(!dispatch)
+    {
+        framingHeader.write("//! Function which handles a received frame, with a user supplied context\n");
+        framingHeader.write("typedef void (*" + handlerType + ")(const void* pkt, void* context);\n");
+        framingHeader.write("\n");
+    }
+    framingHeader.write("//! The state of a parser which separates frames from a stream of received bytes\n");
+    framingHeader.write("typedef struct\n");
+    framingHeader.write("{\n");
+    framingHeader.write("    " + packetType + " partial; //!< The frame that is split across chunks\n");
+    framingHeader.write("    int received;       //!< The number of bytes of the split frame that have been received\n");
+    if(!dispatch)
+        framingHeader.write("    " + handlerType + " handler; //!< The function which handles each valid frame\n");
+    framingHeader.write("    void* context;      //!< Passed to the handler of each frame\n");
+    framingHeader.write("    uint32_t frames;    //!< The number of valid frames\n");
+    framingHeader.write("    uint32_t discarded; //!< The number of bytes discarded to find the next frame\n");
+    framingHeader.write("}" + parserType + ";\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! Initialize a stream parser\n");
+    if(dispatch)
+        framingHeader.write("void init" + name + "StreamParser(" + parserType + "* parser, void* context);\n");
+    else
+        framingHeader.write("void init" + name + "StreamParser(" + parserType + "* parser, " + handlerType + " handler, void* context);\n");
+    framingHeader.write("\n");
+    framingHeader.write("//! Feed received bytes to a stream parser, handling every frame that is completed\n");
+    framingHeader.write("void feed" + name + "StreamParser(" + parserType + "* parser, const uint8_t* chunk, size_t n);\n");
+
+    framingSource.write("\n");
+    framingSource.writeIncludeDirective("fieldencode.h");
+    framingSource.writeIncludeDirective("fielddecode.h");
+    framingSource.writeIncludeDirective("checksum.h");
+    if(dispatch)
+        framingSource.writeIncludeDirective(name + "Dispatch.h");
+    framingSource.writeIncludeDirective("string.h", QString(), true);
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\return the packet data pointer from the packet\n");
+    framingSource.write(" */\n");
+    framingSource.write("uint8_t* get" + name + "PacketData(void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    return ((" + packetType + "*)pkt)->frame + " + define + "_FRAME_HEADER_SIZE;\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\return the packet data pointer from the packet, const\n");
+    framingSource.write(" */\n");
+    framingSource.write("const uint8_t* get" + name + "PacketDataConst(const void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    return ((const " + packetType + "*)pkt)->frame + " + define + "_FRAME_HEADER_SIZE;\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Complete a packet after the data have been encoded, by writing the frame\n");
+    framingSource.write(" * header and the check\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\param size is the number of bytes of packet data\n");
+    framingSource.write(" * \\param packetID is the identifier of the packet\n");
+    framingSource.write(" */\n");
+    framingSource.write("void finish" + name + "Packet(void* pkt, int size, uint32_t packetID)\n");
+    framingSource.write("{\n");
+    framingSource.write("    uint8_t* frame = ((" + packetType + "*)pkt)->frame;\n");
+    framingSource.write("    int byteindex = 0;\n");
+    framingSource.write("\n");
+    framingSource.write("    uint16To" + endian + "Bytes(" + define + "_FRAME_SYNC, frame, &byteindex);\n");
+    framingSource.write("    uint32To" + endian + "Bytes(packetID, frame, &byteindex);\n");
+    framingSource.write("    uint16To" + endian + "Bytes((uint16_t)size, frame, &byteindex);\n");
+    framingSource.write("\n");
+    framingSource.write("    byteindex += size;\n");
+    framingSource.write("    " + checkType + "To" + endian + "Bytes(" + checkFunction + "(frame, byteindex), frame, &byteindex);\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\return the size of a packet from the packet header\n");
+    framingSource.write(" */\n");
+    framingSource.write("int get" + name + "PacketSize(const void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    int byteindex = 6;\n");
+    framingSource.write("    return uint16From" + endian + "Bytes(((const " + packetType + "*)pkt)->frame, &byteindex);\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\return the ID of a packet from the packet header\n");
+    framingSource.write(" */\n");
+    framingSource.write("uint32_t get" + name + "PacketID(const void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    int byteindex = 2;\n");
+    framingSource.write("    return uint32From" + endian + "Bytes(((const " + packetType + "*)pkt)->frame, &byteindex);\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * \\param pkt points to a finished " + packetType + "\n");
+    framingSource.write(" * \\return the number of bytes of the frame, which is the number of bytes to\n");
+    framingSource.write(" *         transmit starting from the packet\n");
+    framingSource.write(" */\n");
+    framingSource.write("int get" + name + "PacketFrameSize(const void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    return " + define + "_FRAME_HEADER_SIZE + get" + name + "PacketSize(pkt) + " + define + "_FRAME_CHECK_SIZE;\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Check the frame of a received packet\n");
+    framingSource.write(" * \\param pkt points to a " + packetType + "\n");
+    framingSource.write(" * \\return 1 if the synchronization word, data length, and check are valid, else 0\n");
+    framingSource.write(" */\n");
+    framingSource.write("int check" + name + "Packet(const void* pkt)\n");
+    framingSource.write("{\n");
+    framingSource.write("    return (check" + name + "Frame(((const " + packetType + "*)pkt)->frame, sizeof(" + packetType + ")) > 0);\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Check a frame at the start of a buffer of received bytes\n");
+    framingSource.write(" * \\param buf is the received bytes, starting from the synchronization word\n");
+    framingSource.write(" * \\param size is the number of bytes in buf\n");
+    framingSource.write(" * \\return the number of bytes of the frame if it is complete and valid, 0\n");
+    framingSource.write(" *         if more bytes are needed to check it, or -1 if it is not a valid\n");
+    framingSource.write(" *         frame\n");
+    framingSource.write(" */\n");
+    framingSource.write("int check" + name + "Frame(const uint8_t* buf, int size)\n");
+    framingSource.write("{\n");
+    framingSource.write("    int byteindex = 0;\n");
+    framingSource.write("    int length;\n");
+    if(dispatch)
+    {
+        framingSource.write("    uint32_t id;\n");
+        framingSource.write("    int minLength, maxLength;\n");
+    }
+    framingSource.write("\n");
+    framingSource.write("    if(size < " + define + "_FRAME_HEADER_SIZE)\n");
+    framingSource.write("        return 0;\n");
+    framingSource.write("\n");
+    framingSource.write("    if(uint16From" + endian + "Bytes(buf, &byteindex) != " + define + "_FRAME_SYNC)\n");
+    framingSource.write("        return -1;\n");
+    framingSource.write("\n");
+    if(dispatch)
+    {
+        framingSource.write("    id = uint32From" + endian + "Bytes(buf, &byteindex);\n");
+        framingSource.write("    length = uint16From" + endian + "Bytes(buf, &byteindex);\n");
+        framingSource.write("\n");
+        framingSource.write("    // The length is checked against the packet before waiting for the data\n");
+        framingSource.write("    if(!get" + name + "PacketLengthLimits(id, &minLength, &maxLength))\n");
+        framingSource.write("        return -1;\n");
+        framingSource.write("\n");
+        framingSource.write("    if((length < minLength) || (length > maxLength) || (length > " + define + "_MAX_PACKET_DATA))\n");
+        framingSource.write("        return -1;\n");
+    }
+    else
+    {
+        framingSource.write("    byteindex = 6;\n");
+        framingSource.write("    length = uint16From" + endian + "Bytes(buf, &byteindex);\n");
+        framingSource.write("\n");
+        framingSource.write("    if(length > " + define + "_MAX_PACKET_DATA)\n");
+        framingSource.write("        return -1;\n");
+    }
+    framingSource.write("\n");
+    framingSource.write("    if(size < " + define + "_FRAME_HEADER_SIZE + length + " + define + "_FRAME_CHECK_SIZE)\n");
+    framingSource.write("        return 0;\n");
+    framingSource.write("\n");
+    framingSource.write("    byteindex += length;\n");
+    framingSource.write("    if(" + checkType + "From" + endian + "Bytes(buf, &byteindex) != " + checkFunction + "(buf, " + define + "_FRAME_HEADER_SIZE + length))\n");
+    framingSource.write("        return -1;\n");
+    framingSource.write("\n");
+    framingSource.write("    return byteindex;\n");
+    framingSource.write("}\n");
+
+    QString handle;
+    if(dispatch)
+        handle = "dispatch" + name + "Packet";
+    else
+        handle = "parser->handler";
+
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Initialize a stream parser\n");
+    framingSource.write(" * \\param parser is the parser to initialize\n");
+    if(!dispatch)
+        framingSource.write(" * \\param handler is called for each valid frame\n");
+    framingSource.write(" * \\param context is passed to the handler of each frame\n");
+    framingSource.write(" */\n");
+    if(dispatch)
+        framingSource.write("void init" + name + "StreamParser(" + parserType + "* parser, void* context)\n");
+    else
+        framingSource.write("void init" + name + "StreamParser(" + parserType + "* parser, " + handlerType + " handler, void* context)\n");
+    framingSource.write("{\n");
+    framingSource.write("    parser->received = 0;\n");
+    if(!dispatch)
+        framingSource.write("    parser->handler = handler;\n");
+    framingSource.write("    parser->context = context;\n");
+    framingSource.write("    parser->frames = 0;\n");
+    framingSource.write("    parser->discarded = 0;\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Continue the frame that is split across chunks, copying only the bytes that\n");
+    framingSource.write(" * the frame needs. If the frame turns out to be invalid the bytes after its\n");
+    framingSource.write(" * first byte are searched for the start of the next frame.\n");
+    framingSource.write(" * \\param parser is the parser with a split frame\n");
+    framingSource.write(" * \\param chunk is the received bytes\n");
+    framingSource.write(" * \\param n is the number of bytes in chunk, which must be at least 1\n");
+    framingSource.write(" * \\return the number of bytes of chunk that were used\n");
+    framingSource.write(" */\n");
+    framingSource.write("static size_t continue" + name + "Frame(" + parserType + "* parser, const uint8_t* chunk, size_t n)\n");
+    framingSource.write("{\n");
+    framingSource.write("    uint8_t* frame = parser->partial.frame;\n");
+    framingSource.write("    size_t needed;\n");
+    framingSource.write("    int framesize;\n");
+    framingSource.write("\n");
+    framingSource.write("    // The bytes we have may be left from resynchronizing, so they are checked\n");
+    framingSource.write("    // before the data length in their header is trusted\n");
+    framingSource.write("    framesize = check" + name + "Frame(frame, parser->received);\n");
+    framingSource.write("\n");
+    framingSource.write("    if(framesize != 0)\n");
+    framingSource.write("        needed = 0;\n");
+    framingSource.write("    else\n");
+    framingSource.write("    {\n");
+    framingSource.write("        if(parser->received < " + define + "_FRAME_HEADER_SIZE)\n");
+    framingSource.write("            needed = " + define + "_FRAME_HEADER_SIZE - parser->received;\n");
+    framingSource.write("        else\n");
+    framingSource.write("            needed = get" + name + "PacketFrameSize(&parser->partial) - parser->received;\n");
+    framingSource.write("\n");
+    framingSource.write("        if(needed > n)\n");
+    framingSource.write("            needed = n;\n");
+    framingSource.write("\n");
+    framingSource.write("        memcpy(frame + parser->received, chunk, needed);\n");
+    framingSource.write("        parser->received += (int)needed;\n");
+    framingSource.write("\n");
+    framingSource.write("        framesize = check" + name + "Frame(frame, parser->received);\n");
+    framingSource.write("    }\n");
+    framingSource.write("\n");
+    framingSource.write("    if(framesize > 0)\n");
+    framingSource.write("    {\n");
+    framingSource.write("        parser->frames++;\n");
+    framingSource.write("        " + handle + "(&parser->partial, parser->context);\n");
+    framingSource.write("\n");
+    framingSource.write("        // Bytes left from resynchronizing can run past the frame\n");
+    framingSource.write("        parser->received -= framesize;\n");
+    framingSource.write("        if(parser->received > 0)\n");
+    framingSource.write("            memmove(frame, frame + framesize, parser->received);\n");
+    framingSource.write("    }\n");
+    framingSource.write("    else if(framesize < 0)\n");
+    framingSource.write("    {\n");
+    framingSource.write("        // Resynchronize on the bytes we already have, which is the only time they are moved\n");
+    framingSource.write("        const uint8_t* next = (const uint8_t*)memchr(frame + 1, " + syncFirst + ", parser->received - 1);\n");
+    framingSource.write("        int kept = 0;\n");
+    framingSource.write("\n");
+    framingSource.write("        if(next != NULL)\n");
+    framingSource.write("        {\n");
+    framingSource.write("            kept = parser->received - (int)(next - frame);\n");
+    framingSource.write("            memmove(frame, next, kept);\n");
+    framingSource.write("        }\n");
+    framingSource.write("\n");
+    framingSource.write("        parser->discarded += parser->received - kept;\n");
+    framingSource.write("        parser->received = kept;\n");
+    framingSource.write("    }\n");
+    framingSource.write("\n");
+    framingSource.write("    return needed;\n");
+    framingSource.write("}\n");
+    framingSource.write("\n");
+    framingSource.write("\n");
+    framingSource.write("/*!\n");
+    framingSource.write(" * Feed received bytes to a stream parser. Every frame that is completed by\n");
+    framingSource.write(" * the bytes is checked and handled before this function returns. Bytes that\n");
+    framingSource.write(" * are not part of a valid frame are skipped by searching for the first byte\n");
+    framingSource.write(" * of the synchronization word.\n");
+    framingSource.write(" * \\param parser is the parser, which must have been initialized\n");
+    framingSource.write(" * \\param chunk is the received bytes\n");
+    framingSource.write(" * \\param n is the number of bytes in chunk\n");
+    framingSource.write(" */\n");
+    framingSource.write("void feed" + name + "StreamParser(" + parserType + "* parser, const uint8_t* chunk, size_t n)\n");
+    framingSource.write("{\n");
+    framingSource.write("    size_t offset = 0;\n");
+    framingSource.write("\n");
+    framingSource.write("    while((parser->received > 0) && (offset < n))\n");
+    framingSource.write("        offset += continue" + name + "Frame(parser, chunk + offset, n - offset);\n");
+    framingSource.write("\n");
+    framingSource.write("    while(offset < n)\n");
+    framingSource.write("    {\n");
+    framingSource.write("        const uint8_t* start = chunk + offset;\n");
+    framingSource.write("        size_t size = n - offset;\n");
+    framingSource.write("        int framesize;\n");
+    framingSource.write("\n");
+    framingSource.write("        if(start[0] != " + syncFirst + ")\n");
+    framingSource.write("        {\n");
+    framingSource.write("            const uint8_t* next = (const uint8_t*)memchr(start, " + syncFirst + ", size);\n");
+    framingSource.write("\n");
+    framingSource.write("            if(next == NULL)\n");
+    framingSource.write("            {\n");
+    framingSource.write("                parser->discarded += (uint32_t)size;\n");
+    framingSource.write("                return;\n");
+    framingSource.write("            }\n");
+    framingSource.write("\n");
+    framingSource.write("            parser->discarded += (uint32_t)(next - start);\n");
+    framingSource.write("            offset += next - start;\n");
+    framingSource.write("            continue;\n");
+    framingSource.write("        }\n");
+    framingSource.write("\n");
+    framingSource.write("        // No frame is longer than the packet, so the size can be limited to an int\n");
+    framingSource.write("        if(size > sizeof(" + packetType + "))\n");
+    framingSource.write("            framesize = check" + name + "Frame(start, sizeof(" + packetType + "));\n");
+    framingSource.write("        else\n");
+    framingSource.write("            framesize = check" + name + "Frame(start, (int)size);\n");
+    framingSource.write("\n");
+    framingSource.write("        if(framesize > 0)\n");
+    framingSource.write("        {\n");
+    framingSource.write("            // The frame is handled where it is, without a copy\n");
+    framingSource.write("            parser->frames++;\n");
+    framingSource.write("            " + handle + "(start, parser->context);\n");
+    framingSource.write("            offset += framesize;\n");
+    framingSource.write("        }\n");
+    framingSource.write("        else if(framesize < 0)\n");
+    framingSource.write("        {\n");
+    framingSource.write("            parser->discarded++;\n");
+    framingSource.write("            offset++;\n");
+    framingSource.write("        }\n");
+    framingSource.write("        else\n");
+    framingSource.write("        {\n");
+    framingSource.write("            // The rest of the chunk is the start of a frame that is split\n");
+    framingSource.write("            memcpy(parser->partial.frame, start, size);\n");
+    framingSource.write("            parser->received = (int)size;\n");
+    framingSource.write("            return;\n");
+    framingSource.write("        }\n");
+    framingSource.write("    }\n");
+    framingSource.write("}\n");
+
+    framingHeader.flush();
+    framingSource.flush();
+
+}// ProtocolParser::createFramingFiles
+
+
+/*!
+ * Create the module which reads logs of framed packets in place. A log is a
+ * file of records, each of which is the 64-bit time of the record followed
+ * by the frame of one packet. The packetlog module maps the log and indexes
+ * it, this module supplies the layout of the records.
+ * \param bigendian should be true if the times and frames are big endian
+ */
+void ProtocolParser::createLogFiles(bool bigendian)
+{
+    QString module = name + "Log";
+    QString define = name.toUpper();
+    QString packetType = name + "Packet_t";
+
+    // The first byte of the synchronization word, as for the stream parser
+    uint sync = frameSync.toUInt(NULL, 0);
+    QString syncFirst = "0x" + QString().setNum(bigendian ? (sync >> 8) : (sync & 0xFF), 16).rightJustified(2, '0').toUpper();
+
+    // The index only depends on how the records are laid out, which is the
+    // synchronization word, the check, and the byte order
+    uint check = (QStringList() << "crc16" << "crc32" << "crc32c" << "fletcher16" << "fletcher32").indexOf(framing) + 1;
+    QString format = "0x" + QString().setNum((sync << 16) | (check << 8) | (bigendian ? 1 : 0), 16).rightJustified(8, '0').toUpper() + "u";
+
+    ProtocolHeaderFile logHeader;
+    ProtocolSourceFile logSource;
+
+    logHeader.setModuleName(module);
+    logSource.setModuleName(module);
+
+    logHeader.write("/*!\n");
+    logHeader.write(" * \\file\n");
+    logHeader.write(" * \\brief " + logHeader.fileName() + " reads logs of the packets of the " + name + " protocol stack\n");
+    logHeader.write(" *\n");
+    logHeader.write(outputLongComment(" *", "A log is a file of records back to back. Each record is the 8 byte time of the record, in " + QString(bigendian ? "big" : "little") + " endian byte order and in units chosen by whoever writes the log, followed by the frame of one packet as built by " + name + "Framing. The log is memory mapped and the packets are used in place, so a packet from the log can be passed straight to the decode, accessor, and batch decode functions.") + "\n");
+    logHeader.write(" *\n");
+    logHeader.write(outputLongComment(" *", "The log is indexed by packet identifier and time, and the index is cached next to the log. findPacketLogEntries() returns the range of index entries of one packet in a range of time, and get" + name + "LogPacket() returns the packet of one entry.") + "\n");
+    logHeader.write(" */\n");
+    logHeader.write("\n");
+    logHeader.writeIncludeDirective("packetlog.h");
+    logHeader.writeIncludeDirective(name + "Framing.h");
+    logHeader.write("\n");
+    logHeader.write("//! The number of bytes of a record before the frame\n");
+    logHeader.write("#define " + define + "_LOG_TIME_SIZE 8\n");
+    logHeader.write("\n");
+    logHeader.write("//! Open a log of " + name + " packets\n");
+    logHeader.write("int open" + name + "Log(packetLog_t* log, const char* path);\n");
+    logHeader.write("\n");
+    logHeader.write("//! Get the packet of an entry of the index of a log\n");
+    logHeader.write("const void* get" + name + "LogPacket(const packetLog_t* log, uint64_t entry);\n");
+    logHeader.write("\n");
+    logHeader.write("//! Get the packets of consecutive entries of the index of a log\n");
+    logHeader.write("int get" + name + "LogPackets(const packetLog_t* log, uint64_t first, int n, const void** pkts);\n");
+    logHeader.write("\n");
+    logHeader.write("//! Create the record of a packet for a log\n");
+    logHeader.write("int encode" + name + "LogRecord(uint8_t* buf, uint64_t time, const void* pkt);\n");
+
+    logSource.write("\n");
+    logSource.writeIncludeDirective("limits.h", QString(), true);
+    logSource.writeIncludeDirective("string.h", QString(), true);
+    logSource.write("\n");
+    logSource.write("//! The layout of the records, which is stored with the cached index\n");
+    logSource.write("#define " + define + "_LOG_FORMAT " + format + "\n");
+    logSource.write("\n");
+    logSource.write("/*!\n");
+    logSource.write(" * Scan the record at the start of a buffer, for the index of the log\n");
+    logSource.write(" * \\param buf is the bytes of the log, starting from the record\n");
+    logSource.write(" * \\param size is the number of bytes in buf\n");
+    logSource.write(" * \\param entry receives the time and packet identifier of the record\n");
+    logSource.write(" * \\return the number of bytes of the record if it is valid, 0 if it is not\n");
+    logSource.write(" *         complete, or the negative number of bytes to skip to the next\n");
+    logSource.write(" *         record that could be valid\n");
+    logSource.write(" */\n");
+    logSource.write("static int64_t scan" + name + "LogRecord(const uint8_t* buf, uint64_t size, packetLogEntry_t* entry)\n");
+    logSource.write("{\n");
+    logSource.write("    const uint8_t* next;\n");
+    logSource.write("    int framesize;\n");
+    logSource.write("    int i;\n");
+    logSource.write("\n");
+    logSource.write("    if(size < " + define + "_LOG_TIME_SIZE + " + define + "_FRAME_HEADER_SIZE)\n");
+    logSource.write("        return 0;\n");
+    logSource.write("\n");
+    logSource.write("    // A frame can be no larger than an int anyway\n");
+    logSource.write("    if(size - " + define + "_LOG_TIME_SIZE > INT_MAX)\n");
+    logSource.write("        framesize = check" + name + "Frame(buf + " + define + "_LOG_TIME_SIZE, INT_MAX);\n");
+    logSource.write("    else\n");
+    logSource.write("        framesize = check" + name + "Frame(buf + " + define + "_LOG_TIME_SIZE, (int)(size - " + define + "_LOG_TIME_SIZE));\n");
+    logSource.write("\n");
+    logSource.write("    if(framesize == 0)\n");
+    logSource.write("        return 0;\n");
+    logSource.write("\n");
+    logSource.write("    if(framesize < 0)\n");
+    logSource.write("    {\n");
+    logSource.write("        // The next record that could be valid has its frame at the next synchronization byte\n");
+    logSource.write("        next = (const uint8_t*)memchr(buf + " + define + "_LOG_TIME_SIZE + 1, " + syncFirst + ", (size_t)(size - " + define + "_LOG_TIME_SIZE - 1));\n");
+    logSource.write("        if(next == NULL)\n");
+    logSource.write("            return -(int64_t)size;\n");
+    logSource.write("        else\n");
+    logSource.write("            return -(int64_t)(next - buf - " + define + "_LOG_TIME_SIZE);\n");
+    logSource.write("    }\n");
+    logSource.write("\n");
+    logSource.write("    entry->time = 0;\n");
+    if(bigendian)
+    {
+        logSource.write("    for(i = 0; i < " + define + "_LOG_TIME_SIZE; i++)\n");
+        logSource.write("        entry->time = (entry->time << 8) | buf[i];\n");
+    }
+    else
+    {
+        logSource.write("    for(i = " + define + "_LOG_TIME_SIZE - 1; i >= 0; i--)\n");
+        logSource.write("        entry->time = (entry->time << 8) | buf[i];\n");
+    }
+    logSource.write("\n");
+    logSource.write("    entry->id = get" + name + "PacketID(buf + " + define + "_LOG_TIME_SIZE);\n");
+    logSource.write("    return " + define + "_LOG_TIME_SIZE + framesize;\n");
+    logSource.write("}\n");
+    logSource.write("\n");
+    logSource.write("\n");
+    logSource.write("/*!\n");
+    logSource.write(" * Open a log of " + name + " packets. See openPacketLog() for how the index\n");
+    logSource.write(" * is cached.\n");
+    logSource.write(" * \\param log receives the open log, which must be closed with closePacketLog()\n");
+    logSource.write(" * \\param path is the name of the log file\n");
+    logSource.write(" * \\return 0 if the log could not be opened, else 1\n");
+    logSource.write(" */\n");
+    logSource.write("int open" + name + "Log(packetLog_t* log, const char* path)\n");
+    logSource.write("{\n");
+    logSource.write("    return openPacketLog(log, path, scan" + name + "LogRecord, " + define + "_LOG_FORMAT);\n");
+    logSource.write("}\n");
+    logSource.write("\n");
+    logSource.write("\n");
+    logSource.write("/*!\n");
+    logSource.write(" * Get the packet of an entry of the index of a log, in place in the log\n");
+    logSource.write(" * \\param log is the open log\n");
+    logSource.write(" * \\param entry is the index of the entry, less than numEntries\n");
+    logSource.write(" * \\return the packet, which is valid until the log is closed\n");
+    logSource.write(" */\n");
+    logSource.write("const void* get" + name + "LogPacket(const packetLog_t* log, uint64_t entry)\n");
+    logSource.write("{\n");
+    logSource.write("    return log->data + log->entries[entry].offset + " + define + "_LOG_TIME_SIZE;\n");
+    logSource.write("}\n");
+    logSource.write("\n");
+    logSource.write("\n");
+    logSource.write("/*!\n");
+    logSource.write(" * Get the packets of consecutive entries of the index of a log, for example\n");
+    logSource.write(" * the entries found by findPacketLogEntries(), to pass to a batch decode\n");
+    logSource.write(" * \\param log is the open log\n");
+    logSource.write(" * \\param first is the index of the first entry\n");
+    logSource.write(" * \\param n is the number of entries\n");
+    logSource.write(" * \\param pkts receives the packets, which are valid until the log is closed\n");
+    logSource.write(" * \\return the number of packets, which is less than n at the end of the index\n");
+    logSource.write(" */\n");
+    logSource.write("int get" + name + "LogPackets(const packetLog_t* log, uint64_t first, int n, const void** pkts)\n");
+    logSource.write("{\n");
+    logSource.write("    int i;\n");
+    logSource.write("\n");
+    logSource.write("    for(i = 0; (i < n) && (first + i < log->numEntries); i++)\n");
+    logSource.write("        pkts[i] = log->data + log->entries[first + i].offset + " + define + "_LOG_TIME_SIZE;\n");
+    logSource.write("\n");
+    logSource.write("    return i;\n");
+    logSource.write("}\n");
+    logSource.write("\n");
+    logSource.write("\n");
+    logSource.write("/*!\n");
+    logSource.write(" * Create the record of a finished packet, to be appended to a log\n");
+    logSource.write(" * \\param buf receives the record, which is " + define + "_LOG_TIME_SIZE bytes more\n");
+    logSource.write(" *        than the frame of the packet\n");
+    logSource.write(" * \\param time is the time of the record\n");
+    logSource.write(" * \\param pkt points to the " + packetType + " to record\n");
+    logSource.write(" * \\return the number of bytes of the record\n");
+    logSource.write(" */\n");
+    logSource.write("int encode" + name + "LogRecord(uint8_t* buf, uint64_t time, const void* pkt)\n");
+    logSource.write("{\n");
+    logSource.write("    int framesize = get" + name + "PacketFrameSize(pkt);\n");
+    logSource.write("    int i;\n");
+    logSource.write("\n");
+    if(bigendian)
+    {
+        logSource.write("    for(i = " + define + "_LOG_TIME_SIZE - 1; i >= 0; i--, time >>= 8)\n");
+        logSource.write("        buf[i] = (uint8_t)time;\n");
+    }
+    else
+    {
+        logSource.write("    for(i = 0; i < " + define + "_LOG_TIME_SIZE; i++, time >>= 8)\n");
+        logSource.write("        buf[i] = (uint8_t)time;\n");
+    }
+    logSource.write("\n");
+    logSource.write("    memcpy(buf + " + define + "_LOG_TIME_SIZE, ((const " + packetType + "*)pkt)->frame, framesize);\n");
+    logSource.write("    return " + define + "_LOG_TIME_SIZE + framesize;\n");
+    logSource.write("}\n");
+
+    logHeader.flush();
+    logSource.flush();
+
+}// ProtocolParser::createLogFiles
+
+
+/*!
+ * Create the module which implements the trace hooks of the packet functions
+ * with counters for each packet identifier. This must be called after the
+ * packets are parsed, so their identifiers are known.
+ */
+void ProtocolParser::createTraceFiles(void)
+{
+    QString module = name + "Trace";
+    QString define = name.toUpper();
+    QString countersType = name + "TraceCounters_t";
+    QString lineType = name + "TraceLine_t";
+
+    // Each identifier has its own counters if the identifiers are small enough
+    qulonglong maxId = 0;
+    bool knownIds = !packets.isEmpty();
+    for(int i = 0; i < packets.size(); i++)
+    {
+        qulonglong value = 0;
+
+        if(getPacketIdValue(packets.at(i)->getId(), &value))
+            maxId = qMax(maxId, value);
+        else
+            knownIds = false;
+    }
+
+    QString ids = "256";
+    if(knownIds && (maxId < 65536))
+        ids.setNum(maxId + 1);
+
+    ProtocolHeaderFile traceHeader;
+    ProtocolSourceFile traceSource;
+
+    traceHeader.setModuleName(module);
+    traceSource.setModuleName(module);
+
+    traceHeader.write("/*!\n");
+    traceHeader.write(" * \\file\n");
+    traceHeader.write(" * \\brief " + traceHeader.fileName() + " counts the packets of the " + name + " protocol stack\n");
+    traceHeader.write(" *\n");
+    traceHeader.write(outputLongComment(" *", "The trace hooks of the packet functions are defined here to count, for each packet identifier, the packets that are encoded and decoded, their bytes, and the packets that are rejected for their identifier or their length. The counters of each identifier are padded to a cache line, so threads that work on different packets do not contend for a line, and they are updated with relaxed atomic adds where the compiler supports them.") + "\n");
+    traceHeader.write(" *\n");
+    traceHeader.write(outputLongComment(" *", "If " + define + "_TRACE_CYCLES is defined, as an expression that reads a cycle counter (for example __rdtsc()), the cycles spent in the encode and decode functions are counted as well.") + "\n");
+    traceHeader.write(" */\n");
+    traceHeader.write("\n");
+    traceHeader.writeIncludeDirective("stdint.h", QString(), true);
+    traceHeader.write("\n");
+    if(knownIds && (maxId < 65536))
+        traceHeader.write("// One more than the largest packet identifier, larger identifiers share the last counters\n");
+    else
+        traceHeader.write("// The packet identifiers could not all be resolved, larger identifiers share the last counters\n");
+    traceHeader.write("#ifndef " + define + "_TRACE_IDS\n");
+    traceHeader.write("#define " + define + "_TRACE_IDS " + ids + "\n");
+    traceHeader.write("#endif\n");
+    traceHeader.write("\n");
+    traceHeader.write("// The size of a cache line, define this before including this file to change it\n");
+    traceHeader.write("#ifndef " + define + "_TRACE_LINE_SIZE\n");
+    traceHeader.write("#define " + define + "_TRACE_LINE_SIZE 64\n");
+    traceHeader.write("#endif\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! The counters of one packet identifier\n");
+    traceHeader.write("typedef struct\n");
+    traceHeader.write("{\n");
+    traceHeader.write("    uint64_t encodes;        //!< The number of packets encoded\n");
+    traceHeader.write("    uint64_t encodedBytes;   //!< The number of bytes of packet data encoded\n");
+    traceHeader.write("    uint64_t encodeCycles;   //!< The cycles spent encoding, if " + define + "_TRACE_CYCLES is defined\n");
+    traceHeader.write("    uint64_t decodes;        //!< The number of packets decoded\n");
+    traceHeader.write("    uint64_t decodedBytes;   //!< The number of bytes of packet data decoded\n");
+    traceHeader.write("    uint64_t decodeCycles;   //!< The cycles spent decoding, if " + define + "_TRACE_CYCLES is defined\n");
+    traceHeader.write("    uint64_t rejectedId;     //!< The number of packets rejected because their identifier was wrong\n");
+    traceHeader.write("    uint64_t rejectedLength; //!< The number of packets rejected because they were too short\n");
+    traceHeader.write("}" + countersType + ";\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! The counters of one packet identifier, padded to a cache line\n");
+    traceHeader.write("typedef union\n");
+    traceHeader.write("{\n");
+    traceHeader.write("    " + countersType + " counters; //!< The counters\n");
+    traceHeader.write("    uint8_t line[" + define + "_TRACE_LINE_SIZE]; //!< The padding\n");
+    traceHeader.write("}" + lineType + ";\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! Count a packet that was encoded\n");
+    traceHeader.write("void trace" + name + "Encode(uint32_t id, int length, uint64_t cycles);\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! Count a packet that was decoded\n");
+    traceHeader.write("void trace" + name + "Decode(uint32_t id, int length, uint64_t cycles);\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! Count a packet that was rejected by a decode function\n");
+    traceHeader.write("void trace" + name + "Reject(uint32_t id, int reason);\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! Get the counters of a packet identifier\n");
+    traceHeader.write("const " + countersType + "* get" + name + "TraceCounters(uint32_t id);\n");
+    traceHeader.write("\n");
+    traceHeader.write("//! Set all the counters to zero\n");
+    traceHeader.write("void clear" + name + "TraceCounters(void);\n");
+    traceHeader.write("\n");
+    traceHeader.write("// The hooks of the packet functions. The begin hook declares the start time,\n");
+    traceHeader.write("// and is the last declaration of the function\n");
+    traceHeader.write("#ifdef " + define + "_TRACE_CYCLES\n");
+    traceHeader.write("#define " + define + "_TRACE_ENCODE_BEGIN(id) uint64_t traceStart = " + define + "_TRACE_CYCLES\n");
+    traceHeader.write("#define " + define + "_TRACE_ENCODE_END(id, len) trace" + name + "Encode((id), (len), " + define + "_TRACE_CYCLES - traceStart)\n");
+    traceHeader.write("#define " + define + "_TRACE_DECODE_BEGIN(id) uint64_t traceStart = " + define + "_TRACE_CYCLES\n");
+    traceHeader.write("#define " + define + "_TRACE_DECODE_END(id, len) trace" + name + "Decode((id), (len), " + define + "_TRACE_CYCLES - traceStart)\n");
+    traceHeader.write("#else\n");
+    traceHeader.write("#define " + define + "_TRACE_ENCODE_BEGIN(id)\n");
+    traceHeader.write("#define " + define + "_TRACE_ENCODE_END(id, len) trace" + name + "Encode((id), (len), 0)\n");
+    traceHeader.write("#define " + define + "_TRACE_DECODE_BEGIN(id)\n");
+    traceHeader.write("#define " + define + "_TRACE_DECODE_END(id, len) trace" + name + "Decode((id), (len), 0)\n");
+    traceHeader.write("#endif\n");
+    traceHeader.write("#define " + define + "_TRACE_DECODE_REJECT(id, len, reason) trace" + name + "Reject((id), (reason))\n");
+
+    traceSource.write("\n");
+    traceSource.writeIncludeDirective(name + "Protocol.h");
+    traceSource.writeIncludeDirective("string.h", QString(), true);
+    traceSource.write("\n");
+    traceSource.write("// Counters can be updated from many threads at once\n");
+    traceSource.write("#if defined(__GNUC__)\n");
+    traceSource.write("#define TRACE_ADD(counter, value) __atomic_fetch_add(&(counter), (value), __ATOMIC_RELAXED)\n");
+    traceSource.write("#else\n");
+    traceSource.write("#define TRACE_ADD(counter, value) ((counter) += (value))\n");
+    traceSource.write("#endif\n");
+    traceSource.write("\n");
+    traceSource.write("//! The counters of each packet identifier, starting on a cache line\n");
+    traceSource.write("#if defined(__GNUC__)\n");
+    traceSource.write("static " + lineType + " traceLines[" + define + "_TRACE_IDS + 1] __attribute__((aligned(" + define + "_TRACE_LINE_SIZE)));\n");
+    traceSource.write("#elif defined(_MSC_VER)\n");
+    traceSource.write("static __declspec(align(" + define + "_TRACE_LINE_SIZE)) " + lineType + " traceLines[" + define + "_TRACE_IDS + 1];\n");
+    traceSource.write("#else\n");
+    traceSource.write("static " + lineType + " traceLines[" + define + "_TRACE_IDS + 1];\n");
+    traceSource.write("#endif\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * \\param id is the packet identifier\n");
+    traceSource.write(" * \\return the counters of the identifier\n");
+    traceSource.write(" */\n");
+    traceSource.write("static " + countersType + "* getTraceLine(uint32_t id)\n");
+    traceSource.write("{\n");
+    traceSource.write("    if(id < " + define + "_TRACE_IDS)\n");
+    traceSource.write("        return &traceLines[id].counters;\n");
+    traceSource.write("    else\n");
+    traceSource.write("        return &traceLines[" + define + "_TRACE_IDS].counters;\n");
+    traceSource.write("}\n");
+    traceSource.write("\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * Count a packet that was encoded\n");
+    traceSource.write(" * \\param id is the packet identifier\n");
+    traceSource.write(" * \\param length is the number of bytes of packet data\n");
+    traceSource.write(" * \\param cycles is the number of cycles spent encoding\n");
+    traceSource.write(" */\n");
+    traceSource.write("void trace" + name + "Encode(uint32_t id, int length, uint64_t cycles)\n");
+    traceSource.write("{\n");
+    traceSource.write("    " + countersType + "* counters = getTraceLine(id);\n");
+    traceSource.write("\n");
+    traceSource.write("    TRACE_ADD(counters->encodes, 1);\n");
+    traceSource.write("    TRACE_ADD(counters->encodedBytes, (uint64_t)length);\n");
+    traceSource.write("    if(cycles != 0)\n");
+    traceSource.write("        TRACE_ADD(counters->encodeCycles, cycles);\n");
+    traceSource.write("}\n");
+    traceSource.write("\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * Count a packet that was decoded\n");
+    traceSource.write(" * \\param id is the packet identifier\n");
+    traceSource.write(" * \\param length is the number of bytes of packet data\n");
+    traceSource.write(" * \\param cycles is the number of cycles spent decoding\n");
+    traceSource.write(" */\n");
+    traceSource.write("void trace" + name + "Decode(uint32_t id, int length, uint64_t cycles)\n");
+    traceSource.write("{\n");
+    traceSource.write("    " + countersType + "* counters = getTraceLine(id);\n");
+    traceSource.write("\n");
+    traceSource.write("    TRACE_ADD(counters->decodes, 1);\n");
+    traceSource.write("    TRACE_ADD(counters->decodedBytes, (uint64_t)length);\n");
+    traceSource.write("    if(cycles != 0)\n");
+    traceSource.write("        TRACE_ADD(counters->decodeCycles, cycles);\n");
+    traceSource.write("}\n");
+    traceSource.write("\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * Count a packet that was rejected by a decode function\n");
+    traceSource.write(" * \\param id is the identifier of the packet the decode function is for\n");
+    traceSource.write(" * \\param reason is " + define + "_TRACE_REJECT_ID or " + define + "_TRACE_REJECT_LENGTH\n");
+    traceSource.write(" */\n");
+    traceSource.write("void trace" + name + "Reject(uint32_t id, int reason)\n");
+    traceSource.write("{\n");
+    traceSource.write("    " + countersType + "* counters = getTraceLine(id);\n");
+    traceSource.write("\n");
+    traceSource.write("    if(reason == " + define + "_TRACE_REJECT_ID)\n");
+    traceSource.write("        TRACE_ADD(counters->rejectedId, 1);\n");
+    traceSource.write("    else\n");
+    traceSource.write("        TRACE_ADD(counters->rejectedLength, 1);\n");
+    traceSource.write("}\n");
+    traceSource.write("\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * Get the counters of a packet identifier. The counters can change while\n");
+    traceSource.write(" * they are read, if other threads are using the packet functions.\n");
+    traceSource.write(" * \\param id is the packet identifier\n");
+    traceSource.write(" * \\return the counters, which are shared by all identifiers of " + define + "_TRACE_IDS\n");
+    traceSource.write(" *         or more\n");
+    traceSource.write(" */\n");
+    traceSource.write("const " + countersType + "* get" + name + "TraceCounters(uint32_t id)\n");
+    traceSource.write("{\n");
+    traceSource.write("    return getTraceLine(id);\n");
+    traceSource.write("}\n");
+    traceSource.write("\n");
+    traceSource.write("\n");
+    traceSource.write("/*!\n");
+    traceSource.write(" * Set all the counters to zero. This is not atomic, so counts from other\n");
+    traceSource.write(" * threads at the same time can be lost.\n");
+    traceSource.write(" */\n");
+    traceSource.write("void clear" + name + "TraceCounters(void)\n");
+    traceSource.write("{\n");
+    traceSource.write("    memset(traceLines, 0, sizeof(traceLines));\n");
+    traceSource.write("}\n");
+
+    traceHeader.flush();
+    traceSource.flush();
+
+}// ProtocolParser::createTraceFiles
+
+
 /*!
  * Output a long string of text which should be wrapped at 80 characters.
  * \param file receives the output
@@ -550,16 +2292,11 @@ QList<QDomNode> ProtocolParser::childElementsByTagName(const QDomNode& node, QSt
 {
     QList<QDomNode> list;
 
-    // All the direct children
-    QDomNodeList children = node.childNodes();
-
-    // Now remove any whose tag is wrong
-    for (int i = 0; i < children.size(); ++i)
+    // Walk the direct children, keeping those whose tag is right
+    for(QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling())
     {
-        if(children.item(i).nodeName().contains(tag, Qt::CaseInsensitive))
-        {
-            list.append(children.item(i));
-        }
+        if(child.nodeName().contains(tag, Qt::CaseInsensitive))
+            list.append(child);
     }
 
     return list;
@@ -598,8 +2335,18 @@ const EnumCreator* ProtocolParser::parseEnumeration(const QDomElement& element)
     EnumCreator* Enum = new EnumCreator(element);
 
     if(!Enum->getOutput().isEmpty())
+    {
         enums.append(Enum);
 
+        // The first definition of a name is the one that is found
+        if(enumSymbols.contains(Enum->getName()))
+            std::cout << Enum->getName().toStdString() << ": duplicate definition of enumeration, the first definition is used" << std::endl;
+        else
+            enumSymbols.insert(Enum->getName(), Enum);
+
+        Enum->addEnumeratorValues(enumeratorSymbols);
+    }
+
     return Enum;
 
 }// ProtocolParser::parseEnumeration
@@ -646,6 +2393,24 @@ void ProtocolParser::outputIncludes(ProtocolFile& file, const QDomNode& node)
 }// ProtocolParser::outputIncludes
 
 
+/*!
+ * Add a structure or packet to the symbol table which is used to look up
+ * type names. If the type name is already defined the first definition is
+ * kept, since structures are parsed before packets this gives structures
+ * precedence.
+ * \param module is the structure or packet to add
+ * \param kind describes the module for the duplicate warning
+ */
+void ProtocolParser::addStructureSymbol(ProtocolStructureModule* module, const QString& kind)
+{
+    if(structureSymbols.contains(module->typeName))
+        std::cout << module->name.toStdString() << ": " << kind.toStdString() << " type " << module->typeName.toStdString() << " duplicates an earlier definition, the first definition is used" << std::endl;
+    else
+        structureSymbols.insert(module->typeName, module);
+
+}// ProtocolParser::addStructureSymbol
+
+
 /*!
  * Find the include name for a specific global structure type
  * \param typeName is the type to lookup
@@ -653,21 +2418,10 @@ void ProtocolParser::outputIncludes(ProtocolFile& file, const QDomNode& node)
  */
 QString ProtocolParser::lookUpIncludeName(const QString& typeName)
 {
-    for(int i = 0; i < structures.size(); i++)
-    {
-        if(structures.at(i)->typeName == typeName)
-        {
-            return structures.at(i)->getHeaderFileName();
-        }
-    }
+    const ProtocolStructureModule* module = structureSymbols.value(typeName, NULL);
 
-    for(int i = 0; i < packets.size(); i++)
-    {
-        if(packets.at(i)->typeName == typeName)
-        {
-            return packets.at(i)->getHeaderFileName();
-        }
-    }
+    if(module != NULL)
+        return module->getHeaderFileName();
 
     return "";
 }
@@ -680,24 +2434,7 @@ QString ProtocolParser::lookUpIncludeName(const QString& typeName)
  */
 const ProtocolStructure* ProtocolParser::lookUpStructure(const QString& typeName)
 {
-    for(int i = 0; i < structures.size(); i++)
-    {
-        if(structures[i]->typeName == typeName)
-        {
-            return structures[i];
-        }
-    }
-
-
-    for(int i = 0; i < packets.size(); i++)
-    {
-        if(packets[i]->typeName == typeName)
-        {
-            return packets[i];
-        }
-    }
-
-    return NULL;
+    return structureSymbols.value(typeName, NULL);
 }
 
 
@@ -708,34 +2445,88 @@ const ProtocolStructure* ProtocolParser::lookUpStructure(const QString& typeName
  */
 const EnumCreator* ProtocolParser::lookUpEnumeration(const QString& enumName)
 {
-    for(int i = 0; i < enums.size(); i++)
-    {
-        if(enums.at(i)->getName() == enumName)
-        {
-            return enums.at(i);
-        }
-    }
-
-    return 0;
+    return enumSymbols.value(enumName, NULL);
 }
 
 
 /*!
- * Replace any text that matches an enumeration name with the value of that enumeration
+ * Replace any text that matches an enumeration name with the value of that
+ * enumeration. Names are matched as whole identifiers, using the symbol table
+ * of enumerators that is built as enumerations are parsed.
  * \param text is modified to replace names with numbers
+ * \param group should be true to put each value in parentheses, so that a
+ *        value like "1<<3" keeps its meaning as part of a larger expression
  * \return a reference to text
  */
-QString& ProtocolParser::replaceEnumerationNameWithValue(QString& text)
+QString& ProtocolParser::replaceEnumerationNameWithValue(QString& text, bool group)
 {
-    for(int i = 0; i < enums.size(); i++)
+    if(enumeratorSymbols.isEmpty())
+        return text;
+
+    QString output;
+    bool replaced = false;
+    int i = 0;
+
+    // A single pass over the identifiers in the text, so that a name is
+    // never matched as part of a longer identifier
+    while(i < text.size())
     {
-        enums.at(i)->replaceEnumerationNameWithValue(text);
+        QChar first = text.at(i);
+
+        if(!first.isLetterOrNumber() && (first != '_'))
+        {
+            output += first;
+            i++;
+            continue;
+        }
+
+        int start = i;
+        while((i < text.size()) && (text.at(i).isLetterOrNumber() || (text.at(i) == '_')))
+            i++;
+
+        QString token = text.mid(start, i - start);
+
+        // Tokens that start with a digit, like 0x1F, are numbers not names
+        QHash<QString, QString>::const_iterator symbol = enumeratorSymbols.constEnd();
+        if(!first.isDigit())
+            symbol = enumeratorSymbols.constFind(token);
+
+        if(symbol != enumeratorSymbols.constEnd())
+        {
+            if(group)
+                output += "(" + symbol.value() + ")";
+            else
+                output += symbol.value();
+            replaced = true;
+        }
+        else
+            output += token;
     }
 
+    if(replaced)
+        text = output;
+
     return text;
 }
 
 
+/*!
+ * Get a length with enumeration names replaced by their values, folded as
+ * far as possible. A length made only of numbers and enumerations becomes a
+ * single number.
+ * \param length is the length expression
+ * \return the folded length, which is "0" if length is empty
+ */
+QString ProtocolParser::getResolvedLength(const QString& length)
+{
+    QString resolved = length;
+
+    replaceEnumerationNameWithValue(resolved, true);
+
+    return EncodedLength::collapseLengthString(resolved, true);
+}
+
+
 /*!
  * Get details needed to produce documentation for a global encodable. The top level details are ommitted.
  * \param typeName identifies the type of the global encodable.
@@ -749,28 +2540,17 @@ QString& ProtocolParser::replaceEnumerationNameWithValue(QString& text)
  */
 void ProtocolParser::getStructureSubDocumentationDetails(QString typeName, QList<int>& outline, QString& startByte, QStringList& bytes, QStringList& names, QStringList& encodings, QStringList& repeats, QStringList& comments)
 {
-    for(int i = 0; i < structures.size(); i++)
-    {
-        if(structures[i]->typeName == typeName)
-        {
-            return structures[i]->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
-        }
-    }
-
+    const ProtocolStructureModule* module = structureSymbols.value(typeName, NULL);
 
-    for(int i = 0; i < packets.size(); i++)
-    {
-        if(packets[i]->typeName == typeName)
-        {
-            return packets[i]->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
-        }
-    }
+    if(module != NULL)
+        module->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
 
 }
 
 
 /*!
- * Ouptut documentation for the protocol as a markdown file
+ * Ouptut documentation for the protocol as a markdown file, and the style
+ * sheet that goes with it. This only needs the parsed packets and structures.
  */
 void ProtocolParser::outputMarkdown(bool isBigEndian)
 {
@@ -829,7 +2609,7 @@ doxygen product, parsing comments embedded in the automatically generated code.\
     file.write("# " + QString().setNum(paragraph1) + "." + QString().setNum(paragraph2++) + ") Encodings\n");
     file.write("\n");
 
-    file.write("Data can be encoded as unsigned integers, signed integers (two's complement), bitfields, and floating point.\n");
+    file.write("Data can be encoded as unsigned integers, signed integers (two's complement), variable length integers, bitfields, and floating point.\n");
     file.write("\n");
 
     file.write("\
@@ -838,6 +2618,8 @@ doxygen product, parsing comments embedded in the automatically generated code.\
 | UX                           | Unsigned integer X bits long          | X must be: 8, 16, 24, 32, 40, 48, 56, or 64                                 |\n\
 | IX                           | Signed integer X bits long            | X must be: 8, 16, 24, 32, 40, 48, 56, or 64                                 |\n\
 | BX                           | Unsigned integer bitfield X bits long | X must be greater than 0 and less than 32                                   |\n\
+| VUX                          | Unsigned variable length integer      | Up to X bits, 7 per byte, least significant first, top bit set if more      |\n\
+| VIX                          | Signed variable length integer        | Zigzag mapped (0, -1, 1, -2 become 0, 1, 2, 3), then encoded as VUX         |\n\
 | F16                          | 16 bit floating point                 | 1 sign bit : 6 exponent bits : 9 significant bits with implied leading 1    |\n\
 | F24                          | 24 bit floating point                 | 1 sign bit : 8 exponent bits : 15 significant bits with implied leading 1   |\n\
 | F32                          | 32 bit floating point (IEEE-754)      | 1 sign bit : 8 exponent bits : 23 significant bits with implied leading 1   |\n\
@@ -947,12 +2729,6 @@ may be repeating information already presented in the packets section\n"));
 
     file.flush();
 
-    QProcess process;
-    QStringList arguments;
-
-    // Tell the QProcess to send stdout to a file, since that's how the script outputs its data
-    process.setStandardOutputFile(QString(name + ".html"));
-
     // Delete the old file
     ProtocolFile::deleteFile(QString(name + ".css"));
 
@@ -962,19 +2738,11 @@ may be repeating information already presented in the packets section\n"));
     // Make it writable (so we can edit it later)
     ProtocolFile::makeFileWritable(QString(name + ".css"));
 
-    arguments << fileName;      // The name of the source file
-    #if defined(__APPLE__) && defined(__MACH__)
-    process.start(QString("/usr/local/bin/MultiMarkdown"), arguments);
-    #else
-    process.start(QString("multimarkdown"), arguments);
-    #endif
-    process.waitForFinished();
-
 }
 
 
 /*!
- * Output the doxygen HTML documentation
+ * Output the configuration files for the doxygen HTML documentation
  */
 void ProtocolParser::outputDoxygen(void)
 {
@@ -995,21 +2763,7 @@ void ProtocolParser::outputDoxygen(void)
     // This is where the files are stored in the resources
     QString sourcePath = ":/files/prebuiltSources/";
 
-    // Copy it to our working directory
+    // Copy it to our working directory. These files are deleted once doxygen
+    // has finished with them
     QFile::copy(sourcePath + "Doxyfile", "Doxyfile");
-
-    // Launch the process
-    QProcess process;
-
-    // On the mac doxygen is a utility inside the Doxygen.app bundle.
-    #if defined(__APPLE__) && defined(__MACH__)
-    process.start(QString("/Applications/Doxygen.app/Contents/Resources/doxygen"), QStringList("Doxyfile"));
-    #else
-    process.start(QString("doxygen"), QStringList("Doxyfile"));
-    #endif
-    process.waitForFinished();
-
-    // Delete our temporary files
-    ProtocolFile::deleteFile("Doxyfile");
-    ProtocolFile::deleteFile(fileName);
 }
@@ -4,10 +4,12 @@
 #include <QDomDocument>
 #include <QFile>
 #include <QList>
+#include <QHash>
 #include "protocolfile.h"
 #include "protocolstructuremodule.h"
 #include "protocolpacket.h"
 #include "enumcreator.h"
+#include "protocolxmlreader.h"
 
 class ProtocolParser
 {
@@ -16,7 +18,10 @@ public:
     ~ProtocolParser();
 
     //! Parse the DOM from the xml file. This kicks off the auto code generation for the protocol
-    bool parse(const QDomDocument& doc, bool nodoxygen = false, bool nomarkdown = false, bool nohelperfiles = false);
+    bool parse(const QDomDocument& doc, bool nodoxygen = false, bool nomarkdown = false, bool nohelperfiles = false, bool detachdocs = false, bool cpp = false);
+
+    //! Parse the protocol from the xml reader, which may stream the xml file
+    bool parse(ProtocolXmlReader& reader, bool nodoxygen = false, bool nomarkdown = false, bool nohelperfiles = false, bool detachdocs = false, bool cpp = false);
 
     //! Return a list of QDomNodes that are direct children and have a specific tag
     static QList<QDomNode> childElementsByTagName(const QDomNode& node, QString tag);
@@ -49,7 +54,10 @@ public:
     static const EnumCreator* lookUpEnumeration(const QString& enumName);
 
     //! Replace any text that matches an enumeration name with the value of that enumeration
-    static QString& replaceEnumerationNameWithValue(QString& text);
+    static QString& replaceEnumerationNameWithValue(QString& text, bool group = false);
+
+    //! Get a length with enumeration names replaced by their values
+    static QString getResolvedLength(const QString& length);
 
     //! Find the global structure point for a specific type
     static const ProtocolStructure* lookUpStructure(const QString& typeName);
@@ -74,26 +82,67 @@ protected:
     //! Create markdown documentation
     void outputMarkdown(bool isBigEndian);
 
-    //! Output the doxygen HTML documentation
+    //! Output the configuration files for the doxygen HTML documentation
     void outputDoxygen(void);
 
     ProtocolHeaderFile header;   //!< The header file (*.h)
+    ProtocolCppHeaderFile cppHeader;//!< The header-only C++ file (*.hpp)
     QString name;   //!< Base name of the protocol
     QString prefix; //!< Naming prefix
     QString comment;//!< Comment description of the protocol
     QString version;//!< The version string
     QString api;    //!< The protocol API enumeration
+    QString framing;//!< The check of the packet frames, empty if packets are not framed
+    QString frameSync;//!< The synchronization word at the start of each frame
+    bool logReader; //!< True if the reader of logs of framed packets is output
+    bool traceCounters;//!< True if the trace hooks of the packet functions are implemented with counters
 
     static QList<ProtocolStructureModule*> structures;
     static QList<ProtocolPacket*> packets;
     static QList<EnumCreator*> enums;
     static QList<EnumCreator*> globalEnums;
 
+    //! Structures and packets by type name, for fast lookup
+    static QHash<QString, ProtocolStructureModule*> structureSymbols;
+
+    //! Enumerations by name, for fast lookup
+    static QHash<QString, EnumCreator*> enumSymbols;
+
+    //! Enumerator values by enumerator name, for name replacement
+    static QHash<QString, QString> enumeratorSymbols;
+
 private:
 
+    //! Add a structure or packet to the symbol table
+    static void addStructureSymbol(ProtocolStructureModule* module, const QString& kind);
+
+    //! Generate the files for modules that share the same files
+    static void generateModules(QList<ProtocolStructureModule*>& group);
+
     //! Create the source and header files for the top level module of the protocol
     bool createProtocolFiles(const QDomElement& docElem);
 
+    //! Create the header for the top level module of the header-only C++ output
+    void createCppProtocolFile(const QDomElement& docElem);
+
+    //! Create the source and header files that dispatch received packets
+    bool createDispatchFiles(void);
+
+    //! Create the source and header files that separate batches of packets
+    void createBatchFiles(bool bigendian);
+
+    //! Create the source and header files that frame packets with a synchronization word and check
+    void createFramingFiles(bool bigendian, bool dispatch);
+
+    //! Create the source and header files that read logs of framed packets
+    void createLogFiles(bool bigendian);
+
+    //! Create the source and header files that count packets with the trace hooks
+    void createTraceFiles(void);
+
+    //! Get the numeric value of a packet identifier
+    static bool getPacketIdValue(QString id, qulonglong* value);
+
 };
 
 #endif // PROTOCOLPARSER_H
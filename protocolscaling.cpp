@@ -43,6 +43,25 @@ bool ProtocolScaling::generate(void)
 }
 
 
+/*!
+ * Determine if a helper function is output. If the protocol asks for minimal
+ * helpers only the functions that the generated code calls are output.
+ * \param signature is the signature of the function, or just its name
+ * \return true if the function should be output
+ */
+bool ProtocolScaling::isCalled(const QString& signature) const
+{
+    if(!support.minimalHelpers)
+        return true;
+
+    // The name is the last word before the argument list
+    QString name = signature.left(signature.indexOf('(')).trimmed();
+
+    return ProtocolFile::isHelperCalled(name.mid(name.lastIndexOf(' ') + 1));
+
+}// ProtocolScaling::isCalled
+
+
 /*!
  * Generate the header file for protocols caling
  * \return true if the file is generated.
@@ -99,6 +118,10 @@ bool ProtocolScaling::generateEncodeHeader(void)
 
     header.write("\n#include <stdint.h>\n");
 
+    // Inline functions need the field encoding functions
+    if(support.inlineHelpers)
+        header.write("#include \"fieldencode.h\"\n");
+
     for(int type = 0; type < typeNames.size(); type++)
     {
         for(int length = 1; length <= typeSizes[type]; length++)
@@ -108,29 +131,29 @@ bool ProtocolScaling::generateEncodeHeader(void)
                 continue;
 
             // big endian unsigned
-            header.write("\n");
-            header.write("//! " + briefEncodeComment(type, length, true, true) + "\n");
-            header.write(encodeSignature(type, length, true, true) + ";\n");
+            header.write(getEncodeDeclaration(type, length, true, true));
+            if(support.arrayHelpers)
+                header.write(getEncodeArrayDeclaration(type, length, true, true));
 
             // little endian unsigned
             if(length != 1)
             {
-                header.write("\n");
-                header.write("//! " + briefEncodeComment(type, length, false, true) + "\n");
-                header.write(encodeSignature(type, length, false, true) + ";\n");
+                header.write(getEncodeDeclaration(type, length, false, true));
+                if(support.arrayHelpers)
+                    header.write(getEncodeArrayDeclaration(type, length, false, true));
             }
 
             // big endian signed
-            header.write("\n");
-            header.write("//! " + briefEncodeComment(type, length, true, false) + "\n");
-            header.write(encodeSignature(type, length, true, false) + ";\n");
+            header.write(getEncodeDeclaration(type, length, true, false));
+            if(support.arrayHelpers)
+                header.write(getEncodeArrayDeclaration(type, length, true, false));
 
             // little endian signed
             if(length != 1)
             {
-                header.write("\n");
-                header.write("//! " + briefEncodeComment(type, length, false, false) + "\n");
-                header.write(encodeSignature(type, length, false, false) + ";\n");
+                header.write(getEncodeDeclaration(type, length, false, false));
+                if(support.arrayHelpers)
+                    header.write(getEncodeArrayDeclaration(type, length, false, false));
             }
 
         }// for all output byte counts
@@ -160,7 +183,8 @@ bool ProtocolScaling::generateEncodeSource(void)
     source.write("#include \"fieldencode.h\"\n");
     source.write("\n");
 
-    for(int type = 0; type < typeNames.size(); type++)
+    // Inline functions are in the header
+    for(int type = 0; (type < typeNames.size()) && !support.inlineHelpers; type++)
     {
         for(int length = 1; length <= typeSizes[type]; length++)
         {
@@ -169,30 +193,70 @@ bool ProtocolScaling::generateEncodeSource(void)
                 continue;
 
             // big endian unsigned
-            source.write("\n");
-            source.write(fullEncodeComment(type, length, true, true) + "\n");
-            source.write(fullEncodeFunction(type, length, true, true) + "\n");
+            if(isCalled(encodeSignature(type, length, true, true)))
+            {
+                source.write("\n");
+                source.write(fullEncodeComment(type, length, true, true) + "\n");
+                source.write(fullEncodeFunction(type, length, true, true) + "\n");
+            }
+
+            if(support.arrayHelpers && isCalled(encodeArraySignature(type, length, true, true)))
+            {
+                source.write("\n");
+                source.write(fullEncodeArrayComment(type, length, true, true) + "\n");
+                source.write(fullEncodeArrayFunction(type, length, true, true) + "\n");
+            }
 
             // little endian unsigned
             if(length != 1)
             {
-                source.write("\n");
-                source.write(fullEncodeComment(type, length, false, true) + "\n");
-                source.write(fullEncodeFunction(type, length, false, true) + "\n");
+                if(isCalled(encodeSignature(type, length, false, true)))
+                {
+                    source.write("\n");
+                    source.write(fullEncodeComment(type, length, false, true) + "\n");
+                    source.write(fullEncodeFunction(type, length, false, true) + "\n");
+                }
+
+                if(support.arrayHelpers && isCalled(encodeArraySignature(type, length, false, true)))
+                {
+                    source.write("\n");
+                    source.write(fullEncodeArrayComment(type, length, false, true) + "\n");
+                    source.write(fullEncodeArrayFunction(type, length, false, true) + "\n");
+                }
             }
 
             // big endian signed
-            source.write("\n");
-            source.write(fullEncodeComment(type, length, true, false) + "\n");
-            source.write(fullEncodeFunction(type, length, true, false) + "\n");
+            if(isCalled(encodeSignature(type, length, true, false)))
+            {
+                source.write("\n");
+                source.write(fullEncodeComment(type, length, true, false) + "\n");
+                source.write(fullEncodeFunction(type, length, true, false) + "\n");
+            }
+
+            if(support.arrayHelpers && isCalled(encodeArraySignature(type, length, true, false)))
+            {
+                source.write("\n");
+                source.write(fullEncodeArrayComment(type, length, true, false) + "\n");
+                source.write(fullEncodeArrayFunction(type, length, true, false) + "\n");
+            }
 
 
             // little endian signed
             if(length != 1)
             {
-                source.write("\n");
-                source.write(fullEncodeComment(type, length, false, false) + "\n");
-                source.write(fullEncodeFunction(type, length, false, false) + "\n");
+                if(isCalled(encodeSignature(type, length, false, false)))
+                {
+                    source.write("\n");
+                    source.write(fullEncodeComment(type, length, false, false) + "\n");
+                    source.write(fullEncodeFunction(type, length, false, false) + "\n");
+                }
+
+                if(support.arrayHelpers && isCalled(encodeArraySignature(type, length, false, false)))
+                {
+                    source.write("\n");
+                    source.write(fullEncodeArrayComment(type, length, false, false) + "\n");
+                    source.write(fullEncodeArrayFunction(type, length, false, false) + "\n");
+                }
             }
 
         }// for all output byte counts
@@ -339,6 +403,29 @@ QString ProtocolScaling::encodeSignature(int type, int length, bool bigendian, b
 }// ProtocolScaling::encodeSignature
 
 
+/*!
+ * Get the declaration of an encode function for the header file. This is
+ * either the prototype, or the entire static inline function.
+ * \param type is the enumerator for the functions input type.
+ * \param length is the number of bytes in the encoded format.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \param Unsigned should be true if the function outputs unsigned bytes.
+ * \return The declaration, with a leading linefeed, or empty if the function
+ *         is not called
+ */
+QString ProtocolScaling::getEncodeDeclaration(int type, int length, bool bigendian, bool Unsigned)
+{
+    if(!isCalled(encodeSignature(type, length, bigendian, Unsigned)))
+        return QString();
+
+    if(support.inlineHelpers)
+        return "\n" + fullEncodeComment(type, length, bigendian, Unsigned) + "\nstatic inline " + fullEncodeFunction(type, length, bigendian, Unsigned);
+    else
+        return "\n//! " + briefEncodeComment(type, length, bigendian, Unsigned) + "\n" + encodeSignature(type, length, bigendian, Unsigned) + ";\n";
+
+}// ProtocolScaling::getEncodeDeclaration
+
+
 /*!
  * Generate the full function output, excluding the comment
  * \param type is the input type to be encoded.
@@ -363,29 +450,7 @@ QString ProtocolScaling::fullEncodeFunction(int type, int length, bool bigendian
     QString bitCount;
     bitCount.setNum(length*8);
 
-    QString numberType;
-    if(Unsigned)
-    {
-        if(length > 4)
-            numberType = "uint64_t";
-        else if(length > 2)
-            numberType = "uint32_t";
-        else if(length > 1)
-            numberType = "uint16_t";
-        else
-            numberType = "uint8_t";
-    }
-    else
-    {
-        if(length > 4)
-            numberType = "int64_t";
-        else if(length > 2)
-            numberType = "int32_t";
-        else if(length > 1)
-            numberType = "int16_t";
-        else
-            numberType = "int8_t";
-    }
+    QString numberType = getEncodedTypeString(length, Unsigned);
 
     QString floatType;
     QString halfFraction;
@@ -405,20 +470,7 @@ QString ProtocolScaling::fullEncodeFunction(int type, int length, bool bigendian
 
     if(Unsigned)
     {
-        QString max;
-
-        switch(length)
-        {
-        default:
-        case 1: max = "255u"; break;
-        case 2: max = "65535u"; break;
-        case 3: max = "16777215u"; break;
-        case 4: max = "4294967295uL"; break;
-        case 5: max = "1099511627775ull"; break;
-        case 6: max = "281474976710655ull"; break;
-        case 7: max = "72057594037927935ull"; break;
-        case 8: max = "18446744073709551615ull"; break;
-        }
+        QString max = getEncodedMaxString(length, true);
 
         function += "    " + floatType + " scaledvalue = (" + floatType + ")((value - min)*scaler);\n";
         function += "    " + numberType + " number;\n";
@@ -435,33 +487,8 @@ QString ProtocolScaling::fullEncodeFunction(int type, int length, bool bigendian
     }
     else
     {
-        QString max;
-        QString min;
-        switch(length)
-        {
-        default:
-        case 1: max = "127"; break;
-        case 2: max = "32767"; break;
-        case 3: max = "8388607"; break;
-        case 4: max = "2147483647"; break;
-        case 5: max = "549755813887ll"; break;
-        case 6: max = "140737488355327ll"; break;
-        case 7: max = "36028797018963967ll"; break;
-        case 8: max = "9223372036854775807ll"; break;
-        }
-
-        switch(length)
-        {
-        default:
-        case 1: min = "(-127 - 1)"; break;
-        case 2: min = "(-32767 - 1)"; break;
-        case 3: min = "(-8388607 - 1)"; break;
-        case 4: min = "(-2147483647 - 1)"; break;
-        case 5: min = "(-549755813887ll - 1)"; break;
-        case 6: min = "(-140737488355327ll - 1)"; break;
-        case 7: min = "(-36028797018963967ll - 1)"; break;
-        case 8: min = "(-9223372036854775807ll - 1)"; break;
-        }
+        QString max = getEncodedMaxString(length, false);
+        QString min = getEncodedMinString(length);
 
         function += "    " + floatType + " scaledvalue = (" + floatType + ")(value*scaler);\n";
         function += "    " + numberType + " number;\n";
@@ -492,6 +519,360 @@ QString ProtocolScaling::fullEncodeFunction(int type, int length, bool bigendian
 }// ProtocolScaling::encodeFullFunction
 
 
+/*!
+ * Get the integer type that holds an encoded number
+ * \param length is the number of bytes in the encoded format.
+ * \param Unsigned should be true for unsigned encoding.
+ * \return the type name, like "uint16_t"
+ */
+QString ProtocolScaling::getEncodedTypeString(int length, bool Unsigned)
+{
+    QString numberType;
+
+    if(Unsigned)
+        numberType = "uint";
+    else
+        numberType = "int";
+
+    if(length > 4)
+        numberType += "64_t";
+    else if(length > 2)
+        numberType += "32_t";
+    else if(length > 1)
+        numberType += "16_t";
+    else
+        numberType += "8_t";
+
+    return numberType;
+
+}// ProtocolScaling::getEncodedTypeString
+
+
+/*!
+ * Get the largest number that can be encoded
+ * \param length is the number of bytes in the encoded format.
+ * \param Unsigned should be true for unsigned encoding.
+ * \return the maximum value as a C literal
+ */
+QString ProtocolScaling::getEncodedMaxString(int length, bool Unsigned)
+{
+    if(Unsigned)
+    {
+        switch(length)
+        {
+        default:
+        case 1: return "255u";
+        case 2: return "65535u";
+        case 3: return "16777215u";
+        case 4: return "4294967295uL";
+        case 5: return "1099511627775ull";
+        case 6: return "281474976710655ull";
+        case 7: return "72057594037927935ull";
+        case 8: return "18446744073709551615ull";
+        }
+    }
+    else
+    {
+        switch(length)
+        {
+        default:
+        case 1: return "127";
+        case 2: return "32767";
+        case 3: return "8388607";
+        case 4: return "2147483647";
+        case 5: return "549755813887ll";
+        case 6: return "140737488355327ll";
+        case 7: return "36028797018963967ll";
+        case 8: return "9223372036854775807ll";
+        }
+    }
+
+}// ProtocolScaling::getEncodedMaxString
+
+
+/*!
+ * Get the most negative number that can be encoded as a signed integer
+ * \param length is the number of bytes in the encoded format.
+ * \return the minimum value as a C expression
+ */
+QString ProtocolScaling::getEncodedMinString(int length)
+{
+    switch(length)
+    {
+    default:
+    case 1: return "(-127 - 1)";
+    case 2: return "(-32767 - 1)";
+    case 3: return "(-8388607 - 1)";
+    case 4: return "(-2147483647 - 1)";
+    case 5: return "(-549755813887ll - 1)";
+    case 6: return "(-140737488355327ll - 1)";
+    case 7: return "(-36028797018963967ll - 1)";
+    case 8: return "(-9223372036854775807ll - 1)";
+    }
+
+}// ProtocolScaling::getEncodedMinString
+
+
+/*!
+ * Get the source that stores an encoded number into element i of an array
+ * of encoded numbers in a byte stream. Each byte is stored at a constant
+ * offset from the element start, which allows the loop to be vectorized.
+ * \param length is the number of bytes in the encoded format.
+ * \param bigendian should be true for big endian encoding.
+ * \param spacing is the indentation of each line
+ * \return the lines of source, including linefeeds
+ */
+QString ProtocolScaling::arrayElementStoreString(int length, bool bigendian, const QString& spacing)
+{
+    QString output;
+
+    for(int k = 0; k < length; k++)
+    {
+        int shift;
+
+        if(bigendian)
+            shift = 8*(length - 1 - k);
+        else
+            shift = 8*k;
+
+        if(length == 1)
+            output += spacing + "bytes[i] = (uint8_t)(number);\n";
+        else if(k == 0)
+            output += spacing + "bytes[" + QString().setNum(length) + "*i] = (uint8_t)(number";
+        else
+            output += spacing + "bytes[" + QString().setNum(length) + "*i + " + QString().setNum(k) + "] = (uint8_t)(number";
+
+        if(length > 1)
+        {
+            if(shift > 0)
+                output += " >> " + QString().setNum(shift);
+
+            output += ");\n";
+        }
+    }
+
+    return output;
+
+}// ProtocolScaling::arrayElementStoreString
+
+
+/*!
+ * Get the expression that loads element i of an array of unsigned encoded
+ * numbers from a byte stream.
+ * \param length is the number of bytes in the encoded format.
+ * \param bigendian should be true for big endian encoding.
+ * \return the expression, whose type is the unsigned encoded type
+ */
+QString ProtocolScaling::arrayElementLoadString(int length, bool bigendian)
+{
+    QString numberType = getEncodedTypeString(length, true);
+    QString output;
+
+    if(length == 1)
+        return QString("bytes[i]");
+
+    for(int k = 0; k < length; k++)
+    {
+        int shift;
+
+        if(bigendian)
+            shift = 8*(length - 1 - k);
+        else
+            shift = 8*k;
+
+        if(k > 0)
+            output += " | ";
+
+        output += "((" + numberType + ")bytes[" + QString().setNum(length) + "*i";
+
+        if(k > 0)
+            output += " + " + QString().setNum(k);
+
+        output += "]";
+
+        if(shift > 0)
+            output += " << " + QString().setNum(shift);
+
+        output += ")";
+    }
+
+    return output;
+
+}// ProtocolScaling::arrayElementLoadString
+
+
+/*!
+ * Get the expression that converts an unsigned encoded number called "raw"
+ * into the signed encoded number, performing the sign extension for non
+ * standard lengths.
+ * \param length is the number of bytes in the encoded format.
+ * \return the expression, whose type is the signed encoded type
+ */
+QString ProtocolScaling::arraySignExtendString(int length)
+{
+    QString numberType = getEncodedTypeString(length, false);
+
+    if((length == 1) || (length == 2) || (length == 4) || (length == 8))
+        return "(" + numberType + ")raw";
+
+    // Flip the sign bit and then subtract it, which sign extends without branches
+    QString signbit = "0x" + QString().setNum((qulonglong)1 << (8*length - 1), 16);
+
+    if(length > 4)
+        signbit += "ll";
+
+    return "((" + numberType + ")(raw ^ " + signbit + ") - (" + numberType + ")" + signbit + ")";
+
+}// ProtocolScaling::arraySignExtendString
+
+
+/*!
+ * Create the full array encode function comment, with doxygen decorations
+ * \param type is the enumerator for the functions input type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \param Unsigned should be true if the function outputs unsigned bytes.
+ * \return The string that represents the full multi-line function comment.
+ */
+QString ProtocolScaling::fullEncodeArrayComment(int type, int length, bool bigendian, bool Unsigned)
+{
+    QString comment= ("/*!\n");
+
+    comment += ProtocolParser::outputLongComment(" *", briefEncodeComment(type, length, bigendian, Unsigned).replace("Encode a " + typeNames[type], "Encode an array of " + typeNames[type])) + "\n";
+    comment += " * \\param value points to the array of numbers to encode.\n";
+    comment += " * \\param count is the number of elements in the array.\n";
+    comment += " * \\param bytes is a pointer to the byte stream which receives the encoded data.\n";
+    comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+    comment += " *        will be incremented by " + QString().setNum(length) + "*count when this function is complete.\n";
+
+    if(Unsigned)
+    {
+        comment += " * \\param min is the minimum value that can be encoded.\n";
+        comment += " * \\param scaler is multiplied by value to create the encoded integer: encoded = (value-min)*scaler.\n";
+    }
+    else
+        comment += " * \\param scaler is multiplied by value to create the encoded integer: encoded = value*scaler.\n";
+
+    comment += " */";
+
+    return comment;
+}
+
+
+/*!
+ * Create the one line array encode function signature, without a trailing
+ * semicolon. This is the same as the single value signature, except for the
+ * name and the first arguments.
+ * \param type is the enumerator for the functions input type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \param Unsigned should be true if the function outputs unsigned bytes.
+ * \return The string that represents the function signature, without a trailing semicolon
+ */
+QString ProtocolScaling::encodeArraySignature(int type, int length, bool bigendian, bool Unsigned)
+{
+    QString signature = encodeSignature(type, length, bigendian, Unsigned);
+
+    signature.replace("ScaledTo", "ArrayScaledTo");
+    signature.replace("(" + typeNames[type] + " value,", "(const " + typeNames[type] + "* value, int count,");
+
+    return signature;
+
+}// ProtocolScaling::encodeArraySignature
+
+
+/*!
+ * Get the declaration of an array encode function for the header file. This
+ * is either the prototype, or the entire static inline function.
+ * \param type is the enumerator for the functions input type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function outputs big endian byte order.
+ * \param Unsigned should be true if the function outputs unsigned bytes.
+ * \return The declaration, with a leading linefeed, or empty if the function
+ *         is not called
+ */
+QString ProtocolScaling::getEncodeArrayDeclaration(int type, int length, bool bigendian, bool Unsigned)
+{
+    if(!isCalled(encodeArraySignature(type, length, bigendian, Unsigned)))
+        return QString();
+
+    if(support.inlineHelpers)
+        return "\n" + fullEncodeArrayComment(type, length, bigendian, Unsigned) + "\nstatic inline " + fullEncodeArrayFunction(type, length, bigendian, Unsigned);
+    else
+        return "\n//! " + briefEncodeComment(type, length, bigendian, Unsigned).replace("Encode a " + typeNames[type], "Encode an array of " + typeNames[type]) + "\n" + encodeArraySignature(type, length, bigendian, Unsigned) + ";\n";
+
+}// ProtocolScaling::getEncodeArrayDeclaration
+
+
+/*!
+ * Generate the full array encode function output, excluding the comment.
+ * The loop has no function calls and no branches, so that compilers can
+ * vectorize it.
+ * \param type is the input type to be encoded.
+ * \param length is the number of bytes to use in the encoding of each element
+ * \param bigendian should be true for bigendian encoding
+ * \param Unsigned should be true for unsigned encoding
+ * \return the function as a string
+ */
+QString ProtocolScaling::fullEncodeArrayFunction(int type, int length, bool bigendian, bool Unsigned)
+{
+    QString function = encodeArraySignature(type, length, bigendian, Unsigned) + "\n";
+    QString numberType = getEncodedTypeString(length, Unsigned);
+    QString max = getEncodedMaxString(length, Unsigned);
+
+    QString floatType;
+    QString halfFraction;
+    if(typeSizes[type] > 4)
+    {
+        halfFraction = "0.5";
+        floatType = "double";
+    }
+    else
+    {
+        halfFraction = "0.5f";
+        floatType = "float";
+    }
+
+    function += "{\n";
+    function += "    int i;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(i = 0; i < count; i++)\n";
+    function += "    {\n";
+
+    if(Unsigned)
+    {
+        function += "        " + floatType + " scaledvalue = (" + floatType + ")((value[i] - min)*scaler);\n";
+        function += "        " + numberType + " number;\n";
+        function += "\n";
+        function += "        // Make sure number fits in the range\n";
+        function += "        number = (scaledvalue >= " + max + ") ? " + max + " : ((scaledvalue <= 0) ? 0 : (" + numberType + ")(scaledvalue + " + halfFraction + "));\n";
+    }
+    else
+    {
+        QString min = getEncodedMinString(length);
+
+        function += "        " + floatType + " scaledvalue = (" + floatType + ")(value[i]*scaler);\n";
+        function += "        " + numberType + " number;\n";
+        function += "\n";
+        function += "        // Make sure number fits in the range\n";
+        function += "        number = (scaledvalue >= " + max + ") ? " + max + " : ((scaledvalue <= " + min + ") ? " + min + " : (" + numberType + ")(scaledvalue + ((scaledvalue >= 0) ? " + halfFraction + " : -" + halfFraction + ")));\n";
+    }
+
+    function += "\n";
+    function += arrayElementStoreString(length, bigendian, "        ");
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + QString().setNum(length) + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// ProtocolScaling::fullEncodeArrayFunction
+
+
 /*!
  * Generate the header file for protocols caling
  * \return true if the file is generated.
@@ -516,6 +897,10 @@ bool ProtocolScaling::generateDecodeHeader(void)
 
     header.write("\n#include <stdint.h>\n");
 
+    // Inline functions need the field decoding functions
+    if(support.inlineHelpers)
+        header.write("#include \"fielddecode.h\"\n");
+
     for(int type = 0; type < typeNames.size(); type++)
     {
         for(int length = 1; length <= typeSizes[type]; length++)
@@ -525,30 +910,30 @@ bool ProtocolScaling::generateDecodeHeader(void)
                 continue;
 
             // big endian unsigned
-            header.write("\n");
-            header.write("//! " + briefDecodeComment(type, length, true, true) + "\n");
-            header.write(decodeSignature(type, length, true, true) + ";\n");
+            header.write(getDecodeDeclaration(type, length, true, true));
+            if(support.arrayHelpers)
+                header.write(getDecodeArrayDeclaration(type, length, true, true));
 
             // little endian unsigned
             if(length != 1)
             {
-                header.write("\n");
-                header.write("//! " + briefDecodeComment(type, length, false, true) + "\n");
-                header.write(decodeSignature(type, length, false, true) + ";\n");
+                header.write(getDecodeDeclaration(type, length, false, true));
+                if(support.arrayHelpers)
+                    header.write(getDecodeArrayDeclaration(type, length, false, true));
             }
 
             // big endian signed
-            header.write("\n");
-            header.write("//! " + briefDecodeComment(type, length, true, false) + "\n");
-            header.write(decodeSignature(type, length, true, false) + ";\n");
+            header.write(getDecodeDeclaration(type, length, true, false));
+            if(support.arrayHelpers)
+                header.write(getDecodeArrayDeclaration(type, length, true, false));
 
 
             // little endian signed
             if(length != 1)
             {
-                header.write("\n");
-                header.write("//! " + briefDecodeComment(type, length, false, false) + "\n");
-                header.write(decodeSignature(type, length, false, false) + ";\n");
+                header.write(getDecodeDeclaration(type, length, false, false));
+                if(support.arrayHelpers)
+                    header.write(getDecodeArrayDeclaration(type, length, false, false));
             }
 
 
@@ -579,7 +964,8 @@ bool ProtocolScaling::generateDecodeSource(void)
     source.write("#include \"fielddecode.h\"\n");
     source.write("\n");
 
-    for(int type = 0; type < typeNames.size(); type++)
+    // Inline functions are in the header
+    for(int type = 0; (type < typeNames.size()) && !support.inlineHelpers; type++)
     {
         for(int length = 1; length <= typeSizes[type]; length++)
         {
@@ -588,29 +974,69 @@ bool ProtocolScaling::generateDecodeSource(void)
                 continue;
 
             // big endian unsigned
-            source.write("\n");
-            source.write(fullDecodeComment(type, length, true, true) + "\n");
-            source.write(fullDecodeFunction(type, length, true, true) + "\n");
+            if(isCalled(decodeSignature(type, length, true, true)))
+            {
+                source.write("\n");
+                source.write(fullDecodeComment(type, length, true, true) + "\n");
+                source.write(fullDecodeFunction(type, length, true, true) + "\n");
+            }
+
+            if(support.arrayHelpers && isCalled(decodeArraySignature(type, length, true, true)))
+            {
+                source.write("\n");
+                source.write(fullDecodeArrayComment(type, length, true, true) + "\n");
+                source.write(fullDecodeArrayFunction(type, length, true, true) + "\n");
+            }
 
             // little endian unsigned
             if(length != 1)
             {
-                source.write("\n");
-                source.write(fullDecodeComment(type, length, false, true) + "\n");
-                source.write(fullDecodeFunction(type, length, false, true) + "\n");
+                if(isCalled(decodeSignature(type, length, false, true)))
+                {
+                    source.write("\n");
+                    source.write(fullDecodeComment(type, length, false, true) + "\n");
+                    source.write(fullDecodeFunction(type, length, false, true) + "\n");
+                }
+
+                if(support.arrayHelpers && isCalled(decodeArraySignature(type, length, false, true)))
+                {
+                    source.write("\n");
+                    source.write(fullDecodeArrayComment(type, length, false, true) + "\n");
+                    source.write(fullDecodeArrayFunction(type, length, false, true) + "\n");
+                }
             }
 
             // big endian signed
-            source.write("\n");
-            source.write(fullDecodeComment(type, length, true, false) + "\n");
-            source.write(fullDecodeFunction(type, length, true, false) + "\n");
+            if(isCalled(decodeSignature(type, length, true, false)))
+            {
+                source.write("\n");
+                source.write(fullDecodeComment(type, length, true, false) + "\n");
+                source.write(fullDecodeFunction(type, length, true, false) + "\n");
+            }
+
+            if(support.arrayHelpers && isCalled(decodeArraySignature(type, length, true, false)))
+            {
+                source.write("\n");
+                source.write(fullDecodeArrayComment(type, length, true, false) + "\n");
+                source.write(fullDecodeArrayFunction(type, length, true, false) + "\n");
+            }
 
             // little endian signed
             if(length != 1)
             {
-                source.write("\n");
-                source.write(fullDecodeComment(type, length, false, false) + "\n");
-                source.write(fullDecodeFunction(type, length, false, false) + "\n");
+                if(isCalled(decodeSignature(type, length, false, false)))
+                {
+                    source.write("\n");
+                    source.write(fullDecodeComment(type, length, false, false) + "\n");
+                    source.write(fullDecodeFunction(type, length, false, false) + "\n");
+                }
+
+                if(support.arrayHelpers && isCalled(decodeArraySignature(type, length, false, false)))
+                {
+                    source.write("\n");
+                    source.write(fullDecodeArrayComment(type, length, false, false) + "\n");
+                    source.write(fullDecodeArrayFunction(type, length, false, false) + "\n");
+                }
             }
 
         }// for all output byte counts
@@ -760,6 +1186,29 @@ QString ProtocolScaling::decodeSignature(int type, int length, bool bigendian, b
 }// ProtocolScaling::decodeSignature
 
 
+/*!
+ * Get the declaration of a decode function for the header file. This is
+ * either the prototype, or the entire static inline function.
+ * \param type is the enumerator for the functions input type.
+ * \param length is the number of bytes in the encoded format.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \param Unsigned should be true if the function inputs unsigned bytes.
+ * \return The declaration, with a leading linefeed, or empty if the function
+ *         is not called
+ */
+QString ProtocolScaling::getDecodeDeclaration(int type, int length, bool bigendian, bool Unsigned)
+{
+    if(!isCalled(decodeSignature(type, length, bigendian, Unsigned)))
+        return QString();
+
+    if(support.inlineHelpers)
+        return "\n" + fullDecodeComment(type, length, bigendian, Unsigned) + "\nstatic inline " + fullDecodeFunction(type, length, bigendian, Unsigned);
+    else
+        return "\n//! " + briefDecodeComment(type, length, bigendian, Unsigned) + "\n" + decodeSignature(type, length, bigendian, Unsigned) + ";\n";
+
+}// ProtocolScaling::getDecodeDeclaration
+
+
 /*!
  * Generate the full function output, excluding the comment
  * \param type is the input type to be decoded.
@@ -801,3 +1250,118 @@ QString ProtocolScaling::fullDecodeFunction(int type, int length, bool bigendian
     return function;
 
 }// ProtocolScaling::decodeFullFunction
+
+
+/*!
+ * Create the full array decode function comment, with doxygen decorations
+ * \param type is the enumerator for the functions output type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \param Unsigned should be true if the function inputs unsigned bytes.
+ * \return The string that represents the full multi-line function comment.
+ */
+QString ProtocolScaling::fullDecodeArrayComment(int type, int length, bool bigendian, bool Unsigned)
+{
+    QString comment= ("/*!\n");
+
+    comment += ProtocolParser::outputLongComment(" *", briefDecodeComment(type, length, bigendian, Unsigned).replace("Compute a " + typeNames[type], "Compute an array of " + typeNames[type])) + "\n";
+    comment += " * \\param value receives the array of decoded numbers.\n";
+    comment += " * \\param count is the number of elements in the array.\n";
+    comment += " * \\param bytes is a pointer to the byte stream to decode.\n";
+    comment += " * \\param index gives the location of the first byte in the byte stream, and\n";
+    comment += " *        will be incremented by " + QString().setNum(length) + "*count when this function is complete.\n";
+
+    if(Unsigned)
+        comment += " * \\param min is the minimum value that can be decoded.\n";
+
+    comment += " * \\param invscaler is multiplied by the encoded integer to create each value.\n";
+    comment += " *        invscaler should be the inverse of the scaler given to the encode function.\n";
+    comment += " */";
+
+    return comment;
+}
+
+
+/*!
+ * Create the one line array decode function signature, without a trailing
+ * semicolon. This is the same as the single value signature, except for the
+ * name and the first arguments, and the return value.
+ * \param type is the enumerator for the functions output type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \param Unsigned should be true if the function inputs unsigned bytes.
+ * \return The string that represents the function signature, without a trailing semicolon
+ */
+QString ProtocolScaling::decodeArraySignature(int type, int length, bool bigendian, bool Unsigned)
+{
+    // Remove the return type
+    QString signature = "void " + decodeSignature(type, length, bigendian, Unsigned).mid(typeNames[type].size() + 1);
+
+    signature.replace("ScaledFrom", "ArrayScaledFrom");
+    signature.replace("(const uint8_t* bytes,", "(" + typeNames[type] + "* value, int count, const uint8_t* bytes,");
+
+    return signature;
+
+}// ProtocolScaling::decodeArraySignature
+
+
+/*!
+ * Get the declaration of an array decode function for the header file. This
+ * is either the prototype, or the entire static inline function.
+ * \param type is the enumerator for the functions output type.
+ * \param length is the number of bytes in each encoded element.
+ * \param bigendian should be true if the function inputs big endian byte order.
+ * \param Unsigned should be true if the function inputs unsigned bytes.
+ * \return The declaration, with a leading linefeed, or empty if the function
+ *         is not called
+ */
+QString ProtocolScaling::getDecodeArrayDeclaration(int type, int length, bool bigendian, bool Unsigned)
+{
+    if(!isCalled(decodeArraySignature(type, length, bigendian, Unsigned)))
+        return QString();
+
+    if(support.inlineHelpers)
+        return "\n" + fullDecodeArrayComment(type, length, bigendian, Unsigned) + "\nstatic inline " + fullDecodeArrayFunction(type, length, bigendian, Unsigned);
+    else
+        return "\n//! " + briefDecodeComment(type, length, bigendian, Unsigned).replace("Compute a " + typeNames[type], "Compute an array of " + typeNames[type]) + "\n" + decodeArraySignature(type, length, bigendian, Unsigned) + ";\n";
+
+}// ProtocolScaling::getDecodeArrayDeclaration
+
+
+/*!
+ * Generate the full array decode function output, excluding the comment.
+ * The loop has no function calls and no branches, so that compilers can
+ * vectorize it.
+ * \param type is the output type to be decoded.
+ * \param length is the number of bytes used in the encoding of each element
+ * \param bigendian should be true for bigendian encoding
+ * \param Unsigned should be true for unsigned encoding
+ * \return the function as a string
+ */
+QString ProtocolScaling::fullDecodeArrayFunction(int type, int length, bool bigendian, bool Unsigned)
+{
+    QString function = decodeArraySignature(type, length, bigendian, Unsigned) + "\n";
+
+    function += "{\n";
+    function += "    int i;\n";
+    function += "\n";
+    function += "    // increment byte pointer for starting point\n";
+    function += "    bytes += (*index);\n";
+    function += "\n";
+    function += "    for(i = 0; i < count; i++)\n";
+    function += "    {\n";
+    function += "        " + getEncodedTypeString(length, true) + " raw = " + arrayElementLoadString(length, bigendian) + ";\n";
+
+    if(Unsigned)
+        function += "        value[i] = (" + typeNames[type] + ")(min + invscaler*raw);\n";
+    else
+        function += "        value[i] = (" + typeNames[type] + ")(invscaler*" + arraySignExtendString(length) + ");\n";
+
+    function += "    }\n";
+    function += "\n";
+    function += "    (*index) += " + QString().setNum(length) + "*count;\n";
+    function += "}\n";
+
+    return function;
+
+}// ProtocolScaling::fullDecodeArrayFunction
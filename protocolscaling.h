@@ -27,6 +27,15 @@ public:
     //! Perform the generation, writing out the files
     bool generate(void);
 
+    //! Get the integer type that holds an encoded number
+    static QString getEncodedTypeString(int length, bool Unsigned);
+
+    //! Get the largest number that can be encoded
+    static QString getEncodedMaxString(int length, bool Unsigned);
+
+    //! Get the most negative number that can be encoded as a signed integer
+    static QString getEncodedMinString(int length);
+
 protected:
 
     //! Generate the encode header file
@@ -41,6 +50,9 @@ protected:
     //! Generate the decode source file
     bool generateDecodeSource(void);
 
+    //! Determine if a helper function is output
+    bool isCalled(const QString& signature) const;
+
     //! Generate the one line brief comment for the encode function
     QString briefEncodeComment(int type, int length, bool bigendian, bool Unsigned);
 
@@ -53,6 +65,21 @@ protected:
     //! Generate the full encode function
     QString fullEncodeFunction(int type, int length, bool bigendian, bool Unsigned);
 
+    //! Generate the header declaration for the encode function
+    QString getEncodeDeclaration(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the full comment for the array encode function
+    QString fullEncodeArrayComment(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the array encode function signature
+    QString encodeArraySignature(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the full array encode function
+    QString fullEncodeArrayFunction(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the header declaration for the array encode function
+    QString getEncodeArrayDeclaration(int type, int length, bool bigendian, bool Unsigned);
+
     //! Generate the one line brief comment for the decode function
     QString briefDecodeComment(int type, int length, bool bigendian, bool Unsigned);
 
@@ -65,6 +92,30 @@ protected:
     //! Generate the full decode function
     QString fullDecodeFunction(int type, int length, bool bigendian, bool Unsigned);
 
+    //! Generate the header declaration for the decode function
+    QString getDecodeDeclaration(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the full comment for the array decode function
+    QString fullDecodeArrayComment(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the array decode function signature
+    QString decodeArraySignature(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the full array decode function
+    QString fullDecodeArrayFunction(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Generate the header declaration for the array decode function
+    QString getDecodeArrayDeclaration(int type, int length, bool bigendian, bool Unsigned);
+
+    //! Get the source that stores element i of an array of encoded numbers
+    static QString arrayElementStoreString(int length, bool bigendian, const QString& spacing);
+
+    //! Get the expression that loads element i of an array of encoded numbers
+    static QString arrayElementLoadString(int length, bool bigendian);
+
+    //! Get the expression that sign extends a raw encoded number
+    static QString arraySignExtendString(int length);
+
     //! Header file output object
     ProtocolHeaderFile header;
 
@@ -0,0 +1,177 @@
+#include "protocolstatistics.h"
+#include "protocolparser.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QPair>
+#include <algorithm>
+
+bool ProtocolStatistics::enabled = false;
+QMutex ProtocolStatistics::mutex;
+QHash<QString, qint64> ProtocolStatistics::phaseTimes;
+QStringList ProtocolStatistics::moduleNames;
+QHash<QString, qint64> ProtocolStatistics::parseTimes;
+QHash<QString, qint64> ProtocolStatistics::generateTimes;
+QHash<QString, qint64> ProtocolStatistics::counts;
+
+
+/*!
+ * Turn the collection of statistics on or off. This should be done before
+ * the run starts.
+ * \param enable should be true to collect statistics
+ */
+void ProtocolStatistics::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
+
+/*!
+ * Forget all the statistics collected so far
+ */
+void ProtocolStatistics::clear(void)
+{
+    QMutexLocker lock(&mutex);
+
+    phaseTimes.clear();
+    moduleNames.clear();
+    parseTimes.clear();
+    generateTimes.clear();
+    counts.clear();
+}
+
+
+/*!
+ * Add to the wall time of a phase of the run. A phase that is timed more than
+ * once reports the total.
+ * \param phase is the name of the phase
+ * \param nanoseconds is the time to add
+ */
+void ProtocolStatistics::addPhaseTime(const QString& phase, qint64 nanoseconds)
+{
+    if(!enabled)
+        return;
+
+    QMutexLocker lock(&mutex);
+    phaseTimes[phase] += nanoseconds;
+}
+
+
+/*!
+ * Add to the time spent on one module
+ * \param module is the name of the structure or packet
+ * \param parseNanoseconds is the time spent building the module from the xml
+ * \param generateNanoseconds is the time spent writing the code of the module
+ */
+void ProtocolStatistics::addModuleTime(const QString& module, qint64 parseNanoseconds, qint64 generateNanoseconds)
+{
+    if(!enabled)
+        return;
+
+    QMutexLocker lock(&mutex);
+
+    if(!parseTimes.contains(module))
+        moduleNames.append(module);
+
+    parseTimes[module] += parseNanoseconds;
+    generateTimes[module] += generateNanoseconds;
+}
+
+
+/*!
+ * Add to one of the counts of the run
+ * \param count is the name of the count
+ * \param amount is added to the count
+ */
+void ProtocolStatistics::addCount(const QString& count, qint64 amount)
+{
+    if(!enabled)
+        return;
+
+    QMutexLocker lock(&mutex);
+    counts[count] += amount;
+}
+
+
+/*!
+ * Record that a file was output
+ * \param bytes is the size of the file
+ * \param changed is true if the file was written, false if it was left alone
+ *        because it already had the same contents
+ * \param nanoseconds is the time spent comparing and writing the file
+ */
+void ProtocolStatistics::addFile(qint64 bytes, bool changed, qint64 nanoseconds)
+{
+    if(!enabled)
+        return;
+
+    QMutexLocker lock(&mutex);
+
+    counts["files"] += 1;
+    counts["bytes"] += bytes;
+    phaseTimes["fileIO"] += nanoseconds;
+
+    if(changed)
+    {
+        counts["filesChanged"] += 1;
+        counts["bytesWritten"] += bytes;
+    }
+    else
+    {
+        // Make sure these show up even if nothing changed
+        counts["filesChanged"] += 0;
+        counts["bytesWritten"] += 0;
+    }
+}
+
+
+/*!
+ * Get the statistics as a JSON document. Times are given in milliseconds.
+ * The fileIO time is the sum over all threads, so it can be longer than the
+ * phase in which the files were written.
+ * \param slowest is the number of modules to list, starting with the slowest
+ * \return the JSON text
+ */
+QByteArray ProtocolStatistics::toJson(int slowest)
+{
+    QMutexLocker lock(&mutex);
+
+    QJsonObject phases;
+    QHash<QString, qint64>::const_iterator i;
+    for(i = phaseTimes.constBegin(); i != phaseTimes.constEnd(); ++i)
+        phases.insert(i.key(), i.value()/1000000.0);
+
+    QJsonObject countObject;
+    for(i = counts.constBegin(); i != counts.constEnd(); ++i)
+        countObject.insert(i.key(), (double)i.value());
+
+    // Sort the modules by total time, keeping document order for equal
+    // times. The time is negated so the slowest comes first
+    QList<QPair<qint64, int> > sorted;
+    for(int j = 0; j < moduleNames.size(); j++)
+        sorted.append(qMakePair(-(parseTimes.value(moduleNames.at(j)) + generateTimes.value(moduleNames.at(j))), j));
+
+    std::sort(sorted.begin(), sorted.end());
+
+    QJsonArray modules;
+    for(int j = 0; (j < sorted.size()) && (j < slowest); j++)
+    {
+        QString name = moduleNames.at(sorted.at(j).second);
+
+        QJsonObject module;
+        module.insert("name", name);
+        module.insert("parse", parseTimes.value(name)/1000000.0);
+        module.insert("generate", generateTimes.value(name)/1000000.0);
+        modules.append(module);
+    }
+
+    QJsonObject root;
+    root.insert("version", ProtocolParser::genVersion);
+    root.insert("phases", phases);
+    root.insert("counts", countObject);
+    root.insert("slowestModules", modules);
+
+    return QJsonDocument(root).toJson();
+
+}// ProtocolStatistics::toJson
@@ -0,0 +1,57 @@
+#ifndef PROTOCOLSTATISTICS_H
+#define PROTOCOLSTATISTICS_H
+
+/*!
+ * \file
+ * Collect timing and counts for a run of ProtoGen
+ *
+ * The statistics are reported as JSON, so the performance of the generator
+ * can be tracked as a protocol grows. Nothing is collected unless the
+ * statistics are enabled. All the functions are safe to call from any thread.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+class ProtocolStatistics
+{
+public:
+    //! Turn the collection of statistics on or off
+    static void setEnabled(bool enable);
+
+    //! Determine if statistics are being collected
+    static bool isEnabled(void) {return enabled;}
+
+    //! Forget all the statistics collected so far
+    static void clear(void);
+
+    //! Add to the wall time of a phase of the run
+    static void addPhaseTime(const QString& phase, qint64 nanoseconds);
+
+    //! Add to the time spent on one module
+    static void addModuleTime(const QString& module, qint64 parseNanoseconds, qint64 generateNanoseconds);
+
+    //! Add to one of the counts of the run
+    static void addCount(const QString& count, qint64 amount);
+
+    //! Record that a file was output
+    static void addFile(qint64 bytes, bool changed, qint64 nanoseconds);
+
+    //! Get the statistics as a JSON document
+    static QByteArray toJson(int slowest);
+
+private:
+    static bool enabled;                        //!< True if statistics are collected
+    static QMutex mutex;                        //!< Protects the statistics, which are added from different threads
+    static QHash<QString, qint64> phaseTimes;   //!< Nanoseconds spent in each phase
+    static QStringList moduleNames;             //!< Names of the modules, in the order they were first timed
+    static QHash<QString, qint64> parseTimes;   //!< Nanoseconds spent parsing each module
+    static QHash<QString, qint64> generateTimes;//!< Nanoseconds spent generating each module
+    static QHash<QString, qint64> counts;       //!< Value of each count
+};
+
+#endif // PROTOCOLSTATISTICS_H
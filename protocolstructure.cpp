@@ -1,5 +1,6 @@
 #include "protocolstructure.h"
 #include "protocolparser.h"
+#include "protocolstatistics.h"
 #include <QDomNodeList>
 #include <QStringList>
 #include <iostream>
@@ -13,8 +14,11 @@
 ProtocolStructure::ProtocolStructure(const QString& protocolName, const QString& protocolPrefix, ProtocolSupport supported) :
     Encodable(protocolName, protocolPrefix, supported),
     bitfields(false),
+    unfusedBitfields(false),
+    bitwordBits(0),
     needsIterator(false),
-    defaults(false)
+    defaults(false),
+    packMembers(false)
 {
 
 }
@@ -28,8 +32,11 @@ ProtocolStructure::ProtocolStructure(const QString& protocolName, const QString&
 ProtocolStructure::ProtocolStructure(const QString& protocolName, const QString& protocolPrefix, ProtocolSupport supported, const QDomElement& field) :
     Encodable(protocolName, protocolPrefix, supported),
     bitfields(false),
+    unfusedBitfields(false),
+    bitwordBits(0),
     needsIterator(false),
-    defaults(false)
+    defaults(false),
+    packMembers(false)
 {
     parse(field);
 
@@ -71,8 +78,12 @@ void ProtocolStructure::clear(void)
 
     // The rest of the metadata
     bitfields = false;
+    unfusedBitfields = false;
+    bitwordBits = 0;
     needsIterator = false;
     defaults = false;
+    packMembers = false;
+    notices.clear();
 
 }// ProtocolStructure::clear
 
@@ -117,6 +128,19 @@ void ProtocolStructure::parse(const QDomElement& field)
     // Any user comment about this
     comment = ProtocolParser::getComment(field);
 
+    // The members may be declared in order of alignment, the protocol gives the default
+    QString pack = field.attribute("packMembers");
+    if(pack.isEmpty())
+        packMembers = support.packMembers;
+    else
+        packMembers = pack.contains("true", Qt::CaseInsensitive);
+
+    // The bitfield groups may be fused, the protocol gives the default. Our
+    // children are created with our support, so they follow the override too
+    QString fuse = field.attribute("fuseBitfields");
+    if(!fuse.isEmpty())
+        support.fuseBitfields = fuse.contains("true", Qt::CaseInsensitive);
+
     // Get any enumerations
     parseEnumerations(field);
 
@@ -238,6 +262,8 @@ void ProtocolStructure::parseChildren(const QDomElement& field)
                        std::cout << name.toStdString() << ": " << encodable->name.toStdString() << ": variable length array ignored, failed to find length variable" << std::endl;
                        encodable->variableArray.clear();
                     }
+                    else
+                       encodable->variableArraySigned = encodables.at(prev)->isInMemorySigned();
 
                 }// if this is a variable length array
 
@@ -313,9 +339,76 @@ void ProtocolStructure::parseChildren(const QDomElement& field)
 
     }// for all children
 
+    // Now that the bitfield groups are known, tell each bitfield how big its group is
+    QList<Encodable*> group;
+    for(int i = 0; i <= encodables.size(); i++)
+    {
+        if((i < encodables.size()) && encodables[i]->isNotEncoded())
+            continue;
+
+        if((i < encodables.size()) && encodables[i]->isBitfield())
+        {
+            group.append(encodables[i]);
+            continue;
+        }
+
+        if(group.size() > 0)
+            setBitfieldGroup(group);
+
+        group.clear();
+
+    }// for all children and one past the end
+
 }// ProtocolStructure::parseChildren
 
 
+/*!
+ * Inform the members of a bitfield group of the total number of bits in the
+ * group, and track whether the group is fused into a single word.
+ * \param group is the list of contiguous bitfields, in encoding order
+ */
+void ProtocolStructure::setBitfieldGroup(const QList<Encodable*>& group)
+{
+    int groupBits = group.last()->getEndingBitCount();
+
+    for(int i = 0; i < group.size(); i++)
+        group[i]->setBitfieldGroupBits(groupBits);
+
+    if(group.last()->isFusedBitfield())
+    {
+        if(groupBits > 32)
+            bitwordBits = 64;
+        else if(bitwordBits < 32)
+            bitwordBits = 32;
+    }
+    else
+        unfusedBitfields = true;
+
+}// ProtocolStructure::setBitfieldGroup
+
+
+/*!
+ * Get the local variable declarations needed by encode or decode functions
+ * of this structure to handle bitfields.
+ * \return the declarations, or an empty string if there are no bitfields
+ */
+QString ProtocolStructure::getBitfieldDeclarations(void) const
+{
+    QString output;
+
+    if(unfusedBitfields)
+        output += "    int bitcount = 0;\n";
+
+    if(bitwordBits > 32)
+        output += "    uint64_t bitword = 0;\n";
+    else if(bitwordBits > 0)
+        output += "    uint32_t bitword = 0;\n";
+
+    return output;
+
+}// ProtocolStructure::getBitfieldDeclarations
+
+
 /*!
  * Get the number of encoded fields. This is not the same as the length of the
  * encodables list, because some or all of them could be isNotEncoded()
@@ -337,6 +430,38 @@ int ProtocolStructure::getNumberOfEncodes(void) const
 }
 
 
+/*!
+ * Get the number of primitive fields in this structure, counting the fields
+ * of any child structures rather than the structures themselves.
+ * \return the number of primitive fields
+ */
+int ProtocolStructure::getNumberOfFields(void) const
+{
+    int numFields = 0;
+    for(int i = 0; i < encodables.length(); i++)
+        numFields += encodables.at(i)->getNumberOfFields();
+
+    return numFields;
+}
+
+
+/*!
+ * Get the notices from generating this structure and its children. The
+ * children are generated first, so their notices come first.
+ * \return the notices, one line each
+ */
+QStringList ProtocolStructure::getNotices(void) const
+{
+    QStringList output;
+    for(int i = 0; i < encodables.length(); i++)
+        output += encodables.at(i)->getNotices();
+
+    output += notices;
+
+    return output;
+}
+
+
 /*!
  * Get the number of encoded fields whose value is set by the user. This is
  * not the same as the length of the encodables list, because some or all of
@@ -383,6 +508,118 @@ QString ProtocolStructure::getDeclaration(void) const
 }// ProtocolStructure::getDeclaration
 
 
+/*!
+ * Get the order in which the members of this structure are declared. This is
+ * the encoded order, unless the members are packed, in which case they are
+ * declared from the largest alignment to the smallest so that the compiler
+ * needs no padding between them. Members whose layout is not known, which
+ * are enumerations, bitfields, and structures, follow in their encoded order.
+ * The wire order is not changed, as the members are coded by name.
+ * \return the indices of the encodables, in the order they are declared
+ */
+QList<int> ProtocolStructure::getDeclarationOrder(void) const
+{
+    QList<int> order;
+
+    if(!packMembers)
+    {
+        for(int i = 0; i < encodables.length(); i++)
+            order.append(i);
+
+        return order;
+    }
+
+    for(int bytes = 8; bytes >= 1; bytes /= 2)
+    {
+        for(int i = 0; i < encodables.length(); i++)
+        {
+            if(encodables.at(i)->getInMemoryBytes() == bytes)
+                order.append(i);
+        }
+    }
+
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        if(encodables.at(i)->getInMemoryBytes() <= 0)
+            order.append(i);
+    }
+
+    return order;
+
+}// ProtocolStructure::getDeclarationOrder
+
+
+/*!
+ * Get the size of this structure in memory, assuming each native type is
+ * aligned to its size, which is what sizeof() gives on most compilers.
+ * \param order is the order in which the members are declared
+ * \param size receives the size in bytes, including any padding
+ * \return false if the size is not known, because a member is not a native
+ *         type or is an array whose length is not a number
+ */
+bool ProtocolStructure::getInMemorySize(const QList<int>& order, int& size) const
+{
+    int offset = 0;
+    int alignment = 1;
+
+    for(int j = 0; j < order.size(); j++)
+    {
+        const Encodable* encodable = encodables.at(order.at(j));
+        int bytes = encodable->getInMemoryBytes();
+        int count = 1;
+
+        if(encodable->isNotInMemory())
+            continue;
+
+        if(bytes <= 0)
+            return false;
+
+        if(encodable->isArray())
+        {
+            bool ok = false;
+            count = encodable->array.toInt(&ok);
+            if(!ok)
+                return false;
+        }
+
+        offset = ((offset + bytes - 1)/bytes)*bytes + bytes*count;
+
+        if(bytes > alignment)
+            alignment = bytes;
+    }
+
+    // The padding at the end, so each element of an array is aligned
+    size = ((offset + alignment - 1)/alignment)*alignment;
+
+    return true;
+
+}// ProtocolStructure::getInMemorySize
+
+
+/*!
+ * Report how much smaller the structure is because its members are packed,
+ * if the sizes are known. The report is a notice, since this is called while
+ * the structure is generated.
+ * \param order is the order in which the members are declared
+ */
+void ProtocolStructure::reportPackedSize(const QList<int>& order) const
+{
+    QList<int> encodedOrder;
+    int packedSize = 0;
+    int size = 0;
+
+    for(int i = 0; i < encodables.length(); i++)
+        encodedOrder.append(i);
+
+    if(!getInMemorySize(order, packedSize) || !getInMemorySize(encodedOrder, size) || (packedSize >= size))
+        return;
+
+    notices.append(typeName + ": packing the members reduces sizeof from " + QString().setNum(size) + " to " + QString().setNum(packedSize) + " bytes");
+    ProtocolStatistics::addCount("packedBytesSaved", size - packedSize);
+
+}// ProtocolStructure::reportPackedSize
+
+
 /*!
  * Get the declaration that goes in the header which declares this structure
  * and all its children.
@@ -422,14 +659,19 @@ QString ProtocolStructure::getStructureDeclaration(bool alwaysCreate) const
             // The opening to the structure
             output += "typedef struct\n";
             output += "{\n";
-            for(int i = 0; i < encodables.length(); i++)
-                structure += encodables[i]->getDeclaration();
+
+            QList<int> order = getDeclarationOrder();
+            for(int i = 0; i < order.size(); i++)
+                structure += encodables[order.at(i)]->getDeclaration();
 
             // Make structures pretty with alignment goodness
             output += alignStructureData(structure);
 
             // Close out the structure
             output += "}" + typeName + ";\n";
+
+            if(packMembers)
+                reportPackedSize(order);
         }
 
     }// if we have some data to encode
@@ -439,6 +681,314 @@ QString ProtocolStructure::getStructureDeclaration(bool alwaysCreate) const
 }// ProtocolStructure::getStructureDeclaration
 
 
+/*!
+ * Find the runs of fields whose encoding is a copy of their memory. This
+ * follows the layout of the structure that getStructureDeclaration() outputs,
+ * assuming each native type is aligned to its size. A run is a sequence of
+ * encodables that are next to each other on the wire, and in memory with no
+ * padding between them. Where the layout is not known, for example after an
+ * enumeration, the run starts again.
+ * \return a list with an entry for each encodable, which is the index after
+ *         the last encodable of the run that starts with it, or its own index
+ *         if no run starts with it.
+ */
+QList<int> ProtocolStructure::getNativeRuns(void) const
+{
+    QList<int> runs;
+    QList<int> position;    // The location of each encodable in the declaration
+    QList<bool> aligned;    // True if there is no padding before each encodable
+    int offset = 0;         // The offset of the next member, modulo the alignment that is known
+    int modulus = 8;        // The alignment to which the offset is known
+    int declared = 0;       // The number of members declared so far
+    int first = -1;         // The first encodable of the current run
+
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        runs.append(i);
+        position.append(-1);
+        aligned.append(false);
+    }
+
+    if(!support.nativeLayout)
+        return runs;
+
+    // The layout of the members, in the order they are declared
+    QList<int> order = getDeclarationOrder();
+    for(int j = 0; j < order.size(); j++)
+    {
+        int i = order.at(j);
+        int bytes = encodables.at(i)->getInMemoryBytes();
+
+        if(encodables.at(i)->isNotInMemory())
+            continue;
+
+        position[i] = declared++;
+
+        if(bytes <= 0)
+        {
+            offset = 0;
+            modulus = 1;
+            continue;
+        }
+
+        // Alignment of this member, and whether there is padding before it
+        aligned[i] = (modulus >= bytes) && ((offset % bytes) == 0);
+
+        if(modulus >= bytes)
+            offset = ((offset + bytes - 1)/bytes)*bytes;
+        else
+        {
+            offset = 0;
+            modulus = bytes;
+        }
+
+        // The offset of the next member
+        if(!encodables.at(i)->isArray())
+            offset = (offset + bytes) % modulus;
+        else
+        {
+            bool ok = false;
+            int count = encodables.at(i)->array.toInt(&ok);
+
+            if(ok)
+                offset = (offset + bytes*count) % modulus;
+            else
+            {
+                // Any number of elements, the offset is still aligned to one
+                offset = 0;
+                modulus = bytes;
+            }
+        }
+
+    }// for all members in order of declaration
+
+    // The runs, which are next to each other on the wire and in the declaration
+    for(int i = 0; i <= encodables.length(); i++)
+    {
+        bool native = (i < encodables.length()) && (encodables.at(i)->getNativeBytes() > 0);
+
+        // Close the current run if this encodable does not continue it. A
+        // run of a single value is left to the coding functions.
+        if((first >= 0) && (!native || !aligned.at(i) || (position.at(i) != position.at(i-1) + 1)))
+        {
+            if((i - first > 1) || encodables.at(first)->isArray())
+                runs[first] = i;
+
+            first = -1;
+        }
+
+        if(native && (first < 0))
+            first = i;
+
+    }// for all encodables, and one past the end
+
+    return runs;
+
+}// ProtocolStructure::getNativeRuns
+
+
+/*!
+ * Get the number of bytes of part of a native run, which is the same in
+ * memory and on the wire
+ * \param first is the index of the first encodable
+ * \param end is the index after the last encodable
+ * \return the number of bytes
+ */
+LengthExpression ProtocolStructure::getNativeLength(int first, int end) const
+{
+    LengthExpression length;
+
+    for(int i = first; i < end; i++)
+    {
+        LengthExpression bytes = LengthExpression::fromString(QString().setNum(encodables.at(i)->getNativeBytes()));
+
+        if(encodables.at(i)->isArray())
+            bytes.multiply(LengthExpression::fromString(encodables.at(i)->array));
+
+        length.add(bytes);
+    }
+
+    return length;
+
+}// ProtocolStructure::getNativeLength
+
+
+/*!
+ * Get the macro that the host must define for a native run to be copied,
+ * which is the macro for a host with the byte order of the protocol
+ * \param first is the index of the first encodable
+ * \param end is the index after the last encodable
+ * \param isBigEndian should be true for big endian encoding.
+ * \return the macro, or an empty string if the run is all single bytes
+ */
+QString ProtocolStructure::getNativeHostMacro(int first, int end, bool isBigEndian) const
+{
+    for(int i = first; i < end; i++)
+    {
+        if(encodables.at(i)->getNativeBytes() > 1)
+        {
+            if(isBigEndian)
+                return QString("FIELDCODING_BIG_ENDIAN_HOST");
+            else
+                return QString("FIELDCODING_LITTLE_ENDIAN_HOST");
+        }
+    }
+
+    return QString();
+
+}// ProtocolStructure::getNativeHostMacro
+
+
+/*!
+ * Get the compile time checks that the compiler lays out the native runs of
+ * this structure the way they are encoded. The checks are typedefs of arrays
+ * whose size is negative if the check fails, which works for any C standard.
+ * \param runs is the list from getNativeRuns()
+ * \param isBigEndian should be true for big endian encoding.
+ * \return the checks, which go at file scope, or an empty string
+ */
+QString ProtocolStructure::getNativeLayoutChecks(const QList<int>& runs, bool isBigEndian) const
+{
+    QString output;
+
+    for(int first = 0; first < runs.size(); first++)
+    {
+        int end = runs.at(first);
+
+        if(end <= first)
+            continue;
+
+        QString macro = getNativeHostMacro(first, end, isBigEndian);
+
+        ProtocolFile::makeLineSeparator(output);
+        if(end - first > 1)
+            output += "// The members " + encodables.at(first)->name + " to " + encodables.at(end-1)->name + " of " + typeName + " must be laid out as they are encoded\n";
+        else
+            output += "// The member " + encodables.at(first)->name + " of " + typeName + " must be laid out as it is encoded\n";
+
+        if(!macro.isEmpty())
+            output += "#if defined(" + macro + ")\n";
+
+        for(int i = first; i < end; i++)
+        {
+            const QString& member = encodables.at(i)->name;
+            QString check = "sizeof(((" + typeName + "*)0)->" + member + ") == " + getNativeLength(i, i + 1).toString(true);
+
+            if(i > first)
+                check = "(offsetof(" + typeName + ", " + member + ") - offsetof(" + typeName + ", " + encodables.at(first)->name + ") == " + getNativeLength(first, i).toString(true) + ") && (" + check + ")";
+
+            output += "typedef char nativeLayoutOf" + typeName + "_" + member + "[(" + check + ") ? 1 : -1];\n";
+        }
+
+        if(!macro.isEmpty())
+            output += "#endif\n";
+
+    }// for all runs
+
+    return output;
+
+}// ProtocolStructure::getNativeLayoutChecks
+
+
+/*!
+ * Get the code that encodes a native run. If the host has the byte order of
+ * the protocol the run is copied with one memcpy, otherwise each field is
+ * encoded as usual.
+ * \param first is the index of the first encodable
+ * \param end is the index after the last encodable
+ * \param isBigEndian should be true for big endian encoding.
+ * \param bitcount points to the running count of bits in a bitfields
+ * \return the code to add to the encode function
+ */
+QString ProtocolStructure::getNativeEncodeString(int first, int end, bool isBigEndian, int* bitcount) const
+{
+    QString output;
+    QString fields;
+    QString macro = getNativeHostMacro(first, end, isBigEndian);
+    LengthExpression length = getNativeLength(first, end);
+
+    output += getFixedOffsetString(first);
+    if(end - first > 1)
+        output += "    // " + encodables.at(first)->name + " to " + encodables.at(end-1)->name + " are encoded as they are laid out in memory\n";
+    else
+        output += "    // " + encodables.at(first)->name + " is encoded as it is laid out in memory\n";
+
+    if(!macro.isEmpty())
+        output += "#if defined(" + macro + ")\n";
+
+    output += "    memcpy(data + byteindex, &user->" + encodables.at(first)->name + ", " + length.toString() + ");\n";
+    output += "    byteindex += " + length.toString() + ";\n";
+
+    if(macro.isEmpty())
+        return output;
+
+    for(int i = first; i < end; i++)
+    {
+        ProtocolFile::makeLineSeparator(fields);
+        if(i > first)
+            fields += getFixedOffsetString(i);
+        fields += encodables.at(i)->getEncodeString(isBigEndian, bitcount, true);
+    }
+
+    output += "#else\n";
+    output += fields;
+    output += "#endif\n";
+
+    return output;
+
+}// ProtocolStructure::getNativeEncodeString
+
+
+/*!
+ * Get the code that decodes a native run. If the host has the byte order of
+ * the protocol the run is copied with one memcpy, otherwise each field is
+ * decoded as usual.
+ * \param first is the index of the first encodable
+ * \param end is the index after the last encodable
+ * \param isBigEndian should be true for big endian encoding.
+ * \param bitcount points to the running count of bits in a bitfields
+ * \param defaultEnabled is passed to the decode of each field
+ * \return the code to add to the decode function
+ */
+QString ProtocolStructure::getNativeDecodeString(int first, int end, bool isBigEndian, int* bitcount, bool defaultEnabled) const
+{
+    QString output;
+    QString fields;
+    QString macro = getNativeHostMacro(first, end, isBigEndian);
+    LengthExpression length = getNativeLength(first, end);
+
+    output += getFixedOffsetString(first);
+    if(end - first > 1)
+        output += "    // " + encodables.at(first)->name + " to " + encodables.at(end-1)->name + " are decoded as they are laid out in memory\n";
+    else
+        output += "    // " + encodables.at(first)->name + " is decoded as it is laid out in memory\n";
+
+    if(!macro.isEmpty())
+        output += "#if defined(" + macro + ")\n";
+
+    output += "    memcpy(&user->" + encodables.at(first)->name + ", data + byteindex, " + length.toString() + ");\n";
+    output += "    byteindex += " + length.toString() + ";\n";
+
+    if(macro.isEmpty())
+        return output;
+
+    for(int i = first; i < end; i++)
+    {
+        ProtocolFile::makeLineSeparator(fields);
+        if(i > first)
+            fields += getFixedOffsetString(i);
+        fields += encodables.at(i)->getDecodeString(isBigEndian, bitcount, true, defaultEnabled);
+    }
+
+    output += "#else\n";
+    output += fields;
+    output += "#endif\n";
+
+    return output;
+
+}// ProtocolStructure::getNativeDecodeString
+
+
 /*!
  * Make a structure output be prettily aligned
  * \param structure is the input structure string
@@ -520,6 +1070,11 @@ QString ProtocolStructure::getPrototypeEncodeString(bool isBigEndian) const
 
         }
 
+        // The layout checks of the fields that are copied
+        QList<int> runs = getNativeRuns();
+        ProtocolFile::makeLineSeparator(output);
+        output += getNativeLayoutChecks(runs, isBigEndian);
+
         ProtocolFile::makeLineSeparator(output);
 
         // My encoding prototype and function
@@ -537,8 +1092,7 @@ QString ProtocolStructure::getPrototypeEncodeString(bool isBigEndian) const
         output += "int encode" + typeName + "(uint8_t* data, int byteindex, const " + typeName + "* user)\n";
         output += "{\n";
 
-        if(bitfields)
-            output += "    int bitcount = 0;\n";
+        output += getBitfieldDeclarations();
 
         if(needsIterator)
             output += "    int i = 0;\n";
@@ -547,7 +1101,14 @@ QString ProtocolStructure::getPrototypeEncodeString(bool isBigEndian) const
         for(int i = 0; i < encodables.length(); i++)
         {
             ProtocolFile::makeLineSeparator(output);
-            output += encodables[i]->getEncodeString(isBigEndian, &bitcount, true);
+
+            if(runs.at(i) > i)
+            {
+                output += getNativeEncodeString(i, runs.at(i), isBigEndian, &bitcount);
+                i = runs.at(i) - 1;
+            }
+            else
+                output += encodables[i]->getEncodeString(isBigEndian, &bitcount, true);
         }
 
         ProtocolFile::makeLineSeparator(output);
@@ -584,6 +1145,8 @@ QString ProtocolStructure::getPrototypeDecodeString(bool isBigEndian) const
 
         }
 
+        QList<int> runs = getNativeRuns();
+
         ProtocolFile::makeLineSeparator(output);
 
         // My decoding prototype and function
@@ -601,8 +1164,7 @@ QString ProtocolStructure::getPrototypeDecodeString(bool isBigEndian) const
         output += "int decode" + typeName + "(const uint8_t* data, int byteindex, " + typeName + "* user)\n";
         output += "{\n";
 
-        if(bitfields)
-            output += "    int bitcount = 0;\n";
+        output += getBitfieldDeclarations();
 
         if(needsIterator)
             output += "    int i = 0;\n";
@@ -611,7 +1173,14 @@ QString ProtocolStructure::getPrototypeDecodeString(bool isBigEndian) const
         for(int i = 0; i < encodables.length(); i++)
         {
             ProtocolFile::makeLineSeparator(output);
-            output += encodables[i]->getDecodeString(isBigEndian, &bitcount, true);
+
+            if(runs.at(i) > i)
+            {
+                output += getNativeDecodeString(i, runs.at(i), isBigEndian, &bitcount, false);
+                i = runs.at(i) - 1;
+            }
+            else
+                output += encodables[i]->getDecodeString(isBigEndian, &bitcount, true);
         }
 
         ProtocolFile::makeLineSeparator(output);
@@ -706,7 +1275,7 @@ QString ProtocolStructure::getEncodeString(bool isBigEndian, int* bitcount, bool
  * \param isStructureMember is true if this encodable is accessed by structure pointer
  * \return the string to add to the source to decode this structure
  */
-QString ProtocolStructure::getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled) const
+QString ProtocolStructure::getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled, const QString& endHook) const
 {
     QString output;
     QString access;
@@ -766,6 +1335,246 @@ QString ProtocolStructure::getDecodeString(bool isBigEndian, int* bitcount, bool
 
 
 
+/*!
+ * Get the C++ declaration of this structure and all its children. Each
+ * structure knows its encoded lengths and the offsets of its fields at
+ * compile time, and encodes and decodes itself with member functions.
+ * \param isBigEndian should be true for big endian encoding.
+ * \return the declarations, children first
+ */
+QString ProtocolStructure::getCppStructureDeclaration(bool isBigEndian) const
+{
+    QString output;
+    QString structure;
+    LengthExpression minLength;
+    LengthExpression maxLength;
+    ProtocolOperationList operations;
+
+    operations.build(encodables);
+
+    // Declare our childrens structures first
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        if(!encodables[i]->isPrimitive())
+        {
+            output += encodables[i]->getCppStructureDeclaration(isBigEndian);
+            output += "\n";
+        }
+
+        if(encodables.at(i)->isNotEncoded())
+            continue;
+
+        // Our own length, not the length of us in our parent
+        minLength.add(encodables.at(i)->encodedLength.getMinimum());
+        maxLength.add(encodables.at(i)->encodedLength.getMaximum());
+
+    }// for all children
+
+    if(!comment.isEmpty())
+    {
+        output += "/*!\n";
+        output += ProtocolParser::outputLongComment(" *", comment) + "\n";
+        output += " */\n";
+    }
+
+    output += "struct " + typeName + "\n";
+    output += "{\n";
+
+    QList<int> order = getDeclarationOrder();
+    for(int i = 0; i < order.size(); i++)
+        structure += encodables[order.at(i)]->getCppDeclaration();
+
+    if(!structure.isEmpty())
+    {
+        output += alignStructureData(structure);
+        output += "\n";
+    }
+
+    if(!getCppStructureConstants().isEmpty())
+    {
+        output += getCppStructureConstants();
+        output += "\n";
+    }
+
+    output += "    //! The minimum number of bytes of an encoded " + typeName + "\n";
+    output += "    static constexpr std::size_t minLength = " + minLength.toString(true) + ";\n";
+    output += "\n";
+    output += "    //! The maximum number of bytes of an encoded " + typeName + "\n";
+    output += "    static constexpr std::size_t maxLength = " + maxLength.toString(true) + ";\n";
+
+    // The fields whose location does not depend on the data before them
+    structure.clear();
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        const ProtocolOperation* operation = operations.find(i);
+
+        if((operation == NULL) || !operation->constantOffset || encodables.at(i)->isNotInMemory())
+            continue;
+
+        structure += "        static constexpr std::size_t " + encodables.at(i)->name + " = " + operation->offset.toString(true) + ";\n";
+    }
+
+    if(!structure.isEmpty())
+    {
+        output += "\n";
+        output += "    //! The byte offset of each field that is at the same location in every encoding\n";
+        output += "    struct Offsets\n";
+        output += "    {\n";
+        output += structure;
+        output += "    };\n";
+    }
+
+    output += "\n";
+    output += ProtocolFile::indentCode(getCppEncodeFunctions(isBigEndian));
+    output += "\n";
+    output += ProtocolFile::indentCode(getCppDecodeFunctions(isBigEndian, operations));
+    output += "};\n";
+
+    // Check the lengths and offsets against each other when the user compiles
+    output += "\n";
+    output += "static_assert(" + typeName + "::minLength <= " + typeName + "::maxLength, \"" + typeName + " lengths are inconsistent\");\n";
+
+    if(operations.size() > 0)
+    {
+        const ProtocolOperation& last = operations.at(operations.size() - 1);
+
+        if(last.constantOffset && (last.minLength == last.maxLength))
+        {
+            LengthExpression end = last.offset;
+            end.add(last.maxLength);
+            output += "static_assert(" + end.toString(true) + " == " + typeName + "::maxLength, \"" + typeName + " offsets are inconsistent with its length\");\n";
+        }
+    }
+
+    return output;
+
+}// ProtocolStructure::getCppStructureDeclaration
+
+
+/*!
+ * Get the C++ encode functions that are members of this structure. The
+ * function that takes an index does the work, the others are conveniences.
+ * \param isBigEndian should be true for big endian encoding.
+ * \return the functions, at the indentation of a namespace
+ */
+QString ProtocolStructure::getCppEncodeFunctions(bool isBigEndian) const
+{
+    QString output;
+    QString body;
+
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        if(encodables.at(i)->isNotEncoded())
+            continue;
+
+        ProtocolFile::makeLineSeparator(body);
+        body += encodables.at(i)->getCppEncodeString(isBigEndian);
+    }
+
+    output += "//! Encode this structure, returning the number of bytes encoded\n";
+    output += "std::size_t encode(std::uint8_t* data) const\n";
+    output += "{\n";
+    output += "    std::size_t index = 0;\n";
+    output += "    encode(data, index);\n";
+    output += "    return index;\n";
+    output += "}\n";
+    output += "\n";
+    output += "//! Encode this structure to an array that is known to be large enough\n";
+    output += "template<std::size_t N>\n";
+    output += "std::size_t encode(std::array<std::uint8_t, N>& data) const\n";
+    output += "{\n";
+    output += "    static_assert(N >= maxLength, \"array is too small for " + typeName + "\");\n";
+    output += "    return encode(data.data());\n";
+    output += "}\n";
+    output += "\n";
+    output += "//! Encode this structure at data + index, and move index past the encoded bytes\n";
+
+    if(body.isEmpty())
+    {
+        output += "void encode(std::uint8_t*, std::size_t&) const\n";
+        output += "{\n";
+        output += "}\n";
+    }
+    else
+    {
+        output += "void encode(std::uint8_t* data, std::size_t& index) const\n";
+        output += "{\n";
+        output += body;
+        output += "}\n";
+    }
+
+    return output;
+
+}// ProtocolStructure::getCppEncodeFunctions
+
+
+/*!
+ * Get the C++ decode functions that are members of this structure
+ * \param isBigEndian should be true for big endian encoding.
+ * \param operations are the operations of this structure, which say where
+ *        the data length must be checked
+ * \return the functions, at the indentation of a namespace
+ */
+QString ProtocolStructure::getCppDecodeFunctions(bool isBigEndian, const ProtocolOperationList& operations) const
+{
+    QString output;
+    QString body;
+    QString defaults;
+
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        const ProtocolOperation* operation = operations.find(i);
+
+        if(operation == NULL)
+            continue;
+
+        ProtocolFile::makeLineSeparator(body);
+        body += encodables.at(i)->getCppDecodeString(isBigEndian, *operation);
+        defaults += encodables.at(i)->getCppSetToDefaultsString();
+    }
+
+    output += "//! Decode this structure, returning false if there are not enough bytes\n";
+    output += "bool decode(const std::uint8_t* data, std::size_t size)\n";
+    output += "{\n";
+    output += "    std::size_t index = 0;\n";
+    output += "    return decode(data, size, index);\n";
+    output += "}\n";
+    output += "\n";
+    output += "//! Decode this structure from data + index, and move index past the decoded bytes\n";
+
+    if(body.isEmpty())
+    {
+        output += "bool decode(const std::uint8_t*, std::size_t size, std::size_t& index)\n";
+        output += "{\n";
+        output += "    return index <= size;\n";
+        output += "}\n";
+        return output;
+    }
+
+    output += "bool decode(const std::uint8_t* data, std::size_t size, std::size_t& index)\n";
+    output += "{\n";
+    output += "    // The fields whose length is fixed are checked all at once\n";
+    output += "    if(index + minLength > size)\n";
+    output += "        return false;\n";
+
+    if(!defaults.isEmpty())
+    {
+        output += "\n";
+        output += "    // Fields that are not in the data keep their defaults\n";
+        output += defaults;
+    }
+
+    output += "\n";
+    output += body;
+    ProtocolFile::makeLineSeparator(output);
+    output += "    return true;\n";
+    output += "}\n";
+
+    return output;
+
+}// ProtocolStructure::getCppDecodeFunctions
+
+
 /*!
  * Get details needed to produce documentation for this encodable.
  * \param parentName is the name of the parent which will be pre-pended to the name of this encodable
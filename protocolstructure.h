@@ -43,6 +43,12 @@ public:
     //! Get the number of encoded fields
     int getNumberOfEncodes(void) const;
 
+    //! Get the number of primitive fields in this structure and its children
+    virtual int getNumberOfFields(void) const;
+
+    //! Get the notices from generating this structure and its children
+    virtual QStringList getNotices(void) const;
+
     //! Get the number of encoded fields whose value is set by the user.
     int getNumberOfNonConstEncodes(void) const;
 
@@ -62,7 +68,16 @@ public:
     virtual QString getEncodeString(bool isBigEndian, int* bitcount, bool isStructureMember) const;
 
     //! Return the string that is used to decode this encoable
-    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false) const;
+    virtual QString getDecodeString(bool isBigEndian, int* bitcount, bool isStructureMember, bool defaultEnabled = false, const QString& endHook = QString()) const;
+
+    //! Get the C++ declaration of this structure and all its children
+    virtual QString getCppStructureDeclaration(bool isBigEndian) const;
+
+    //! Return the C++ code that encodes this structure as a member of its parent
+    virtual QString getCppEncodeString(bool isBigEndian) const {return getCppEncodeStringForStructure();}
+
+    //! Return the C++ code that decodes this structure as a member of its parent
+    virtual QString getCppDecodeString(bool isBigEndian, const ProtocolOperation& operation) const {return getCppDecodeStringForStructure(operation);}
 
     //! Get details needed to produce documentation for this encodable.
     virtual void getDocumentationDetails(QList<int>& outline, QString& startByte, QStringList& bytes, QStringList& names, QStringList& encodings, QStringList& repeats, QStringList& comments) const;
@@ -78,6 +93,51 @@ protected:
     //! Parse all enumerations which are direct children of a DomNode
     void parseEnumerations(const QDomNode& node);
 
+    //! Inform a group of contiguous bitfields of the size of their group
+    void setBitfieldGroup(const QList<Encodable*>& group);
+
+    //! Get the local variable declarations needed to encode or decode bitfields
+    QString getBitfieldDeclarations(void) const;
+
+    //! Get the order in which the members of this structure are declared
+    QList<int> getDeclarationOrder(void) const;
+
+    //! Get the size of this structure in memory, if it is known
+    bool getInMemorySize(const QList<int>& order, int& size) const;
+
+    //! Report how much smaller the structure is because its members are packed
+    void reportPackedSize(const QList<int>& order) const;
+
+    //! Get the line that sets the byte index to the constant offset of an encodable, empty if there is none
+    virtual QString getFixedOffsetString(int index) const {return QString();}
+
+    //! Find the runs of fields that are encoded as they are laid out in memory
+    QList<int> getNativeRuns(void) const;
+
+    //! Get the number of bytes of part of a native run
+    LengthExpression getNativeLength(int first, int end) const;
+
+    //! Get the host byte order macro that a native run needs, empty if it needs none
+    QString getNativeHostMacro(int first, int end, bool isBigEndian) const;
+
+    //! Get the compile time checks of the memory layout of the native runs
+    QString getNativeLayoutChecks(const QList<int>& runs, bool isBigEndian) const;
+
+    //! Get the code that encodes a native run, copying it if the host allows
+    QString getNativeEncodeString(int first, int end, bool isBigEndian, int* bitcount) const;
+
+    //! Get the code that decodes a native run, copying it if the host allows
+    QString getNativeDecodeString(int first, int end, bool isBigEndian, int* bitcount, bool defaultEnabled) const;
+
+    //! Get the C++ declarations of constants that are members of this structure
+    virtual QString getCppStructureConstants(void) const {return QString();}
+
+    //! Get the C++ encode functions that are members of this structure
+    QString getCppEncodeFunctions(bool isBigEndian) const;
+
+    //! Get the C++ decode functions that are members of this structure
+    QString getCppDecodeFunctions(bool isBigEndian, const ProtocolOperationList& operations) const;
+
     //! This list of all children encodables
     QList<Encodable*> encodables;
 
@@ -85,9 +145,15 @@ protected:
     QList<const EnumCreator*> enumList;
 
     bool bitfields;             //!< True if this structure uses bitfields
+    bool unfusedBitfields;      //!< True if this structure uses bitfields that are encoded bit by bit
+    int bitwordBits;            //!< Size of the word used for fused bitfields, 0 if none are fused
     bool needsIterator;         //!< True if this structure uses arrays
     bool defaults;              //!< True if this structure uses default values
     bool strings;               //!< True if this structure uses strings
+    bool packMembers;           //!< True if the members are declared in order of alignment
+
+    //! Notices from generating this structure, which is done on a worker thread, so they wait to be printed in order
+    mutable QStringList notices;
 
 };
 
@@ -36,6 +36,12 @@ void ProtocolStructureModule::clear(void)
     ProtocolStructure::clear();
     source.clear();
     header.clear();
+    cppHeader.clear();
+    typesHeader.clear();
+    moduleName.clear();
+    includeNames.clear();
+    includeComments.clear();
+    includeGlobals.clear();
 
     // Note that data set during constructor are not changed
 
@@ -43,8 +49,9 @@ void ProtocolStructureModule::clear(void)
 
 
 /*!
- * Create the source and header files that represent a packet
- * \param packet is DOM element that defines the packet
+ * Parse the DOM description of a structure. This only builds the structure,
+ * generate() must then be called to write the files.
+ * \param e is DOM element that defines the structure
  */
 void ProtocolStructureModule::parse(const QDomElement& e)
 {
@@ -68,14 +75,132 @@ void ProtocolStructureModule::parse(const QDomElement& e)
     }
 
     // The file directive tells us if we are creating a separate file, or if we are appending an existing one
-    QString moduleName = e.attribute("file");
+    moduleName = e.attribute("file");
 
     if(moduleName.isEmpty())
     {
         // The file names
         header.setModuleName(prefix + name);
         source.setModuleName(prefix + name);
+        cppHeader.setModuleName(prefix + name);
+        typesHeader.setModuleName(prefix + name + "Types");
+    }
+    else
+    {
+        // The file names
+        header.setModuleName(moduleName);
+        source.setModuleName(moduleName);
+        cppHeader.setModuleName(moduleName);
+        typesHeader.setModuleName(moduleName + "Types");
+    }
+
+    // Other includes specific to this structure
+    parseIncludes(e);
+
+}// ProtocolStructureModule::parse
+
+
+/*!
+ * Remember the include directives given in the DOM, so they can be output
+ * without going back to the DOM.
+ * \param e is the DOM element of this structure or packet
+ */
+void ProtocolStructureModule::parseIncludes(const QDomElement& e)
+{
+    QList<QDomNode> list = ProtocolParser::childElementsByTagName(e, "Include");
+    for(int i = 0; i < list.size(); i++)
+    {
+        QDomElement include = list.at(i).toElement();
+
+        if(include.attribute("name").isEmpty())
+            continue;
+
+        includeNames.append(include.attribute("name"));
+        includeComments.append(ProtocolParser::getComment(include));
+        includeGlobals.append(include.attribute("global") == "true");
+    }
+
+}// ProtocolStructureModule::parseIncludes
+
+
+/*!
+ * Write the include directives that were given in the DOM to a header file
+ * \param file is the header or the types header
+ */
+void ProtocolStructureModule::outputIncludes(ProtocolHeaderFile& file)
+{
+    for(int i = 0; i < includeNames.size(); i++)
+        file.writeIncludeDirective(includeNames.at(i), includeComments.at(i), includeGlobals.at(i));
+
+}// ProtocolStructureModule::outputIncludes
+
+
+/*!
+ * Start the types header, if the protocol splits the headers. The types
+ * header has the enumerations and structures of the module, so other modules
+ * can use the types without the prototypes of the functions. The header
+ * includes the types header, in place of those declarations.
+ */
+void ProtocolStructureModule::openTypesHeader(void)
+{
+    typesHeader.clear();
+
+    if(!support.typesHeaders)
+        return;
+
+    // Several modules may share the types header, as they share the header
+    typesHeader.prepareToAppend();
+
+    if(!typesHeader.isAppending())
+    {
+        typesHeader.write("/*!\n");
+        typesHeader.write(" * \\file\n");
+        typesHeader.write(" * \\brief " + typesHeader.fileName() + " defines the types of " + header.fileName() + ", without the functions that encode and decode them\n");
+        typesHeader.write(" */\n");
+        typesHeader.write("\n");
+        typesHeader.writeIncludeDirective(protoName + "Protocol.h");
+    }
+    else
+        typesHeader.makeLineSeparator();
+
+    header.writeIncludeDirective(typesHeader.fileName());
+
+}// ProtocolStructureModule::openTypesHeader
+
+
+/*!
+ * Write the include directives needed for the types of our children to a
+ * header file. The types header includes the types headers of the children.
+ * \param file is the header or the types header
+ */
+void ProtocolStructureModule::outputChildIncludes(ProtocolHeaderFile& file)
+{
+    for(int i = 0; i < encodables.length(); i++)
+    {
+        QString include = encodables[i]->getIncludeDirective();
+
+        if(support.typesHeaders && include.endsWith(".h"))
+            include = include.left(include.size() - 2) + "Types.h";
+
+        file.writeIncludeDirective(include);
+    }
+
+}// ProtocolStructureModule::outputChildIncludes
 
+
+/*!
+ * Create the source and header files that represent a structure. This does
+ * not modify any data outside of this structure, so modules that do not
+ * share files can be generated at the same time.
+ */
+void ProtocolStructureModule::generate(void)
+{
+    // Make sure these are empty
+    header.clear();
+    source.clear();
+
+    if(moduleName.isEmpty())
+    {
         // Comment block at the top of the header file
         header.write("/*!\n");
         header.write(" * \\file\n");
@@ -97,10 +222,6 @@ void ProtocolStructureModule::parse(const QDomElement& e)
     }
     else
     {
-        // The file names
-        header.setModuleName(moduleName);
-        source.setModuleName(moduleName);
-
         // We may be appending data to an already existing file
         header.prepareToAppend();
         source.prepareToAppend();
@@ -125,21 +246,24 @@ void ProtocolStructureModule::parse(const QDomElement& e)
 
     }
 
+    // The types go in the header, unless they have their own
+    openTypesHeader();
+    ProtocolHeaderFile& types = support.typesHeaders ? typesHeader : header;
+
     // Add other includes specific to this structure
-    ProtocolParser::outputIncludes(header, e);
+    outputIncludes(types);
 
     // Include directives that may be needed for our children
-    for(int i = 0; i < encodables.length(); i++)
-        header.writeIncludeDirective(encodables[i]->getIncludeDirective());
+    outputChildIncludes(types);
 
     // White space is good
-    header.makeLineSeparator();
+    types.makeLineSeparator();
 
     // Output enumerations specific to this structure
     for(int i = 0; i < enumList.size(); i++)
     {
-        header.makeLineSeparator();
-        header.write(enumList.at(i)->getOutput());
+        types.makeLineSeparator();
+        types.write(enumList.at(i)->getOutput());
     }
 
     // Include the helper files in the source, but only do this once
@@ -154,20 +278,32 @@ void ProtocolStructureModule::parse(const QDomElement& e)
         if(support.bitfield)
             source.writeIncludeDirective("bitfieldspecial.h");
 
-        source.writeIncludeDirective("fielddecode.h");
-        source.writeIncludeDirective("fieldencode.h");
-        source.writeIncludeDirective("scaleddecode.h");
-        source.writeIncludeDirective("scaledencode.h");
+        // With minimal helpers only the modules that are called are included, once the source is done
+        if(!support.minimalHelpers)
+        {
+            source.writeIncludeDirective("fielddecode.h");
+            source.writeIncludeDirective("fieldencode.h");
+            source.writeIncludeDirective("scaleddecode.h");
+            source.writeIncludeDirective("scaledencode.h");
+        }
+
+        // offsetof and memcpy, for the fields that are copied
+        if(support.nativeLayout)
+        {
+            source.writeIncludeDirective("stddef.h", QString(), true);
+            source.writeIncludeDirective("string.h", QString(), true);
+        }
     }
 
     // White space is good
-    header.makeLineSeparator();
+    types.makeLineSeparator();
 
     // Create the structure definition in the header.
     // This includes any sub-structures as well
-    header.write(getStructureDeclaration(true));
+    types.write(getStructureDeclaration(true));
 
     // White space is good
+    types.makeLineSeparator();
     header.makeLineSeparator();
 
     // The functions to encoding and ecoding
@@ -182,15 +318,94 @@ void ProtocolStructureModule::parse(const QDomElement& e)
     // White space is good
     header.makeLineSeparator();
 
+    if(support.minimalHelpers)
+        source.writeHelperIncludeDirectives();
+
     // Write to disk
     header.flush();
     source.flush();
+    typesHeader.flush();
 
     // Make sure these are empty for next time around
     header.clear();
     source.clear();
+    typesHeader.clear();
 
-}// ProtocolStructureModule::parse
+}// ProtocolStructureModule::generate
+
+
+/*!
+ * Create the header-only C++ file that represents this structure, which is
+ * a parallel to the C header and source, built from the same encodables.
+ * The structure, its children, and its enumerations go in the namespace
+ * of the protocol.
+ */
+void ProtocolStructureModule::generateCpp(void)
+{
+    cppHeader.clear();
+
+    if(moduleName.isEmpty())
+    {
+        cppHeader.write("/*!\n");
+        cppHeader.write(" * \\file\n");
+        cppHeader.write(" * \\brief " + cppHeader.fileName() + " defines the C++ interface for the " + typeName + " structure of the " + protoName + " protocol stack\n");
+
+        if(!comment.isEmpty())
+        {
+            cppHeader.write(" *\n");
+            cppHeader.write(ProtocolParser::outputLongComment(" *", comment) + "\n");
+        }
+
+        cppHeader.write(" */\n");
+        cppHeader.write("\n");
+
+        cppHeader.writeIncludeDirective(protoName + "Protocol.hpp");
+    }
+    else
+    {
+        cppHeader.prepareToAppend();
+
+        if(!cppHeader.isAppending())
+        {
+            cppHeader.write("/*!\n");
+            cppHeader.write(" * \\file\n");
+            cppHeader.write(" * " + cppHeader.fileName() + " is part of the C++ interface to the " + protoName + " protocol stack\n");
+            cppHeader.write(" */\n");
+            cppHeader.write("\n");
+
+            cppHeader.writeIncludeDirective(protoName + "Protocol.hpp");
+        }
+        else
+            cppHeader.makeLineSeparator();
+    }
+
+    for(int i = 0; i < includeNames.size(); i++)
+        cppHeader.writeIncludeDirective(includeNames.at(i), includeComments.at(i), includeGlobals.at(i));
+
+    for(int i = 0; i < encodables.length(); i++)
+        cppHeader.writeIncludeDirective(encodables[i]->getCppIncludeDirective());
+
+    cppHeader.makeLineSeparator();
+    cppHeader.write("namespace " + protoName + "\n");
+    cppHeader.write("{\n");
+
+    for(int i = 0; i < enumList.size(); i++)
+    {
+        cppHeader.makeLineSeparator();
+        cppHeader.write(enumList.at(i)->getOutput());
+    }
+
+    cppHeader.makeLineSeparator();
+    cppHeader.write(getCppStructureDeclaration(isBigEndian));
+
+    cppHeader.makeLineSeparator();
+    cppHeader.write("}// namespace " + protoName + "\n");
+    cppHeader.write("\n");
+
+    cppHeader.flush();
+    cppHeader.clear();
+
+}// ProtocolStructureModule::generateCpp
 
 
 /*!
@@ -250,6 +465,11 @@ void ProtocolStructureModule::createTopLevelStructureFunctions(void)
 
     source.makeLineSeparator();
 
+    // The layout checks of the fields that are copied
+    QList<int> runs = getNativeRuns();
+    output += getNativeLayoutChecks(runs, isBigEndian);
+    ProtocolFile::makeLineSeparator(output);
+
     // My encoding function
     output += "/*!\n";
     output += " * \\brief Encode a " + typeName + " structure into a byte array\n";
@@ -267,8 +487,7 @@ void ProtocolStructureModule::createTopLevelStructureFunctions(void)
         output += "int encode" + typeName + "(uint8_t* data, int byteindex)\n";
     output += "{\n";
 
-    if(bitfields)
-        output += "    int bitcount = 0;\n";
+    output += getBitfieldDeclarations();
 
     if(needsIterator)
         output += "    int i = 0;\n";
@@ -277,7 +496,14 @@ void ProtocolStructureModule::createTopLevelStructureFunctions(void)
     for(int i = 0; i < encodables.length(); i++)
     {
         ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getEncodeString(isBigEndian, &bitcount, true);
+
+        if(runs.at(i) > i)
+        {
+            output += getNativeEncodeString(i, runs.at(i), isBigEndian, &bitcount);
+            i = runs.at(i) - 1;
+        }
+        else
+            output += encodables[i]->getEncodeString(isBigEndian, &bitcount, true);
     }
 
     ProtocolFile::makeLineSeparator(output);
@@ -299,8 +525,7 @@ void ProtocolStructureModule::createTopLevelStructureFunctions(void)
     output += "int decode" + typeName + "(const uint8_t* data, int byteindex, " + typeName + "* user)\n";
     output += "{\n";
 
-    if(bitfields)
-        output += "    int bitcount = 0;\n";
+    output += getBitfieldDeclarations();
 
     // Reserved arrays are handled here differently, don't need the iterator
     if(needsIterator)
@@ -310,7 +535,14 @@ void ProtocolStructureModule::createTopLevelStructureFunctions(void)
     for(int i = 0; i < encodables.length(); i++)
     {
         ProtocolFile::makeLineSeparator(output);
-        output += encodables[i]->getDecodeString(isBigEndian, &bitcount, true);
+
+        if(runs.at(i) > i)
+        {
+            output += getNativeDecodeString(i, runs.at(i), isBigEndian, &bitcount, false);
+            i = runs.at(i) - 1;
+        }
+        else
+            output += encodables[i]->getDecodeString(isBigEndian, &bitcount, true);
     }
 
     ProtocolFile::makeLineSeparator(output);
@@ -5,6 +5,8 @@
 #include "protocolfile.h"
 #include "enumcreator.h"
 #include <QString>
+#include <QStringList>
+#include <QList>
 #include <QDomElement>
 
 class ProtocolStructureModule : public ProtocolStructure
@@ -13,9 +15,15 @@ public:
     //! Construct the structure parsing object, with details about the overall protocol
     ProtocolStructureModule(const QString& protocolName, const QString& protocolPrefix, ProtocolSupport supported, const QString& protocolApi, const QString& protocolVersion, bool bigendian);
 
-    //! Parse a packet from the DOM
+    //! Parse a structure from the DOM
     virtual void parse(const QDomElement& e);
 
+    //! Write the source and header files for this structure
+    virtual void generate(void);
+
+    //! Write the header-only C++ file for this structure
+    void generateCpp(void);
+
     //! Reset our data contents
     virtual void clear(void);
 
@@ -25,11 +33,32 @@ public:
     //! Get the name of the header file that encompasses this structure definition
     QString getHeaderFileName(void) const {return header.fileName();}
 
+    //! Get the name of the source file that encompasses this structure definition
+    QString getSourceFileName(void) const {return source.fileName();}
+
+    //! Get the name of the header-only C++ file that encompasses this structure definition
+    QString getCppHeaderFileName(void) const {return cppHeader.fileName();}
+
+    //! Get the name of the header file that declares the types of this structure, without the functions
+    QString getTypesHeaderFileName(void) const {return typesHeader.fileName();}
+
     //! Output the top level markdown documentation for the this structure and its children
     QString getTopLevelMarkdown(QString outline) const;
 
 protected:
 
+    //! Remember the include directives given in the DOM
+    void parseIncludes(const QDomElement& e);
+
+    //! Write the include directives given in the DOM to a header file
+    void outputIncludes(ProtocolHeaderFile& file);
+
+    //! Start the types header, and include it from the header
+    void openTypesHeader(void);
+
+    //! Write the include directives of the children to a header file
+    void outputChildIncludes(ProtocolHeaderFile& file);
+
     //! Write data to the source and header files to encode and decode this structure and all its children
     void createStructureFunctions(void);
 
@@ -38,9 +67,15 @@ protected:
 
     ProtocolSourceFile source;      //!< The source file (*.c)
     ProtocolHeaderFile header;      //!< The header file (*.c)
+    ProtocolCppHeaderFile cppHeader;//!< The header-only C++ file (*.hpp)
+    ProtocolHeaderFile typesHeader; //!< The header file of the types, if the protocol splits the headers (*Types.h)
     QString api;                    //!< The protocol API enumeration
     QString version;                //!< The version string
     bool isBigEndian;               //!< True if this packets data are encoded in Big Endian
+    QString moduleName;             //!< The file attribute, empty if this module has its own files
+    QStringList includeNames;       //!< Include files given in the DOM
+    QStringList includeComments;    //!< Comments for each of the include files
+    QList<bool> includeGlobals;     //!< True for each include file that is given in angle brackets
 
 };
 
@@ -4,6 +4,19 @@ ProtocolSupport::ProtocolSupport() :
     int64(true),
     float64(true),
     specialFloat(true),
-    bitfield(true)
+    bitfield(true),
+    fuseBitfields(false),
+    fixedOffsets(false),
+    inlineHelpers(false),
+    arrayHelpers(false),
+    foldScaling(false),
+    bufferInterface(false),
+    cpp(false),
+    packMembers(false),
+    nativeLayout(false),
+    checksum(false),
+    tableCodec(false),
+    minimalHelpers(false),
+    typesHeaders(false)
 {
 }
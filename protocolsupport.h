@@ -9,6 +9,19 @@ public:
     bool float64;       //!< true if support for double precision is included
     bool specialFloat;  //!< true if support for float16 and float24 is included
     bool bitfield;      //!< true if support for bitfields is included
+    bool fuseBitfields; //!< true if contiguous bitfields are packed into a single word
+    bool fixedOffsets;  //!< true if fixed length packets are coded using constant byte offsets
+    bool inlineHelpers; //!< true if the field coding and scaling helpers are static inline in their headers
+    bool arrayHelpers;  //!< true if array fields are encoded and decoded with bulk array helpers
+    bool foldScaling;   //!< true if scaled fields are coded inline with their scaling constants
+    bool bufferInterface; //!< true if packets can be encoded into caller supplied buffers
+    bool cpp;           //!< true if header-only C++ is output alongside the C
+    bool packMembers;   //!< true if the members of structures are declared in order of alignment, rather than encoded order
+    bool nativeLayout;  //!< true if runs of fields that are laid out in memory as they are encoded are copied with memcpy
+    bool checksum;      //!< true if the CRC and checksum helpers are output
+    bool tableCodec;    //!< true if the structure functions of packets are interpreted from tables, rather than straight line code
+    bool minimalHelpers;//!< true if the helper modules only have the functions that the generated code calls
+    bool typesHeaders;  //!< true if the types of each module are declared in a header of their own, without the functions
 
 };
 
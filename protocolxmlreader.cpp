@@ -0,0 +1,242 @@
+#include "protocolxmlreader.h"
+#include "protocolparser.h"
+#include <QFile>
+#include <QXmlStreamReader>
+
+
+/*!
+ * Construct an empty reader. Call setDocument() or readFile() to give it the
+ * protocol.
+ */
+ProtocolXmlReader::ProtocolXmlReader()
+{
+}
+
+
+/*!
+ * Use a DOM of the entire protocol file. This is the original way of reading
+ * a protocol, and the elements are simply found in the DOM.
+ * \param doc is the DOM of the protocol file
+ * \return true if the document has a root element
+ */
+bool ProtocolXmlReader::setDocument(const QDomDocument& doc)
+{
+    QDomElement docElem = doc.documentElement();
+
+    text.clear();
+    protocol = doc;
+    structureNodes = ProtocolParser::childElementsByTagName(docElem, "Structure");
+    packetNodes = ProtocolParser::childElementsByTagName(docElem, "Packet");
+
+    if(docElem.isNull())
+    {
+        error = "no root element";
+        return false;
+    }
+
+    return true;
+
+}// ProtocolXmlReader::setDocument
+
+
+/*!
+ * Stream through a protocol file, remembering where each top level structure
+ * and packet is in the text, without building a DOM of them. The protocol
+ * element and its other children, such as global enumerations and includes,
+ * are small and are kept as a DOM.
+ * \param fileName is the protocol xml file
+ * \return true if the file was read, else getErrorString() says why not
+ */
+bool ProtocolXmlReader::readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        error = "failed to open protocol file: " + fileName;
+        return false;
+    }
+
+    text = QString::fromUtf8(file.readAll());
+    file.close();
+
+    protocol.clear();
+    structureNodes.clear();
+    packetNodes.clear();
+    structureStarts.clear();
+    structureLengths.clear();
+    packetStarts.clear();
+    packetLengths.clear();
+
+    QXmlStreamReader reader(text);
+    QDomElement root;
+    int depth = 0;
+    int start = 0;
+
+    while(!reader.atEnd())
+    {
+        // A token starts where the one before it ended
+        int tokenStart = (int)reader.characterOffset();
+
+        QXmlStreamReader::TokenType token = reader.readNext();
+
+        if(token == QXmlStreamReader::StartElement)
+        {
+            depth++;
+
+            if(depth == 1)
+            {
+                // The protocol element, with its attributes but not its children
+                root = protocol.createElement(reader.qualifiedName().toString());
+
+                QXmlStreamAttributes attributes = reader.attributes();
+                for(int i = 0; i < attributes.size(); i++)
+                    root.setAttribute(attributes.at(i).qualifiedName().toString(), attributes.at(i).value().toString());
+
+                protocol.appendChild(root);
+            }
+            else if(depth == 2)
+                start = tokenStart;
+        }
+        else if(token == QXmlStreamReader::EndElement)
+        {
+            if(depth == 2)
+            {
+                QString tag = reader.qualifiedName().toString();
+                int end = (int)reader.characterOffset();
+
+                // Skip any white space that was reported with the previous token
+                while((start < end) && text.at(start).isSpace())
+                    start++;
+
+                int length = end - start;
+
+                if((length < 2) || (text.at(start) != '<') || (text.at(end - 1) != '>'))
+                {
+                    error = "could not locate " + tag + " element ending on line " + QString().setNum(reader.lineNumber());
+                    return false;
+                }
+
+                // The same test as childElementsByTagName()
+                bool isStructure = tag.contains("Structure", Qt::CaseInsensitive);
+                bool isPacket = tag.contains("Packet", Qt::CaseInsensitive);
+
+                if(isStructure)
+                {
+                    structureStarts.append(start);
+                    structureLengths.append(length);
+                }
+
+                if(isPacket)
+                {
+                    packetStarts.append(start);
+                    packetLengths.append(length);
+                }
+
+                // Everything else is part of the protocol element
+                if(!isStructure && !isPacket)
+                {
+                    QDomElement element = getElement(start, length);
+                    if(element.isNull())
+                        return false;
+
+                    root.appendChild(protocol.importNode(element, true));
+                    fragment.clear();
+                }
+            }
+
+            depth--;
+        }
+
+    }// while reading tokens
+
+    if(reader.hasError())
+    {
+        error = reader.errorString() + " on line " + QString().setNum(reader.lineNumber());
+        return false;
+    }
+
+    if(root.isNull())
+    {
+        error = "no root element";
+        return false;
+    }
+
+    return true;
+
+}// ProtocolXmlReader::readFile
+
+
+/*!
+ * Build the DOM of one top level element from its text
+ * \param start is the character offset of the element in the text
+ * \param length is the number of characters in the element
+ * \return the element, which is only valid until the next call
+ */
+QDomElement ProtocolXmlReader::getElement(int start, int length)
+{
+    QString message;
+    int line = 0;
+
+    if(!fragment.setContent(text.mid(start, length), &message, &line))
+    {
+        error = message + " on line " + QString().setNum(text.left(start).count('\n') + line);
+        return QDomElement();
+    }
+
+    return fragment.documentElement();
+
+}// ProtocolXmlReader::getElement
+
+
+/*!
+ * \return the number of top level structures in the protocol
+ */
+int ProtocolXmlReader::getNumberOfStructures(void) const
+{
+    if(text.isEmpty())
+        return structureNodes.size();
+    else
+        return structureStarts.size();
+}
+
+
+/*!
+ * Get one of the top level structures. When streaming the DOM of the
+ * structure is built now, and replaces the DOM of the last element returned.
+ * \param index is the index of the structure, in document order
+ * \return the element of the structure, which is valid until the next get
+ */
+QDomElement ProtocolXmlReader::getStructure(int index)
+{
+    if(text.isEmpty())
+        return structureNodes.at(index).toElement();
+    else
+        return getElement(structureStarts.at(index), structureLengths.at(index));
+}
+
+
+/*!
+ * \return the number of packets in the protocol
+ */
+int ProtocolXmlReader::getNumberOfPackets(void) const
+{
+    if(text.isEmpty())
+        return packetNodes.size();
+    else
+        return packetStarts.size();
+}
+
+
+/*!
+ * Get one of the packets. When streaming the DOM of the packet is built now,
+ * and replaces the DOM of the last element returned.
+ * \param index is the index of the packet, in document order
+ * \return the element of the packet, which is valid until the next get
+ */
+QDomElement ProtocolXmlReader::getPacket(int index)
+{
+    if(text.isEmpty())
+        return packetNodes.at(index).toElement();
+    else
+        return getElement(packetStarts.at(index), packetLengths.at(index));
+}
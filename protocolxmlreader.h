@@ -0,0 +1,66 @@
+#ifndef PROTOCOLXMLREADER_H
+#define PROTOCOLXMLREADER_H
+
+/*!
+ * \file
+ * Read the top level elements of a protocol xml file
+ *
+ * A DOM of a large protocol file takes many times the memory of the file
+ * itself. The reader streams through the file once, remembering only where
+ * each top level structure and packet is, and builds a small DOM of just one
+ * of those elements when it is needed. A whole document DOM can still be
+ * used in its place.
+ */
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QString>
+#include <QList>
+
+class ProtocolXmlReader
+{
+public:
+    //! Construct an empty reader
+    ProtocolXmlReader();
+
+    //! Use a DOM of the entire protocol file
+    bool setDocument(const QDomDocument& doc);
+
+    //! Stream through a protocol file, without building a DOM of the entire file
+    bool readFile(const QString& fileName);
+
+    //! Get a description of the problem if reading failed
+    QString getErrorString(void) const {return error;}
+
+    //! Get the protocol element, including its children other than structures and packets
+    QDomElement getProtocolElement(void) const {return protocol.documentElement();}
+
+    //! Get the number of top level structures
+    int getNumberOfStructures(void) const;
+
+    //! Get one of the top level structures, which is valid until the next get
+    QDomElement getStructure(int index);
+
+    //! Get the number of packets
+    int getNumberOfPackets(void) const;
+
+    //! Get one of the packets, which is valid until the next get
+    QDomElement getPacket(int index);
+
+protected:
+    //! Build the DOM of one top level element from its text
+    QDomElement getElement(int start, int length);
+
+    QDomDocument protocol;          //!< The protocol element, with the children that are always needed
+    QDomDocument fragment;          //!< The DOM of the last structure or packet that was asked for
+    QString text;                   //!< The file text when streaming, empty when a DOM is used
+    QList<QDomNode> structureNodes; //!< Top level structures when a DOM is used
+    QList<int> structureStarts;     //!< Character offset of each top level structure in the text
+    QList<int> structureLengths;    //!< Character length of each top level structure in the text
+    QList<QDomNode> packetNodes;    //!< Packets when a DOM is used
+    QList<int> packetStarts;        //!< Character offset of each packet in the text
+    QList<int> packetLengths;       //!< Character length of each packet in the text
+    QString error;                  //!< Description of the last problem
+};
+
+#endif // PROTOCOLXMLREADER_H
@@ -1,31 +1,189 @@
 #include "shuntingyard.h"
 #include <QStack>
 #include <QStringList>
+#include <QMutexLocker>
+#include <QVarLengthArray>
 #include <math.h>
 
+QHash<QString, ShuntingYard::CompiledExpression> ShuntingYard::cache;
+QMutex ShuntingYard::cacheMutex;
+
 
 /*!
  * Given a raw (untokenized) mathematical expression in infix notation, compute
- * the result. Allowable operators are " ( ) + - * / ^ ".
+ * the result. Allowable operators are " ( ) + - * / ^ ". The expression is
+ * compiled the first time it is seen, and the compilation is cached.
  * \param infix is the infix expresions to compute
  * \param ok is set to true if the computation is god. ok can point to NULL.
  * \return the computational result, or 0 if the computation cannot be performed.
  */
 double ShuntingYard::computeInfix(const QString& infix, bool* ok)
 {
-    bool inputok;
-    QString postfix = infixToPostfix(infix, &inputok);
+    CompiledExpression expression;
+    bool found;
 
-    if(inputok)
-        return computePostfix(postfix, ok);
-    else
+    {
+        QMutexLocker lock(&cacheMutex);
+
+        QHash<QString, CompiledExpression>::const_iterator it = cache.constFind(infix);
+
+        found = (it != cache.constEnd());
+        if(found)
+            expression = it.value();
+    }
+
+    // Compile outside the lock, if two threads compile the same expression
+    // they get the same result
+    if(!found)
+    {
+        expression = compileInfix(infix);
+
+        QMutexLocker lock(&cacheMutex);
+        cache.insert(infix, expression);
+    }
+
+    return computeCompiled(expression, ok);
+
+}// ShuntingYard::computeInfix
+
+
+/*!
+ * Compile a raw (untokenized) mathematical expression in infix notation to a
+ * list of postfix tokens. The expression is checked as computePostfix() would
+ * check it, so a compiled expression that is ok can always be computed.
+ * \param infix is the infix expresions to compile
+ * \return the compiled expression, whose ok member is false if the expression
+ *         is malformed.
+ */
+ShuntingYard::CompiledExpression ShuntingYard::compileInfix(const QString& infix)
+{
+    CompiledExpression expression;
+    int depth = 0;
+
+    expression.depth = 0;
+
+    QString postfix = infixToPostfix(infix, &expression.ok);
+
+    if(!expression.ok)
+        return expression;
+
+    // split the string by the separators
+    QStringList list = postfix.split(' ');
+
+    for(int i = 0; i < list.size(); i++)
+    {
+        QString o1 = list.at(i);
+        CompiledToken token;
+
+        if(o1.isEmpty())
+            continue;
+
+        token.value = 0;
+
+        if(isNumber(o1))
+        {
+            token.value = o1.toDouble();
+            token.operation = 0;
+
+            depth++;
+            if(depth > expression.depth)
+                expression.depth = depth;
+        }
+        else if(depth >= 2)
+        {
+            // Same order of tests as computePostfix(). An operator that is none
+            // of these consumes its arguments without producing a result.
+            if(o1.contains('^'))
+                token.operation = '^';
+            else if(o1.contains('*'))
+                token.operation = '*';
+            else if(o1.contains('/'))
+                token.operation = '/';
+            else if(o1.contains('+'))
+                token.operation = '+';
+            else if(o1.contains('-'))
+                token.operation = '-';
+            else
+                token.operation = ' ';
+
+            if(token.operation == ' ')
+                depth -= 2;
+            else
+                depth--;
+        }
+        else
+        {
+            // An operator without enough arguments
+            expression.ok = false;
+            return expression;
+        }
+
+        expression.tokens.append(token);
+
+    }// for tokens
+
+    // there should be one value left on the stack
+    if(depth != 1)
+        expression.ok = false;
+
+    return expression;
+
+}// ShuntingYard::compileInfix
+
+
+/*!
+ * Compute an expression compiled by compileInfix(). This is the same
+ * computation as computePostfix(), without any string handling.
+ * \param expression is the compiled expression
+ * \param ok is set to true if the computation is god. ok can point to NULL.
+ * \return the computational result, or 0 if the computation cannot be performed.
+ */
+double ShuntingYard::computeCompiled(const CompiledExpression& expression, bool* ok)
+{
+    if(!expression.ok)
     {
         if(ok != 0)
             *ok = false;
 
         return 0;
     }
-}
+
+    // Expressions are short, so the arguments nearly always fit without an allocation
+    QVarLengthArray<double, 32> arguments(expression.depth);
+    int top = 0;
+
+    for(int i = 0; i < expression.tokens.size(); i++)
+    {
+        const CompiledToken& token = expression.tokens.at(i);
+
+        if(token.operation == 0)
+        {
+            arguments[top++] = token.value;
+            continue;
+        }
+
+        // the rightmost argument is the top of the stack
+        double arg2 = arguments[--top];
+        double arg1 = arguments[--top];
+
+        switch(token.operation)
+        {
+        case '^': arguments[top++] = powf(arg1, arg2); break;
+        case '*': arguments[top++] = arg1*arg2; break;
+        case '/': arguments[top++] = arg1/arg2; break;
+        case '+': arguments[top++] = arg1+arg2; break;
+        case '-': arguments[top++] = arg1-arg2; break;
+        default: break;
+        }
+
+    }// for tokens
+
+    if(ok != 0)
+        *ok = true;
+
+    return arguments[0];
+
+}// ShuntingYard::computeCompiled
 
 
 /*!
@@ -449,5 +607,18 @@ bool ShuntingYard::test(void)
     if((fabs(test ) > 0.0000000000001) || (ok == true))
         return false;
 
+    // The second time an expression is computed it comes from the cache
+    test = computeInfix("360/(2*-pi", &ok);
+    if((fabs(test ) > 0.0000000000001) || (ok == true))
+        return false;
+
+    test = computeInfix("-300-1/((1-5)^3)^-3", &ok);
+    if((fabs(test - 261844) > 0.0000000000001) || (ok == false))
+        return false;
+
+    // Agrees with the uncompiled computation
+    if(test != computePostfix(infixToPostfix("-300-1/((1-5)^3)^-3")))
+        return false;
+
     return true;
 }
@@ -21,10 +21,19 @@
  * "e", which are replaced with 3.14159265358979323846 and 2.71828182845904523536
  * respectively.
  *
+ * computeInfix() compiles each expression once, into a list of postfix tokens
+ * with the numbers already converted, and caches the compilation by the text
+ * of the expression. The same expressions are computed many times while a
+ * protocol is parsed, and after the first time they are computed without
+ * converting or allocating any strings.
+ *
  * \author Five By Five Development, LLC
  */
 
 #include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
 
 class ShuntingYard
 {
@@ -49,6 +58,33 @@ public:
 
 private:
 
+    //! One token of a compiled postfix expression
+    typedef struct
+    {
+        double value;   //!< The value of a number token
+        char operation; //!< The operator of an operator token, or 0 for a number token
+    }CompiledToken;
+
+    //! An infix expression compiled to postfix tokens
+    typedef struct
+    {
+        bool ok;                        //!< False if the expression could not be compiled
+        int depth;                      //!< The number of arguments that are stacked at once
+        QList<CompiledToken> tokens;    //!< The tokens in postfix order
+    }CompiledExpression;
+
+    //! Compiled expressions by their infix, kept for the life of the program as the number of distinct expressions in a protocol is small
+    static QHash<QString, CompiledExpression> cache;
+
+    //! Protects cache, as expressions are computed from different threads
+    static QMutex cacheMutex;
+
+    //! Compile an infix expression to postfix tokens
+    static CompiledExpression compileInfix(const QString& infix);
+
+    //! Compute a compiled expression
+    static double computeCompiled(const CompiledExpression& expression, bool* ok);
+
     //! Place delimiters as needed in the infix expression
     static QString tokenize(const QString& input);
 